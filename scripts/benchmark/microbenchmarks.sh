@@ -0,0 +1,24 @@
+#!/bin/bash
+
+# Build and run the microbenchmarks, which run on synthetic data so they need
+# none of the benchmark_objects. The results are saved in json format to the
+# given output file, such that runs before and after a change can be compared
+# with google benchmark's tools/compare.py. Any extra arguments are passed on
+# to the benchmark_main, for example --benchmark_filter=printer
+
+if [ $# -lt 2 ] || ( [ "${2,,}" != "nvidia" ] && [ "${2,,}" != "amd" ] && [ "${2,,}" != "cpu" ]); then
+  echo "Usage: ./scripts/benchmark/microbenchmarks.sh <output_file> <NVIDIA|AMD|CPU> [benchmark_main arguments]"
+  exit 1
+fi
+
+output_file="$1"
+platform="$2"
+shift 2
+
+./scripts/build/benchmarks.sh "${platform}"
+if [ $? -ne 0 ]; then >&2 echo "Building the benchmarks failed" && exit 1; fi
+
+./build/bin/benchmark_main \
+  --benchmark_out="${output_file}" \
+  --benchmark_out_format=json \
+  "$@"
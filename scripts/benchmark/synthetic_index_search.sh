@@ -0,0 +1,60 @@
+#!/bin/bash
+
+# Sweep the index search over synthetic data of different index sizes, k-mer
+# sizes and read lengths. Everything is generated and built locally by the
+# 'generate' and 'build' modes of the main executable, so no benchmark objects
+# need to be downloaded. The timing statistics are appended to the output file.
+
+if [ $# -ne 2 ]; then
+  echo "Usage: ./scripts/benchmark/synthetic_index_search.sh <output_file> <nvidia|amd|cpu>"
+  exit 1
+fi
+
+## Set loglevel to trace because we use this to get timing statistics
+export SPDLOG_LEVEL=TRACE
+
+benchmark_out="$1"
+objects_folder="benchmark_objects/synthetic"
+mkdir -p "${objects_folder}"
+
+reference_lengths=(1000000 10000000 100000000)
+kmer_sizes=(15 31)
+read_lengths=(100 150 300)
+reads=1000000
+
+. scripts/build/release.sh "$2" >&2
+
+for reference_length in "${reference_lengths[@]}"; do
+  for read_length in "${read_lengths[@]}"; do
+    prefix="${objects_folder}/${reference_length}_${read_length}"
+    ./build/bin/sbwt_search generate \
+      -o "${prefix}" \
+      -l "${reference_length}" \
+      -r "${reads}" \
+      --read-length "${read_length}" \
+      --reverse-complements \
+      > /dev/null
+  done
+  # the references only depend on the seed and their length, so they are the
+  # same for every read length
+  for kmer_size in "${kmer_sizes[@]}"; do
+    index_file="${objects_folder}/${reference_length}_k${kmer_size}.sbwt"
+    ./build/bin/sbwt_search build \
+      -i "${objects_folder}/${reference_length}_${read_lengths[0]}_references.fna" \
+      -o "${index_file}" \
+      -k "${kmer_size}" \
+      --add-reverse-complements \
+      > /dev/null
+    for read_length in "${read_lengths[@]}"; do
+      echo "Now running: Index of ${reference_length} base pairs with k=${kmer_size} and reads of length ${read_length}"
+      echo "Now running: Index of ${reference_length} base pairs with k=${kmer_size} and reads of length ${read_length}" >> "${benchmark_out}"
+      ./build/bin/sbwt_search index \
+        -i "${index_file}" \
+        -q "${objects_folder}/${reference_length}_${read_length}_reads.fna" \
+        -o "${objects_folder}/out" \
+        -p bool \
+        >> "${benchmark_out}"
+      rm -f "${objects_folder}/out.bool"
+    done
+  done
+done
@@ -30,6 +30,8 @@ extensions=(
 
 bad_exits=0
 
+# The arguments are given to verify_color_results_equal.py, along with the
+# expected and actual files
 function run_tests() {
   for file in ${files}
   do
@@ -40,7 +42,8 @@ function run_tests() {
       python3 scripts/test/verify_color_results_equal.py \
         -x ${expected} \
         -y ${actual} \
-        --quiet
+        --quiet \
+        "$@"
       last_exit=$?
       if [ ${last_exit} -ne 0 ]; then
         echo ${expected} and ${actual} do not match
@@ -68,7 +71,10 @@ done
 
 # build
 for streams in {1..5}; do
-  echo "Running combined with streams = ${streams}"
+  # there are fewer colors than this, so the top colors are all of them, but
+  # they are printed from the most k-mers to the fewest
+  top_colors=$(( (streams % 2) * 64 ))
+  echo "Running combined with streams = ${streams}, top colors = ${top_colors}"
   for mode in ${modes[@]}; do
     ./build/bin/sbwt_search colors \
       -o ${output_file} \
@@ -77,9 +83,10 @@ for streams in {1..5}; do
       -p ${mode} \
       -t 0.7 \
       -s ${streams} \
-      -c 0.1
+      -c 0.1 \
+      --top-colors ${top_colors}
   done
-  run_tests
+  run_tests --unordered
 done
 
 echo "Running individually"
@@ -97,6 +104,69 @@ for mode in ${modes[@]}; do
 done
 run_tests
 
+# A threshold of 1 intersects the color sets rather than counting them, while
+# a threshold just below 1 still counts them but should print the same colors
+echo "Running intersection against counting"
+mkdir -p tmp/color_pipeline_test/intersection tmp/color_pipeline_test/counting
+for file in ${files[@]}; do
+  for threshold in 1 0.9999999; do
+    if [[ ${threshold} == 1 ]]; then
+      directory=intersection
+    else
+      directory=counting
+    fi
+    ./build/bin/sbwt_search colors \
+      -q "test_objects/full_pipeline/color_search/${file%.*}.indexes.txt" \
+      -k test_objects/themisto_example/GCA_combined_d1.tcolors \
+      -o "tmp/color_pipeline_test/${directory}/${file%.*}.colors"  \
+      -p ascii \
+      -t ${threshold} \
+      -s 1 \
+      -c 0.1
+  done
+  python3 scripts/test/verify_color_results_equal.py \
+    -x "tmp/color_pipeline_test/intersection/${file%.*}.colors.txt" \
+    -y "tmp/color_pipeline_test/counting/${file%.*}.colors.txt" \
+    --quiet
+  last_exit=$?
+  if [ ${last_exit} -ne 0 ]; then
+    echo "The intersection and counting of ${file} do not match"
+  fi
+  ((bad_exits+=${last_exit}))
+done
+
+# With a threshold of 1, every color which is printed was found in all the
+# k-mers of the seq, so they all have the most k-mers and the ties go to the
+# smaller colors. Keeping a single top color should then print the first color
+# of each line of the intersection.
+echo "Running with fewer top colors than colors"
+top_colors=1
+for mode in ${modes[@]}; do
+  ./build/bin/sbwt_search colors \
+    -o ${output_file} \
+    -k test_objects/themisto_example/GCA_combined_d1.tcolors \
+    -q ${input_file} \
+    -p ${mode} \
+    -t 1 \
+    -s 2 \
+    -c 0.1 \
+    --top-colors ${top_colors}
+done
+for file in ${files[@]}; do
+  for extension in ${extensions[@]}; do
+    python3 scripts/test/verify_color_results_equal.py \
+      -x "tmp/color_pipeline_test/intersection/${file%.*}.colors.txt" \
+      -y "tmp/color_pipeline_test/actual/${file%.*}.colors${extension}" \
+      --top ${top_colors} \
+      --quiet
+    last_exit=$?
+    if [ ${last_exit} -ne 0 ]; then
+      echo "The top ${top_colors} colors of ${file} do not match"
+    fi
+    ((bad_exits+=${last_exit}))
+  done
+done
+
 rm -r tmp/color_pipeline_test
 
 if [[ ${bad_exits} -gt 0 ]]; then
@@ -83,6 +83,8 @@ for file in ${fna_files[@]}; do
 done
 
 for streams in {1..5}; do
+  # strides of 0 (no jumps), 1 and 2, where later runs load the cached jumps
+  jump_stride=$(( streams % 3 ))
   echo "Running combined with streams = ${streams}"
   for index_mode_idx in ${!index_modes[@]}; do
     ./build/bin/sbwt_search index \
@@ -92,7 +94,8 @@ for streams in {1..5}; do
       -q ${index_input_file} \
       -p ${index_modes[index_mode_idx]} \
       -s ${streams} \
-      -c 0.1
+      -c 0.1 \
+      --key-kmer-jump-stride ${jump_stride}
     printf "" > ${colors_input_file}
     for file in ${fna_files[@]}; do
       echo tmp/d20_pipeline_test/${file%.*}.indexes${index_extensions[index_mode_idx]} >> ${colors_input_file}
@@ -112,6 +115,7 @@ for streams in {1..5}; do
 done
 
 rm -r tmp/d20_pipeline_test
+rm -f test_objects/themisto_example/GCA_combined_d20.tcolors.*.keyjumps
 
 if [[ ${bad_exits} -gt 0 ]]; then
   exit 1
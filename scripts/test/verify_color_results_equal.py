@@ -26,6 +26,25 @@ parser.add_argument(
     action='store_true',
     default=False
 )
+parser.add_argument(
+    '-u',
+    '--unordered',
+    help='The colors of each line may be in any order',
+    required=False,
+    action='store_true',
+    default=False
+)
+parser.add_argument(
+    '-n',
+    '--top',
+    help=(
+        'Only the first this many colors of each line of the first file are'
+        ' expected in the second'
+    ),
+    required=False,
+    type=int,
+    default=None
+)
 args = vars(parser.parse_args())
 
 max_u64 = 18446744073709551615
@@ -157,6 +176,18 @@ class PackedIntParser(FileParser):
                 return ("result",n)
 
 
+def read_line(file_parser: FileParser) -> list[int] | None:
+    """The colors of the next line, or None at the end of the file"""
+    results = []
+    while True:
+        item = file_parser.get_next()
+        if item[0] == "EOF":
+            return results if len(results) > 0 else None
+        if item[0] == "newline":
+            return results
+        results.append(item[1])
+
+
 with ExitStack() as stack:
     file_parsers = []
     files: list[io.BytesIO] = [
@@ -178,6 +209,28 @@ with ExitStack() as stack:
             print(f"unknown type: {file_type}")
 
 
+    if args['unordered'] or args['top'] is not None:
+        line_count = 0
+        while True:
+            line1 = read_line(file_parsers[0])
+            line2 = read_line(file_parsers[1])
+            if line1 is not None and args['top'] is not None:
+                line1 = line1[:args['top']]
+            if line1 is not None and args['unordered']:
+                line1.sort()
+                line2 = None if line2 is None else sorted(line2)
+            if line1 != line2:
+                print(f'Lines differ at line {line_count}')
+                print(f'line1 == {line1}')
+                print(f'line2 == {line2}')
+                sys.exit(1)
+            if line1 is None:
+                break
+            line_count += 1
+        if not args['quiet']:
+            print('The file contents match!')
+        sys.exit(0)
+
     line_count = 0
     position = 0
     brk = False
@@ -0,0 +1,87 @@
+#include <string>
+#include <vector>
+
+#include "ArgumentParser/BuildIndexArgumentParser.h"
+#include "cxxopts.hpp"
+
+namespace sbwt_search {
+
+using cxxopts::value;
+using std::string;
+using std::vector;
+
+BuildIndexArgumentParser::BuildIndexArgumentParser(
+  const string &program_name,
+  const string &program_description,
+  int argc,
+  char **argv
+):
+    ArgumentParser::ArgumentParser(program_name, program_description) {
+  create_options();
+  initialise_args(argc, argv);
+}
+
+auto BuildIndexArgumentParser::create_options() -> void {
+  get_options().add_options()(
+    "i,input-file",
+    "The references in FASTA format, which must not be gzipped. Multiple "
+    "files can be given by separating them with commas or by using this "
+    "option multiple times. Characters other than ACGT (in upper or lower "
+    "case) break the sequence, such that no k-mer contains them.",
+    value<vector<string>>()
+  );
+  get_options().add_options()(
+    "o,output-file",
+    "The file to which the index is written, which should have the '.sbwt' "
+    "extension. The file is in the same plain-matrix format as that produced "
+    "by the SBWT tool, so it may be used as the index-file of the 'index' "
+    "mode.",
+    value<string>()
+  );
+  get_options().add_options()(
+    "k,kmer-size",
+    "The size of the k-mers stored in the index, which can be at most 32. By "
+    "default it is 31.",
+    value<u64>()->default_value("31")
+  );
+  get_options().add_options()(
+    "add-reverse-complements",
+    "Also index the reverse complement of every k-mer in the references. By "
+    "default this option is false."
+  );
+  get_options().add_options()(
+    "precalc-size",
+    "The length of the k-mer suffixes whose SBWT intervals are precalculated "
+    "and stored in the index for the SBWT tool to use. This program does not "
+    "make use of them. By default it is 8, which is the same as the SBWT "
+    "tool.",
+    value<u64>()->default_value("8")
+  );
+  get_options().add_options()(
+    "h,help",
+    "Print usage (you are here)",
+    value<bool>()->default_value("false")
+  );
+  get_options().allow_unrecognised_options();
+}
+
+auto BuildIndexArgumentParser::get_input_files() const -> vector<string> {
+  return get_args()["input-file"].as<vector<string>>();
+}
+auto BuildIndexArgumentParser::get_output_file() const -> string {
+  return get_args()["output-file"].as<string>();
+}
+auto BuildIndexArgumentParser::get_kmer_size() const -> u64 {
+  return get_args()["kmer-size"].as<u64>();
+}
+auto BuildIndexArgumentParser::get_add_reverse_complements() const -> bool {
+  return get_args()["add-reverse-complements"].as<bool>();
+}
+auto BuildIndexArgumentParser::get_precalc_size() const -> u64 {
+  return get_args()["precalc-size"].as<u64>();
+}
+auto BuildIndexArgumentParser::get_required_options() const -> vector<string> {
+  return {"input-file", "output-file", "kmer-size"};
+}
+
+}  // namespace sbwt_search
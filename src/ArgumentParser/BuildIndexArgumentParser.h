@@ -0,0 +1,45 @@
+#ifndef BUILD_INDEX_ARGUMENT_PARSER_H
+#define BUILD_INDEX_ARGUMENT_PARSER_H
+
+/**
+ * @file BuildIndexArgumentParser.h
+ * @brief Command line argument parser for the module which constructs a
+ * plain-matrix SBWT index from FASTA files
+ */
+
+#include <string>
+#include <vector>
+
+#include "ArgumentParser/ArgumentParser.h"
+#include "Tools/TypeDefinitions.h"
+#include "cxxopts.hpp"
+
+namespace sbwt_search {
+
+using std::string;
+using std::vector;
+
+class BuildIndexArgumentParser: public ArgumentParser {
+public:
+  BuildIndexArgumentParser(
+    const string &program_name,
+    const string &program_description,
+    int argc,
+    char **argv
+  );
+  auto get_input_files() const -> vector<string>;
+  auto get_output_file() const -> string;
+  auto get_kmer_size() const -> u64;
+  auto get_add_reverse_complements() const -> bool;
+  auto get_precalc_size() const -> u64;
+
+private:
+  auto create_options() -> void;
+
+protected:
+  auto get_required_options() const -> vector<string> override;
+};
+
+}  // namespace sbwt_search
+
+#endif
@@ -1,16 +1,20 @@
+#include <algorithm>
 #include <iostream>
 #include <limits>
 #include <string>
 
 #include "ArgumentParser/ColorSearchArgumentParser.h"
+#include "Global/GlobalDefinitions.h"
 #include "Tools/MathUtils.hpp"
 #include "Tools/MemoryUnitsParser.h"
+#include "Tools/ResourceLimits.h"
 
 namespace sbwt_search {
 
 using math_utils::gB_to_bits;
 using std::numeric_limits;
 using std::to_string;
+using system_utils::get_resource_limits;
 using units_parser::MemoryUnitsParser;
 
 ColorSearchArgumentParser::ColorSearchArgumentParser(
@@ -32,7 +36,9 @@ auto ColorSearchArgumentParser::create_options() -> void {
     "the previous step since we must also have the file extension in this "
     "step. If the file extension is '.list', this is interpreted as a list of "
     "query files, one per line. In this case, --output-prefix must also be "
-    "list of output files in the same manner, one line for each input file.",
+    "list of output files in the same manner, one line for each input file. "
+    "If this is '-', the query is read from standard input, gzipped or "
+    "not.",
     value<string>()
   );
   get_options().add_options()(
@@ -41,7 +47,9 @@ auto ColorSearchArgumentParser::create_options() -> void {
     "extension '.list', then it will be interepreted as a list of file output "
     "prefixes, separated by a newline. The extension of these output files "
     "will be determined by the choice of output format (look at the print-mode "
-    "option for more information chosen",
+    "option for more information chosen. If this is '-', the results are "
+    "written to standard output without any extension, and the logs are "
+    "written to standard error instead.",
     value<string>()
   );
   get_options().add_options()(
@@ -108,7 +116,13 @@ auto ColorSearchArgumentParser::create_options() -> void {
     "csv format is the densest format and results in VERY huge files. As such "
     "it is only recommended to use it for smaller files. The format consists "
     "of comma separated 0s and 1s, where a 0 indicates that the color at that "
-    "index has not been found, while a 1 represents the opposite.",
+    "index has not been found, while a 1 represents the opposite. The "
+    "abundance format does not print each seq, and instead writes a single "
+    "tab separated summary per file with a header, where each line has a "
+    "color, the number of seqs which had that color in their results and the "
+    "number of k-mers of the file which had that color. This is meant for "
+    "when only the colors of the whole file are needed, and writes '.tsv' "
+    "files.",
     value<string>()->default_value("ascii")
   );
   get_options().add_options()(
@@ -120,16 +134,42 @@ auto ColorSearchArgumentParser::create_options() -> void {
     "per file is already large, and it also depends on your disk drive. The "
     "default is 4. This means that 4 files will be processed at a time. If are "
     "processing less files than this, then the program will automatically "
-    "default to using as many streams as you have files.",
+    "default to using as many streams as you have files. If this is not "
+    "given, there are also no more streams than the cpus which the program "
+    "may use, which within a container or Slurm job may be less than those of "
+    "the machine.",
     value<u64>()->default_value("4")
   );
   get_options().add_options()(
     "t,threshold",
     "The percentage of kmers within a seq which need to be attributed to a "
     "color in order for us to accept that color as being part of our output. "
-    "Must be a value between 1 and 0 (both included)",
+    "Must be a value between 1 and 0 (both included). At 1, the color sets "
+    "are intersected directly rather than having each color counted, which "
+    "is faster.",
     value<double>()->default_value("1")
   );
+  get_options().add_options()(
+    "top-colors",
+    "Only print the colors with the most kmers in each seq, up to this many "
+    "of them, out of those which pass the threshold. They are printed from "
+    "the most kmers to the fewest, except with csv. The top colors are "
+    "picked on the gpu, so that only these are copied back rather than the "
+    "count of every color, which leaves room for larger batches when there "
+    "are many colors. Ties go to the smaller color. Must be at most 64. The "
+    "default is 0, which prints every color that passes the threshold.",
+    value<u64>()->default_value("0")
+  );
+  get_options().add_options()(
+    "paired-end",
+    "Treat each two consecutive seqs of every input file as the two mates of "
+    "a paired-end read, which is what index search outputs for interleaved "
+    "paired-end reads. The kmers of both mates are then counted together, "
+    "or intersected together when the threshold is 1, before the threshold "
+    "is applied, and a single line of colors is printed for each pair. If a "
+    "file has an odd number of seqs, its last seq is printed on its own. By "
+    "default this option is false."
+  );
   get_options().add_options()(
     "include-not-found",
     "By default, indexes which have not been found in the index search "
@@ -161,6 +201,13 @@ auto ColorSearchArgumentParser::create_options() -> void {
     "default). Please note that if you wish to use the ascii or binary format "
     "for pseudoalignment later, this header is mandatory."
   );
+  get_options().add_options()(
+    "gzip-output",
+    "Compress the output files with gzip and add the .gz extension to them. "
+    "Each thread compresses its own part of every batch as a separate gzip "
+    "member, so compression runs in parallel, while the file is still a "
+    "single valid gzip file. By default this option is false."
+  );
   get_options().add_options()(
     "r,indexes-per-seq",
     "The approximate number of indexes in every seq. This is necessary "
@@ -171,6 +218,70 @@ auto ColorSearchArgumentParser::create_options() -> void {
     "your seqs vary a lot more than that and you wish to optimise for space.",
     value<u64>()->default_value("70")
   );
+  get_options().add_options()(
+    "pin-threads",
+    "Pin each of the worker threads which do the parallel work of the "
+    "pipeline to its own core, out of the cores this process is allowed to run "
+    "on. This avoids threads migrating between cores and can improve cache "
+    "usage on large machines, but it should not be used if other heavy "
+    "programs share the same cores. By default this option is false."
+  );
+  get_options().add_options()(
+    "checkpoint-file",
+    "A file in which each output file is recorded once it has been fully "
+    "written and closed, so that a run which is stopped halfway can later be "
+    "resumed with the resume option. The checkpoint is only written to when a "
+    "file is finished, so it takes next to no time. By default this is empty, "
+    "and no checkpoint is written.",
+    value<string>()->default_value("")
+  );
+  get_options().add_options()(
+    "resume",
+    "Skip the queries whose output files are recorded as complete in the "
+    "checkpoint file, and carry on adding to that checkpoint. Output files "
+    "which were only partly written are written again from the start. The "
+    "queries and output files should be the same as those of the run which is "
+    "resumed. This option needs the checkpoint-file option to be set. By "
+    "default this option is false."
+  );
+  get_options().add_options()(
+    "metrics-file",
+    "A file into which the throughput of each stage of the pipeline, the "
+    "number of batches waiting in each queue, the time spent waiting on "
+    "queues and the memory in use are written while the program runs, in the "
+    "Prometheus text format. The file is rewritten as a whole every "
+    "metrics-interval seconds, so it can be read at any time or collected by "
+    "the textfile collector of the Prometheus node exporter. By default this "
+    "is empty, and no metrics are kept.",
+    value<string>()->default_value("")
+  );
+  get_options().add_options()(
+    "metrics-interval",
+    "The number of seconds between each time the metrics-file is rewritten. "
+    "The per second rates in the file are over this interval.",
+    value<u64>()->default_value("10")
+  );
+  get_options().add_options()(
+    "bottleneck-report",
+    "At the end of the run, print a report to standard error of how much of "
+    "the wall time each stage of the pipeline spent busy, waiting for its "
+    "input and waiting for room for its output, which stages waited the "
+    "longest and on what, and the critical path of each stream, which ends "
+    "at the stage which holds up the rest. This tells which part of the "
+    "pipeline to give more memory, threads or batches to. By default this "
+    "option is false."
+  );
+  get_options().add_options()(
+    "memory-estimate-margin",
+    "At the end of the run, the most pinned, gpu and main memory that each "
+    "stage of the pipeline took is logged next to the amount which was "
+    "expected when working out the size of the batches, and a warning is "
+    "logged for each one which is further than this margin from what was "
+    "expected, where 0.2 means 20% more or less. A warning means that the "
+    "memory formulas of that stage no longer match what it allocates. The "
+    "peaks are also kept in the metrics-file if it is set.",
+    value<double>()->default_value("0.2")
+  );
   get_options().add_options()(
     "h,help",
     "Print usage (you are here)",
@@ -209,6 +320,15 @@ auto ColorSearchArgumentParser::get_threshold() const -> double {
   }
   return threshold;
 }
+auto ColorSearchArgumentParser::get_top_colors() const -> u64 {
+  auto top_colors = get_args()["top-colors"].as<u64>();
+  if (top_colors > max_top_colors) {
+    std::cerr << "Invalid value for top-colors, must be at most "
+              << max_top_colors << std::endl;
+    std::quick_exit(1);
+  }
+  return top_colors;
+}
 auto ColorSearchArgumentParser::get_indexes_per_seq() const -> u64 {
   return get_args()["indexes-per-seq"].as<u64>();
 }
@@ -239,11 +359,59 @@ auto ColorSearchArgumentParser::get_include_invalid() const -> bool {
   return get_args()["include-invalid"].as<bool>();
 }
 auto ColorSearchArgumentParser::get_streams() const -> u64 {
-  return get_args()["streams"].as<u64>();
+  auto result = get_args()["streams"].as<u64>();
+  if (get_args()["streams"].count() == 0) {
+    result = std::min(result, get_resource_limits().get_cpus());
+  }
+  return result;
+}
+auto ColorSearchArgumentParser::get_paired_end() const -> bool {
+  return get_args()["paired-end"].as<bool>();
 }
 auto ColorSearchArgumentParser::get_write_headers() const -> bool {
   return !get_args()["no-headers"].as<bool>();
 }
+auto ColorSearchArgumentParser::get_gzip_output() const -> bool {
+  return get_args()["gzip-output"].as<bool>();
+}
+auto ColorSearchArgumentParser::get_pin_threads() const -> bool {
+  return get_args()["pin-threads"].as<bool>();
+}
+auto ColorSearchArgumentParser::get_checkpoint_file() const -> string {
+  return get_args()["checkpoint-file"].as<string>();
+}
+auto ColorSearchArgumentParser::get_resume() const -> bool {
+  auto result = get_args()["resume"].as<bool>();
+  if (result && get_checkpoint_file().empty()) {
+    std::cerr << "The resume option needs a checkpoint-file to resume from."
+              << std::endl;
+    std::quick_exit(1);
+  }
+  return result;
+}
+auto ColorSearchArgumentParser::get_metrics_file() const -> string {
+  return get_args()["metrics-file"].as<string>();
+}
+auto ColorSearchArgumentParser::get_metrics_interval() const -> u64 {
+  auto result = get_args()["metrics-interval"].as<u64>();
+  if (result == 0) {
+    std::cerr << "The metrics-interval must be at least 1 second." << std::endl;
+    std::quick_exit(1);
+  }
+  return result;
+}
+auto ColorSearchArgumentParser::get_bottleneck_report() const -> bool {
+  return get_args()["bottleneck-report"].as<bool>();
+}
+auto ColorSearchArgumentParser::get_memory_estimate_margin() const
+  -> double {
+  auto result = get_args()["memory-estimate-margin"].as<double>();
+  if (result < 0) {
+    std::cerr << "The memory-estimate-margin can not be negative." << std::endl;
+    std::quick_exit(1);
+  }
+  return result;
+}
 auto ColorSearchArgumentParser::get_required_options() const -> vector<string> {
   return {
     "query-file",
@@ -36,13 +36,23 @@ public:
   auto get_max_cpu_memory() const -> u64;
   auto get_print_mode() const -> string;
   auto get_threshold() const -> double;
+  auto get_top_colors() const -> u64;
   auto get_indexes_per_seq() const -> u64;
   auto get_cpu_memory_percentage() const -> double;
   auto get_gpu_memory_percentage() const -> double;
   auto get_include_not_found() const -> bool;
   auto get_include_invalid() const -> bool;
+  auto get_paired_end() const -> bool;
   auto get_streams() const -> u64;
   auto get_write_headers() const -> bool;
+  auto get_gzip_output() const -> bool;
+  auto get_pin_threads() const -> bool;
+  auto get_checkpoint_file() const -> string;
+  auto get_resume() const -> bool;
+  auto get_metrics_file() const -> string;
+  auto get_metrics_interval() const -> u64;
+  auto get_bottleneck_report() const -> bool;
+  auto get_memory_estimate_margin() const -> double;
 
 private:
   auto create_options() -> void;
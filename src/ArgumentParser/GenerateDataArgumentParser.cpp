@@ -0,0 +1,130 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ArgumentParser/GenerateDataArgumentParser.h"
+#include "cxxopts.hpp"
+
+namespace sbwt_search {
+
+using cxxopts::value;
+using std::string;
+using std::vector;
+
+GenerateDataArgumentParser::GenerateDataArgumentParser(
+  const string &program_name,
+  const string &program_description,
+  int argc,
+  char **argv
+):
+    ArgumentParser::ArgumentParser(program_name, program_description) {
+  create_options();
+  initialise_args(argc, argv);
+}
+
+auto GenerateDataArgumentParser::create_options() -> void {
+  get_options().add_options()(
+    "o,output-prefix",
+    "The prefix of the output files. The references are written to "
+    "<output-prefix>_references.fna and the reads to "
+    "<output-prefix>_reads.fna, both in FASTA format.",
+    value<string>()
+  );
+  get_options().add_options()(
+    "n,references",
+    "The number of reference sequences to generate. By default it is 1.",
+    value<u64>()->default_value("1")
+  );
+  get_options().add_options()(
+    "l,reference-length",
+    "The number of base pairs in each reference sequence. By default it is "
+    "1000000.",
+    value<u64>()->default_value("1000000")
+  );
+  get_options().add_options()(
+    "r,reads",
+    "The number of reads to generate. By default it is 100000.",
+    value<u64>()->default_value("100000")
+  );
+  get_options().add_options()(
+    "read-length",
+    "The number of base pairs in each read. Reads sampled from a shorter "
+    "reference will be as long as that reference. By default it is 150.",
+    value<u64>()->default_value("150")
+  );
+  get_options().add_options()(
+    "e,error-rate",
+    "The probability that each base pair of a read sampled from a reference "
+    "is substituted by a different one. By default it is 0.01.",
+    value<double>()->default_value("0.01")
+  );
+  get_options().add_options()(
+    "u,unmapped-fraction",
+    "The fraction of reads which are generated randomly instead of being "
+    "sampled from the references, such that most of their k-mers will not be "
+    "found. By default it is 0.",
+    value<double>()->default_value("0")
+  );
+  get_options().add_options()(
+    "reverse-complements",
+    "Reverse complement half of the reads which are sampled from the "
+    "references. By default this option is false."
+  );
+  get_options().add_options()(
+    "s,seed",
+    "The seed of the random number generator. The same seed and options will "
+    "always generate the same files. By default it is 0.",
+    value<u64>()->default_value("0")
+  );
+  get_options().add_options()(
+    "h,help",
+    "Print usage (you are here)",
+    value<bool>()->default_value("false")
+  );
+  get_options().allow_unrecognised_options();
+}
+
+auto GenerateDataArgumentParser::get_output_prefix() const -> string {
+  return get_args()["output-prefix"].as<string>();
+}
+auto GenerateDataArgumentParser::get_references() const -> u64 {
+  return get_args()["references"].as<u64>();
+}
+auto GenerateDataArgumentParser::get_reference_length() const -> u64 {
+  return get_args()["reference-length"].as<u64>();
+}
+auto GenerateDataArgumentParser::get_reads() const -> u64 {
+  return get_args()["reads"].as<u64>();
+}
+auto GenerateDataArgumentParser::get_read_length() const -> u64 {
+  return get_args()["read-length"].as<u64>();
+}
+auto GenerateDataArgumentParser::get_error_rate() const -> double {
+  return get_fraction("error-rate");
+}
+auto GenerateDataArgumentParser::get_unmapped_fraction() const -> double {
+  return get_fraction("unmapped-fraction");
+}
+auto GenerateDataArgumentParser::get_reverse_complements() const -> bool {
+  return get_args()["reverse-complements"].as<bool>();
+}
+auto GenerateDataArgumentParser::get_seed() const -> u64 {
+  return get_args()["seed"].as<u64>();
+}
+auto GenerateDataArgumentParser::get_fraction(const string &option) const
+  -> double {
+  auto result = get_args()[option].as<double>();
+  if (result < 0 || result > 1) {
+    std::cerr << "Invalid value for " << option << ". Must be between 0 and 1."
+              << std::endl;
+    std::quick_exit(1);
+  }
+  return result;
+}
+auto GenerateDataArgumentParser::get_required_options() const
+  -> vector<string> {
+  return {"output-prefix"};
+}
+
+}  // namespace sbwt_search
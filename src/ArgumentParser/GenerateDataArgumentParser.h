@@ -0,0 +1,50 @@
+#ifndef GENERATE_DATA_ARGUMENT_PARSER_H
+#define GENERATE_DATA_ARGUMENT_PARSER_H
+
+/**
+ * @file GenerateDataArgumentParser.h
+ * @brief Command line argument parser for the module which generates synthetic
+ * references and reads
+ */
+
+#include <string>
+#include <vector>
+
+#include "ArgumentParser/ArgumentParser.h"
+#include "Tools/TypeDefinitions.h"
+#include "cxxopts.hpp"
+
+namespace sbwt_search {
+
+using std::string;
+using std::vector;
+
+class GenerateDataArgumentParser: public ArgumentParser {
+public:
+  GenerateDataArgumentParser(
+    const string &program_name,
+    const string &program_description,
+    int argc,
+    char **argv
+  );
+  auto get_output_prefix() const -> string;
+  auto get_references() const -> u64;
+  auto get_reference_length() const -> u64;
+  auto get_reads() const -> u64;
+  auto get_read_length() const -> u64;
+  auto get_error_rate() const -> double;
+  auto get_unmapped_fraction() const -> double;
+  auto get_reverse_complements() const -> bool;
+  auto get_seed() const -> u64;
+
+private:
+  auto create_options() -> void;
+  auto get_fraction(const string &option) const -> double;
+
+protected:
+  auto get_required_options() const -> vector<string> override;
+};
+
+}  // namespace sbwt_search
+
+#endif
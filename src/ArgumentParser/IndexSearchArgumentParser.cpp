@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <memory>
@@ -5,6 +6,7 @@
 
 #include "ArgumentParser/IndexSearchArgumentParser.h"
 #include "Tools/MathUtils.hpp"
+#include "Tools/ResourceLimits.h"
 #include "cxxopts.hpp"
 
 namespace sbwt_search {
@@ -13,6 +15,7 @@ using cxxopts::value;
 using math_utils::gB_to_bits;
 using std::string;
 using std::to_string;
+using system_utils::get_resource_limits;
 using units_parser::MemoryUnitsParser;
 
 IndexSearchArgumentParser::IndexSearchArgumentParser(
@@ -33,7 +36,8 @@ auto IndexSearchArgumentParser::create_options() -> void {
     "combination of both. Empty lines are also supported. "
     "If the file extension is '.list', this is interpreted as a list of query "
     "files, one per line. In this case, --output-prefix must also be "
-    "list of output files in the same manner, one line for each input file.",
+    "list of output files in the same manner, one line for each input file. "
+    "If this is '-', the query is read from standard input.",
     value<string>()
   );
   get_options().add_options()(
@@ -49,7 +53,9 @@ auto IndexSearchArgumentParser::create_options() -> void {
     "extension '.list', then it will be interepreted as a list of file output "
     "prefixes, separated by a newline. The extension of these output files "
     "will be determined by the choice of output format (look at the print-mode "
-    "option for more information chosen",
+    "option for more information chosen. If this is '-', the results are "
+    "written to standard output without any extension, and the logs are "
+    "written to standard error instead.",
     value<string>()
   );
   get_options().add_options()(
@@ -115,35 +121,47 @@ auto IndexSearchArgumentParser::create_options() -> void {
     "per file is already large, and it also depends on your disk drive. The "
     "default is 4. This means that 4 files will be processed at a time. If are "
     "processing less files than this, then the program will automatically "
-    "default to using as many streams as you have files.",
+    "default to using as many streams as you have files. If this is not "
+    "given, there are also no more streams than the cpus which the program "
+    "may use, which within a container or Slurm job may be less than those of "
+    "the machine.",
     value<u64>()->default_value("4")
   );
   get_options().add_options()(
     "p,print-mode",
-    "The mode used when printing the result to the output file. Options "
-    "are 'ascii' (default), 'binary' or 'bool'. In ascii mode the "
-    "results will be printed in ASCII format so that the number viewed "
-    "represents the position in the SBWT index. The indexes within a seq are "
-    "separated by spaces and each seq is separated by a newline. Strings "
-    "which are not found are represented by -1 and strings which are invalid "
-    "(they contain characters other than ACGT) are represented by a -2. For "
-    "binary format, the output is in binary, that is, each index takes 8 bits. "
-    "The numbers are placed in a single binary string where every 8 bytes "
-    "represents an unsigned 64-bit number. Similarly to ASCII, strings which "
-    "are not found are represented by a -1 (which loops around to become the "
-    "maximum 64-bit integer (ULLONG_MAX=18446744073709551615)), strings which "
-    "are invalid are represented by -2 (ULLONG_MAX-1) and seqs are separeted "
-    "by a -3 (ULLONG_MAX-2). This version turns out to be slower and uses more "
-    "space, it is only recommended if your indexes are huge (mostly larger "
-    "than 8 bits). 'bool' is the fastest mode however it is also the least "
+    "The mode used when printing the result to the output file. Options are "
+    "'ascii' (default), 'binary', 'blockedbinary', 'bool' or 'packedbool'. In "
+    "ascii mode the results will be printed in ASCII format so that the "
+    "number viewed represents the position in the SBWT index. The indexes "
+    "within a seq are separated by spaces and each seq is separated by a "
+    "newline. Strings which are not found are represented by -1 and strings "
+    "which are invalid (they contain characters other than ACGT) are "
+    "represented by a -2. For binary format, the output is in binary, that "
+    "is, each index takes 8 bits. The numbers are placed in a single binary "
+    "string where every 8 bytes represents an unsigned 64-bit number. "
+    "Similarly to ASCII, strings which are not found are represented by a -1 "
+    "(which loops around to become the maximum 64-bit integer "
+    "(ULLONG_MAX=18446744073709551615)), strings which are invalid are "
+    "represented by -2 (ULLONG_MAX-1) and seqs are separeted by a -3 "
+    "(ULLONG_MAX-2). This version turns out to be slower and uses more space, "
+    "it is only recommended if your indexes are huge (mostly larger than 8 "
+    "bits). 'blockedbinary' writes the same values as 'binary', but split "
+    "into blocks which each start with the number of seqs and kmers within "
+    "them, and the file ends with an index of where every block starts, so "
+    "that later steps can split the file up or start reading from the middle "
+    "of it. 'bool' is the fastest mode however it is also the least "
     "desriptive. In this mode, each index results in a single ASCII byte, "
-    "which contains the value 0 if found, 1 if not found and 2 if the value is "
-    "invalid. Similarly to the ascii format, each seq is separated by a "
+    "which contains the value 0 if found, 1 if not found and 2 if the value "
+    "is invalid. Similarly to the ascii format, each seq is separated by a "
     "newline. This is the fastest and most condensed way of printing the "
     "results, but we lose the position in the index, and therefore we cannot "
-    "use this format for pseudoalignment. In terms of file extensions, ASCII "
-    "format will add '.txt', boolean format will add '.bool' and binary format "
-    "will add '.bin'.",
+    "use this format for pseudoalignment. 'packedbool' keeps the same values "
+    "as 'bool', but packs them into 2 bits each and stores the length of each "
+    "seq in a table instead of the newlines, which makes the output about 4 "
+    "times smaller. In terms of file extensions, ASCII format will add "
+    "'.txt', boolean format will add '.bool', binary format will add '.bin', "
+    "blocked binary format will add '.bbin' and packed boolean format will "
+    "add '.pbool'.",
     value<string>()->default_value("ascii")
   );
   get_options().add_options()(
@@ -169,6 +187,150 @@ auto IndexSearchArgumentParser::create_options() -> void {
     "wish to use the ascii or binary format for pseudoalignment later, this "
     "header is mandatory. "
   );
+  get_options().add_options()(
+    "gzip-output",
+    "Compress the output files with gzip and add the .gz extension to them. "
+    "Each thread compresses its own part of every batch as a separate gzip "
+    "member, so compression runs in parallel, while the file is still a "
+    "single valid gzip file which can be read by the usual tools as well as "
+    "by the color search. By default this option is false."
+  );
+  get_options().add_options()(
+    "pin-threads",
+    "Pin each of the worker threads which do the parallel work of the "
+    "pipeline to its own core, out of the cores this process is allowed to run "
+    "on. This avoids threads migrating between cores and can improve cache "
+    "usage on large machines, but it should not be used if other heavy "
+    "programs share the same cores. By default this option is false."
+  );
+  get_options().add_options()(
+    "kmer-cache-size",
+    "The amount of main memory to give to a cache of k-mers and their search "
+    "results, which sits in front of the gpu search, so that k-mers which "
+    "were already searched for do not need to be searched again. This is "
+    "worth it for highly redundant query sets, such as deeply sequenced "
+    "reads. The memory is split evenly between the streams and is taken out "
+    "of the memory available for the batches. The format of this value is the "
+    "same as that for the unavailable-main-memory option. The cache only "
+    "supports indexes whose k-mers have at most 64 characters, and it is an "
+    "error to enable it for a larger k. By default it is 0, which disables "
+    "the cache.",
+    value<string>()->default_value("0")
+  );
+  get_options().add_options()(
+    "deduplicate-reads",
+    "Collapse the seqs which are exact duplicates of an earlier seq within the "
+    "same batch, so that each distinct seq is only searched once. The results "
+    "are expanded back to every seq before being printed, so the output is "
+    "identical to that without this option. This is worth it for inputs with "
+    "many duplicate reads, such as amplicon or RNA-seq reads. By default this "
+    "option is false."
+  );
+  get_options().add_options()(
+    "invalid-kmers-on-gpu",
+    "Send a bitmap of the invalid characters to the gpu along with the seqs, "
+    "so that kmers which contain an invalid character are marked as invalid "
+    "by the search itself and are not searched for. The printers then only "
+    "need to go over the results, rather than also checking every character "
+    "of every kmer. This takes 1 bit per character instead of the 8 bits per "
+    "character otherwise taken by the list of invalid characters. By default "
+    "this option is false."
+  );
+  get_options().add_options()(
+    "bucket-kmers",
+    "Sort the k-mers of each batch by their first 12 characters before they "
+    "are searched, so that neighbouring gpu threads walk nearby parts of "
+    "the index, which makes better use of the caches. The results are put "
+    "back in the order of the k-mers before they are printed, so the output "
+    "is the same as without this option. This takes an extra 288 bits per "
+    "character of main memory. By default this option is false."
+  );
+  get_options().add_options()(
+    "pinned-arena",
+    "Carve all the pinned host memory of the batches out of a single arena "
+    "which is reserved and registered with the gpu once, and backed by huge "
+    "pages where the system allows it. This saves the cost of pinning many "
+    "large buffers one at a time, which adds up for runs over many small "
+    "files. Buffers which do not fit in the arena are pinned on their own "
+    "as usual. By default this option is false."
+  );
+  get_options().add_options()(
+    "key-kmer-jump-stride",
+    "Only used when a colors file is given. Precompute jump pointers which "
+    "move each k-mer found to its key k-mer in at most this many steps minus "
+    "one through the index and a single lookup, rather than a step at a time. "
+    "This bounds the cost of each search and keeps the gpu threads together. "
+    "A stride of 1 makes every move a single lookup, but takes 64 bits of gpu "
+    "memory for each k-mer of the index which is not a key k-mer, while "
+    "larger strides take proportionally less. The jumps are built when the "
+    "index is loaded and cached to <colors-file>.<stride>.keyjumps, so that "
+    "later runs only need to load them. By default it is 0, which disables "
+    "the jumps.",
+    value<u64>()->default_value("0")
+  );
+  get_options().add_options()(
+    "run-length-encode",
+    "Only used by the packedbool print mode. Replace long runs of kmers with "
+    "the same status, such as the whole of a seq which is not found, by the "
+    "length of the run, which shrinks the output further when results come "
+    "in long stretches. By default this option is false."
+  );
+  get_options().add_options()(
+    "checkpoint-file",
+    "A file in which each output file is recorded once it has been fully "
+    "written and closed, so that a run which is stopped halfway can later be "
+    "resumed with the resume option. The checkpoint is only written to when a "
+    "file is finished, so it takes next to no time. By default this is empty, "
+    "and no checkpoint is written.",
+    value<string>()->default_value("")
+  );
+  get_options().add_options()(
+    "resume",
+    "Skip the queries whose output files are recorded as complete in the "
+    "checkpoint file, and carry on adding to that checkpoint. Output files "
+    "which were only partly written are written again from the start. The "
+    "queries and output files should be the same as those of the run which is "
+    "resumed. This option needs the checkpoint-file option to be set. By "
+    "default this option is false."
+  );
+  get_options().add_options()(
+    "metrics-file",
+    "A file into which the throughput of each stage of the pipeline, the "
+    "number of batches waiting in each queue, the time spent waiting on "
+    "queues and the memory in use are written while the program runs, in the "
+    "Prometheus text format. The file is rewritten as a whole every "
+    "metrics-interval seconds, so it can be read at any time or collected by "
+    "the textfile collector of the Prometheus node exporter. By default this "
+    "is empty, and no metrics are kept.",
+    value<string>()->default_value("")
+  );
+  get_options().add_options()(
+    "metrics-interval",
+    "The number of seconds between each time the metrics-file is rewritten. "
+    "The per second rates in the file are over this interval.",
+    value<u64>()->default_value("10")
+  );
+  get_options().add_options()(
+    "bottleneck-report",
+    "At the end of the run, print a report to standard error of how much of "
+    "the wall time each stage of the pipeline spent busy, waiting for its "
+    "input and waiting for room for its output, which stages waited the "
+    "longest and on what, and the critical path of each stream, which ends "
+    "at the stage which holds up the rest. This tells which part of the "
+    "pipeline to give more memory, threads or batches to. By default this "
+    "option is false."
+  );
+  get_options().add_options()(
+    "memory-estimate-margin",
+    "At the end of the run, the most pinned, gpu and main memory that each "
+    "stage of the pipeline took is logged next to the amount which was "
+    "expected when working out the size of the batches, and a warning is "
+    "logged for each one which is further than this margin from what was "
+    "expected, where 0.2 means 20% more or less. A warning means that the "
+    "memory formulas of that stage no longer match what it allocates. The "
+    "peaks are also kept in the metrics-file if it is set.",
+    value<double>()->default_value("0.2")
+  );
   get_options().add_options()(
     "h,help",
     "Print usage (you are here)",
@@ -221,7 +383,11 @@ auto IndexSearchArgumentParser::get_gpu_memory_percentage() const -> double {
   return result;
 }
 auto IndexSearchArgumentParser::get_streams() const -> u64 {
-  return get_args()["streams"].as<u64>();
+  auto result = get_args()["streams"].as<u64>();
+  if (get_args()["streams"].count() == 0) {
+    result = std::min(result, get_resource_limits().get_cpus());
+  }
+  return result;
 }
 auto IndexSearchArgumentParser::get_colors_file() const -> string {
   return get_args()["colors-file"].as<string>();
@@ -229,6 +395,68 @@ auto IndexSearchArgumentParser::get_colors_file() const -> string {
 auto IndexSearchArgumentParser::get_write_headers() const -> bool {
   return !get_args()["no-headers"].as<bool>();
 }
+auto IndexSearchArgumentParser::get_gzip_output() const -> bool {
+  return get_args()["gzip-output"].as<bool>();
+}
+auto IndexSearchArgumentParser::get_pin_threads() const -> bool {
+  return get_args()["pin-threads"].as<bool>();
+}
+auto IndexSearchArgumentParser::get_kmer_cache_size() const -> u64 {
+  return MemoryUnitsParser::convert(get_args()["kmer-cache-size"].as<string>());
+}
+auto IndexSearchArgumentParser::get_deduplicate_reads() const -> bool {
+  return get_args()["deduplicate-reads"].as<bool>();
+}
+auto IndexSearchArgumentParser::get_invalid_kmers_on_gpu() const -> bool {
+  return get_args()["invalid-kmers-on-gpu"].as<bool>();
+}
+auto IndexSearchArgumentParser::get_bucket_kmers() const -> bool {
+  return get_args()["bucket-kmers"].as<bool>();
+}
+auto IndexSearchArgumentParser::get_pinned_arena() const -> bool {
+  return get_args()["pinned-arena"].as<bool>();
+}
+auto IndexSearchArgumentParser::get_key_kmer_jump_stride() const -> u64 {
+  return get_args()["key-kmer-jump-stride"].as<u64>();
+}
+auto IndexSearchArgumentParser::get_run_length_encode() const -> bool {
+  return get_args()["run-length-encode"].as<bool>();
+}
+auto IndexSearchArgumentParser::get_checkpoint_file() const -> string {
+  return get_args()["checkpoint-file"].as<string>();
+}
+auto IndexSearchArgumentParser::get_resume() const -> bool {
+  auto result = get_args()["resume"].as<bool>();
+  if (result && get_checkpoint_file().empty()) {
+    std::cerr << "The resume option needs a checkpoint-file to resume from."
+              << std::endl;
+    std::quick_exit(1);
+  }
+  return result;
+}
+auto IndexSearchArgumentParser::get_metrics_file() const -> string {
+  return get_args()["metrics-file"].as<string>();
+}
+auto IndexSearchArgumentParser::get_metrics_interval() const -> u64 {
+  auto result = get_args()["metrics-interval"].as<u64>();
+  if (result == 0) {
+    std::cerr << "The metrics-interval must be at least 1 second." << std::endl;
+    std::quick_exit(1);
+  }
+  return result;
+}
+auto IndexSearchArgumentParser::get_bottleneck_report() const -> bool {
+  return get_args()["bottleneck-report"].as<bool>();
+}
+auto IndexSearchArgumentParser::get_memory_estimate_margin() const
+  -> double {
+  auto result = get_args()["memory-estimate-margin"].as<double>();
+  if (result < 0) {
+    std::cerr << "The memory-estimate-margin can not be negative." << std::endl;
+    std::quick_exit(1);
+  }
+  return result;
+}
 auto IndexSearchArgumentParser::get_required_options() const -> vector<string> {
   return {
     "query-file",
@@ -41,6 +41,21 @@ public:
   auto get_streams() const -> u64;
   auto get_colors_file() const -> string;
   auto get_write_headers() const -> bool;
+  auto get_gzip_output() const -> bool;
+  auto get_pin_threads() const -> bool;
+  auto get_kmer_cache_size() const -> u64;
+  auto get_deduplicate_reads() const -> bool;
+  auto get_invalid_kmers_on_gpu() const -> bool;
+  auto get_bucket_kmers() const -> bool;
+  auto get_pinned_arena() const -> bool;
+  auto get_key_kmer_jump_stride() const -> u64;
+  auto get_run_length_encode() const -> bool;
+  auto get_checkpoint_file() const -> string;
+  auto get_resume() const -> bool;
+  auto get_metrics_file() const -> string;
+  auto get_metrics_interval() const -> u64;
+  auto get_bottleneck_report() const -> bool;
+  auto get_memory_estimate_margin() const -> double;
 
 protected:
   auto get_required_options() const -> vector<string> override;
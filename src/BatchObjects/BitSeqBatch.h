@@ -4,7 +4,11 @@
 /**
  * @file BitSeqBatch.h
  * @brief Container for the bit sequences. These are the converted binary
- * versions from  the string representation
+ * versions from  the string representation. Optionally, it also holds a bitmap
+ * with a bit for each character, set if that character is invalid, laid out
+ * the same way as the bit sequence with the first character as the most
+ * significant bit. The bitmap is empty if the invalid characters are instead
+ * produced as an InvalidCharsBatch.
  */
 
 #include "Tools/PinnedVector.h"
@@ -17,7 +21,9 @@ using gpu_utils::PinnedVector;
 class BitSeqBatch {
 public:
   PinnedVector<u64> bit_seq;
-  explicit BitSeqBatch(u64 bit_seq_size): bit_seq(bit_seq_size) {}
+  PinnedVector<u64> invalid_bits;
+  BitSeqBatch(u64 bit_seq_size, u64 invalid_bits_size):
+      bit_seq(bit_seq_size), invalid_bits(invalid_bits_size) {}
 };
 
 }  // namespace sbwt_search
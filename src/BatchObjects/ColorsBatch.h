@@ -4,7 +4,11 @@
 /**
  * @file ColorsBatch.h
  * @brief Stores the colors contiguously for each colored sequence. A colored
- * sequence means that the sequence has found_idxs > 0.
+ * sequence means that the sequence has found_idxs > 0. When top_colors is not
+ * 0, the colors of the first and last colored sequences come first, since
+ * these may continue from or into another batch, followed by top_colors
+ * (color, count) pairs for each colored sequence, ordered from the largest
+ * count to the smallest. Pairs with a count of 0 are unused.
  */
 
 #include "Tools/PinnedVector.h"
@@ -17,7 +21,9 @@ using gpu_utils::PinnedVector;
 class ColorsBatch {
 public:
   PinnedVector<u64> colors;
-  explicit ColorsBatch(u64 colors_size): colors(colors_size) {}
+  u64 top_colors;
+  explicit ColorsBatch(u64 colors_size, u64 top_colors_ = 0):
+      colors(colors_size), top_colors(top_colors_) {}
 };
 
 }  // namespace sbwt_search
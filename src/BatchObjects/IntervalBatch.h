@@ -9,7 +9,11 @@
  * tells us how many newlines we need before we need to start considering the
  * next lines or sequences as originating from a new file. Note: the last
  * character of both vectores will always be the max value (ULLONG_MAX), and
- * both vectors are cumulative
+ * both vectors are cumulative. When the reads are deduplicated, the other
+ * stages only see the unique seqs, whose breaks are in
+ * unique_chars_before_new_seq, and unique_seq_indexes gives the index of the
+ * unique seq for each of the seqs in chars_before_new_seq. Otherwise these are
+ * null.
  */
 
 #include <vector>
@@ -24,6 +28,8 @@ class IntervalBatch {
 public:
   const vector<u64> *chars_before_new_seq;
   vector<u64> seqs_before_newfile;
+  const vector<u64> *unique_chars_before_new_seq = nullptr;
+  const vector<u64> *unique_seq_indexes = nullptr;
 };
 
 }  // namespace sbwt_search
@@ -14,6 +14,11 @@ namespace sbwt_search {
 
 using gpu_utils::PinnedVector;
 
+// Search results are either an index or -1 when the k-mer is not found. When
+// the invalid characters are resolved on the gpu, k-mers which contain an
+// invalid character are given this value instead
+constexpr const u64 invalid_kmer_result = -2ULL;
+
 class ResultsBatch {
 public:
   PinnedVector<u64> results;
@@ -0,0 +1,75 @@
+# Builds the microbenchmarking program. We use google benchmark as a
+# benchmarking framework. The benchmarks run on synthetic data, so they do not
+# need any of the benchmark_objects, and they may be run with any of the
+# platforms, including the CPU one.
+
+option(
+  BUILD_BENCHMARKS
+  "Build the microbenchmarks"
+  OFF
+)
+
+option(
+  BENCHMARK_PERF_COUNTERS
+  "Read hardware counters such as cache misses in the benchmarks (needs libpfm)"
+  OFF
+)
+
+if (BUILD_BENCHMARKS)
+
+include(FetchContent)
+set(BENCHMARK_ENABLE_LIBPFM ${BENCHMARK_PERF_COUNTERS} CACHE BOOL "" FORCE)
+set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL "" FORCE)
+set(BENCHMARK_ENABLE_GTEST_TESTS OFF CACHE BOOL "" FORCE)
+set(BENCHMARK_ENABLE_INSTALL OFF CACHE BOOL "" FORCE)
+FetchContent_Declare(
+  googlebenchmark
+  QUIET
+  GIT_REPOSITORY https://github.com/google/benchmark.git
+  GIT_TAG        v1.7.1
+)
+FetchContent_MakeAvailable(googlebenchmark)
+
+set(
+  gpu_benchmark_sources
+  "${PROJECT_SOURCE_DIR}/UtilityKernels/Rank_benchmark.cu"
+)
+add_library(
+  gpu_benchmarks
+  ${gpu_benchmark_sources}
+)
+target_link_libraries(gpu_benchmarks PRIVATE gpu_utils)
+set_source_files_properties(
+  ${gpu_benchmark_sources}
+  TARGET_DIRECTORY gpu_benchmarks
+  PROPERTIES LANGUAGE ${HIP_TARGET_LANGUAGE}
+)
+
+add_executable(
+  benchmark_main
+  "${PROJECT_SOURCE_DIR}/benchmark_main.cpp"
+
+  "${PROJECT_SOURCE_DIR}/SbwtContainer/SbwtContainerBenchmarkUtils.cpp"
+  "${PROJECT_SOURCE_DIR}/ColorIndexContainer/ColorIndexContainerBenchmarkUtils.cpp"
+
+  "${PROJECT_SOURCE_DIR}/PoppyBuilder/PoppyBuilder_benchmark.cpp"
+  "${PROJECT_SOURCE_DIR}/UtilityKernels/Rank_benchmark.cpp"
+  "${PROJECT_SOURCE_DIR}/Presearcher/Presearcher_benchmark.cpp"
+  "${PROJECT_SOURCE_DIR}/IndexSearcher/IndexSearcher_benchmark.cpp"
+  "${PROJECT_SOURCE_DIR}/ColorSearcher/ColorSearcher_benchmark.cpp"
+
+  "${PROJECT_SOURCE_DIR}/SeqToBitsConverter/ContinuousSeqToBitsConverter_benchmark.cpp"
+  "${PROJECT_SOURCE_DIR}/PositionsBuilder/PositionsBuilder_benchmark.cpp"
+  "${PROJECT_SOURCE_DIR}/IndexFileParser/IndexFileParser_benchmark.cpp"
+  "${PROJECT_SOURCE_DIR}/IndexResultsPrinter/IndexResultsPrinter_benchmark.cpp"
+  "${PROJECT_SOURCE_DIR}/ColorResultsPrinter/ColorResultsPrinter_benchmark.cpp"
+)
+target_link_libraries(
+  benchmark_main
+  PRIVATE
+  common_libraries
+  gpu_benchmarks
+  benchmark::benchmark
+)
+
+endif() # BUILD_BENCHMARKS
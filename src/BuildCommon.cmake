@@ -76,8 +76,12 @@ add_library(
   "${PROJECT_SOURCE_DIR}/ArgumentParser/ArgumentParser.cpp"
   "${PROJECT_SOURCE_DIR}/ArgumentParser/ColorSearchArgumentParser.cpp"
   "${PROJECT_SOURCE_DIR}/ArgumentParser/IndexSearchArgumentParser.cpp"
+  "${PROJECT_SOURCE_DIR}/ArgumentParser/BuildIndexArgumentParser.cpp"
+  "${PROJECT_SOURCE_DIR}/ArgumentParser/GenerateDataArgumentParser.cpp"
+)
+target_link_libraries(
+  argument_parser PRIVATE cxxopts memory_units_parser resource_limits
 )
-target_link_libraries(argument_parser PRIVATE cxxopts memory_units_parser)
 add_library(
   presearcher_cpu
   "${PROJECT_SOURCE_DIR}/Presearcher/Presearcher.cpp"
@@ -93,6 +97,26 @@ set_source_files_properties(
   PROPERTIES LANGUAGE ${HIP_TARGET_LANGUAGE}
 )
 target_link_libraries(presearcher_gpu PRIVATE gpu_utils)
+add_library(
+  key_kmer_jumper_cpu
+  "${PROJECT_SOURCE_DIR}/KeyKmerJumper/KeyKmerJumper.cpp"
+)
+target_link_libraries(
+  key_kmer_jumper_cpu PRIVATE gpu_utils io_utils logger poppy_builder fmt::fmt
+)
+add_library(
+  key_kmer_jumper_gpu
+  "${PROJECT_SOURCE_DIR}/KeyKmerJumper/KeyKmerJumper.cu"
+)
+set_source_files_properties(
+  "${PROJECT_SOURCE_DIR}/KeyKmerJumper/KeyKmerJumper.cu"
+  TARGET_DIRECTORY key_kmer_jumper_gpu
+  PROPERTIES LANGUAGE ${HIP_TARGET_LANGUAGE}
+)
+target_link_libraries(key_kmer_jumper_gpu PRIVATE gpu_utils)
+add_library(
+  read_deduplicator "${PROJECT_SOURCE_DIR}/ReadDeduplicator/ReadDeduplicator.cpp"
+)
 add_library(
   sequence_file_parser
   "${PROJECT_SOURCE_DIR}/SequenceFileParser/ContinuousSequenceFileParser.cpp"
@@ -109,6 +133,7 @@ target_link_libraries(
   fmt::fmt
   logger
   OpenMP::OpenMP_CXX
+  read_deduplicator
 )
 add_library(
   seq_to_bits_converter
@@ -117,7 +142,7 @@ add_library(
   "${PROJECT_SOURCE_DIR}/SeqToBitsConverter/BitsProducer.cpp"
 )
 target_link_libraries(
-  seq_to_bits_converter PRIVATE fmt::fmt logger OpenMP::OpenMP_CXX
+  seq_to_bits_converter PRIVATE fmt::fmt logger OpenMP::OpenMP_CXX task_scheduler
 )
 add_library(
   filenames_parser
@@ -127,6 +152,11 @@ add_library(
   filesize_load_balancer
   "${PROJECT_SOURCE_DIR}/FilesizeLoadBalancer/FilesizeLoadBalancer.cpp"
 )
+add_library(
+  checkpointer
+  "${PROJECT_SOURCE_DIR}/Checkpointer/Checkpointer.cpp"
+)
+target_link_libraries(checkpointer PRIVATE io_utils logger fmt::fmt)
 add_library(
   poppy_builder
   "${PROJECT_SOURCE_DIR}/PoppyBuilder/PoppyBuilder.cpp"
@@ -144,6 +174,23 @@ target_link_libraries(
   gpu_utils
   libsdsl
 )
+add_library(
+  sbwt_constructor
+  "${PROJECT_SOURCE_DIR}/SbwtConstructor/SbwtConstructor.cpp"
+)
+target_link_libraries(
+  sbwt_constructor
+  PRIVATE
+  io_utils
+  OpenMP::OpenMP_CXX
+  fmt::fmt
+  logger
+)
+add_library(
+  synthetic_data_generator
+  "${PROJECT_SOURCE_DIR}/SyntheticDataGenerator/SyntheticDataGenerator.cpp"
+)
+target_link_libraries(synthetic_data_generator PRIVATE io_utils fmt::fmt)
 add_library(
   sbwt_container
   "${PROJECT_SOURCE_DIR}/SbwtContainer/SbwtContainer.cpp"
@@ -159,11 +206,19 @@ add_library(
 target_link_libraries(
   positions_builder PRIVATE fmt::fmt logger OpenMP::OpenMP_CXX
 )
+add_library(kmer_cache "${PROJECT_SOURCE_DIR}/KmerCache/KmerCache.cpp")
+add_library(
+  kmer_bucketer "${PROJECT_SOURCE_DIR}/KmerBucketer/KmerBucketer.cpp"
+)
+target_link_libraries(kmer_bucketer PRIVATE kmer_cache task_scheduler)
 add_library(
   index_searcher_cpu
   "${PROJECT_SOURCE_DIR}/IndexSearcher/IndexSearcher.cpp"
 )
-target_link_libraries(index_searcher_cpu PRIVATE fmt::fmt)
+target_link_libraries(
+  index_searcher_cpu
+  PRIVATE fmt::fmt kmer_cache kmer_bucketer task_scheduler
+)
 add_library(
   index_searcher_gpu
   "${PROJECT_SOURCE_DIR}/IndexSearcher/IndexSearcher.cu"
@@ -183,10 +238,12 @@ add_library(
   index_results_printer
   "${PROJECT_SOURCE_DIR}/IndexResultsPrinter/AsciiContinuousIndexResultsPrinter.cpp"
   "${PROJECT_SOURCE_DIR}/IndexResultsPrinter/BinaryContinuousIndexResultsPrinter.cpp"
+  "${PROJECT_SOURCE_DIR}/IndexResultsPrinter/BlockedBinaryContinuousIndexResultsPrinter.cpp"
   "${PROJECT_SOURCE_DIR}/IndexResultsPrinter/BoolContinuousIndexResultsPrinter.cpp"
+  "${PROJECT_SOURCE_DIR}/IndexResultsPrinter/PackedBoolContinuousIndexResultsPrinter.cpp"
   "${PROJECT_SOURCE_DIR}/IndexResultsPrinter/PackedIntContinuousIndexResultsPrinter.cpp"
 )
-target_link_libraries(index_results_printer PRIVATE io_utils fmt::fmt OpenMP::OpenMP_CXX libjeaiii_itoa)
+target_link_libraries(index_results_printer PRIVATE io_utils fmt::fmt OpenMP::OpenMP_CXX libjeaiii_itoa task_scheduler read_deduplicator)
 
 # Colors
 add_library(
@@ -196,6 +253,8 @@ add_library(
   "${PROJECT_SOURCE_DIR}/IndexFileParser/IndexFileParser.cpp"
   "${PROJECT_SOURCE_DIR}/IndexFileParser/AsciiIndexFileParser.cpp"
   "${PROJECT_SOURCE_DIR}/IndexFileParser/BinaryIndexFileParser.cpp"
+  "${PROJECT_SOURCE_DIR}/IndexFileParser/BlockedBinaryIndexFileParser.cpp"
+  "${PROJECT_SOURCE_DIR}/IndexFileParser/PackedBoolIndexFileParser.cpp"
   "${PROJECT_SOURCE_DIR}/IndexFileParser/PackedIntIndexFileParser.cpp"
 
   "${PROJECT_SOURCE_DIR}/IndexFileParser/SeqStatisticsBatchProducer.cpp"
@@ -219,14 +278,17 @@ target_link_libraries(color_index_builder PRIVATE libsdsl poppy_builder)
 add_library(
   color_searcher_cpu
   "${PROJECT_SOURCE_DIR}/ColorSearcher/ColorSearcher.cpp"
+  "${PROJECT_SOURCE_DIR}/ColorSearcher/TopColorsSelector.cpp"
 )
 target_link_libraries(color_searcher_cpu PRIVATE gpu_utils fmt::fmt libsdsl)
 add_library(
   color_searcher_gpu
   "${PROJECT_SOURCE_DIR}/ColorSearcher/ColorSearcher.cu"
+  "${PROJECT_SOURCE_DIR}/ColorSearcher/TopColorsSelector.cu"
 )
 set_source_files_properties(
   "${PROJECT_SOURCE_DIR}/ColorSearcher/ColorSearcher.cu"
+  "${PROJECT_SOURCE_DIR}/ColorSearcher/TopColorsSelector.cu"
   TARGET_DIRECTORY color_searcher_gpu
   PROPERTIES LANGUAGE ${HIP_TARGET_LANGUAGE}
 )
@@ -238,12 +300,13 @@ add_library(
 target_link_libraries(color_searcher PRIVATE fmt::fmt color_searcher_cpu color_searcher_gpu libsdsl)
 add_library(
   color_results_printer
+  "${PROJECT_SOURCE_DIR}/ColorResultsPrinter/AbundanceContinuousColorResultsPrinter.cpp"
   "${PROJECT_SOURCE_DIR}/ColorResultsPrinter/AsciiContinuousColorResultsPrinter.cpp"
   "${PROJECT_SOURCE_DIR}/ColorResultsPrinter/BinaryContinuousColorResultsPrinter.cpp"
   "${PROJECT_SOURCE_DIR}/ColorResultsPrinter/CsvContinuousColorResultsPrinter.cpp"
   "${PROJECT_SOURCE_DIR}/ColorResultsPrinter/PackedIntContinuousColorResultsPrinter.cpp"
 )
-target_link_libraries(color_results_printer PRIVATE io_utils fmt::fmt OpenMP::OpenMP_CXX libjeaiii_itoa)
+target_link_libraries(color_results_printer PRIVATE io_utils fmt::fmt OpenMP::OpenMP_CXX libjeaiii_itoa task_scheduler color_searcher_cpu)
 
 # Common libraries
 add_library(common_libraries INTERFACE)
@@ -264,8 +327,12 @@ target_link_libraries(
   error_utils
   memory_units_parser
   memory_utils
+  resource_limits
   omp_lock
   semaphore
+  task_scheduler
+  metrics
+  memory_tracker
   math_utils
 
   ## Common libraries
@@ -274,15 +341,23 @@ target_link_libraries(
   ## Index search libraries
   filenames_parser
   filesize_load_balancer
+  checkpointer
   sbwt_builder
+  sbwt_constructor
+  synthetic_data_generator
   sbwt_container
   poppy_builder
   presearcher_cpu
   presearcher_gpu
+  key_kmer_jumper_cpu
+  key_kmer_jumper_gpu
 
+  read_deduplicator
   sequence_file_parser
   seq_to_bits_converter
   positions_builder
+  kmer_cache
+  kmer_bucketer
   index_searcher
   index_results_printer
 
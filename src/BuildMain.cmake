@@ -13,6 +13,8 @@ add_library(
   "${PROJECT_SOURCE_DIR}/Main/Main.cpp"
   "${PROJECT_SOURCE_DIR}/Main/IndexSearchMain.cpp"
   "${PROJECT_SOURCE_DIR}/Main/ColorSearchMain.cpp"
+  "${PROJECT_SOURCE_DIR}/Main/BuildIndexMain.cpp"
+  "${PROJECT_SOURCE_DIR}/Main/GenerateDataMain.cpp"
 )
 target_link_libraries(main_lib PRIVATE common_libraries)
 
@@ -52,24 +52,44 @@ add_executable(
   "${PROJECT_SOURCE_DIR}/Tools/CircularQueue_test.cpp"
   "${PROJECT_SOURCE_DIR}/Tools/CircularBuffer_test.cpp"
   "${PROJECT_SOURCE_DIR}/Tools/IOUtils_test.cpp"
+  "${PROJECT_SOURCE_DIR}/Tools/AsyncBufferWriter_test.cpp"
+  "${PROJECT_SOURCE_DIR}/Tools/GzipUtils_test.cpp"
   "${PROJECT_SOURCE_DIR}/Tools/Semaphore_test.cpp"
+  "${PROJECT_SOURCE_DIR}/Tools/TaskScheduler_test.cpp"
+  "${PROJECT_SOURCE_DIR}/Tools/PinnedArena_test.cpp"
   "${PROJECT_SOURCE_DIR}/Tools/MathUtils_test.cpp"
   "${PROJECT_SOURCE_DIR}/Tools/Logger_test.cpp"
+  "${PROJECT_SOURCE_DIR}/Tools/Metrics_test.cpp"
+  "${PROJECT_SOURCE_DIR}/Tools/PipelineProfiler_test.cpp"
+  "${PROJECT_SOURCE_DIR}/Tools/MemoryTracker_test.cpp"
+  "${PROJECT_SOURCE_DIR}/Tools/ResourceLimits_test.cpp"
   "${PROJECT_SOURCE_DIR}/Tools/MemoryUnitsParser_test.cpp"
   "${PROJECT_SOURCE_DIR}/Tools/BenchmarkUtils_test.cpp"
 
   "${PROJECT_SOURCE_DIR}/FilenamesParser/FilenamesParser_test.cpp"
   "${PROJECT_SOURCE_DIR}/FilesizeLoadBalancer/FilesizeLoadBalancer_test.cpp"
+  "${PROJECT_SOURCE_DIR}/Checkpointer/Checkpointer_test.cpp"
 
   "${PROJECT_SOURCE_DIR}/SequenceFileParser/ContinuousSequenceFileParser_test.cpp"
+  "${PROJECT_SOURCE_DIR}/ReadDeduplicator/ReadDeduplicator_test.cpp"
   "${PROJECT_SOURCE_DIR}/PositionsBuilder/PositionsBuilder_test.cpp"
   "${PROJECT_SOURCE_DIR}/PositionsBuilder/ContinuousPositionsBuilder_test.cpp"
   "${PROJECT_SOURCE_DIR}/SeqToBitsConverter/ContinuousSeqToBitsConverter_test.cpp"
+  "${PROJECT_SOURCE_DIR}/KmerCache/KmerCache_test.cpp"
+  "${PROJECT_SOURCE_DIR}/KmerBucketer/KmerBucketer_test.cpp"
+  "${PROJECT_SOURCE_DIR}/KeyKmerJumper/KeyKmerJumper_test.cpp"
+  "${PROJECT_SOURCE_DIR}/ColorSearcher/TopColorsSelector_test.cpp"
+  "${PROJECT_SOURCE_DIR}/ColorResultsPrinter/AbundanceContinuousColorResultsPrinter_test.cpp"
+
+  "${PROJECT_SOURCE_DIR}/SbwtConstructor/SbwtConstructor_test.cpp"
+  "${PROJECT_SOURCE_DIR}/SyntheticDataGenerator/SyntheticDataGenerator_test.cpp"
 
   "${PROJECT_SOURCE_DIR}/ColorIndexBuilder/ColorIndexBuilder_test.cpp"
   "${PROJECT_SOURCE_DIR}/IndexFileParser/IndexFileParserTestUtils.cpp"
   "${PROJECT_SOURCE_DIR}/IndexFileParser/AsciiIndexFileParser_test.cpp"
   "${PROJECT_SOURCE_DIR}/IndexFileParser/BinaryIndexFileParser_test.cpp"
+  "${PROJECT_SOURCE_DIR}/IndexFileParser/BlockedBinaryIndexFileParser_test.cpp"
+  "${PROJECT_SOURCE_DIR}/IndexFileParser/PackedBoolIndexFileParser_test.cpp"
   "${PROJECT_SOURCE_DIR}/IndexFileParser/ContinuousIndexFileParser_test.cpp"
 
   "${PROJECT_SOURCE_DIR}/UtilityKernels/Rank_test.cpp"
@@ -33,11 +33,15 @@ add_library(
   math_utils
   "${PROJECT_SOURCE_DIR}/Tools/MathUtils.cpp"
 )
+find_package(ZLIB REQUIRED)
 add_library(
   io_utils
   "${PROJECT_SOURCE_DIR}/Tools/IOUtils.cpp"
+  "${PROJECT_SOURCE_DIR}/Tools/GzipUtils.cpp"
 )
 target_link_libraries(io_utils PRIVATE fmt::fmt)
+# GzipUtils.h exposes zlib types, so users of io_utils need its headers too
+target_link_libraries(io_utils PUBLIC ZLIB::ZLIB)
 
 add_library(
   error_utils
@@ -47,8 +51,9 @@ add_library(
 add_library(
   logger
   "${PROJECT_SOURCE_DIR}/Tools/Logger.cpp"
+  "${PROJECT_SOURCE_DIR}/Tools/PipelineProfiler.cpp"
 )
-target_link_libraries(logger PRIVATE spdlog::spdlog)
+target_link_libraries(logger PRIVATE spdlog::spdlog fmt::fmt)
 
 add_library(
   memory_units_parser
@@ -60,6 +65,14 @@ add_library(
   "${PROJECT_SOURCE_DIR}/Tools/MemoryUtils.cpp"
 )
 
+add_library(
+  resource_limits
+  "${PROJECT_SOURCE_DIR}/Tools/ResourceLimits.cpp"
+)
+target_link_libraries(
+  resource_limits PRIVATE math_utils memory_utils fmt::fmt
+)
+
 add_library(
   omp_lock
   "${PROJECT_SOURCE_DIR}/Tools/OmpLock.cpp"
@@ -72,6 +85,29 @@ add_library(
 )
 target_link_libraries(semaphore PRIVATE OpenMP::OpenMP_CXX omp_lock)
 
+find_package(Threads REQUIRED)
+add_library(
+  task_scheduler
+  "${PROJECT_SOURCE_DIR}/Tools/TaskScheduler.cpp"
+)
+target_link_libraries(task_scheduler PRIVATE Threads::Threads)
+
+add_library(
+  metrics
+  "${PROJECT_SOURCE_DIR}/Tools/Metrics.cpp"
+)
+target_link_libraries(
+  metrics PRIVATE io_utils logger fmt::fmt Threads::Threads
+)
+
+add_library(
+  memory_tracker
+  "${PROJECT_SOURCE_DIR}/Tools/MemoryTracker.cpp"
+)
+target_link_libraries(
+  memory_tracker PRIVATE logger math_utils memory_utils metrics fmt::fmt
+)
+
 set(
   gpu_sources
   "${PROJECT_SOURCE_DIR}/Tools/GpuUtils.cu"
@@ -79,6 +115,7 @@ set(
   "${PROJECT_SOURCE_DIR}/Tools/GpuStream.cu"
   "${PROJECT_SOURCE_DIR}/Tools/GpuEvent.cu"
   "${PROJECT_SOURCE_DIR}/Tools/PinnedVector.cu"
+  "${PROJECT_SOURCE_DIR}/Tools/PinnedArena.cu"
 )
 
 add_library(
@@ -86,6 +123,7 @@ add_library(
   ${gpu_sources}
 )
 target_link_libraries(gpu_utils PUBLIC hip_rt)
+target_link_libraries(gpu_utils PRIVATE memory_tracker)
 set_source_files_properties(
   ${gpu_sources}
   TARGET_DIRECTORY gpu_utils
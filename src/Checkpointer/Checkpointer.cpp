@@ -0,0 +1,119 @@
+#include <filesystem>
+#include <ios>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+#include "Checkpointer/Checkpointer.h"
+#include "Tools/Logger.h"
+#include "fmt/core.h"
+
+namespace sbwt_search {
+
+using fmt::format;
+using io_utils::is_standard_stream;
+using io_utils::ThrowingIfstream;
+using log_utils::Logger;
+using std::ios;
+using std::lock_guard;
+using std::make_unique;
+using std::runtime_error;
+
+namespace {
+
+const string checkpoint_format = "sbwt-search-checkpoint-v1";
+
+}  // namespace
+
+Checkpointer::Checkpointer(string filename_, bool resume):
+    filename(std::move(filename_)) {
+  if (resume) { read_checkpoint(); }
+  rewrite_checkpoint();
+  out_stream = make_unique<ThrowingOfstream>(filename, ios::out | ios::app);
+}
+
+auto Checkpointer::is_complete(const string &output_filename) const -> bool {
+  return complete_files.contains(output_filename);
+}
+
+auto Checkpointer::remove_complete(
+  vector<string> &input_filenames, vector<string> &output_filenames
+) const -> u64 {
+  u64 kept = 0;
+  for (u64 i = 0; i < output_filenames.size(); ++i) {
+    if (is_complete(output_filenames[i])) { continue; }
+    input_filenames[kept] = std::move(input_filenames[i]);
+    output_filenames[kept] = std::move(output_filenames[i]);
+    ++kept;
+  }
+  const u64 removed = output_filenames.size() - kept;
+  input_filenames.resize(kept);
+  output_filenames.resize(kept);
+  return removed;
+}
+
+auto Checkpointer::mark_complete(u64 stream_id, const string &output_filename)
+  -> void {
+  // standard output is never written again, so it can not be resumed either
+  if (is_standard_stream(output_filename)) { return; }
+  const lock_guard<mutex> lock(out_stream_mutex);
+  *out_stream << format("{}\t{}\n", stream_id, output_filename);
+  out_stream->flush();
+}
+
+auto Checkpointer::read_checkpoint() -> void {
+  if (!std::filesystem::exists(filename)) {
+    Logger::log(
+      Logger::LOG_LEVEL::WARN,
+      format("No checkpoint found at {}, so nothing is skipped", filename)
+    );
+    return;
+  }
+  ThrowingIfstream in_stream(filename, ios::in);
+  const string contents(
+    (std::istreambuf_iterator<char>(in_stream)),
+    std::istreambuf_iterator<char>()
+  );
+  std::istringstream lines(contents);
+  string line;
+  if (!std::getline(lines, line) || line != checkpoint_format) {
+    throw runtime_error(
+      format("The file {} is not a valid checkpoint", filename)
+    );
+  }
+  // a line without a newline at the end was being written when the run was
+  // stopped, so it is left out
+  while (std::getline(lines, line) && !lines.eof()) {
+    const auto tab = line.find('\t');
+    if (tab == string::npos) {
+      throw runtime_error(
+        format("The file {} is not a valid checkpoint", filename)
+      );
+    }
+    complete_files[line.substr(tab + 1)] = std::stoull(line.substr(0, tab));
+  }
+  Logger::log(
+    Logger::LOG_LEVEL::INFO,
+    format(
+      "Resuming from {}, where {} output files are complete",
+      filename,
+      complete_files.size()
+    )
+  );
+}
+
+auto Checkpointer::rewrite_checkpoint() -> void {
+  // written in full before it replaces the checkpoint, so that a run which is
+  // stopped halfway never leaves a broken checkpoint behind
+  const string temporary_filename = filename + ".tmp";
+  {
+    ThrowingOfstream temporary_stream(temporary_filename, ios::out);
+    temporary_stream << checkpoint_format << '\n';
+    for (const auto &[output_filename, stream_id] : complete_files) {
+      temporary_stream << format("{}\t{}\n", stream_id, output_filename);
+    }
+  }
+  std::filesystem::rename(temporary_filename, filename);
+}
+
+}  // namespace sbwt_search
@@ -0,0 +1,63 @@
+#ifndef CHECKPOINTER_H
+#define CHECKPOINTER_H
+
+/**
+ * @file Checkpointer.h
+ * @brief Records which output files have been fully written, so that a run
+ * which is stopped halfway can be resumed without redoing them. The printers
+ * of each stream call mark_complete once a file is closed, which appends a
+ * line with the stream and the output file to the checkpoint file and flushes
+ * it straight away, so that the checkpoint never mentions a file which is not
+ * complete. When resuming, the files in the checkpoint are taken out of the
+ * queries before they are split into streams. A file which was only partly
+ * written is not in the checkpoint, so it is written again from the start,
+ * which overwrites what was there.
+ */
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Tools/IOUtils.h"
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+using io_utils::ThrowingOfstream;
+using std::mutex;
+using std::string;
+using std::unique_ptr;
+using std::unordered_map;
+using std::vector;
+
+class Checkpointer {
+private:
+  string filename;
+  // from each complete output file to the stream which wrote it
+  unordered_map<string, u64> complete_files;
+  unique_ptr<ThrowingOfstream> out_stream;
+  mutex out_stream_mutex;
+
+public:
+  // If resume is false, any previous checkpoint in the file is discarded
+  Checkpointer(string filename_, bool resume);
+
+  [[nodiscard]] auto is_complete(const string &output_filename) const -> bool;
+  // Removes the queries whose output file is complete, and returns how many
+  // were removed
+  auto remove_complete(
+    vector<string> &input_filenames, vector<string> &output_filenames
+  ) const -> u64;
+  // Thread safe
+  auto mark_complete(u64 stream_id, const string &output_filename) -> void;
+
+private:
+  auto read_checkpoint() -> void;
+  auto rewrite_checkpoint() -> void;
+};
+
+}  // namespace sbwt_search
+
+#endif
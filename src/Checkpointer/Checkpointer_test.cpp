@@ -0,0 +1,90 @@
+#include <filesystem>
+#include <ios>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include "Checkpointer/Checkpointer.h"
+#include "Tools/IOUtils.h"
+
+namespace sbwt_search {
+
+using io_utils::ThrowingOfstream;
+using std::ios;
+using std::runtime_error;
+
+namespace {
+
+const string checkpoint_filename = "test_objects/tmp/CheckpointerTest.ckpt";
+
+}  // namespace
+
+TEST(CheckpointerTest, ResumeSkipsCompleteFiles) {
+  std::filesystem::create_directories("test_objects/tmp");
+  {
+    Checkpointer checkpointer(checkpoint_filename, false);
+    checkpointer.mark_complete(0, "out_1");
+    checkpointer.mark_complete(1, "out_3");
+    checkpointer.mark_complete(1, "-");
+  }
+  Checkpointer checkpointer(checkpoint_filename, true);
+  EXPECT_TRUE(checkpointer.is_complete("out_1"));
+  EXPECT_FALSE(checkpointer.is_complete("out_2"));
+  EXPECT_TRUE(checkpointer.is_complete("out_3"));
+  EXPECT_FALSE(checkpointer.is_complete("-"));
+  vector<string> input_filenames = {"in_1", "in_2", "in_3", "in_4"};
+  vector<string> output_filenames = {"out_1", "out_2", "out_3", "out_4"};
+  EXPECT_EQ(
+    checkpointer.remove_complete(input_filenames, output_filenames), 2
+  );
+  EXPECT_EQ(input_filenames, (vector<string>{"in_2", "in_4"}));
+  EXPECT_EQ(output_filenames, (vector<string>{"out_2", "out_4"}));
+  // the files recorded before resuming are kept along with the new ones
+  checkpointer.mark_complete(0, "out_2");
+  Checkpointer resumed_again(checkpoint_filename, true);
+  EXPECT_TRUE(resumed_again.is_complete("out_1"));
+  EXPECT_TRUE(resumed_again.is_complete("out_2"));
+  EXPECT_TRUE(resumed_again.is_complete("out_3"));
+  std::filesystem::remove(checkpoint_filename);
+}
+
+TEST(CheckpointerTest, NotResumingDiscardsCheckpoint) {
+  std::filesystem::create_directories("test_objects/tmp");
+  {
+    Checkpointer checkpointer(checkpoint_filename, false);
+    checkpointer.mark_complete(0, "out_1");
+  }
+  { Checkpointer checkpointer(checkpoint_filename, false); }
+  Checkpointer checkpointer(checkpoint_filename, true);
+  EXPECT_FALSE(checkpointer.is_complete("out_1"));
+  std::filesystem::remove(checkpoint_filename);
+}
+
+TEST(CheckpointerTest, CutShortLineIsIgnored) {
+  std::filesystem::create_directories("test_objects/tmp");
+  {
+    ThrowingOfstream out_stream(checkpoint_filename, ios::out);
+    out_stream << "sbwt-search-checkpoint-v1\n0\tout_1\n1\tout_";
+  }
+  Checkpointer checkpointer(checkpoint_filename, true);
+  EXPECT_TRUE(checkpointer.is_complete("out_1"));
+  EXPECT_FALSE(checkpointer.is_complete("out_"));
+  // the line which was cut short does not get in the way of the next ones
+  checkpointer.mark_complete(0, "out_2");
+  Checkpointer resumed_again(checkpoint_filename, true);
+  EXPECT_TRUE(resumed_again.is_complete("out_1"));
+  EXPECT_TRUE(resumed_again.is_complete("out_2"));
+  std::filesystem::remove(checkpoint_filename);
+}
+
+TEST(CheckpointerTest, InvalidCheckpoint) {
+  std::filesystem::create_directories("test_objects/tmp");
+  {
+    ThrowingOfstream out_stream(checkpoint_filename, ios::out);
+    out_stream << "not a checkpoint\n";
+  }
+  EXPECT_THROW(Checkpointer(checkpoint_filename, true), runtime_error);
+  std::filesystem::remove(checkpoint_filename);
+}
+
+}  // namespace sbwt_search
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <vector>
+
+#include "ColorIndexContainer/ColorIndexContainerBenchmarkUtils.h"
+#include "PoppyBuilder/PoppyBuilder.h"
+#include "Tools/RNGUtils.hpp"
+#include "sdsl/int_vector.hpp"
+#include "sdsl/util.hpp"
+
+namespace sbwt_search {
+
+using rng_utils::get_uniform_int_generator;
+using std::vector;
+
+namespace {
+
+const u64 max_sparse_colors = 16;
+
+auto to_int_vector(const vector<u64> &v) -> sdsl::int_vector<> {
+  sdsl::int_vector<> result(v.size());
+  std::copy(v.begin(), v.end(), result.begin());
+  sdsl::util::bit_compress(result);
+  return result;
+}
+
+auto to_bit_vector(const vector<bool> &v) -> sdsl::bit_vector {
+  sdsl::bit_vector result(v.size(), 0);
+  for (u64 i = 0; i < v.size(); ++i) { result[i] = v[i]; }
+  return result;
+}
+
+auto get_poppy(sdsl::bit_vector &v) -> Poppy {
+  return PoppyBuilder({v.data(), v.capacity() / u64_bits}, v.size())
+    .get_poppy();
+}
+
+}  // namespace
+
+auto get_synthetic_cpu_color_index(
+  u64 num_nodes, u64 num_color_sets, u64 num_colors, int seed
+) -> CpuColorIndexContainer {
+  auto rng = get_uniform_int_generator<u64>(0, num_colors - 1, seed);
+  vector<bool> is_dense_marks(num_color_sets);
+  vector<bool> dense_arrays;
+  vector<u64> dense_arrays_intervals;
+  vector<u64> sparse_arrays;
+  vector<u64> sparse_arrays_intervals;
+  for (u64 i = 0; i < num_color_sets; ++i) {
+    is_dense_marks[i] = rng() % 2 == 0;
+    if (is_dense_marks[i]) {
+      // the last color is always present so that no dense array is empty
+      dense_arrays_intervals.push_back(dense_arrays.size());
+      u64 array_size = rng() + 1;
+      for (u64 color = 0; color + 1 < array_size; ++color) {
+        dense_arrays.push_back(rng() % 2 == 0);
+      }
+      dense_arrays.push_back(true);
+    } else {
+      sparse_arrays_intervals.push_back(sparse_arrays.size());
+      u64 colors_size = rng() % max_sparse_colors + 1;
+      vector<u64> colors;
+      for (u64 color = 0; color < colors_size; ++color) {
+        colors.push_back(rng());
+      }
+      std::sort(colors.begin(), colors.end());
+      colors.erase(std::unique(colors.begin(), colors.end()), colors.end());
+      sparse_arrays.insert(sparse_arrays.end(), colors.begin(), colors.end());
+    }
+  }
+  dense_arrays_intervals.push_back(dense_arrays.size());
+  sparse_arrays_intervals.push_back(sparse_arrays.size());
+  auto color_set_idxs_rng
+    = get_uniform_int_generator<u64>(0, num_color_sets - 1, seed + 1);
+  vector<u64> color_set_idxs(num_nodes);
+  for (auto &idx : color_set_idxs) { idx = color_set_idxs_rng(); }
+
+  auto cpu_is_dense_marks = to_bit_vector(is_dense_marks);
+  auto cpu_is_dense_marks_poppy = get_poppy(cpu_is_dense_marks);
+  auto cpu_key_kmer_marks = sdsl::bit_vector(num_nodes, 1);
+  auto cpu_key_kmer_marks_poppy = get_poppy(cpu_key_kmer_marks);
+  return {
+    to_bit_vector(dense_arrays),
+    to_int_vector(dense_arrays_intervals),
+    to_int_vector(sparse_arrays),
+    to_int_vector(sparse_arrays_intervals),
+    cpu_is_dense_marks,
+    cpu_is_dense_marks_poppy,
+    cpu_key_kmer_marks,
+    cpu_key_kmer_marks_poppy,
+    to_int_vector(color_set_idxs),
+    num_color_sets,
+    num_colors};
+}
+
+}  // namespace sbwt_search
@@ -0,0 +1,22 @@
+#ifndef COLOR_INDEX_CONTAINER_BENCHMARK_UTILS_H
+#define COLOR_INDEX_CONTAINER_BENCHMARK_UTILS_H
+
+/**
+ * @file ColorIndexContainerBenchmarkUtils.h
+ * @brief Methods used by the benchmarking modules to generate a synthetic color
+ * index. Every node of the SBWT is marked as a key kmer, and half of the color
+ * sets are dense while the other half are sparse.
+ */
+
+#include "ColorIndexContainer/CpuColorIndexContainer.h"
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+auto get_synthetic_cpu_color_index(
+  u64 num_nodes, u64 num_color_sets, u64 num_colors, int seed = 0
+) -> CpuColorIndexContainer;
+
+}  // namespace sbwt_search
+
+#endif
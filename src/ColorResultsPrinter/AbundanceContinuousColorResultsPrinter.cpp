@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <string>
+
+#include "ColorResultsPrinter/AbundanceContinuousColorResultsPrinter.h"
+#include "Tools/StdUtils.hpp"
+#include "fmt/core.h"
+
+namespace sbwt_search {
+
+using fmt::format;
+using std_utils::copy_advance;
+
+AbundanceContinuousColorResultsPrinter::AbundanceContinuousColorResultsPrinter(
+  u64 stream_id_,
+  shared_ptr<SharedBatchesProducer<SeqStatisticsBatch>>
+    seq_statistics_batch_producer_,
+  shared_ptr<SharedBatchesProducer<ColorsBatch>> colors_batch_producer_,
+  const vector<string> &filenames_,
+  u64 num_colors_,
+  double threshold_,
+  bool include_not_found_,
+  bool include_invalid_,
+  u64 threads,
+  u64 max_seqs_per_batch,
+  u64 write_buffer_slots,
+  bool write_headers,
+  bool gzip_output
+):
+    Base(
+      stream_id_,
+      std::move(seq_statistics_batch_producer_),
+      std::move(colors_batch_producer_),
+      filenames_,
+      num_colors_,
+      threshold_,
+      include_not_found_,
+      include_invalid_,
+      threads,
+      // nothing is printed per seq
+      0,
+      max_seqs_per_batch,
+      write_buffer_slots,
+      write_headers,
+      gzip_output
+    ),
+    num_colors(num_colors_),
+    seq_counts(threads * num_colors_, 0),
+    kmer_counts(threads * num_colors_, 0) {}
+
+auto AbundanceContinuousColorResultsPrinter::get_bits_per_seq(
+  u64 num_colors  // NOLINT (misc-unused-parameters)
+) -> u64 {
+  return 0;
+}
+
+auto AbundanceContinuousColorResultsPrinter::get_bits_per_stream(
+  u64 num_colors, u64 threads
+) -> u64 {
+  // seq_counts and kmer_counts
+  return 2 * threads * num_colors * u64_bits;
+}
+
+auto AbundanceContinuousColorResultsPrinter::do_get_extension() -> string {
+  return ".tsv";
+}
+
+auto AbundanceContinuousColorResultsPrinter::do_process_seq(
+  u64 thread_idx,
+  u64 *results,
+  u64 found_idxs,
+  u64 not_found_idxs,
+  u64 invalid_idxs,
+  vector<char> &buffer,  // NOLINT (misc-unused-parameters)
+  u64 &buffer_idx        // NOLINT (misc-unused-parameters)
+) -> void {
+  const u64 minimum_found
+    = get_minimum_found(found_idxs, not_found_idxs, invalid_idxs);
+  auto seq_counts_it
+    = copy_advance(seq_counts.begin(), thread_idx * num_colors);
+  auto kmer_counts_it
+    = copy_advance(kmer_counts.begin(), thread_idx * num_colors);
+  for (u64 color_idx = 0; found_idxs > 0 && color_idx < num_colors;
+       ++color_idx, ++results, ++seq_counts_it, ++kmer_counts_it) {
+    *kmer_counts_it += *results;
+    if (minimum_found > 0 && *results >= minimum_found) { ++*seq_counts_it; }
+  }
+}
+
+auto AbundanceContinuousColorResultsPrinter::do_process_top_seq(
+  u64 thread_idx,
+  const u64 *pairs,
+  u64 num_pairs,
+  u64 found_idxs,
+  u64 not_found_idxs,
+  u64 invalid_idxs,
+  vector<char> &buffer,  // NOLINT (misc-unused-parameters)
+  u64 &buffer_idx        // NOLINT (misc-unused-parameters)
+) -> void {
+  const u64 minimum_found
+    = get_minimum_found(found_idxs, not_found_idxs, invalid_idxs);
+  const u64 offset = thread_idx * num_colors;
+  for (u64 i = 0; i < num_pairs && pairs[2 * i + 1] > 0; ++i) {
+    const u64 color_idx = pairs[2 * i];
+    kmer_counts[offset + color_idx] += pairs[2 * i + 1];
+    if (minimum_found > 0 && pairs[2 * i + 1] >= minimum_found) {
+      ++seq_counts[offset + color_idx];
+    }
+  }
+}
+
+auto AbundanceContinuousColorResultsPrinter::do_write_file_header(
+  ThrowingOfstream &out_stream
+) const -> void {
+  if (get_write_headers()) { out_stream << "color\tseqs\tkmers\n"; }
+}
+
+auto AbundanceContinuousColorResultsPrinter::do_at_file_end() -> void {
+  // the counts of the other threads are added to those of the first
+  for (u64 thread_idx = 1; thread_idx * num_colors < seq_counts.size();
+       ++thread_idx) {
+    for (u64 color_idx = 0; color_idx < num_colors; ++color_idx) {
+      seq_counts[color_idx] += seq_counts[thread_idx * num_colors + color_idx];
+      kmer_counts[color_idx]
+        += kmer_counts[thread_idx * num_colors + color_idx];
+    }
+  }
+  auto &out_stream = get_out_stream();
+  for (u64 color_idx = 0; color_idx < num_colors; ++color_idx) {
+    if (kmer_counts[color_idx] == 0) { continue; }
+    out_stream << format(
+      "{}\t{}\t{}\n",
+      color_idx,
+      seq_counts[color_idx],
+      kmer_counts[color_idx]
+    );
+  }
+  std::fill(seq_counts.begin(), seq_counts.end(), 0);
+  std::fill(kmer_counts.begin(), kmer_counts.end(), 0);
+}
+
+}  // namespace sbwt_search
@@ -0,0 +1,87 @@
+#ifndef ABUNDANCE_CONTINUOUS_COLOR_RESULTS_PRINTER_H
+#define ABUNDANCE_CONTINUOUS_COLOR_RESULTS_PRINTER_H
+
+/**
+ * @file AbundanceContinuousColorResultsPrinter.h
+ * @brief Outputs a single summary per file rather than a line per seq. Each
+ * thread adds the results of its seqs to its own counts, which are summed up
+ * across threads once the file is over. The summary is a tab separated table
+ * where each line has a color, the number of seqs which had that color in
+ * their results and the total number of k-mers of the file which were found
+ * to have that color. Colors which no k-mer had are skipped. The table starts
+ * with a line naming its columns, unless headers are turned off. With the top
+ * colors, only the k-mers of the top colors of each seq are counted.
+ */
+
+#include "ColorResultsPrinter/ContinuousColorResultsPrinter.hpp"
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+class AbundanceContinuousColorResultsPrinter:
+    public ContinuousColorResultsPrinter<
+      AbundanceContinuousColorResultsPrinter,
+      char> {
+  using Base = ContinuousColorResultsPrinter<
+    AbundanceContinuousColorResultsPrinter,
+    char>;
+  friend Base;
+
+  u64 num_colors;
+  // each thread has num_colors counts, one after the other
+  vector<u64> seq_counts;
+  vector<u64> kmer_counts;
+
+public:
+  AbundanceContinuousColorResultsPrinter(
+    u64 stream_id_,
+    shared_ptr<SharedBatchesProducer<SeqStatisticsBatch>>
+      seq_statistics_batch_producer_,
+    shared_ptr<SharedBatchesProducer<ColorsBatch>> colors_batch_producer_,
+    const vector<string> &filenames_,
+    u64 num_colors_,
+    double threshold_,
+    bool include_not_found_,
+    bool include_invalid_,
+    u64 threads,
+    u64 max_seqs_per_batch,
+    u64 write_buffer_slots,
+    bool write_headers,
+    bool gzip_output
+  );
+
+  auto static get_bits_per_seq(u64 num_colors) -> u64;
+  // The counts of every thread, which each stream has once, whatever the size
+  // of its batches
+  auto static get_bits_per_stream(u64 num_colors, u64 threads) -> u64;
+
+protected:
+  auto do_get_extension() -> string;
+
+  auto do_process_seq(
+    u64 thread_idx,
+    u64 *results,
+    u64 found_idxs,
+    u64 not_found_idxs,
+    u64 invalid_idxs,
+    vector<char> &buffer,
+    u64 &buffer_idx
+  ) -> void;
+  auto do_process_top_seq(
+    u64 thread_idx,
+    const u64 *pairs,
+    u64 num_pairs,
+    u64 found_idxs,
+    u64 not_found_idxs,
+    u64 invalid_idxs,
+    vector<char> &buffer,
+    u64 &buffer_idx
+  ) -> void;
+
+  auto do_write_file_header(ThrowingOfstream &out_stream) const -> void;
+  auto do_at_file_end() -> void;
+};
+
+}  // namespace sbwt_search
+
+#endif
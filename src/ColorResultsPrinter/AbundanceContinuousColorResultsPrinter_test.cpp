@@ -0,0 +1,126 @@
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "BatchObjects/ColorsBatch.h"
+#include "BatchObjects/SeqStatisticsBatch.h"
+#include "ColorResultsPrinter/AbundanceContinuousColorResultsPrinter.h"
+#include "Tools/DummyBatchProducer.hpp"
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+using std::make_shared;
+using std::numeric_limits;
+using std::string;
+using std::vector;
+using test_utils::DummyBatchProducer;
+
+namespace {
+
+const string folder = "test_objects/tmp/AbundanceTest";
+const u64 num_colors = 3;
+const double threshold = 0.5;
+const u64 threads = 2;
+const u64 max_seqs_per_batch = 4;
+
+// Each seq has its own row of colors. The last seq of each batch continues
+// into the next batch, and the first seq of the first batch has nothing
+// before it.
+auto get_seq_statistics_batch(
+  const vector<u64> &found_idxs, const vector<u64> &seqs_before_newfile
+) -> shared_ptr<SeqStatisticsBatch> {
+  auto batch = make_shared<SeqStatisticsBatch>();
+  batch->found_idxs = found_idxs;
+  batch->not_found_idxs = vector<u64>(found_idxs.size(), 0);
+  batch->invalid_idxs = vector<u64>(found_idxs.size(), 0);
+  for (u64 i = 0; i < found_idxs.size(); ++i) {
+    batch->colored_seq_id.push_back(i);
+  }
+  batch->seqs_before_newfile = seqs_before_newfile;
+  return batch;
+}
+
+auto get_colors_batch(const vector<u64> &colors) -> shared_ptr<ColorsBatch> {
+  auto batch = make_shared<ColorsBatch>(colors.size());
+  for (auto color : colors) { batch->colors.push_back(color); }
+  return batch;
+}
+
+auto read_file(const string &filename) -> string {
+  std::ifstream stream(filename);
+  std::stringstream contents;
+  contents << stream.rdbuf();
+  return contents.str();
+}
+
+auto run_printer(bool write_headers) -> void {
+  std::filesystem::remove_all(folder);
+  std::filesystem::create_directories(folder);
+  const u64 end = numeric_limits<u64>::max();
+  // the first file ends after the first seq of the second batch, which
+  // continues the last seq of the first batch
+  auto seq_statistics_producer
+    = make_shared<DummyBatchProducer<SeqStatisticsBatch>>(
+      vector<shared_ptr<SeqStatisticsBatch>>{
+        get_seq_statistics_batch({0, 4, 2, 2}, {end}),
+        get_seq_statistics_batch({2, 3, 0}, {1, end})}
+    );
+  auto colors_producer = make_shared<DummyBatchProducer<ColorsBatch>>(
+    vector<shared_ptr<ColorsBatch>>{
+      get_colors_batch({0, 0, 0, 4, 2, 0, 0, 2, 1, 2, 0, 0}),
+      get_colors_batch({1, 0, 3, 0, 3, 3, 0, 0, 0})}
+  );
+  AbundanceContinuousColorResultsPrinter printer(
+    0,
+    seq_statistics_producer,
+    colors_producer,
+    {folder + "/first", folder + "/second"},
+    num_colors,
+    threshold,
+    false,
+    false,
+    threads,
+    max_seqs_per_batch,
+    2,
+    write_headers,
+    false
+  );
+  printer.read_and_generate();
+}
+
+}  // namespace
+
+TEST(AbundanceContinuousColorResultsPrinterTest, SumsEachFile) {
+  run_printer(true);
+  // the seq which continues across the batches has 3 k-mers of color 0 and 3
+  // of color 2, out of 4
+  ASSERT_EQ(
+    read_file(folder + "/first.tsv"),
+    "color\tseqs\tkmers\n"
+    "0\t2\t7\n"
+    "1\t2\t4\n"
+    "2\t2\t4\n"
+  );
+  // the counts start again from 0, so color 0 is left out
+  ASSERT_EQ(
+    read_file(folder + "/second.tsv"),
+    "color\tseqs\tkmers\n"
+    "1\t1\t3\n"
+    "2\t1\t3\n"
+  );
+}
+
+TEST(AbundanceContinuousColorResultsPrinterTest, NoHeaders) {
+  run_printer(false);
+  ASSERT_EQ(read_file(folder + "/first.tsv"), "0\t2\t7\n1\t2\t4\n2\t2\t4\n");
+  ASSERT_EQ(read_file(folder + "/second.tsv"), "1\t1\t3\n2\t1\t3\n");
+}
+
+}  // namespace sbwt_search
@@ -17,7 +17,9 @@ AsciiContinuousColorResultsPrinter::AsciiContinuousColorResultsPrinter(
   bool include_invalid_,
   u64 threads,
   u64 max_seqs_per_batch,
-  bool write_headers
+  u64 write_buffer_slots,
+  bool write_headers,
+  bool gzip_output
 ):
     Base(
       stream_id_,
@@ -31,7 +33,9 @@ AsciiContinuousColorResultsPrinter::AsciiContinuousColorResultsPrinter(
       threads,
       get_bits_per_seq(num_colors_) / bits_in_byte,
       max_seqs_per_batch,
-      write_headers
+      write_buffer_slots,
+      write_headers,
+      gzip_output
     ) {}
 
 auto AsciiContinuousColorResultsPrinter::get_bits_per_seq(u64 num_colors)
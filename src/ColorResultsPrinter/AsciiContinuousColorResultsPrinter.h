@@ -36,7 +36,9 @@ public:
     bool include_invalid_,
     u64 threads,
     u64 max_seqs_per_batch,
-    bool write_headers
+    u64 write_buffer_slots,
+    bool write_headers,
+    bool gzip_output
   );
 
   auto static get_bits_per_seq(u64 num_colors) -> u64;
@@ -16,7 +16,9 @@ BinaryContinuousColorResultsPrinter::BinaryContinuousColorResultsPrinter(
   bool include_invalid_,
   u64 threads,
   u64 max_seqs_per_batch,
-  bool write_headers
+  u64 write_buffer_slots,
+  bool write_headers,
+  bool gzip_output
 ):
     Base(
       stream_id_,
@@ -30,7 +32,9 @@ BinaryContinuousColorResultsPrinter::BinaryContinuousColorResultsPrinter(
       threads,
       num_colors_ + 1,
       max_seqs_per_batch,
-      write_headers
+      write_buffer_slots,
+      write_headers,
+      gzip_output
     ) {}
 
 auto BinaryContinuousColorResultsPrinter::get_bits_per_seq(u64 num_colors)
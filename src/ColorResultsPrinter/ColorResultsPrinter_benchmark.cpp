@@ -0,0 +1,143 @@
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BatchObjects/ColorsBatch.h"
+#include "BatchObjects/SeqStatisticsBatch.h"
+#include "ColorResultsPrinter/AbundanceContinuousColorResultsPrinter.h"
+#include "ColorResultsPrinter/AsciiContinuousColorResultsPrinter.h"
+#include "ColorResultsPrinter/BinaryContinuousColorResultsPrinter.h"
+#include "ColorResultsPrinter/CsvContinuousColorResultsPrinter.h"
+#include "ColorResultsPrinter/PackedIntContinuousColorResultsPrinter.h"
+#include "Tools/DummyBatchProducer.hpp"
+#include "Tools/RNGUtils.hpp"
+#include "Tools/TaskScheduler.h"
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+using rng_utils::get_uniform_int_generator;
+using std::make_shared;
+using std::numeric_limits;
+using std::string;
+using std::vector;
+using test_utils::DummyBatchProducer;
+using threading_utils::TaskScheduler;
+
+namespace {
+
+const u64 color_printer_max_seq_size = 300;
+const double color_printer_threshold = 0.7;
+const u64 color_printer_write_buffer_slots = 2;
+
+// A single batch where each sequence has a random number of found, not found
+// and invalid indexes. A quarter of the colors of each sequence pass the
+// threshold.
+class ColorPrinterBenchmarkData {
+public:
+  SeqStatisticsBatch seq_statistics;
+  vector<u64> colors;
+
+  ColorPrinterBenchmarkData(u64 num_seqs, u64 num_colors) {
+    auto rng = get_uniform_int_generator<u64>(0, color_printer_max_seq_size);
+    for (u64 seq = 0; seq < num_seqs; ++seq) {
+      u64 found = rng() + 1;
+      seq_statistics.found_idxs.push_back(found);
+      seq_statistics.not_found_idxs.push_back(rng() % 8);
+      seq_statistics.invalid_idxs.push_back(rng() % 8);
+      seq_statistics.colored_seq_id.push_back(seq);
+      for (u64 color = 0; color < num_colors; ++color) {
+        colors.push_back(rng() % 4 == 0 ? found : rng() % found);
+      }
+    }
+    // the sequence which would be continued by the next batch is empty
+    seq_statistics.found_idxs.push_back(0);
+    seq_statistics.not_found_idxs.push_back(0);
+    seq_statistics.invalid_idxs.push_back(0);
+    seq_statistics.colored_seq_id.push_back(num_seqs);
+    colors.resize(colors.size() + num_colors, 0);
+    seq_statistics.seqs_before_newfile = {numeric_limits<u64>::max()};
+  }
+};
+
+template <class Printer>
+auto benchmark_color_results_printer(benchmark::State &state) -> void {
+  const u64 num_seqs = state.range(0);
+  const u64 num_colors = state.range(1);
+  ColorPrinterBenchmarkData data(num_seqs, num_colors);
+  const auto directory = std::filesystem::temp_directory_path()
+    / "sbwt_search_color_results_printer_benchmark";
+  std::filesystem::create_directories(directory);
+  const string filename = (directory / "out").string();
+  for (auto _ : state) {
+    // the printer modifies its batches, so each run gets a fresh copy
+    state.PauseTiming();
+    auto colors_batch = make_shared<ColorsBatch>(data.colors.size());
+    for (u64 c : data.colors) { colors_batch->colors.push_back(c); }
+    auto printer = make_shared<Printer>(
+      0,
+      make_shared<DummyBatchProducer<SeqStatisticsBatch>>(
+        vector<shared_ptr<SeqStatisticsBatch>>{
+          make_shared<SeqStatisticsBatch>(data.seq_statistics)}
+      ),
+      make_shared<DummyBatchProducer<ColorsBatch>>(
+        vector<shared_ptr<ColorsBatch>>{colors_batch}
+      ),
+      vector<string>{filename},
+      num_colors,
+      color_printer_threshold,
+      false,
+      false,
+      TaskScheduler::get_global().get_threads(),
+      num_seqs + 1,
+      color_printer_write_buffer_slots,
+      true,
+      false
+    );
+    state.ResumeTiming();
+    printer->read_and_generate();
+  }
+  state.SetItemsProcessed(
+    static_cast<int64_t>(state.iterations() * num_seqs * num_colors)
+  );
+  std::filesystem::remove_all(directory);
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(
+  benchmark_color_results_printer, AsciiContinuousColorResultsPrinter
+)
+  ->ArgNames({"seqs", "colors"})
+  ->ArgsProduct({{1ULL << 16}, {64, 1024}})
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(
+  benchmark_color_results_printer, BinaryContinuousColorResultsPrinter
+)
+  ->ArgNames({"seqs", "colors"})
+  ->ArgsProduct({{1ULL << 16}, {64, 1024}})
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(
+  benchmark_color_results_printer, CsvContinuousColorResultsPrinter
+)
+  ->ArgNames({"seqs", "colors"})
+  ->ArgsProduct({{1ULL << 16}, {64, 1024}})
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(
+  benchmark_color_results_printer, PackedIntContinuousColorResultsPrinter
+)
+  ->ArgNames({"seqs", "colors"})
+  ->ArgsProduct({{1ULL << 16}, {64, 1024}})
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(
+  benchmark_color_results_printer, AbundanceContinuousColorResultsPrinter
+)
+  ->ArgNames({"seqs", "colors"})
+  ->ArgsProduct({{1ULL << 16}, {64, 1024}})
+  ->Unit(benchmark::kMillisecond);
+
+}  // namespace sbwt_search
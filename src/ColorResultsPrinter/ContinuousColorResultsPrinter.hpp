@@ -5,12 +5,21 @@
  * @file ContinuousColorResultsPrinter.hpp
  * @brief Prints out the color results in parallel. Each threads handles an
  * equal number of sequences (colored or not). Then these are first printed to a
- * buffer in parallel, and later serially output to disk.
+ * buffer in parallel, and later output to disk. The buffers are taken from the
+ * pool of an AsyncBufferWriter, which writes them on its own thread while the
+ * next batch is being formatted. With gzip output, each thread compresses its
+ * own buffer into a separate gzip member. When the batch only has the top
+ * colors of each sequence, these are printed straight from their (color,
+ * count) pairs, from the color with the most k-mers to the one with the
+ * fewest, so that the cost of each sequence does not grow with the number of
+ * colors. Printers which do not print each seq can instead override
+ * do_process_seq and do_process_top_seq, which are also given the index of
+ * the thread handling the seq.
  */
 
 #include <algorithm>
-#include <bit>
 #include <cmath>
+#include <functional>
 #include <ios>
 #include <iterator>
 #include <limits>
@@ -19,29 +28,36 @@
 
 #include "BatchObjects/ColorsBatch.h"
 #include "BatchObjects/SeqStatisticsBatch.h"
+#include "Checkpointer/Checkpointer.h"
+#include "ColorSearcher/TopColorsSelector.h"
+#include "Tools/AsyncBufferWriter.hpp"
 #include "Tools/IOUtils.h"
 #include "Tools/Logger.h"
 #include "Tools/MathUtils.hpp"
-#include "Tools/OmpLock.h"
+#include "Tools/PipelineProfiler.h"
 #include "Tools/SharedBatchesProducer.hpp"
 #include "Tools/StdUtils.hpp"
+#include "Tools/TaskScheduler.h"
 #include "fmt/core.h"
 
 namespace sbwt_search {
 
 using design_utils::SharedBatchesProducer;
 using fmt::format;
+using io_utils::AsyncBufferWriter;
+using io_utils::is_standard_stream;
 using io_utils::ThrowingOfstream;
 using log_utils::Logger;
+using log_utils::PipelineProfiler;
 using math_utils::divide_and_ceil;
-using std::bit_cast;
 using std::ios;
+using std::make_unique;
 using std::numeric_limits;
 using std::ostream;
 using std::shared_ptr;
 using std::unique_ptr;
 using std_utils::copy_advance;
-using threading_utils::OmpLock;
+using threading_utils::TaskScheduler;
 
 template <class TImplementation, class Buffer_t>
 class ContinuousColorResultsPrinter {
@@ -64,12 +80,14 @@ private:
   u64 previous_last_invalid_idxs = numeric_limits<u64>::max();
   u64 include_not_found;
   u64 include_invalid;
-  vector<vector<Buffer_t>> buffers;
   u64 threads;
   u64 stream_id;
-  vector<OmpLock> write_locks{};
+  u64 batch_id = 0;
   unique_ptr<ThrowingOfstream> out_stream;
+  unique_ptr<AsyncBufferWriter<Buffer_t>> writer;
   bool write_headers;
+  bool gzip_output;
+  shared_ptr<Checkpointer> checkpointer;
 
 public:
   ContinuousColorResultsPrinter(
@@ -85,7 +103,9 @@ public:
     u64 threads_,
     u64 seq_size,
     u64 max_seqs_per_batch,
-    bool write_headers_
+    u64 write_buffer_slots,
+    bool write_headers_,
+    bool gzip_output_
   ):
       seq_statistics_batch_producer(std::move(seq_statistics_batch_producer_)),
       colors_batch_producer(std::move(colors_batch_producer_)),
@@ -96,14 +116,26 @@ public:
       include_not_found(static_cast<u64>(include_not_found_)),
       include_invalid(static_cast<u64>(include_invalid_)),
       threads(threads_),
-      write_locks(threads_ - 1),
       stream_id(stream_id_),
-      buffers(threads_),
-      write_headers(write_headers_) {
-    for (auto &b : buffers) {
-      impl().do_allocate_buffer(
-        b, divide_and_ceil<u64>(max_seqs_per_batch, threads_) * seq_size
-      );
+      writer(make_unique<AsyncBufferWriter<Buffer_t>>(
+        format("ResultsWriter_{}", stream_id_),
+        write_buffer_slots,
+        threads_,
+        gzip_output_
+      )),
+      write_headers(write_headers_),
+      gzip_output(gzip_output_) {
+    PipelineProfiler::add_queue(
+      format("ResultsWriter_{}", stream_id),
+      format("ResultsPrinter_{}", stream_id),
+      format("ResultsWriter_{}", stream_id)
+    );
+    for (auto &slot : writer->get_slots()) {
+      for (auto &b : slot.buffers) {
+        impl().do_allocate_buffer(
+          b, divide_and_ceil<u64>(max_seqs_per_batch, threads_) * seq_size
+        );
+      }
     }
   }
 
@@ -111,11 +143,16 @@ public:
     buffer.resize(amount);
   }
 
+  // The output files are recorded in the checkpoint once they are complete
+  auto set_checkpointer(shared_ptr<Checkpointer> checkpointer_) -> void {
+    checkpointer = std::move(checkpointer_);
+  }
+
   auto read_and_generate() -> void {
     current_filename = filenames.begin();
     if (current_filename == filenames.end()) { return; }
     impl().do_start_next_file();
-    for (u64 batch_id = 0; get_batch(); ++batch_id) {
+    for (batch_id = 0; get_batch(); ++batch_id) {
       Logger::log_timed_event(
         format("ResultsPrinter_{}", stream_id),
         Logger::EVENT_STATE::START,
@@ -128,10 +165,21 @@ public:
         format("batch {}", batch_id)
       );
     }
+    writer->wait_until_written();
     impl().do_at_file_end();
+    checkpoint_file();
+    writer->log_statistics();
   }
 
 private:
+  // The file is closed before it is recorded, so that everything in it has
+  // been written by then
+  auto checkpoint_file() -> void {
+    if (checkpointer == nullptr) { return; }
+    out_stream.reset();
+    checkpointer->mark_complete(stream_id, *std::prev(current_filename));
+  }
+
   auto get_batch() -> bool {
     return (static_cast<u64>(
               *seq_statistics_batch_producer >> seq_statistics_batch
@@ -146,16 +194,25 @@ protected:
   auto do_get_version() -> string;
 
   auto do_start_next_file() -> void {
-    if (current_filename != filenames.begin()) { impl().do_at_file_end(); }
+    if (current_filename != filenames.begin()) {
+      writer->wait_until_written();
+      impl().do_at_file_end();
+      checkpoint_file();
+    }
     impl().do_open_next_file(*current_filename);
     impl().do_write_file_header(*out_stream);
     current_filename = next(current_filename);
   }
   auto do_at_file_end() -> void {}
   auto do_open_next_file(const string &filename) -> void {
+    // standard output is written to as is, without adding any extension
     out_stream = make_unique<ThrowingOfstream>(
-      filename + impl().do_get_extension(), ios::binary | ios::out
+      is_standard_stream(filename) ?
+        filename :
+        filename + impl().do_get_extension() + (gzip_output ? ".gz" : ""),
+      ios::binary | ios::out
     );
+    if (gzip_output) { out_stream->enable_gzip_members(); }
   }
   auto do_write_file_header(ThrowingOfstream &out_stream) -> void {
     if (write_headers) {
@@ -171,6 +228,8 @@ protected:
     auto &invalid_idxs = seq_statistics_batch->invalid_idxs;
     auto &colored_seq_id = seq_statistics_batch->colored_seq_id;
     auto &sbnfs = seq_statistics_batch->seqs_before_newfile;
+    const u64 top_colors = colors_batch->top_colors;
+    u64 *top_colors_pairs = colors.data() + 2 * num_colors;
 
     // Fill in from previous batch (seq is continued)
     found_idxs[0] += previous_last_found_idx;
@@ -183,33 +242,57 @@ protected:
       colors.data(),
       std::plus<>()
     );
+    // the counts which were added to may change which colors are on top
+    if (top_colors > 0 && colors.size() > 2 * num_colors) {
+      select_top_colors(
+        colors.data(), num_colors, top_colors, top_colors_pairs
+      );
+    }
     u64 start_seq = 0;
     for (u64 sbnf_idx = 0; sbnf_idx < sbnfs.size(); ++sbnf_idx) {
       u64 end_seq = std::min(sbnfs[sbnf_idx], colored_seq_id.size() - 1);
-#pragma omp parallel num_threads(threads)
-      {
-        u64 thread_idx = omp_get_thread_num();
-        if (!write_locks.empty() && thread_idx < buffers.size() - 1) {
-          write_locks[thread_idx].set_lock();
-        }
-#pragma omp barrier
-
-        auto &buffer = buffers[thread_idx];
-        u64 buffer_idx = 0;
-
-#pragma omp for schedule(static)
-        for (u64 seq_idx = start_seq; seq_idx < end_seq; ++seq_idx) {
-          impl().do_print_seq(
-            colors.data() + colored_seq_id[seq_idx] * num_colors,
-            found_idxs[seq_idx],
-            not_found_idxs[seq_idx],
-            invalid_idxs[seq_idx],
-            buffer,
-            buffer_idx
-          );
+      const u64 seqs_per_thread
+        = divide_and_ceil<u64>(end_seq - start_seq, threads);
+      auto &slot = writer->acquire(batch_id);
+      TaskScheduler::get_global().parallel_for(
+        threads,
+        [&](u64 thread_idx) {
+          auto &buffer = slot.buffers[thread_idx];
+          u64 &buffer_idx = slot.sizes[thread_idx];
+          buffer_idx = 0;
+          u64 first_seq
+            = std::min(start_seq + thread_idx * seqs_per_thread, end_seq);
+          u64 last_seq = std::min(first_seq + seqs_per_thread, end_seq);
+          for (u64 seq_idx = first_seq; seq_idx < last_seq; ++seq_idx) {
+            if (top_colors == 0) {
+              impl().do_process_seq(
+                thread_idx,
+                colors.data() + colored_seq_id[seq_idx] * num_colors,
+                found_idxs[seq_idx],
+                not_found_idxs[seq_idx],
+                invalid_idxs[seq_idx],
+                buffer,
+                buffer_idx
+              );
+              continue;
+            }
+            // seqs without any k-mers found do not have any pairs
+            const bool has_pairs = found_idxs[seq_idx] > 0;
+            impl().do_process_top_seq(
+              thread_idx,
+              top_colors_pairs + colored_seq_id[seq_idx] * 2 * top_colors,
+              has_pairs ? top_colors : 0,
+              found_idxs[seq_idx],
+              not_found_idxs[seq_idx],
+              invalid_idxs[seq_idx],
+              buffer,
+              buffer_idx
+            );
+          }
+          writer->finish_buffer(slot, thread_idx);
         }
-        write_buffers_parallel(buffer_idx);
-      }
+      );
+      writer->submit(*out_stream);
       if (end_seq == sbnfs[sbnf_idx]) { impl().do_start_next_file(); }
       start_seq = end_seq;
     }
@@ -218,20 +301,51 @@ protected:
     previous_last_not_found_idxs = not_found_idxs.back();
     previous_last_invalid_idxs = invalid_idxs.back();
     if (previous_last_found_idx > 0) {
+      u64 *last_results = colors.data() + colored_seq_id.back() * num_colors;
+      if (top_colors > 0) {
+        // the last seq has its counts after those of the first, unless it is
+        // also the first, whose counts were added to above
+        last_results
+          = colors.data() + (colored_seq_id.back() > 0 ? num_colors : 0);
+      }
       previous_last_results.insert(
         previous_last_results.begin(),
-        std::make_move_iterator(
-          colors.data() + colored_seq_id.back() * num_colors
-        ),
-        std::make_move_iterator(
-          colors.data() + (colored_seq_id.back() + 1) * num_colors
-        )
+        std::make_move_iterator(last_results),
+        std::make_move_iterator(last_results + num_colors)
       );
     } else {
       previous_last_results.assign(previous_last_results.size(), 0);
     }
   }
 
+  auto get_out_stream() -> ThrowingOfstream & { return *out_stream; }
+  [[nodiscard]] auto get_write_headers() const -> bool { return write_headers; }
+
+  // The count which a color needs to reach for it to be part of the seq's
+  // results, or 0 if no color can be part of them
+  auto get_minimum_found(u64 found_idxs, u64 not_found_idxs, u64 invalid_idxs)
+    -> u64 {
+    u64 seq_size = found_idxs + include_not_found * not_found_idxs
+      + include_invalid * invalid_idxs;
+    return static_cast<u64>(
+      std::ceil(static_cast<double>(seq_size) * threshold)
+    );
+  }
+
+  auto do_process_seq(
+    u64 thread_idx,  // NOLINT (misc-unused-parameters)
+    u64 *results,
+    u64 found_idxs,
+    u64 not_found_idxs,
+    u64 invalid_idxs,
+    vector<Buffer_t> &buffer,
+    u64 &buffer_idx
+  ) -> void {
+    impl().do_print_seq(
+      results, found_idxs, not_found_idxs, invalid_idxs, buffer, buffer_idx
+    );
+  }
+
   auto do_print_seq(
     u64 *results,
     u64 found_idxs,
@@ -240,10 +354,8 @@ protected:
     vector<Buffer_t> &buffer,
     u64 &buffer_idx
   ) -> void {
-    u64 seq_size = found_idxs + include_not_found * not_found_idxs
-      + include_invalid * invalid_idxs;
     const u64 minimum_found
-      = static_cast<u64>(std::ceil(static_cast<double>(seq_size) * threshold));
+      = get_minimum_found(found_idxs, not_found_idxs, invalid_idxs);
     bool first_print = true;
     for (u64 color_idx = 0; minimum_found > 0 && color_idx < num_colors;
          ++color_idx, ++results) {
@@ -262,27 +374,57 @@ protected:
       += impl().do_with_newline(copy_advance(buffer.begin(), buffer_idx));
   }
 
-  auto do_with_newline(vector<Buffer_t>::iterator buffer) -> u64;
-  auto do_with_space(vector<Buffer_t>::iterator buffer) -> u64 { return 0; }
-  auto do_with_result(vector<Buffer_t>::iterator buffer, u64 result) -> u64;
+  auto do_process_top_seq(
+    u64 thread_idx,  // NOLINT (misc-unused-parameters)
+    const u64 *pairs,
+    u64 num_pairs,
+    u64 found_idxs,
+    u64 not_found_idxs,
+    u64 invalid_idxs,
+    vector<Buffer_t> &buffer,
+    u64 &buffer_idx
+  ) -> void {
+    impl().do_print_top_seq(
+      pairs,
+      num_pairs,
+      found_idxs,
+      not_found_idxs,
+      invalid_idxs,
+      buffer,
+      buffer_idx
+    );
+  }
 
-  auto write_buffers_parallel(u64 buffer_idx) -> void {
-    u64 thread_idx = omp_get_thread_num();
-    auto &buffer = buffers[thread_idx];
-    if (thread_idx > 0) { write_locks[thread_idx - 1].set_lock(); }
-    impl().do_write_buffer(buffer, buffer_idx);
-    if (thread_idx > 0) { write_locks[thread_idx - 1].unset_lock(); }
-    if (thread_idx < write_locks.size()) {
-      write_locks[thread_idx].unset_lock();
+  // The pairs go from the largest count to the smallest, so the first pair
+  // below the threshold ends the seq
+  auto do_print_top_seq(
+    const u64 *pairs,
+    u64 num_pairs,
+    u64 found_idxs,
+    u64 not_found_idxs,
+    u64 invalid_idxs,
+    vector<Buffer_t> &buffer,
+    u64 &buffer_idx
+  ) -> void {
+    const u64 minimum_found
+      = get_minimum_found(found_idxs, not_found_idxs, invalid_idxs);
+    for (u64 i = 0; minimum_found > 0 && i < num_pairs; ++i) {
+      if (pairs[2 * i + 1] < minimum_found) { break; }
+      if (i > 0) {
+        buffer_idx
+          += impl().do_with_space(copy_advance(buffer.begin(), buffer_idx));
+      }
+      buffer_idx += impl().do_with_result(
+        copy_advance(buffer.begin(), buffer_idx), pairs[2 * i]
+      );
     }
+    buffer_idx
+      += impl().do_with_newline(copy_advance(buffer.begin(), buffer_idx));
   }
 
-  auto do_write_buffer(const vector<Buffer_t> &buffer, u64 amount) -> void {
-    out_stream->write(
-      bit_cast<char *>(buffer.data()),
-      static_cast<std::streamsize>(amount * sizeof(Buffer_t))
-    );
-  }
+  auto do_with_newline(vector<Buffer_t>::iterator buffer) -> u64;
+  auto do_with_space(vector<Buffer_t>::iterator buffer) -> u64 { return 0; }
+  auto do_with_result(vector<Buffer_t>::iterator buffer, u64 result) -> u64;
 };
 
 }  // namespace sbwt_search
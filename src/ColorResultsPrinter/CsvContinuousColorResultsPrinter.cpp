@@ -21,7 +21,9 @@ CsvContinuousColorResultsPrinter::CsvContinuousColorResultsPrinter(
   bool include_invalid_,
   u64 threads,
   u64 max_seqs_per_batch,
-  bool write_headers
+  u64 write_buffer_slots,
+  bool write_headers,
+  bool gzip_output
 ):
     Base(
       stream_id_,
@@ -35,7 +37,9 @@ CsvContinuousColorResultsPrinter::CsvContinuousColorResultsPrinter(
       threads,
       num_colors_ * 2,
       max_seqs_per_batch,
-      write_headers
+      write_buffer_slots,
+      write_headers,
+      gzip_output
     ),
     num_colors(num_colors_) {
   row_template.resize(num_colors * 2);
@@ -93,6 +97,32 @@ auto CsvContinuousColorResultsPrinter::do_print_seq(
   buffer_idx += row_template.size();
 }
 
+auto CsvContinuousColorResultsPrinter::do_print_top_seq(
+  const u64 *pairs,
+  u64 num_pairs,
+  u64 found_idxs,
+  u64 not_found_idxs,
+  u64 invalid_idxs,
+  vector<char> &buffer,
+  u64 &buffer_idx
+) -> void {
+  std::copy(
+    row_template.begin(),
+    row_template.end(),
+    copy_advance(buffer.begin(), buffer_idx)
+  );
+  Base::do_print_top_seq(
+    pairs,
+    num_pairs,
+    found_idxs,
+    not_found_idxs,
+    invalid_idxs,
+    buffer,
+    buffer_idx
+  );
+  buffer_idx += row_template.size();
+}
+
 auto CsvContinuousColorResultsPrinter::do_with_newline(
   vector<char>::iterator buffer  // NOLINT (misc-unused-parameters)
 ) -> u64 {
@@ -4,7 +4,8 @@
 /**
  * @file CsvContinuousColorResultsPrinter.h
  * @brief Outputs csv results. Color indexes are ordered and space separated,
- * and each seq is placed on a new line
+ * and each seq is placed on a new line. Every row has a column for each color,
+ * so with the top colors, the row is still filled in for every color.
  */
 
 #include "ColorResultsPrinter/ContinuousColorResultsPrinter.hpp"
@@ -36,7 +37,9 @@ public:
     bool include_invalid_,
     u64 threads,
     u64 max_seqs_per_batch,
-    bool write_headers
+    u64 write_buffer_slots,
+    bool write_headers,
+    bool gzip_output
   );
 
   auto static get_bits_per_seq(u64 num_colors) -> u64;
@@ -52,6 +55,15 @@ protected:
     vector<char> &buffer,
     u64 &buffer_idx
   ) -> void;
+  auto do_print_top_seq(
+    const u64 *pairs,
+    u64 num_pairs,
+    u64 found_idxs,
+    u64 not_found_idxs,
+    u64 invalid_idxs,
+    vector<char> &buffer,
+    u64 &buffer_idx
+  ) -> void;
 
   auto do_write_file_header(ThrowingOfstream &out_stream) const -> void;
   auto do_with_newline(vector<char>::iterator buffer) -> u64;
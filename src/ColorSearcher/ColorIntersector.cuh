@@ -0,0 +1,285 @@
+#ifndef COLOR_INTERSECTOR_CUH
+#define COLOR_INTERSECTOR_CUH
+
+/**
+ * @file ColorIntersector.cuh
+ * @brief The search and post processing kernels used when the threshold is 1,
+ * in which case a color is only printed if every k-mer found in the seq has
+ * it. Rather than counting each color, each warp intersects the color sets of
+ * its k-mers one u64 of colors at a time, with a bitwise and over the dense
+ * color sets and a merge over the sorted sparse ones. The warp only goes over
+ * the colors between the largest first color and the smallest last color of
+ * its color sets, since no other color can be in all of them. The result of
+ * each warp is the intersected colors as a bit vector followed by the number
+ * of k-mers found in the warp. The post processing then gives each color which
+ * is in every warp of the seq the number of k-mers found in the seq, and 0 to
+ * the rest, which makes the printed results the same as those of the counts.
+ */
+
+#include "ColorSearcher/ColorSearcher.cuh"
+#include "Global/GlobalDefinitions.h"
+#include "Tools/KernelUtils.cuh"
+#include "Tools/TypeDefinitions.h"
+#include "UtilityKernels/GetBoolFromBitVector.cuh"
+#include "UtilityKernels/Rank.cuh"
+#include "UtilityKernels/VariableLengthIntegerIndex.cuh"
+#include "hip/hip_runtime.h"
+
+namespace sbwt_search {
+
+using gpu_utils::get_idx;
+
+inline __device__ auto d_warp_and(u64 value) -> u64 {
+  for (int offset = gpu_warp_size / 2; offset > 0; offset /= 2) {
+#if (defined(__HIP_CPU_RT__) || defined(__HIP_PLATFORM_HCC__) || defined(__HIP_PLATFORM_AMD__))
+    value &= __shfl_xor(value, offset);
+#elif (defined(__HIP_PLATFORM_NVCC__) || defined(__HIP_PLATFORM_NVIDIA__))
+    value &= __shfl_xor_sync(full_mask, value, offset);
+#endif
+  }
+  return value;
+}
+
+inline __device__ auto d_warp_max(u64 value) -> u64 {
+  for (int offset = gpu_warp_size / 2; offset > 0; offset /= 2) {
+#if (defined(__HIP_CPU_RT__) || defined(__HIP_PLATFORM_HCC__) || defined(__HIP_PLATFORM_AMD__))
+    u64 shfld = __shfl_xor(value, offset);
+#elif (defined(__HIP_PLATFORM_NVCC__) || defined(__HIP_PLATFORM_NVIDIA__))
+    u64 shfld = __shfl_xor_sync(full_mask, value, offset);
+#endif
+    value = value > shfld ? value : shfld;
+  }
+  return value;
+}
+
+inline __device__ auto d_warp_min(u64 value) -> u64 {
+  for (int offset = gpu_warp_size / 2; offset > 0; offset /= 2) {
+#if (defined(__HIP_CPU_RT__) || defined(__HIP_PLATFORM_HCC__) || defined(__HIP_PLATFORM_AMD__))
+    u64 shfld = __shfl_xor(value, offset);
+#elif (defined(__HIP_PLATFORM_NVCC__) || defined(__HIP_PLATFORM_NVIDIA__))
+    u64 shfld = __shfl_xor_sync(full_mask, value, offset);
+#endif
+    value = value < shfld ? value : shfld;
+  }
+  return value;
+}
+
+inline __device__ auto d_warp_count(bool value) -> u64 {
+#if (defined(__HIP_CPU_RT__) || defined(__HIP_PLATFORM_HCC__) || defined(__HIP_PLATFORM_AMD__))
+  return __popcll(__ballot(value));
+#elif (defined(__HIP_PLATFORM_NVCC__) || defined(__HIP_PLATFORM_NVIDIA__))
+  return __popc(__ballot_sync(full_mask, value));
+#else
+#error("No runtime defined");
+#endif
+}
+
+// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+// Gets the colors from word_idx * 64 to word_idx * 64 + 63 of the dense color
+// set, where the first color is the least significant bit
+inline __device__ auto d_dense_get_colors_word(
+  const u64 arrays_start,
+  const u64 arrays_end,
+  const u64 word_idx,
+  const u64 *dense_arrays
+) -> u64 {
+  const u64 first_color = word_idx * u64_bits;
+  const u64 num_bits = arrays_end - arrays_start;
+  if (first_color >= num_bits) { return 0; }
+  const u64 start = arrays_start + first_color;
+  const u64 shift = start % u64_bits;
+  u64 result = dense_arrays[start / u64_bits] >> shift;
+  if (shift != 0 && num_bits - first_color > u64_bits - shift) {
+    result |= dense_arrays[start / u64_bits + 1] << (u64_bits - shift);
+  }
+  if (num_bits - first_color < u64_bits) {
+    result &= (1ULL << (num_bits - first_color)) - 1;
+  }
+  return result;
+}
+// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+// Same as the dense version, but array_idx is moved past the colors read, so
+// that going over the words in order merges through the sorted colors once
+inline __device__ auto d_sparse_get_colors_word(
+  u64 &array_idx,
+  const u64 arrays_end,
+  const u64 word_idx,
+  const u64 *sparse_arrays,
+  const u64 sparse_arrays_width,
+  const u64 sparse_arrays_width_set_bits
+) -> u64 {
+  u64 result = 0;
+  for (; array_idx < arrays_end; ++array_idx) {
+    const u64 color = d_variable_length_int_index(
+      sparse_arrays,
+      sparse_arrays_width,
+      sparse_arrays_width_set_bits,
+      array_idx
+    );
+    if (color >= (word_idx + 1) * u64_bits) { break; }
+    if (color >= word_idx * u64_bits) { result |= 1ULL << (color % u64_bits); }
+  }
+  return result;
+}
+
+// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+__global__ auto d_color_intersect(
+  const u64 *sbwt_idxs,
+  const u64 *key_kmer_marks,
+  const u64 *key_kmer_marks_poppy_layer_0,
+  const u64 *key_kmer_marks_poppy_layer_1_2,
+  const u64 *color_set_idxs,
+  const u32 color_set_idxs_width,
+  const u64 color_set_idxs_width_set_bits,
+  const u64 *is_dense_marks,
+  const u64 *is_dense_marks_poppy_layer_0,
+  const u64 *is_dense_marks_poppy_layer_1_2,
+  const u64 *dense_arrays,
+  const u64 *dense_arrays_intervals,
+  const u32 dense_arrays_intervals_width,
+  const u64 dense_arrays_intervals_width_set_bits,
+  const u64 *sparse_arrays,
+  const u32 sparse_arrays_width,
+  const u64 sparse_arrays_width_set_bits,
+  const u64 *sparse_arrays_intervals,
+  const u32 sparse_arrays_intervals_width,
+  const u64 sparse_arrays_intervals_width_set_bits,
+  const u64 num_colors,
+  const u64 colors_words,
+  u64 *results
+) -> void {
+  const u64 thread_idx = get_idx();
+  const u64 sbwt_idx = sbwt_idxs[thread_idx];
+  const bool found = sbwt_idx != static_cast<u64>(-1);
+  bool is_dense = false;
+  u64 arrays_start = 0;
+  u64 arrays_end = 0;
+  // k-mers which were not found have every color, so that they leave the
+  // intersection as it is
+  u64 min_color = 0;
+  u64 max_color = num_colors;
+  if (found) {
+    const u64 color_set_idxs_idx = d_rank(
+      key_kmer_marks,
+      key_kmer_marks_poppy_layer_0,
+      key_kmer_marks_poppy_layer_1_2,
+      sbwt_idx
+    );
+    const u64 color_set_idx = d_variable_length_int_index(
+      color_set_idxs,
+      color_set_idxs_width,
+      color_set_idxs_width_set_bits,
+      color_set_idxs_idx
+    );
+    is_dense = d_get_bool_from_bit_vector(is_dense_marks, color_set_idx);
+    if (is_dense) {
+      d_dense_get_arrays_start_end(
+        color_set_idx,
+        is_dense_marks,
+        is_dense_marks_poppy_layer_0,
+        is_dense_marks_poppy_layer_1_2,
+        dense_arrays_intervals,
+        dense_arrays_intervals_width,
+        dense_arrays_intervals_width_set_bits,
+        arrays_start,
+        arrays_end
+      );
+      min_color = d_dense_get_min(arrays_start, dense_arrays);
+      max_color = arrays_end - arrays_start;
+    } else {
+      d_sparse_get_arrays_start_end(
+        color_set_idx,
+        is_dense_marks,
+        is_dense_marks_poppy_layer_0,
+        is_dense_marks_poppy_layer_1_2,
+        sparse_arrays_intervals,
+        sparse_arrays_intervals_width,
+        sparse_arrays_intervals_width_set_bits,
+        arrays_start,
+        arrays_end
+      );
+      min_color = d_sparse_get_min(
+        arrays_start,
+        sparse_arrays,
+        sparse_arrays_width,
+        sparse_arrays_width_set_bits
+      );
+      const u64 last_color = d_variable_length_int_index(
+        sparse_arrays,
+        sparse_arrays_width,
+        sparse_arrays_width_set_bits,
+        arrays_end - 1
+      );
+      max_color = last_color + 1;
+    }
+  }
+  min_color = d_warp_max(min_color);
+  max_color = d_warp_min(max_color);
+  u64 *warp_results
+    = results + thread_idx / gpu_warp_size * (colors_words + 1);
+  const u64 found_kmers = d_warp_count(found);
+  // such as the padding after the last seq, which must not be written to
+  if (found_kmers == 0) { return; }
+  const bool is_first_lane = thread_idx % gpu_warp_size == 0;
+  if (is_first_lane) { warp_results[colors_words] = found_kmers; }
+  // the words outside this range were set to 0 before the kernel
+  u64 array_idx = arrays_start;
+  const u64 end_word = (max_color + u64_bits - 1) / u64_bits;
+  for (u64 word_idx = min_color / u64_bits;
+       min_color < max_color && word_idx < end_word;
+       ++word_idx) {
+    u64 colors = static_cast<u64>(-1);
+    if (found && is_dense) {
+      colors = d_dense_get_colors_word(
+        arrays_start, arrays_end, word_idx, dense_arrays
+      );
+    } else if (found) {
+      colors = d_sparse_get_colors_word(
+        array_idx,
+        arrays_end,
+        word_idx,
+        sparse_arrays,
+        sparse_arrays_width,
+        sparse_arrays_width_set_bits
+      );
+    }
+    colors = d_warp_and(colors);
+    if (is_first_lane) { warp_results[word_idx] = colors; }
+  }
+}
+
+// Each index handles a single color from a single sequence, and stops at the
+// first warp which does not have its color
+__global__ auto d_post_process_intersection(
+  const u64 *warp_results,
+  const u64 *warps_before_new_read,
+  const u64 num_seqs,
+  const u64 num_colors,
+  const u64 colors_words,
+  u64 *results
+) -> void {
+  const u64 tidx = get_idx();
+  if (tidx >= num_seqs * num_colors) { return; }
+  const u64 color_idx = tidx % num_colors;
+  const u64 seq_idx = tidx / num_colors;
+  u64 found_kmers = 0;
+  for (u64 warp_idx = warps_before_new_read[seq_idx];
+       warp_idx < warps_before_new_read[seq_idx + 1];
+       ++warp_idx) {
+    const u64 *warp = warp_results + warp_idx * (colors_words + 1);
+    // warps without any k-mers found leave the intersection as it is
+    if (warp[colors_words] == 0) { continue; }
+    if (!d_get_bool_from_bit_vector(warp, color_idx)) {
+      results[tidx] = 0;
+      return;
+    }
+    found_kmers += warp[colors_words];
+  }
+  results[tidx] = found_kmers;
+}
+// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+}  // namespace sbwt_search
+
+#endif
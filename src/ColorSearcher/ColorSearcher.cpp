@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <limits>
 
 #include "ColorSearcher/ColorSearcher.h"
@@ -10,30 +11,74 @@ namespace sbwt_search {
 
 using fmt::format;
 using log_utils::Logger;
+using math_utils::divide_and_ceil;
 using math_utils::round_up;
 using std::numeric_limits;
 
+namespace {
+
+auto get_results_size(u64 num_colors, u64 top_colors, u64 num_seqs) -> u64 {
+  return ColorSearcher::get_results_per_seq(num_colors, top_colors) * num_seqs
+    + ColorSearcher::get_results_per_batch(num_colors, top_colors);
+}
+
+}  // namespace
+
 ColorSearcher::ColorSearcher(
   u64 stream_id_,
   shared_ptr<GpuColorIndexContainer> container_,
   u64 max_indexes_per_batch,
-  u64 max_seqs_per_batch
+  u64 max_seqs_per_batch,
+  bool intersect_,
+  u64 top_colors_
 ):
     container(std::move(container_)),
     d_sbwt_index_idxs(std::max(
       max_indexes_per_batch,
-      max_seqs_per_batch * container->num_colors + max_seqs_per_batch + 1
+      get_results_size(
+        container->num_colors, top_colors_, max_seqs_per_batch
+      ) + max_seqs_per_batch + 1
     )),
     d_fat_results(
-      max_indexes_per_batch / gpu_warp_size * container->num_colors, gpu_stream
+      max_indexes_per_batch / gpu_warp_size
+        * (get_bits_per_warp(container->num_colors) / bits_in_byte),
+      gpu_stream
+    ),
+    d_results(
+      d_sbwt_index_idxs,
+      0,
+      get_results_size(container->num_colors, top_colors_, max_seqs_per_batch)
     ),
-    d_results(d_sbwt_index_idxs, 0, max_seqs_per_batch * container->num_colors),
     d_warps_intervals(
       d_sbwt_index_idxs,
-      max_seqs_per_batch * container->num_colors,
+      get_results_size(container->num_colors, top_colors_, max_seqs_per_batch),
       max_seqs_per_batch + 1
     ),
-    stream_id(stream_id_) {}
+    stream_id(stream_id_),
+    intersect(intersect_),
+    top_colors(top_colors_) {}
+
+auto ColorSearcher::get_bits_per_warp(u64 num_colors) -> u64 {
+  const u64 bits_required_per_color_count = 8;
+  // the intersected colors and the number of k-mers found
+  const u64 intersection_bits
+    = (divide_and_ceil<u64>(num_colors, u64_bits) + 1) * u64_bits;
+  return std::max(
+    bits_required_per_color_count * num_colors, intersection_bits
+  );
+}
+
+auto ColorSearcher::get_results_per_seq(u64 num_colors, u64 top_colors)
+  -> u64 {
+  // a color and its count for each of the top colors
+  return top_colors == 0 ? num_colors : 2 * top_colors;
+}
+
+auto ColorSearcher::get_results_per_batch(u64 num_colors, u64 top_colors)
+  -> u64 {
+  // the counts of the first and last seqs
+  return top_colors == 0 ? 0 : 2 * num_colors;
+}
 
 auto ColorSearcher::search(
   const PinnedVector<u64> &sbwt_index_idxs,
@@ -48,7 +93,9 @@ auto ColorSearcher::search(
   if (!sbwt_index_idxs.empty()) {
     searcher_copy_to_gpu(batch_id, sbwt_index_idxs);
     launch_search_kernel(sbwt_index_idxs.size(), batch_id);
-    results.resize((warps_intervals.size() - 1) * container->num_colors);
+    results.resize(get_results_size(
+      container->num_colors, top_colors, warps_intervals.size() - 1
+    ));
     combine_copy_to_gpu(batch_id, warps_intervals);
     launch_combine_kernel(
       warps_intervals.size() - 1, container->num_colors, batch_id
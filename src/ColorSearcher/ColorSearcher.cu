@@ -1,6 +1,8 @@
+#include "ColorSearcher/ColorIntersector.cuh"
 #include "ColorSearcher/ColorPostProcessor.cuh"
 #include "ColorSearcher/ColorSearcher.cuh"
 #include "ColorSearcher/ColorSearcher.h"
+#include "ColorSearcher/TopColorsSelector.h"
 #include "Tools/BitDefinitions.h"
 #include "Tools/GpuUtils.h"
 #include "Tools/Logger.h"
@@ -24,6 +26,34 @@ auto ColorSearcher::launch_search_kernel(u64 num_queries, u64 batch_id)
   );
   u64 blocks_per_grid = divide_and_ceil<u64>(num_queries, threads_per_block);
   start_timer.record(&gpu_stream);
+  if (intersect) {
+    launch_intersect_kernel(num_queries, blocks_per_grid);
+  } else {
+    launch_count_kernel(num_queries, blocks_per_grid);
+  }
+  end_timer.record(&gpu_stream);
+  GPU_CHECK(hipPeekAtLastError());
+  GPU_CHECK(hipStreamSynchronize(*static_cast<hipStream_t *>(gpu_stream.data()))
+  );
+  float millis = start_timer.time_elapsed_ms(end_timer);
+  Logger::log(
+    Logger::LOG_LEVEL::DEBUG,
+    format(
+      "Batch {} from stream {} took {} ms to search in the GPU",
+      batch_id,
+      stream_id,
+      millis
+    )
+  );
+  Logger::log_timed_event(
+    format("SearcherSearch_{}", stream_id),
+    Logger::EVENT_STATE::STOP,
+    format("batch {}", batch_id)
+  );
+}
+
+auto ColorSearcher::launch_count_kernel(u64 num_queries, u64 blocks_per_grid)
+  -> void {
   d_fat_results.memset_async(
     0, num_queries / gpu_warp_size * container->num_colors, 0, gpu_stream
   );
@@ -56,24 +86,48 @@ auto ColorSearcher::launch_search_kernel(u64 num_queries, u64 batch_id)
     container->num_colors,
     d_fat_results.data()
   );
-  end_timer.record(&gpu_stream);
-  GPU_CHECK(hipPeekAtLastError());
-  GPU_CHECK(hipStreamSynchronize(*static_cast<hipStream_t *>(gpu_stream.data()))
-  );
-  float millis = start_timer.time_elapsed_ms(end_timer);
-  Logger::log(
-    Logger::LOG_LEVEL::DEBUG,
-    format(
-      "Batch {} from stream {} took {} ms to search in the GPU",
-      batch_id,
-      stream_id,
-      millis
-    )
+}
+
+auto ColorSearcher::launch_intersect_kernel(
+  u64 num_queries, u64 blocks_per_grid
+) -> void {
+  const u64 colors_words
+    = divide_and_ceil<u64>(container->num_colors, u64_bits);
+  d_fat_results.memset_async(
+    0,
+    num_queries / gpu_warp_size * (colors_words + 1) * sizeof(u64),
+    0,
+    gpu_stream
   );
-  Logger::log_timed_event(
-    format("SearcherSearch_{}", stream_id),
-    Logger::EVENT_STATE::STOP,
-    format("batch {}", batch_id)
+  hipLaunchKernelGGL(
+    d_color_intersect,
+    blocks_per_grid,
+    threads_per_block,
+    0,
+    *static_cast<hipStream_t *>(gpu_stream.data()),
+    d_sbwt_index_idxs.data(),
+    container->key_kmer_marks.data(),
+    container->key_kmer_marks_poppy_layer_0.data(),
+    container->key_kmer_marks_poppy_layer_1_2.data(),
+    container->color_set_idxs.data(),
+    container->color_set_idxs_width,
+    set_bits.at(container->color_set_idxs_width),
+    container->is_dense_marks.data(),
+    container->is_dense_marks_poppy_layer_0.data(),
+    container->is_dense_marks_poppy_layer_1_2.data(),
+    container->dense_arrays.data(),
+    container->dense_arrays_intervals.data(),
+    container->dense_arrays_intervals_width,
+    set_bits.at(container->dense_arrays_intervals_width),
+    container->sparse_arrays.data(),
+    container->sparse_arrays_width,
+    set_bits.at(container->sparse_arrays_width),
+    container->sparse_arrays_intervals.data(),
+    container->sparse_arrays_intervals_width,
+    set_bits.at(container->sparse_arrays_intervals_width),
+    container->num_colors,
+    colors_words,
+    reinterpret_cast<u64 *>(d_fat_results.data())
   );
 }
 
@@ -88,18 +142,44 @@ auto ColorSearcher::launch_combine_kernel(
   u64 blocks_per_grid
     = divide_and_ceil<u64>(num_warps * num_colors, threads_per_block);
   start_timer.record(&gpu_stream);
-  hipLaunchKernelGGL(
-    d_post_process,
-    blocks_per_grid,
-    threads_per_block,
-    0,
-    *static_cast<hipStream_t *>(gpu_stream.data()),
-    d_fat_results.data(),
-    d_warps_intervals.data(),
-    num_warps,
-    num_colors,
-    d_results.data()
-  );
+  if (top_colors > 0) {
+    launch_select_top_colors(
+      d_fat_results.data(),
+      d_warps_intervals.data(),
+      num_warps,
+      num_colors,
+      top_colors,
+      d_results.data(),
+      gpu_stream
+    );
+  } else if (intersect) {
+    hipLaunchKernelGGL(
+      d_post_process_intersection,
+      blocks_per_grid,
+      threads_per_block,
+      0,
+      *static_cast<hipStream_t *>(gpu_stream.data()),
+      reinterpret_cast<u64 *>(d_fat_results.data()),
+      d_warps_intervals.data(),
+      num_warps,
+      num_colors,
+      divide_and_ceil<u64>(num_colors, u64_bits),
+      d_results.data()
+    );
+  } else {
+    hipLaunchKernelGGL(
+      d_post_process,
+      blocks_per_grid,
+      threads_per_block,
+      0,
+      *static_cast<hipStream_t *>(gpu_stream.data()),
+      d_fat_results.data(),
+      d_warps_intervals.data(),
+      num_warps,
+      num_colors,
+      d_results.data()
+    );
+  }
   end_timer.record(&gpu_stream);
   GPU_CHECK(hipPeekAtLastError());
   GPU_CHECK(hipStreamSynchronize(*static_cast<hipStream_t *>(gpu_stream.data()))
@@ -31,15 +31,31 @@ private:
   GpuPointer<u64> d_warps_intervals;
   GpuEvent start_timer{}, end_timer{};
   u64 stream_id;
+  bool intersect;
+  u64 top_colors;
 
 public:
+  // If intersect is true, the colors of each seq are intersected rather than
+  // counted, which gives the same results when the threshold is 1. If
+  // top_colors is not 0, only the top_colors largest counts of each seq are
+  // given, as described in ColorsBatch, and intersect must be false.
   ColorSearcher(
     u64 stream_id_,
     shared_ptr<GpuColorIndexContainer> container,
     u64 max_indexes_per_batch,
-    u64 max_seqs_per_batch
+    u64 max_seqs_per_batch,
+    bool intersect_ = false,
+    u64 top_colors_ = 0
   );
 
+  // The space each warp takes for either its color counts or its
+  // intersection, whichever is larger
+  static auto get_bits_per_warp(u64 num_colors) -> u64;
+
+  // The number of results given for each seq, plus those given once per batch
+  static auto get_results_per_seq(u64 num_colors, u64 top_colors) -> u64;
+  static auto get_results_per_batch(u64 num_colors, u64 top_colors) -> u64;
+
   auto search(
     const PinnedVector<u64> &sbwt_index_idxs,
     const PinnedVector<u64> &warps_intervals,
@@ -47,11 +63,13 @@ public:
     u64 batch_id
   ) -> void;
 
-private:
+protected:
   auto
   searcher_copy_to_gpu(u64 batch_id, const PinnedVector<u64> &sbwt_index_ids)
     -> void;
   auto launch_search_kernel(u64 num_queries, u64 batch_id) -> void;
+  auto launch_count_kernel(u64 num_queries, u64 blocks_per_grid) -> void;
+  auto launch_intersect_kernel(u64 num_queries, u64 blocks_per_grid) -> void;
 
   auto
   combine_copy_to_gpu(u64 batch_id, const PinnedVector<u64> &warps_intervals)
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "ColorIndexContainer/ColorIndexContainerBenchmarkUtils.h"
+#include "ColorSearcher/ColorSearcher.h"
+#include "Global/GlobalDefinitions.h"
+#include "Tools/MathUtils.hpp"
+#include "Tools/PinnedVector.h"
+#include "Tools/RNGUtils.hpp"
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+using gpu_utils::PinnedVector;
+using math_utils::round_up;
+using rng_utils::get_uniform_int_generator;
+using std::make_unique;
+using std::unique_ptr;
+
+const u64 color_search_num_nodes = 1ULL << 22;
+const u64 color_search_num_color_sets = 1ULL << 16;
+const u64 color_search_max_warps_per_seq = 8;
+
+// Exposes the individual steps of the searcher so that each kernel can be
+// timed on its own
+class ColorSearcherBenchmark: public ColorSearcher {
+public:
+  using ColorSearcher::ColorSearcher;
+  using ColorSearcher::combine_copy_to_gpu;
+  using ColorSearcher::launch_combine_kernel;
+  using ColorSearcher::launch_search_kernel;
+  using ColorSearcher::searcher_copy_to_gpu;
+};
+
+class ColorSearchBenchmarkData {
+public:
+  shared_ptr<GpuColorIndexContainer> container;
+  unique_ptr<PinnedVector<u64>> sbwt_index_idxs;
+  unique_ptr<PinnedVector<u64>> warps_intervals;
+  unique_ptr<ColorSearcherBenchmark> searcher;
+
+  // One in every 8 indexes is not found. Each sequence spans a random number
+  // of warps.
+  ColorSearchBenchmarkData(u64 num_queries, u64 num_colors, bool intersect) {
+    auto cpu_container = get_synthetic_cpu_color_index(
+      color_search_num_nodes, color_search_num_color_sets, num_colors
+    );
+    container = cpu_container.to_gpu();
+    auto rng = get_uniform_int_generator<u64>(0, color_search_num_nodes - 1);
+    sbwt_index_idxs = make_unique<PinnedVector<u64>>(num_queries);
+    for (u64 i = 0; i < num_queries; ++i) {
+      sbwt_index_idxs->push_back(rng() % 8 == 0 ? -1ULL : rng());
+    }
+    const u64 num_warps = num_queries / gpu_warp_size;
+    warps_intervals = make_unique<PinnedVector<u64>>(num_warps + 1);
+    warps_intervals->push_back(0);
+    for (u64 warps = 0; warps < num_warps;) {
+      warps = std::min(
+        num_warps, warps + rng() % color_search_max_warps_per_seq + 1
+      );
+      warps_intervals->push_back(warps);
+    }
+    searcher = make_unique<ColorSearcherBenchmark>(
+      0,
+      container,
+      round_up<u64>(num_queries, superblock_bits),
+      warps_intervals->size() - 1,
+      intersect
+    );
+  }
+};
+
+auto benchmark_d_color_search(benchmark::State &state) -> void {
+  const u64 num_queries = state.range(0);
+  ColorSearchBenchmarkData data(
+    num_queries, state.range(1), state.range(2) > 0
+  );
+  for (auto _ : state) {
+    // the post processing results share memory with the sbwt indexes on the
+    // gpu, so we copy them again each time
+    state.PauseTiming();
+    data.searcher->searcher_copy_to_gpu(0, *data.sbwt_index_idxs);
+    state.ResumeTiming();
+    data.searcher->launch_search_kernel(num_queries, 0);
+  }
+  state.SetItemsProcessed(
+    static_cast<int64_t>(state.iterations() * num_queries)
+  );
+}
+BENCHMARK(benchmark_d_color_search)
+  ->ArgNames({"queries", "colors", "intersect"})
+  ->ArgsProduct({{1ULL << 16, 1ULL << 20}, {64, 1024}, {0, 1}})
+  ->Unit(benchmark::kMillisecond);
+
+auto benchmark_d_post_process(benchmark::State &state) -> void {
+  const u64 num_queries = state.range(0);
+  const u64 num_colors = state.range(1);
+  ColorSearchBenchmarkData data(num_queries, num_colors, state.range(2) > 0);
+  const u64 num_seqs = data.warps_intervals->size() - 1;
+  data.searcher->searcher_copy_to_gpu(0, *data.sbwt_index_idxs);
+  data.searcher->launch_search_kernel(num_queries, 0);
+  for (auto _ : state) {
+    data.searcher->combine_copy_to_gpu(0, *data.warps_intervals);
+    data.searcher->launch_combine_kernel(num_seqs, num_colors, 0);
+  }
+  state.SetItemsProcessed(
+    static_cast<int64_t>(state.iterations() * num_seqs * num_colors)
+  );
+}
+BENCHMARK(benchmark_d_post_process)
+  ->ArgNames({"queries", "colors", "intersect"})
+  ->ArgsProduct({{1ULL << 16, 1ULL << 20}, {64, 1024}, {0, 1}})
+  ->Unit(benchmark::kMillisecond);
+
+}  // namespace sbwt_search
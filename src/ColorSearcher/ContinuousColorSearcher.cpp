@@ -4,12 +4,14 @@
 #include "ColorSearcher/ContinuousColorSearcher.h"
 #include "Global/GlobalDefinitions.h"
 #include "Tools/Logger.h"
+#include "Tools/Metrics.h"
 #include "fmt/core.h"
 
 namespace sbwt_search {
 
 using fmt::format;
 using log_utils::Logger;
+using log_utils::Metrics;
 using std::make_shared;
 
 ContinuousColorSearcher::ContinuousColorSearcher(
@@ -19,51 +21,66 @@ ContinuousColorSearcher::ContinuousColorSearcher(
   u64 max_indexes_per_batch_,
   u64 max_seqs_per_batch_,
   u64 max_batches,
-  u64 num_colors_
+  u64 num_colors_,
+  bool intersect,
+  u64 top_colors_
 ):
     SharedBatchesProducer<ColorsBatch>(max_batches),
     searcher(
       stream_id_,
       std::move(color_index_container_),
       max_indexes_per_batch_,
-      max_seqs_per_batch_
+      max_seqs_per_batch_,
+      intersect,
+      top_colors_
     ),
     indexes_batch_producer(std::move(indexes_batch_producer_)),
     max_indexes_per_batch(max_indexes_per_batch_),
     max_seqs_per_batch(max_seqs_per_batch_),
     num_colors(num_colors_),
+    top_colors(top_colors_),
     stream_id(stream_id_) {
   initialise_batches();
 }
 
-auto ContinuousColorSearcher::get_bits_per_seq_cpu(u64 num_colors) -> u64 {
+auto ContinuousColorSearcher::get_bits_per_seq_cpu(
+  u64 num_colors, u64 top_colors
+) -> u64 {
   const u64 bits_required_per_result = 64;
-  return num_colors * bits_required_per_result;
+  return ColorSearcher::get_results_per_seq(num_colors, top_colors)
+    * bits_required_per_result;
 }
 
 auto ContinuousColorSearcher::get_bits_per_element_gpu(
-  u64 num_colors, u64 idxs_per_seq
+  u64 num_colors, u64 idxs_per_seq, u64 top_colors
 ) -> double {
   const double bits_required_per_index = 64;
-  const double bits_required_per_color = 64;
+  const double bits_required_per_result = 64;
   const double bits_required_per_warp_interval = 64;
   return std::max(
     // searching part
     bits_required_per_index,
     // post processing part
-    (bits_required_per_color * static_cast<double>(num_colors)
+    (bits_required_per_result
+       * static_cast<double>(
+         ColorSearcher::get_results_per_seq(num_colors, top_colors)
+       )
      + bits_required_per_warp_interval)
       / static_cast<double>(idxs_per_seq)
   );
 }
 
 auto ContinuousColorSearcher::get_bits_per_warp_gpu(u64 num_colors) -> u64 {
-  const u64 bits_required_per_fat_result = 8;
-  return num_colors * bits_required_per_fat_result;
+  return ColorSearcher::get_bits_per_warp(num_colors);
 }
 
 auto ContinuousColorSearcher::get_default_value() -> shared_ptr<ColorsBatch> {
-  return make_shared<ColorsBatch>(max_seqs_per_batch * num_colors);
+  return make_shared<ColorsBatch>(
+    max_seqs_per_batch
+        * ColorSearcher::get_results_per_seq(num_colors, top_colors)
+      + ColorSearcher::get_results_per_batch(num_colors, top_colors),
+    top_colors
+  );
 }
 
 auto ContinuousColorSearcher::continue_read_condition() -> bool {
@@ -77,6 +94,11 @@ auto ContinuousColorSearcher::generate() -> void {
     current_write()->colors,
     get_batch_id()
   );
+  Metrics::add(
+    format("Searcher_{}", stream_id),
+    "kmers_total",
+    static_cast<double>(indexes_batch->warped_indexes.size())
+  );
 }
 
 auto ContinuousColorSearcher::do_at_batch_start() -> void {
@@ -30,6 +30,7 @@ private:
   u64 max_indexes_per_batch;
   u64 max_seqs_per_batch;
   u64 num_colors;
+  u64 top_colors;
   u64 stream_id;
 
 public:
@@ -40,14 +41,17 @@ public:
     u64 max_indexes_per_batch_,
     u64 max_seqs_per_batch_,
     u64 max_batches,
-    u64 num_colors_
+    u64 num_colors_,
+    bool intersect = false,
+    u64 top_colors_ = 0
   );
 
-  auto static get_bits_per_seq_cpu(u64 num_colors) -> u64;
+  auto static get_bits_per_seq_cpu(u64 num_colors, u64 top_colors = 0) -> u64;
   auto static get_bits_per_warp_gpu(u64 num_colors) -> u64;
 
-  auto static get_bits_per_element_gpu(u64 num_colors, u64 idxs_per_seq)
-    -> double;
+  auto static get_bits_per_element_gpu(
+    u64 num_colors, u64 idxs_per_seq, u64 top_colors = 0
+  ) -> double;
 
 private:
   auto get_default_value() -> shared_ptr<ColorsBatch> override;
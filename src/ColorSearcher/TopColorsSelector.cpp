@@ -0,0 +1,31 @@
+#include "ColorSearcher/TopColorsSelector.h"
+
+namespace sbwt_search {
+
+// Keeps the pairs sorted while the colors are added one at a time, in the
+// same way as d_select_top_colors
+auto select_top_colors(
+  const u64 *counts, u64 num_colors, u64 top_colors, u64 *pairs
+) -> void {
+  u64 size = 0;
+  for (u64 color_idx = 0; color_idx < num_colors; ++color_idx) {
+    const u64 count = counts[color_idx];
+    // ties keep the smaller color, since it was added first
+    if (count == 0 || (size == top_colors && count <= pairs[2 * size - 1])) {
+      continue;
+    }
+    u64 position = size < top_colors ? size++ : size - 1;
+    for (; position > 0 && pairs[2 * position - 1] < count; --position) {
+      pairs[2 * position] = pairs[2 * position - 2];
+      pairs[2 * position + 1] = pairs[2 * position - 1];
+    }
+    pairs[2 * position] = color_idx;
+    pairs[2 * position + 1] = count;
+  }
+  for (u64 i = size; i < top_colors; ++i) {
+    pairs[2 * i] = 0;
+    pairs[2 * i + 1] = 0;
+  }
+}
+
+}  // namespace sbwt_search
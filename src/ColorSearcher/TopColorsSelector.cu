@@ -0,0 +1,35 @@
+#include "ColorSearcher/TopColorsSelector.cuh"
+#include "ColorSearcher/TopColorsSelector.h"
+#include "Global/GlobalDefinitions.h"
+#include "Tools/MathUtils.hpp"
+#include "hip/hip_runtime.h"
+
+namespace sbwt_search {
+
+using math_utils::divide_and_ceil;
+
+auto launch_select_top_colors(
+  const u8 *fat_results,
+  const u64 *warps_before_new_read,
+  u64 num_seqs,
+  u64 num_colors,
+  u64 top_colors,
+  u64 *results,
+  GpuStream &gpu_stream
+) -> void {
+  hipLaunchKernelGGL(
+    d_select_top_colors,
+    divide_and_ceil<u64>(num_seqs, threads_per_block),
+    threads_per_block,
+    0,
+    *static_cast<hipStream_t *>(gpu_stream.data()),
+    fat_results,
+    warps_before_new_read,
+    num_seqs,
+    num_colors,
+    top_colors,
+    results
+  );
+}
+
+}  // namespace sbwt_search
@@ -0,0 +1,74 @@
+#ifndef TOP_COLORS_SELECTOR_CUH
+#define TOP_COLORS_SELECTOR_CUH
+
+/**
+ * @file TopColorsSelector.cuh
+ * @brief Used instead of the post processing when only the top colors of each
+ * sequence are needed. Each index handles a whole sequence, adding the color
+ * sets of its warps together one color at a time and keeping only the
+ * top_colors largest counts in a sorted list, so that the counts of every
+ * color are never stored. The first and last sequences also have all their
+ * counts stored, since these may still be added to those of the previous or
+ * next batch.
+ */
+
+#include "Global/GlobalDefinitions.h"
+#include "Tools/KernelUtils.cuh"
+#include "Tools/TypeDefinitions.h"
+#include "hip/hip_runtime.h"
+
+namespace sbwt_search {
+
+using gpu_utils::get_idx;
+
+// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+__global__ auto d_select_top_colors(
+  const u8 *fat_results,
+  const u64 *warps_before_new_read,
+  const u64 num_seqs,
+  const u64 num_colors,
+  const u64 top_colors,
+  u64 *results
+) -> void {
+  const u64 seq_idx = get_idx();
+  if (seq_idx >= num_seqs) { return; }
+  u64 top_counts[max_top_colors];
+  u64 top_color_idxs[max_top_colors];
+  u64 size = 0;
+  u64 *first_results = seq_idx == 0 ? results : nullptr;
+  u64 *last_results = seq_idx == num_seqs - 1 ? results + num_colors : nullptr;
+  const u64 fat_results_start_idx
+    = warps_before_new_read[seq_idx] * num_colors;
+  const u64 fat_results_stop_idx
+    = warps_before_new_read[seq_idx + 1] * num_colors;
+  for (u64 color_idx = 0; color_idx < num_colors; ++color_idx) {
+    u64 total = 0;
+    for (u64 i = fat_results_start_idx + color_idx; i < fat_results_stop_idx;
+         i += num_colors) {
+      total += fat_results[i];
+    }
+    if (first_results != nullptr) { first_results[color_idx] = total; }
+    if (last_results != nullptr) { last_results[color_idx] = total; }
+    // ties keep the smaller color, since it was added first
+    if (total == 0 || (size == top_colors && total <= top_counts[size - 1])) {
+      continue;
+    }
+    u64 position = size < top_colors ? size++ : size - 1;
+    for (; position > 0 && top_counts[position - 1] < total; --position) {
+      top_counts[position] = top_counts[position - 1];
+      top_color_idxs[position] = top_color_idxs[position - 1];
+    }
+    top_counts[position] = total;
+    top_color_idxs[position] = color_idx;
+  }
+  u64 *pairs = results + 2 * num_colors + seq_idx * 2 * top_colors;
+  for (u64 i = 0; i < top_colors; ++i) {
+    pairs[2 * i] = i < size ? top_color_idxs[i] : 0;
+    pairs[2 * i + 1] = i < size ? top_counts[i] : 0;
+  }
+}
+// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+}  // namespace sbwt_search
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef TOP_COLORS_SELECTOR_H
+#define TOP_COLORS_SELECTOR_H
+
+/**
+ * @file TopColorsSelector.h
+ * @brief Picks the top_colors largest counts of a seq as (color, count)
+ * pairs, ordered from the largest count to the smallest, where ties go to the
+ * smaller color and the unused pairs are left as 0s. The gpu picks them for
+ * every seq of a batch, while the cpu picks them again for a seq which
+ * continues from the previous batch once its counts have been added to, so
+ * that both have to pick the same colors.
+ */
+
+#include "Tools/GpuStream.h"
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+using gpu_utils::GpuStream;
+
+// Picks the pairs from the counts of each of the num_colors colors
+auto select_top_colors(
+  const u64 *counts, u64 num_colors, u64 top_colors, u64 *pairs
+) -> void;
+
+// Launches the kernel which sums the fat results of the warps of each seq and
+// picks their pairs, as described in ColorsBatch
+auto launch_select_top_colors(
+  const u8 *fat_results,
+  const u64 *warps_before_new_read,
+  u64 num_seqs,
+  u64 num_colors,
+  u64 top_colors,
+  u64 *results,
+  GpuStream &gpu_stream
+) -> void;
+
+}  // namespace sbwt_search
+
+#endif
@@ -0,0 +1,97 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ColorSearcher/TopColorsSelector.h"
+#include "Tools/GpuPointer.h"
+#include "Tools/RNGUtils.hpp"
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+using gpu_utils::GpuPointer;
+using rng_utils::get_uniform_int_generator;
+using std::vector;
+
+namespace {
+
+auto get_pairs(const vector<u64> &counts, u64 top_colors) -> vector<u64> {
+  vector<u64> pairs(2 * top_colors, 1);
+  select_top_colors(counts.data(), counts.size(), top_colors, pairs.data());
+  return pairs;
+}
+
+}  // namespace
+
+TEST(TopColorsSelectorTest, TiesGoToSmallerColor) {
+  const vector<u64> counts = {3, 0, 5, 3, 5, 1, 3};
+  ASSERT_EQ(get_pairs(counts, 3), vector<u64>({2, 5, 4, 5, 0, 3}));
+  ASSERT_EQ(get_pairs(counts, 1), vector<u64>({2, 5}));
+  // the last color with a tied count is the one left out
+  ASSERT_EQ(get_pairs(counts, 4), vector<u64>({2, 5, 4, 5, 0, 3, 3, 3}));
+}
+
+TEST(TopColorsSelectorTest, ZeroCountsAreUnused) {
+  ASSERT_EQ(get_pairs({0, 2, 0}, 3), vector<u64>({1, 2, 0, 0, 0, 0}));
+  ASSERT_EQ(get_pairs({0, 0, 0}, 2), vector<u64>({0, 0, 0, 0}));
+  // more top colors than there are colors
+  ASSERT_EQ(get_pairs({1, 2}, 4), vector<u64>({1, 2, 0, 1, 0, 0, 0, 0}));
+}
+
+TEST(TopColorsSelectorTest, GpuAgreesWithCpu) {
+  const u64 num_colors = 50;
+  const u64 top_colors = 8;
+  const u64 num_seqs = 300;
+  // small counts, so that there are many ties and zeros
+  auto count_rng = get_uniform_int_generator<u64>(0, 3);
+  auto warps_rng = get_uniform_int_generator<u64>(0, 4);
+  vector<u64> warps_before_new_read = {0};
+  for (u64 i = 0; i < num_seqs; ++i) {
+    warps_before_new_read.push_back(warps_before_new_read.back() + warps_rng());
+  }
+  vector<u8> fat_results(warps_before_new_read.back() * num_colors);
+  for (auto &result : fat_results) { result = static_cast<u8>(count_rng()); }
+  GpuPointer<u8> d_fat_results(fat_results);
+  GpuPointer<u64> d_warps_before_new_read(warps_before_new_read);
+  GpuPointer<u64> d_results(2 * num_colors + num_seqs * 2 * top_colors);
+  GpuStream gpu_stream;
+  launch_select_top_colors(
+    d_fat_results.data(),
+    d_warps_before_new_read.data(),
+    num_seqs,
+    num_colors,
+    top_colors,
+    d_results.data(),
+    gpu_stream
+  );
+  vector<u64> results;
+  d_results.copy_to_async(results, gpu_stream);
+  vector<vector<u64>> counts(num_seqs, vector<u64>(num_colors, 0));
+  for (u64 seq_idx = 0; seq_idx < num_seqs; ++seq_idx) {
+    for (u64 warp = warps_before_new_read[seq_idx];
+         warp < warps_before_new_read[seq_idx + 1];
+         ++warp) {
+      for (u64 color_idx = 0; color_idx < num_colors; ++color_idx) {
+        counts[seq_idx][color_idx]
+          += fat_results[warp * num_colors + color_idx];
+      }
+    }
+    const auto *pairs
+      = results.data() + 2 * num_colors + seq_idx * 2 * top_colors;
+    ASSERT_EQ(
+      vector<u64>(pairs, pairs + 2 * top_colors),
+      get_pairs(counts[seq_idx], top_colors)
+    ) << "Unequal at seq "  // LCOV_EXCL_LINE
+      << seq_idx;
+  }
+  // the first and last seqs also have the counts of every color
+  ASSERT_EQ(
+    vector<u64>(results.data(), results.data() + num_colors), counts.front()
+  );
+  ASSERT_EQ(
+    vector<u64>(results.data() + num_colors, results.data() + 2 * num_colors),
+    counts.back()
+  );
+}
+
+}  // namespace sbwt_search
@@ -1,5 +1,6 @@
 #include <fstream>
 #include <ios>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -7,10 +8,12 @@
 #include "Tools/IOUtils.h"
 #include "Tools/TypeDefinitions.h"
 
+using io_utils::is_standard_stream;
 using io_utils::ThrowingIfstream;
 using std::getline;
 using std::ifstream;
 using std::ios;
+using std::runtime_error;
 using std::string;
 using std::vector;
 
@@ -41,7 +44,17 @@ auto FilenamesParser::file_lines_to_vector(const string &filename)
   vector<string> result;
   ThrowingIfstream stream(filename, ios::in);
   string buffer;
-  while (getline(stream, buffer)) { result.push_back(buffer); }
+  while (getline(stream, buffer)) {
+    // standard input can only be read once, and the streams would interleave
+    // their results if they shared standard output
+    if (is_standard_stream(buffer)) {
+      throw runtime_error(
+        "The list file " + filename
+        + " can not contain standard input or output, pass '-' directly instead"
+      );
+    }
+    result.push_back(buffer);
+  }
   return result;
 }
 
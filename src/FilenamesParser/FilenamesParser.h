@@ -5,7 +5,8 @@
  * @file FilenamesParser.h
  * @brief Takes the input and output user input and outputs if the files are a
  * direct input or if they are a series of files. They are considered a series
- * of files if the extension of the file is '.list'
+ * of files if the extension of the file is '.list'. A filename of '-', for
+ * standard input or output, must be given directly rather than in a list.
  */
 
 #include <string>
@@ -1,9 +1,17 @@
+#include <filesystem>
+#include <stdexcept>
+
 #include <gtest/gtest.h>
 
 #include "FilenamesParser/FilenamesParser.h"
+#include "Tools/IOUtils.h"
 
 namespace sbwt_search {
 
+using io_utils::ThrowingOfstream;
+using std::ios;
+using std::runtime_error;
+
 TEST(FilenamesParserTest, TestTxt) {
   auto host = FilenamesParser(
     "test_objects/filenames.list", "test_objects/filenames.list"
@@ -22,4 +30,17 @@ TEST(FilenamesParserTest, TestNotTxt) {
   EXPECT_EQ(host.get_output_filenames(), expected_output_files);
 }
 
+TEST(FilenamesParserTest, StandardStreams) {
+  auto host = FilenamesParser("-", "-");
+  EXPECT_EQ(host.get_input_filenames(), vector<string>{"-"});
+  EXPECT_EQ(host.get_output_filenames(), vector<string>{"-"});
+  const string list_filename = "test_objects/tmp/FilenamesParserTest.list";
+  {
+    ThrowingOfstream list_stream(list_filename, ios::out);
+    list_stream << "filename 1\n-\n";
+  }
+  EXPECT_THROW(FilenamesParser(list_filename, list_filename), runtime_error);
+  std::filesystem::remove(list_filename);
+}
+
 }  // namespace sbwt_search
@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <filesystem>
 #include <stdexcept>
+#include <system_error>
 #include <utility>
 
 #include "FilesizeLoadBalancer/FilesizeLoadBalancer.h"
@@ -41,12 +42,21 @@ auto FilesizeLoadBalancer::partition(u64 partitions)
 
 auto FilesizeLoadBalancer::populate_size_to_files() -> void {
   for (u64 i = 0; i < in_files.size(); ++i) {
-    size_to_files[file_size(in_files[i])].emplace_back(
+    size_to_files[get_file_size(in_files[i])].emplace_back(
       std::make_pair(in_files[i], out_files[i])
     );
   }
 }
 
+auto FilesizeLoadBalancer::get_file_size(const string &filename) -> u64 {
+  std::error_code error;
+  const u64 size = file_size(filename, error);
+  // Files which can not be sized, such as standard input or other pipes, are
+  // counted as empty. Missing files are also left to the file parsers, which
+  // report them and carry on with the rest.
+  return error ? 0 : size;
+}
+
 auto FilesizeLoadBalancer::get_smallest_partition_index(
   vector<u64> &partition_sizes
 ) -> u64 {
@@ -14,6 +14,7 @@
  * can be found here:
  * https://en.wikipedia.org/wiki/Longest-processing-time-first_scheduling. Other
  * methods were attempted but they were too slow, especially as N increases.
+ * Inputs whose size can not be found, such as standard input, count as empty.
  */
 
 #include <map>
@@ -44,6 +45,7 @@ public:
 
 private:
   auto populate_size_to_files() -> void;
+  static auto get_file_size(const string &filename) -> u64;
   auto get_smallest_partition_index(vector<u64> &partition_sizes) -> u64;
 };
 
@@ -46,6 +46,18 @@ TEST_F(FilesizeLoadBalancerTest, ThreePartitions) {
   run_test(3, in_files, out_files);
 }
 
+TEST(FilesizeLoadBalancerTestIndividual, StandardInput) {
+  const vector<string> in_files = {"-", "test_objects/small_fasta.fna"};
+  const vector<string> out_files = {"-", "250"};
+  auto [actual_in_files, actual_out_files]
+    = FilesizeLoadBalancer(in_files, out_files).partition(2);
+  const vector<vector<string>> expected_in_files
+    = {{"test_objects/small_fasta.fna"}, {"-"}};
+  const vector<vector<string>> expected_out_files = {{"250"}, {"-"}};
+  EXPECT_EQ(actual_in_files, expected_in_files);
+  EXPECT_EQ(actual_out_files, expected_out_files);
+}
+
 /* TEST(FilesizeLoadBalancerTestIndividual, InvalidFile) {} */
 
 }  // namespace sbwt_search
@@ -0,0 +1,162 @@
+#include <bit>
+#include <ios>
+#include <stdexcept>
+
+#include "IndexFileParser/BlockedBinaryIndexFileParser.h"
+#include "fmt/core.h"
+
+namespace sbwt_search {
+
+using fmt::format;
+using std::bit_cast;
+using std::ios;
+using std::runtime_error;
+
+BlockedBinaryIndexFileParser::BlockedBinaryIndexFileParser(
+  shared_ptr<ThrowingIfstream> in_stream_,
+  u64 max_indexes_,
+  u64 max_seqs_,
+  u64 warp_size_
+):
+    IndexFileParser(std::move(in_stream_), max_indexes_, max_seqs_, warp_size_),
+    block_header(block_header_elements) {
+  assert_version();
+}
+
+auto BlockedBinaryIndexFileParser::assert_version() -> void {
+  auto version = get_istream().read_string_with_size();
+  if (version != "v1.0") {
+    throw runtime_error("The file has an incompatible version number");
+  }
+}
+
+auto BlockedBinaryIndexFileParser::generate_batch(
+  shared_ptr<SeqStatisticsBatch> seq_statistics_batch_,
+  shared_ptr<IndexesBatch> indexes_batch_
+) -> bool {
+  IndexFileParser::generate_batch(
+    std::move(seq_statistics_batch_), std::move(indexes_batch_)
+  );
+  const u64 initial_size = get_indexes_batch()->warped_indexes.size()
+    + get_seq_statistics_batch()->colored_seq_id.size();
+  while (get_indexes().size() < get_max_indexes()
+         && get_num_seqs() < get_max_seqs()) {
+    if (payload_index == payload_size) {
+      if (!load_block()) { break; }
+      if (block_fits_in_batch()) {
+        for (; payload_index < payload_size; ++payload_index) {
+          parse_value(payload[payload_index]);
+        }
+        continue;
+      }
+    }
+    parse_value(payload[payload_index++]);
+  }
+  add_warp_interval();
+  return (get_indexes_batch()->warped_indexes.size()
+          + get_seq_statistics_batch()->colored_seq_id.size())
+    > initial_size;
+}
+
+auto BlockedBinaryIndexFileParser::load_block() -> bool {
+  if (reached_footer) { return false; }
+  auto &in_stream = get_istream();
+  in_stream.read(bit_cast<char *>(block_header.data()), sizeof(u64));
+  if (in_stream.gcount() == 0) {
+    throw runtime_error("The blocked binary file ended before its footer");
+  }
+  if (block_header[block_payload_bytes] == blocked_footer_marker) {
+    reached_footer = true;
+    return false;
+  }
+  const u64 rest_of_header = (block_header_elements - 1) * sizeof(u64);
+  in_stream.read(
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    bit_cast<char *>(block_header.data() + 1),
+    static_cast<std::streamsize>(rest_of_header)
+  );
+  if (static_cast<u64>(in_stream.gcount()) != rest_of_header) {
+    throw runtime_error(
+      "The blocked binary file ended in the middle of a block"
+    );
+  }
+  const u64 payload_bytes = block_header[block_payload_bytes];
+  payload_size = payload_bytes / sizeof(u64);
+  if (payload.size() < payload_size) { payload.resize(payload_size); }
+  in_stream.read(
+    bit_cast<char *>(payload.data()),
+    static_cast<std::streamsize>(payload_bytes)
+  );
+  if (static_cast<u64>(in_stream.gcount()) != payload_bytes) {
+    throw runtime_error(
+      "The blocked binary file ended in the middle of a block"
+    );
+  }
+  payload_index = 0;
+  return true;
+}
+
+// Every seq which ends may need up to a warp of padding, so if the block fits
+// even then, the limits can not be reached while it is being parsed
+auto BlockedBinaryIndexFileParser::block_fits_in_batch() -> bool {
+  const u64 max_new_indexes = block_header[block_found]
+    + block_header[block_seqs] * (get_warp_size() - 1);
+  return get_indexes().size() + max_new_indexes < get_max_indexes()
+    && get_num_seqs() + block_header[block_seqs] < get_max_seqs();
+}
+
+inline auto BlockedBinaryIndexFileParser::parse_value(u64 value) -> void {
+  if (value == static_cast<u64>(-1)) {
+    ++get_seq_statistics_batch()->not_found_idxs.back();
+  } else if (value == static_cast<u64>(-2)) {
+    ++get_seq_statistics_batch()->invalid_idxs.back();
+  } else if (value == static_cast<u64>(-3)) {
+    end_seq();
+  } else {
+    ++get_seq_statistics_batch()->found_idxs.back();
+    get_indexes().push_back(value);
+  }
+}
+
+auto BlockedBinaryIndexFileParser::read_block_index(const string &filename)
+  -> vector<BlockIndexEntry> {
+  const auto error = runtime_error(
+    format("The file {} does not end with a block index", filename)
+  );
+  ThrowingIfstream in_stream(filename, ios::in | ios::binary);
+  in_stream.seekg(0, ios::end);
+  const u64 file_size = in_stream.tellg();
+  vector<u64> trailer(blocked_footer_trailer_elements);
+  const u64 trailer_bytes = trailer.size() * sizeof(u64);
+  if (file_size < trailer_bytes) { throw error; }
+  in_stream.seekg(static_cast<std::streamoff>(file_size - trailer_bytes));
+  in_stream.read(
+    bit_cast<char *>(trailer.data()),
+    static_cast<std::streamsize>(trailer_bytes)
+  );
+  const u64 num_blocks = trailer[0];
+  const u64 footer_offset = trailer[1];
+  vector<u64> footer;
+  const u64 footer_elements = 1 + num_blocks * blocked_footer_entry_elements;
+  // check the sizes before trusting them with an allocation
+  if (num_blocks > file_size / sizeof(u64)
+      || footer_offset + footer_elements * sizeof(u64) + trailer_bytes
+        != file_size) {
+    throw error;
+  }
+  footer.resize(footer_elements);
+  in_stream.seekg(static_cast<std::streamoff>(footer_offset));
+  in_stream.read(
+    bit_cast<char *>(footer.data()),
+    static_cast<std::streamsize>(footer.size() * sizeof(u64))
+  );
+  if (in_stream.fail() || footer[0] != blocked_footer_marker) { throw error; }
+  vector<BlockIndexEntry> result(num_blocks);
+  for (u64 i = 0; i < num_blocks; ++i) {
+    result[i].offset = footer[1 + i * blocked_footer_entry_elements];
+    result[i].first_seq = footer[2 + i * blocked_footer_entry_elements];
+  }
+  return result;
+}
+
+}  // namespace sbwt_search
@@ -0,0 +1,63 @@
+#ifndef BLOCKED_BINARY_INDEX_FILE_PARSER_H
+#define BLOCKED_BINARY_INDEX_FILE_PARSER_H
+
+/**
+ * @file BlockedBinaryIndexFileParser.h
+ * @brief Index file parser for blocked binary files. Each block is read with
+ * a single read call, and since its header holds its counts, a block which
+ * fits entirely within what is left of the batch is parsed without checking
+ * the batch limits after every value. The footer is not needed for parsing
+ * the file from the start, but read_block_index gives the byte offset and
+ * first seq of every block, so that a file can be split up or entered in the
+ * middle.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "IndexFileParser/IndexFileParser.h"
+#include "IndexResultsPrinter/BlockedBinaryFormat.h"
+#include "Tools/IOUtils.h"
+
+namespace sbwt_search {
+
+using io_utils::ThrowingIfstream;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+class BlockedBinaryIndexFileParser: public IndexFileParser {
+private:
+  vector<u64> block_header;
+  vector<u64> payload;
+  u64 payload_size = 0;
+  u64 payload_index = 0;
+  bool reached_footer = false;
+
+public:
+  BlockedBinaryIndexFileParser(
+    shared_ptr<ThrowingIfstream> in_stream_,
+    u64 max_indexes_,
+    u64 max_seqs_,
+    u64 warp_size_
+  );
+  auto generate_batch(
+    shared_ptr<SeqStatisticsBatch> seq_statistics_batch_,
+    shared_ptr<IndexesBatch> indexes_batch_
+  ) -> bool override;
+
+  // Reads the footer of an uncompressed blocked binary file
+  static auto read_block_index(const string &filename)
+    -> vector<BlockIndexEntry>;
+
+private:
+  auto assert_version() -> void;
+  auto load_block() -> bool;
+  [[nodiscard]] auto block_fits_in_batch() -> bool;
+  auto parse_value(u64 value) -> void;
+};
+
+}  // namespace sbwt_search
+
+#endif
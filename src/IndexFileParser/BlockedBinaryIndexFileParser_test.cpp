@@ -0,0 +1,268 @@
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include "IndexFileParser/BlockedBinaryIndexFileParser.h"
+#include "IndexFileParser/IndexFileParserTestUtils.h"
+#include "Tools/IOUtils.h"
+#include "Tools/TestUtils.hpp"
+
+namespace sbwt_search {
+
+using std::ios;
+using std::make_shared;
+using std::runtime_error;
+using std::filesystem::remove;
+
+class BlockedBinaryIndexFileParserTest: public ::testing::Test {
+private:
+  string temp_filename
+    = "test_objects/tmp/BlockedBinaryIndexFileParserTest.bbin";
+
+protected:
+  auto get_temp_filename() -> const string & { return temp_filename; }
+  auto get_results_ints() -> vector<vector<int>> {
+    const vector<vector<int>> result = {
+      {-2, 39, 164, 216, 59, -1, -2},
+      {-2, -1, -1, -1, -1, -1, -2},
+      {1, 2, 3, 4},
+      {},
+      {0, 1, 2, 4, 5, 6},
+    };
+    return result;
+  }
+  auto run_test(
+    const vector<vector<int>> &results_ints,
+    u64 max_indexes,
+    u64 max_seqs,
+    u64 warp_size,
+    u64 values_per_block,
+    const vector<vector<u64>> &expected_indexes,
+    const vector<vector<u64>> &expected_warps_intervals,
+    const vector<vector<u64>> &expected_found_idxs,
+    const vector<vector<u64>> &expected_not_found_idxs,
+    const vector<vector<u64>> &expected_invalid_idxs,
+    const vector<vector<u64>> &expected_colored_seq_id
+  ) -> void {
+    write_fake_blocked_binary_results_to_file(
+      temp_filename, results_ints, values_per_block
+    );
+    auto in_stream = make_shared<ThrowingIfstream>(temp_filename, ios::in);
+    auto format_name = in_stream->read_string_with_size();
+    ASSERT_EQ(format_name, "blockedbinary");
+    auto seq_statistics_batch = make_shared<SeqStatisticsBatch>();
+    auto indexes_batch = make_shared<IndexesBatch>(999, 999);
+    auto host = BlockedBinaryIndexFileParser(
+      in_stream, max_indexes, max_seqs, warp_size
+    );
+    for (int i = 0; i < expected_indexes.size(); ++i) {
+      seq_statistics_batch->reset();
+      indexes_batch->reset();
+      host.generate_batch(seq_statistics_batch, indexes_batch);
+      EXPECT_EQ(indexes_batch->warped_indexes.to_vector(), expected_indexes[i])
+        << "with " << values_per_block << " values per block";
+      EXPECT_EQ(
+        indexes_batch->warp_intervals.to_vector(), expected_warps_intervals[i]
+      );
+      EXPECT_EQ(seq_statistics_batch->found_idxs, expected_found_idxs[i]);
+      EXPECT_EQ(
+        seq_statistics_batch->not_found_idxs, expected_not_found_idxs[i]
+      );
+      EXPECT_EQ(seq_statistics_batch->invalid_idxs, expected_invalid_idxs[i]);
+      EXPECT_EQ(
+        seq_statistics_batch->colored_seq_id, expected_colored_seq_id[i]
+      );
+    }
+    seq_statistics_batch->reset();
+    indexes_batch->reset();
+    ASSERT_FALSE(host.generate_batch(seq_statistics_batch, indexes_batch));
+    remove(temp_filename);
+  }
+};
+
+TEST_F(BlockedBinaryIndexFileParserTest, OneBatch) {
+  const u64 max_indexes = 999;
+  const u64 max_seqs = 999;
+  const u64 warp_size = 4;
+  const int pad = -1;
+  const vector<vector<int>> expected_indexes = {{
+    39,
+    164,
+    216,
+    59,  // end of 1st seq
+         // 2nd seq is empty
+    1,
+    2,
+    3,
+    4,  // end of 3rd seq
+    0,
+    1,
+    2,
+    4,
+    5,
+    6,
+    pad,
+    pad  // end of 4th seq
+  }};
+  const vector<vector<u64>> expected_warps_intervals = {{0, 1, 2, 4}};
+  const vector<vector<u64>> expected_found_idxs = {{4, 0, 4, 0, 6, 0}};
+  const vector<vector<u64>> expected_not_found_idxs = {{1, 5, 0, 0, 0, 0}};
+  const vector<vector<u64>> expected_invalid_idxs = {{2, 2, 0, 0, 0, 0}};
+  const vector<vector<u64>> expected_colored_seq_id = {{0, 1, 1, 2, 2, 3}};
+
+  // 8 values make up the first seq and 29 make up the whole file
+  for (auto values_per_block : {1, 2, 3, 7, 8, 9, 29, 999}) {
+    run_test(
+      get_results_ints(),
+      max_indexes,
+      max_seqs,
+      warp_size,
+      values_per_block,
+      test_utils::to_u64s(expected_indexes),
+      expected_warps_intervals,
+      expected_found_idxs,
+      expected_not_found_idxs,
+      expected_invalid_idxs,
+      expected_colored_seq_id
+    );
+  }
+}
+
+TEST_F(BlockedBinaryIndexFileParserTest, MaxSeqs) {
+  const u64 max_indexes = 999;
+  const u64 max_seqs = 4;
+  const u64 warp_size = 4;
+  const int pad = -1;
+  const vector<vector<int>> expected_indexes = {
+    {39,
+     164,
+     216,
+     59,  // end of 1st seq
+          // 2nd seq is empty
+     1,
+     2,
+     3,
+     4},  // end of 3rd seq + empty seq
+    {
+      0,
+      1,
+      2,
+      4,
+      5,
+      6,
+      pad,
+      pad  // end of 4th seq
+    }};
+  const vector<vector<u64>> expected_warps_intervals = {{0, 1, 2}, {0, 2}};
+  const vector<vector<u64>> expected_found_idxs = {{4, 0, 4, 0}, {0, 6, 0}};
+  const vector<vector<u64>> expected_not_found_idxs = {{1, 5, 0, 0}, {0, 0, 0}};
+  const vector<vector<u64>> expected_invalid_idxs = {{2, 2, 0, 0}, {0, 0, 0}};
+  const vector<vector<u64>> expected_colored_seq_id = {{0, 1, 1, 2}, {0, 0, 1}};
+
+  for (auto values_per_block : {1, 2, 3, 7, 8, 9, 29, 999}) {
+    run_test(
+      get_results_ints(),
+      max_indexes,
+      max_seqs,
+      warp_size,
+      values_per_block,
+      test_utils::to_u64s(expected_indexes),
+      expected_warps_intervals,
+      expected_found_idxs,
+      expected_not_found_idxs,
+      expected_invalid_idxs,
+      expected_colored_seq_id
+    );
+  }
+}
+
+TEST_F(BlockedBinaryIndexFileParserTest, BreakInMiddle) {
+  const u64 max_indexes = 12;
+  const u64 max_seqs = 999;
+  const u64 warp_size = 4;
+  const int pad = -1;
+  const vector<vector<int>> expected_indexes = {
+    {39,
+     164,
+     216,
+     59,  // end of 1st seq
+          // 2nd seq is empty
+     1,
+     2,
+     3,
+     4,  // end of 3rd seq
+     0,
+     1,
+     2,
+     4},
+    {
+      5,
+      6,
+      pad,
+      pad  // end of 4th seq
+    }};
+  const vector<vector<u64>> expected_warps_intervals = {{0, 1, 2, 3}, {0, 1}};
+  const vector<vector<u64>> expected_found_idxs = {{4, 0, 4, 0, 4}, {2, 0}};
+  const vector<vector<u64>> expected_not_found_idxs = {{1, 5, 0, 0, 0}, {0, 0}};
+  const vector<vector<u64>> expected_invalid_idxs = {{2, 2, 0, 0, 0}, {0, 0}};
+  const vector<vector<u64>> expected_colored_seq_id = {{0, 1, 1, 2, 2}, {0, 1}};
+
+  for (auto values_per_block : {1, 2, 3, 7, 8, 9, 29, 999}) {
+    run_test(
+      get_results_ints(),
+      max_indexes,
+      max_seqs,
+      warp_size,
+      values_per_block,
+      test_utils::to_u64s(expected_indexes),
+      expected_warps_intervals,
+      expected_found_idxs,
+      expected_not_found_idxs,
+      expected_invalid_idxs,
+      expected_colored_seq_id
+    );
+  }
+}
+
+TEST_F(BlockedBinaryIndexFileParserTest, BlockIndex) {
+  const u64 values_per_block = 7;
+  write_fake_blocked_binary_results_to_file(
+    get_temp_filename(), get_results_ints(), values_per_block
+  );
+  const auto block_index
+    = BlockedBinaryIndexFileParser::read_block_index(get_temp_filename());
+  // 29 values split into blocks of 7, with the seqs ending at values 7, 15,
+  // 20, 21 and 28
+  const vector<u64> expected_first_seqs = {0, 0, 1, 3, 4};
+  const vector<vector<int>> values
+    = {{-2, 39, 164, 216, 59, -1, -2, -3, -2, -1, -1, -1, -1, -1, -2,
+        -3, 1,  2,   3,   4,  -3, -3, 0,  1,  2,  4,  5,  6,  -3}};
+  const auto expected_values = test_utils::to_u64s(values)[0];
+  ASSERT_EQ(block_index.size(), expected_first_seqs.size());
+  ThrowingIfstream in_stream(get_temp_filename(), ios::in | ios::binary);
+  for (u64 i = 0; i < block_index.size(); ++i) {
+    EXPECT_EQ(block_index[i].first_seq, expected_first_seqs[i]);
+    // every offset points at a block header, which is followed by the first
+    // value of that block
+    in_stream.seekg(static_cast<std::streamoff>(
+      block_index[i].offset + block_header_elements * sizeof(u64)
+    ));
+    EXPECT_EQ(
+      in_stream.read_real<u64>(), expected_values[i * values_per_block]
+    );
+  }
+  remove(get_temp_filename());
+}
+
+TEST_F(BlockedBinaryIndexFileParserTest, MissingBlockIndex) {
+  write_fake_binary_results_to_file(get_temp_filename(), get_results_ints());
+  ASSERT_THROW(
+    BlockedBinaryIndexFileParser::read_block_index(get_temp_filename()),
+    runtime_error
+  );
+  remove(get_temp_filename());
+}
+
+}  // namespace sbwt_search
@@ -8,19 +8,29 @@
 
 #include "IndexFileParser/AsciiIndexFileParser.h"
 #include "IndexFileParser/BinaryIndexFileParser.h"
+#include "IndexFileParser/BlockedBinaryIndexFileParser.h"
 #include "IndexFileParser/ContinuousIndexFileParser.h"
 #include "IndexFileParser/PackedIntIndexFileParser.h"
 #include "Tools/IOUtils.h"
 #include "Tools/Logger.h"
+#include "Tools/Metrics.h"
 
 namespace sbwt_search {
 
 using fmt::format;
+using io_utils::is_standard_stream;
 using log_utils::Logger;
+using log_utils::Metrics;
 using std::ios;
 using std::make_shared;
 using std::numeric_limits;
 
+namespace {
+
+const int gzip_first_byte = 0x1f;
+
+}  // namespace
+
 ContinuousIndexFileParser::ContinuousIndexFileParser(
   u64 stream_id_,
   u64 max_indexes_per_batch_,
@@ -28,7 +38,8 @@ ContinuousIndexFileParser::ContinuousIndexFileParser(
   u64 warp_size_,
   vector<string> filenames_,
   u64 seq_statistics_batch_producer_max_batches,
-  u64 indexes_batch_producer_max_batches
+  u64 indexes_batch_producer_max_batches,
+  bool paired_end_
 ):
     max_indexes_per_batch(max_indexes_per_batch_),
     max_seqs_per_batch(max_seqs_per_batch_),
@@ -42,7 +53,8 @@ ContinuousIndexFileParser::ContinuousIndexFileParser(
       indexes_batch_producer_max_batches
     )),
     filenames(std::move(filenames_)),
-    stream_id(stream_id_) {
+    stream_id(stream_id_),
+    paired_end(paired_end_) {
   filename_iterator = filenames.begin();
 }
 
@@ -63,6 +75,14 @@ auto ContinuousIndexFileParser::reset_batches() -> void {
 }
 
 auto ContinuousIndexFileParser::start_next_file() -> bool {
+  // mates never carry on into the next file
+  if (index_file_parser != nullptr && index_file_parser->end_unpaired_mate()) {
+    Logger::log(
+      Logger::LOG_LEVEL::WARN,
+      "A paired-end file has an odd number of seqs, so its last seq has no "
+      "mate"
+    );
+  }
   while (filename_iterator != filenames.end()) {
     auto filename = *filename_iterator++;
     Logger::log(
@@ -85,6 +105,13 @@ auto ContinuousIndexFileParser::start_next_file() -> bool {
 
 auto ContinuousIndexFileParser::start_new_file(const string &filename) -> void {
   auto in_stream = make_shared<ThrowingIfstream>(filename, ios::in);
+  // standard input has no extension to go by, but no format name is long
+  // enough for its size to start with the first byte of a gzip header
+  if (filename.ends_with(".gz")
+      || (is_standard_stream(filename)
+          && in_stream->peek() == gzip_first_byte)) {
+    in_stream->enable_gzip_decompression();
+  }
   const string file_format = in_stream->read_string_with_size();
   if (file_format == "ascii") {  // NOLINT (bugprone-branch-clone)
     index_file_parser = make_unique<AsciiIndexFileParser>(
@@ -94,6 +121,10 @@ auto ContinuousIndexFileParser::start_new_file(const string &filename) -> void {
     index_file_parser = make_unique<BinaryIndexFileParser>(
       std::move(in_stream), max_indexes_per_batch, max_seqs_per_batch, warp_size
     );
+  } else if (file_format == "blockedbinary") {
+    index_file_parser = make_unique<BlockedBinaryIndexFileParser>(
+      std::move(in_stream), max_indexes_per_batch, max_seqs_per_batch, warp_size
+    );
   } else if (file_format == "packedint") {
     index_file_parser = make_unique<PackedIntIndexFileParser>(
       std::move(in_stream), max_indexes_per_batch, max_seqs_per_batch, warp_size
@@ -102,7 +133,9 @@ auto ContinuousIndexFileParser::start_new_file(const string &filename) -> void {
     Logger::log(
       Logger::LOG_LEVEL::WARN, "Invalid file format in file: " + filename
     );
+    return;
   }
+  index_file_parser->set_paired_end(paired_end);
 }
 
 auto ContinuousIndexFileParser::do_at_batch_start() -> void {
@@ -167,6 +200,11 @@ auto ContinuousIndexFileParser::do_at_batch_finish() -> void {
       num_invalid_idxs
     )
   );
+  Metrics::add(
+    format("ContinuousIndexFileParser_{}", stream_id),
+    "kmers_total",
+    static_cast<double>(num_indexes)
+  );
   Logger::log_timed_event(
     format("ContinuousIndexFileParser_{}", stream_id),
     Logger::EVENT_STATE::STOP,
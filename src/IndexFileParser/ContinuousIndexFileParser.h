@@ -6,7 +6,9 @@
  * @brief Reads a list of files one by one, filling in the batches producer as
  * it goes along. Uses the sub IndexFileParsers to do its parsing for it.
  * Indexes are padded to the next warp and sequence statistics are counted as
- * well.
+ * well. Files ending with .gz are decompressed as they are read. With paired
+ * end reads, each two seqs of a file are interleaved mates, which are joined
+ * into a single seq.
  */
 
 #include <memory>
@@ -35,6 +37,7 @@ private:
   u64 max_seqs_per_batch;
   u64 warp_size;
   u64 stream_id;
+  bool paired_end;
 
 public:
   ContinuousIndexFileParser(
@@ -44,7 +47,8 @@ public:
     u64 warp_size_,
     vector<string> filenames_,
     u64 seq_statistics_batch_producer_max_batches,
-    u64 indexes_batch_producer_max_batches
+    u64 indexes_batch_producer_max_batches,
+    bool paired_end_ = false
   );
 
   [[nodiscard]] auto get_seq_statistics_batch_producer() const
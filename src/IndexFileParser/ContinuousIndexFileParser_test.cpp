@@ -1,5 +1,7 @@
 #include <chrono>
 #include <filesystem>
+#include <ios>
+#include <iterator>
 #include <limits>
 #include <memory>
 #include <thread>
@@ -8,12 +10,18 @@
 
 #include "IndexFileParser/ContinuousIndexFileParser.h"
 #include "IndexFileParser/IndexFileParserTestUtils.h"
+#include "Tools/GzipUtils.h"
+#include "Tools/IOUtils.h"
 #include "Tools/RNGUtils.hpp"
 #include "Tools/TestUtils.hpp"
 
 namespace sbwt_search {
 
+using io_utils::gzip_compress;
+using io_utils::ThrowingIfstream;
+using io_utils::ThrowingOfstream;
 using rng_utils::get_uniform_int_generator;
+using std::ios;
 using std::make_shared;
 using std::numeric_limits;
 using std::chrono::milliseconds;
@@ -41,6 +49,33 @@ protected:
   auto get_binary_filename() {
     return "test_objects/tmp/BinaryIndexFileParserTest.bin";
   }
+  // Compresses the file as two gzip members, so that reading has to carry on
+  // past the end of the first one
+  auto write_gzip_copy(const string &filename) -> string {
+    const string gzip_filename = "test_objects/tmp/"
+      + std::filesystem::path(filename).filename().string() + ".gz";
+    ThrowingIfstream in_stream(filename, ios::in | ios::binary);
+    const string content(
+      (std::istreambuf_iterator<char>(in_stream)),
+      std::istreambuf_iterator<char>()
+    );
+    ThrowingOfstream out_stream(gzip_filename, ios::out | ios::binary);
+    vector<char> compressed;
+    const u64 half = content.size() / 2;
+    gzip_compress(content.data(), half, compressed);
+    out_stream.write_raw(compressed.data(), compressed.size());
+    gzip_compress(content.data() + half, content.size() - half, compressed);
+    out_stream.write_raw(compressed.data(), compressed.size());
+    return gzip_filename;
+  }
+  auto get_gzip_filenames() -> vector<string> {
+    write_fake_binary_results_to_file(
+      get_binary_filename(), get_results_ints()
+    );
+    return {
+      write_gzip_copy("test_objects/example_index_search_result.txt"),
+      write_gzip_copy(get_binary_filename())};
+  }
   auto run_test(
     u64 max_batches,
     u64 max_indexes_per_batch,
@@ -53,7 +88,8 @@ protected:
     const vector<vector<u64>> &expected_not_found_idxs,
     const vector<vector<u64>> &expected_invalid_idxs,
     const vector<vector<u64>> &expected_colored_seq_id,
-    const vector<vector<u64>> &expected_seqs_before_newfile
+    const vector<vector<u64>> &expected_seqs_before_newfile,
+    bool paired_end = false
   ) {
     write_fake_binary_results_to_file(
       get_binary_filename(), get_results_ints()
@@ -65,7 +101,8 @@ protected:
       warp_padding,
       filenames,
       max_batches,
-      max_batches
+      max_batches,
+      paired_end
     );
     const auto num_sections = 3;
 #pragma omp parallel sections num_threads(num_sections)
@@ -150,58 +187,67 @@ protected:
     }
     EXPECT_EQ(batches, expected_indexes.size());
   }
+  auto test_all(const vector<string> &filenames) -> void {
+    const u64 max_indexes_per_batch = 4;
+    const u64 max_seqs_per_batch = 4;
+    const u64 warp_padding = 4;
+    int pad = -1;
+    const vector<vector<int>> expected_indexes = {
+      {39, 164, 216, 59},  // end of 1st seq
+                           // 2nd seq is empty
+      {1, 2, 3, 4},        // end of 3rd seq
+                           // empty line
+      {0, 1, 2, 4},
+      {5, 6, pad, pad},    // end of 4th seq
+      {39, 164, 216, 59},  // end of 1st seq
+                           // 2nd seq is empty
+      {1, 2, 3, 4},        // end of 3rd seq
+                           // empty line
+      {0, 1, 2, 4},
+      {5, 6, pad, pad},    // end of 4th seq
+      {}};
+    u64 max = numeric_limits<u64>::max();
+    const vector<vector<u64>> expected_warps_intervals
+      = {{0, 1}, {0, 1}, {0, 1}, {0, 1}, {0, 1}, {0, 1}, {0, 1}, {0, 1}, {0}};
+    const vector<vector<u64>> expected_seqs_before_newfile
+      = {{max}, {max}, {max}, {max}, {0, max}, {max}, {max}, {max}, {max}};
+    const vector<vector<u64>> expected_found_idxs = {
+      {4}, {0, 0, 4}, {0, 0, 4}, {2, 0}, {4}, {0, 0, 4}, {0, 0, 4}, {2, 0}, {0}};
+    const vector<vector<u64>> expected_not_found_idxs = {
+      {0}, {1, 5, 0}, {0, 0, 0}, {0, 0}, {0}, {1, 5, 0}, {0, 0, 0}, {0, 0}, {0}};
+    const vector<vector<u64>> expected_invalid_idxs = {
+      {1}, {1, 2, 0}, {0, 0, 0}, {0, 0}, {1}, {1, 2, 0}, {0, 0, 0}, {0, 0}, {0}};
+    const vector<vector<u64>> expected_colored_seq_id = {
+      {0}, {0, 0, 0}, {0, 0, 0}, {0, 1}, {0}, {0, 0, 0}, {0, 0, 0}, {0, 1}, {0}};
+    for (auto max_batches : {1, 2, 3, 4, 5, 7, 99}) {
+      run_test(
+        max_batches,
+        max_indexes_per_batch,
+        max_seqs_per_batch,
+        warp_padding,
+        filenames,
+        to_u64s(expected_indexes),
+        expected_warps_intervals,
+        expected_found_idxs,
+        expected_not_found_idxs,
+        expected_invalid_idxs,
+        expected_colored_seq_id,
+        expected_seqs_before_newfile
+      );
+    }
+  }
 };
 
 TEST_F(ContinuousIndexFileParserTest, TestAll) {
-  const u64 max_indexes_per_batch = 4;
-  const u64 max_seqs_per_batch = 4;
-  const vector<string> filenames
-    = {"test_objects/example_index_search_result.txt", get_binary_filename()};
-  const u64 warp_padding = 4;
-  int pad = -1;
-  const vector<vector<int>> expected_indexes = {
-    {39, 164, 216, 59},  // end of 1st seq
-                         // 2nd seq is empty
-    {1, 2, 3, 4},        // end of 3rd seq
-                         // empty line
-    {0, 1, 2, 4},
-    {5, 6, pad, pad},    // end of 4th seq
-    {39, 164, 216, 59},  // end of 1st seq
-                         // 2nd seq is empty
-    {1, 2, 3, 4},        // end of 3rd seq
-                         // empty line
-    {0, 1, 2, 4},
-    {5, 6, pad, pad},    // end of 4th seq
-    {}};
-  u64 max = numeric_limits<u64>::max();
-  const vector<vector<u64>> expected_warps_intervals
-    = {{0, 1}, {0, 1}, {0, 1}, {0, 1}, {0, 1}, {0, 1}, {0, 1}, {0, 1}, {0}};
-  const vector<vector<u64>> expected_seqs_before_newfile
-    = {{max}, {max}, {max}, {max}, {0, max}, {max}, {max}, {max}, {max}};
-  const vector<vector<u64>> expected_found_idxs = {
-    {4}, {0, 0, 4}, {0, 0, 4}, {2, 0}, {4}, {0, 0, 4}, {0, 0, 4}, {2, 0}, {0}};
-  const vector<vector<u64>> expected_not_found_idxs = {
-    {0}, {1, 5, 0}, {0, 0, 0}, {0, 0}, {0}, {1, 5, 0}, {0, 0, 0}, {0, 0}, {0}};
-  const vector<vector<u64>> expected_invalid_idxs = {
-    {1}, {1, 2, 0}, {0, 0, 0}, {0, 0}, {1}, {1, 2, 0}, {0, 0, 0}, {0, 0}, {0}};
-  const vector<vector<u64>> expected_colored_seq_id = {
-    {0}, {0, 0, 0}, {0, 0, 0}, {0, 1}, {0}, {0, 0, 0}, {0, 0, 0}, {0, 1}, {0}};
-  for (auto max_batches : {1, 2, 3, 4, 5, 7, 99}) {
-    run_test(
-      max_batches,
-      max_indexes_per_batch,
-      max_seqs_per_batch,
-      warp_padding,
-      filenames,
-      to_u64s(expected_indexes),
-      expected_warps_intervals,
-      expected_found_idxs,
-      expected_not_found_idxs,
-      expected_invalid_idxs,
-      expected_colored_seq_id,
-      expected_seqs_before_newfile
-    );
-  }
+  test_all(
+    {"test_objects/example_index_search_result.txt", get_binary_filename()}
+  );
+}
+
+TEST_F(ContinuousIndexFileParserTest, TestGzipped) {
+  const auto filenames = get_gzip_filenames();
+  test_all(filenames);
+  for (const auto &filename : filenames) { remove(filename); }
 }
 
 TEST_F(ContinuousIndexFileParserTest, TestOneBatch) {
@@ -279,4 +325,63 @@ TEST_F(ContinuousIndexFileParserTest, TestOneBatch) {
   }
 }
 
+// Each file has 5 seqs, so the 5th has no mate and is a seq of its own
+TEST_F(ContinuousIndexFileParserTest, TestPairedEnd) {
+  const u64 max_indexes_per_batch = 4;
+  const u64 max_seqs_per_batch = 2;
+  const vector<string> filenames
+    = {"test_objects/example_index_search_result.txt", get_binary_filename()};
+  const u64 warp_padding = 4;
+  int pad = -1;
+  const vector<vector<int>> expected_indexes = {
+    {39, 164, 216, 59},  // 1st mate of the 1st pair
+    {},                  // rest of the 1st pair
+    {1, 2, 3, 4},        // 1st mate of the 2nd pair
+    {},                  // 2nd mate of the 2nd pair is an empty line
+    {0, 1, 2, 4},
+    {5, 6, pad, pad},    // 5th seq, which has no mate
+    {39, 164, 216, 59},  // same as above for the second file
+    {},
+    {1, 2, 3, 4},
+    {},
+    {0, 1, 2, 4},
+    {5, 6, pad, pad}};
+  u64 max = numeric_limits<u64>::max();
+  const vector<vector<u64>> expected_warps_intervals = {
+    {0, 1}, {0}, {0, 1}, {0}, {0, 1}, {0, 1},
+    {0, 1}, {0}, {0, 1}, {0}, {0, 1}, {0, 1}};
+  const vector<vector<u64>> expected_seqs_before_newfile = {
+    {max}, {max}, {max}, {max}, {max}, {1, max},
+    {max}, {max}, {max}, {max}, {max}, {max}};
+  const vector<vector<u64>> expected_found_idxs = {
+    {4}, {0, 0}, {4}, {0, 0}, {4}, {2, 0},
+    {4}, {0, 0}, {4}, {0, 0}, {4}, {2, 0}};
+  const vector<vector<u64>> expected_not_found_idxs = {
+    {0}, {6, 0}, {0}, {0, 0}, {0}, {0, 0},
+    {0}, {6, 0}, {0}, {0, 0}, {0}, {0, 0}};
+  const vector<vector<u64>> expected_invalid_idxs = {
+    {1}, {3, 0}, {0}, {0, 0}, {0}, {0, 0},
+    {1}, {3, 0}, {0}, {0, 0}, {0}, {0, 0}};
+  const vector<vector<u64>> expected_colored_seq_id = {
+    {0}, {0, 0}, {0}, {0, 0}, {0}, {0, 1},
+    {0}, {0, 0}, {0}, {0, 0}, {0}, {0, 1}};
+  for (auto max_batches : {1, 2, 3, 4, 5, 7, 99}) {
+    run_test(
+      max_batches,
+      max_indexes_per_batch,
+      max_seqs_per_batch,
+      warp_padding,
+      filenames,
+      to_u64s(expected_indexes),
+      expected_warps_intervals,
+      expected_found_idxs,
+      expected_not_found_idxs,
+      expected_invalid_idxs,
+      expected_colored_seq_id,
+      expected_seqs_before_newfile,
+      true
+    );
+  }
+}
+
 }  // namespace sbwt_search
@@ -23,6 +23,7 @@ auto IndexFileParser::get_indexes() const -> PinnedVector<u64> & {
 }
 auto IndexFileParser::get_max_indexes() const -> u64 { return max_indexes; }
 auto IndexFileParser::get_max_seqs() const -> u64 { return max_seqs; }
+auto IndexFileParser::get_warp_size() const -> u64 { return warp_size; }
 
 auto IndexFileParser::generate_batch(
   shared_ptr<SeqStatisticsBatch> read_statistics_batch_,
@@ -33,7 +34,26 @@ auto IndexFileParser::generate_batch(
   return false;
 }
 
+auto IndexFileParser::set_paired_end(bool paired_end_) -> void {
+  paired_end = paired_end_;
+}
+
 auto IndexFileParser::end_seq() -> void {
+  if (paired_end) {
+    is_first_mate = !is_first_mate;
+    if (!is_first_mate) { return; }
+  }
+  finish_seq();
+}
+
+auto IndexFileParser::end_unpaired_mate() -> bool {
+  if (!paired_end || is_first_mate) { return false; }
+  is_first_mate = true;
+  finish_seq();
+  return true;
+}
+
+auto IndexFileParser::finish_seq() -> void {
   pad_warp();
   add_warp_interval();
   begin_new_seq();
@@ -62,12 +82,16 @@ auto IndexFileParser::begin_new_seq() -> void {
   seq_statistics_batch->found_idxs.push_back(0);
   seq_statistics_batch->invalid_idxs.push_back(0);
   seq_statistics_batch->not_found_idxs.push_back(0);
-  seq_statistics_batch->colored_seq_id.push_back(0);
+  seq_statistics_batch->colored_seq_id.push_back(
+    indexes_batch->warp_intervals.size() - 1
+  );
 }
 
 auto IndexFileParser::add_warp_interval() -> void {
   auto &warp_intervals = indexes_batch->warp_intervals;
-  seq_statistics_batch->colored_seq_id.back() = warp_intervals.size() - 1;
+  // a seq which was given an end before it was finished, such as a first
+  // mate at the end of its file, has that end replaced
+  warp_intervals.resize(seq_statistics_batch->colored_seq_id.back() + 1);
   if (warp_intervals.back() != indexes_batch->warped_indexes.size() / warp_size) {
     warp_intervals.push_back(indexes_batch->warped_indexes.size() / warp_size);
   }
@@ -38,12 +38,15 @@ private:
   u64 max_seqs;
   u64 warp_size;
   u64 colored_seq_id;
+  bool paired_end = false;
+  bool is_first_mate = true;
 
 protected:
   [[nodiscard]] auto get_istream() const -> ThrowingIfstream &;
   [[nodiscard]] auto get_indexes() const -> PinnedVector<u64> &;
   [[nodiscard]] auto get_max_indexes() const -> u64;
   [[nodiscard]] auto get_max_seqs() const -> u64;
+  [[nodiscard]] auto get_warp_size() const -> u64;
   IndexFileParser(
     shared_ptr<ThrowingIfstream> in_stream_,
     u64 max_indexes_,
@@ -57,6 +60,12 @@ public:
     shared_ptr<SeqStatisticsBatch> seq_statistics_batch_,
     shared_ptr<IndexesBatch> indexes_batch_
   ) -> bool;
+  // Each two seqs are then the two mates of a paired-end read, and the
+  // second mate carries on in the seq of the first
+  auto set_paired_end(bool paired_end_) -> void;
+  // Ends the seq of a first mate which has no second mate, such as the last
+  // seq of a file with an odd number of seqs. Returns true if there was one.
+  auto end_unpaired_mate() -> bool;
   virtual ~IndexFileParser() = default;
   IndexFileParser(IndexFileParser &) = delete;
   IndexFileParser(IndexFileParser &&) = delete;
@@ -74,6 +83,7 @@ protected:
   auto add_warp_interval() -> void;
 
 private:
+  auto finish_seq() -> void;
   auto pad_warp() -> void;
   auto begin_new_seq() -> void;
 };
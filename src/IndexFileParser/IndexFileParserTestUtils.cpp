@@ -1,14 +1,20 @@
+#include <algorithm>
+#include <bit>
 #include <ios>
 
 #include "Global/GlobalDefinitions.h"
 #include "IndexFileParser/IndexFileParserTestUtils.h"
+#include "IndexResultsPrinter/BlockedBinaryFormat.h"
+#include "IndexResultsPrinter/PackedBoolFormat.h"
 #include "Tools/IOUtils.h"
 #include "Tools/TestUtils.hpp"
 
 namespace sbwt_search {
 
 using io_utils::ThrowingOfstream;
+using std::bit_cast;
 using std::ios;
+using std::min;
 using test_utils::to_u64s;
 
 auto write_fake_binary_results_to_file(
@@ -24,4 +30,129 @@ auto write_fake_binary_results_to_file(
   }
 }
 
+auto write_fake_blocked_binary_results_to_file(
+  const string &filename,
+  const vector<vector<int>> &results_ints,
+  u64 values_per_block
+) -> void {
+  vector<u64> values;
+  for (const auto &seq : to_u64s(results_ints)) {
+    values.insert(values.end(), seq.begin(), seq.end());
+    values.push_back(static_cast<u64>(-3));
+  }
+  ThrowingOfstream out_stream(filename, ios::binary | ios::out);
+  out_stream.write_string_with_size("blockedbinary");
+  out_stream.write_string_with_size("v1.0");
+  vector<u64> footer = {blocked_footer_marker};
+  u64 seqs_before_block = 0;
+  for (u64 start = 0; start < values.size(); start += values_per_block) {
+    const u64 end = min(start + values_per_block, values.size());
+    vector<u64> header(block_header_elements, 0);
+    header[block_payload_bytes] = (end - start) * sizeof(u64);
+    for (u64 i = start; i < end; ++i) {
+      if (values[i] == static_cast<u64>(-3)) {
+        ++header[block_seqs];
+        continue;
+      }
+      ++header[block_kmers];
+      if (values[i] == static_cast<u64>(-1)) {
+        ++header[block_not_found];
+      } else if (values[i] == static_cast<u64>(-2)) {
+        ++header[block_invalid];
+      } else {
+        ++header[block_found];
+      }
+    }
+    footer.push_back(out_stream.tellp());
+    footer.push_back(seqs_before_block);
+    seqs_before_block += header[block_seqs];
+    out_stream.write(header);
+    for (u64 i = start; i < end; ++i) { out_stream.write(values[i]); }
+  }
+  const u64 footer_offset = out_stream.tellp();
+  footer.push_back((footer.size() - 1) / blocked_footer_entry_elements);
+  footer.push_back(footer_offset);
+  out_stream.write(footer);
+}
+
+namespace {
+
+auto to_packed_bool_status(int result) -> u8 {
+  if (result == -1) { return packed_bool_not_found; }
+  if (result == -2) { return packed_bool_invalid; }
+  return packed_bool_found;
+}
+
+auto pack_segment(
+  const vector<u8> &statuses, bool run_length_encode, vector<u8> &packed
+) -> void {
+  for (u64 i = 0; i < statuses.size();) {
+    u64 run = 1;
+    while (i + run < statuses.size() && statuses[i + run] == statuses[i]) {
+      ++run;
+    }
+    if (run_length_encode && run >= packed_bool_min_run) {
+      packed.push_back(
+        packed_bool_run | (statuses[i] << packed_bool_status_bits)
+      );
+      vector<u8> vlq(max_vlq_bytes);
+      packed.insert(
+        packed.end(), vlq.begin(), vlq.begin() + write_vlq(vlq.data(), run)
+      );
+      i += run;
+      continue;
+    }
+    u8 byte = 0;
+    for (u64 j = 0; j < packed_bool_statuses_per_byte && i < statuses.size();
+         ++j, ++i) {
+      byte |= statuses[i] << (j * packed_bool_status_bits);
+    }
+    packed.push_back(byte);
+  }
+}
+
+}  // namespace
+
+auto write_fake_packed_bool_results_to_file(
+  const string &filename,
+  const vector<vector<int>> &results_ints,
+  u64 values_per_block,
+  bool run_length_encode
+) -> void {
+  // the end of a seq is marked with -3, as in the binary format
+  vector<int> values;
+  for (const auto &seq : results_ints) {
+    values.insert(values.end(), seq.begin(), seq.end());
+    values.push_back(-3);
+  }
+  ThrowingOfstream out_stream(filename, ios::binary | ios::out);
+  out_stream.write_string_with_size("packedbool");
+  out_stream.write_string_with_size("v1.0");
+  for (u64 start = 0; start < values.size(); start += values_per_block) {
+    const u64 end = min(start + values_per_block, values.size());
+    vector<u8> packed;
+    vector<u8> table;
+    vector<u8> segment;
+    u64 seqs = 0;
+    for (u64 i = start; i <= end; ++i) {
+      if (i < end && values[i] != -3) {
+        segment.push_back(to_packed_bool_status(values[i]));
+        continue;
+      }
+      pack_segment(segment, run_length_encode, packed);
+      vector<u8> vlq(max_vlq_bytes);
+      table.insert(
+        table.end(),
+        vlq.begin(),
+        vlq.begin() + write_vlq(vlq.data(), segment.size())
+      );
+      segment.clear();
+      seqs += static_cast<u64>(i < end);
+    }
+    out_stream.write(vector<u64>{packed.size(), table.size(), seqs});
+    out_stream.write(bit_cast<char *>(packed.data()), packed.size());
+    out_stream.write(bit_cast<char *>(table.data()), table.size());
+  }
+}
+
 }  // namespace sbwt_search
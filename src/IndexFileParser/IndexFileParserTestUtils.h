@@ -9,6 +9,8 @@
 #include <string>
 #include <vector>
 
+#include "Tools/TypeDefinitions.h"
+
 namespace sbwt_search {
 
 using std::string;
@@ -18,6 +20,24 @@ auto write_fake_binary_results_to_file(
   const string &filename, const vector<vector<int>> &results_ints
 ) -> void;
 
+// Writes the same values as above, but as a blocked binary file where every
+// block holds values_per_block values, so that seqs are split between blocks
+auto write_fake_blocked_binary_results_to_file(
+  const string &filename,
+  const vector<vector<int>> &results_ints,
+  u64 values_per_block
+) -> void;
+
+// Writes the statuses of the same values as a packed bool file, where every
+// block holds values_per_block values (counting the end of each seq as a
+// value), optionally with long runs of the same status run length encoded
+auto write_fake_packed_bool_results_to_file(
+  const string &filename,
+  const vector<vector<int>> &results_ints,
+  u64 values_per_block,
+  bool run_length_encode
+) -> void;
+
 }  // namespace sbwt_search
 
 #endif
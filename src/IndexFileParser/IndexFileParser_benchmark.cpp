@@ -0,0 +1,209 @@
+#include <filesystem>
+#include <ios>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BatchObjects/IndexesBatch.h"
+#include "BatchObjects/SeqStatisticsBatch.h"
+#include "Global/GlobalDefinitions.h"
+#include "IndexFileParser/AsciiIndexFileParser.h"
+#include "IndexFileParser/BinaryIndexFileParser.h"
+#include "IndexFileParser/IndexFileParser.h"
+#include "IndexFileParser/PackedIntIndexFileParser.h"
+#include "Tools/IOUtils.h"
+#include "Tools/RNGUtils.hpp"
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+using io_utils::ThrowingIfstream;
+using io_utils::ThrowingOfstream;
+using rng_utils::get_uniform_int_generator;
+using std::ios;
+using std::make_shared;
+using std::make_unique;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+namespace {
+
+const u64 parser_max_indexes_per_batch = 1ULL << 20;
+const u64 parser_max_seqs_per_batch = 1ULL << 16;
+const u64 parser_max_index = 1ULL << 30;
+const u64 parser_max_seq_size = 300;
+const u64 parser_not_found = static_cast<u64>(-1);
+const u64 parser_invalid = static_cast<u64>(-2);
+const u64 parser_newline = static_cast<u64>(-3);
+
+enum class IndexFileFormat { ascii, binary, packedint };
+
+// Sequences of random length made of indexes, where one in every 8 indexes is
+// not found and one in every 32 is invalid. Sequences are separated with
+// parser_newline.
+auto get_random_results(u64 num_results) -> vector<u64> {
+  auto rng = get_uniform_int_generator<u64>(0, parser_max_index);
+  vector<u64> results;
+  results.reserve(num_results + num_results / 8);
+  for (u64 seq_end = 0; results.size() < num_results;) {
+    seq_end = results.size() + rng() % parser_max_seq_size;
+    while (results.size() < seq_end) {
+      u64 r = rng();
+      if (r % 32 == 0) {
+        results.push_back(parser_invalid);
+      } else if (r % 8 == 0) {
+        results.push_back(parser_not_found);
+      } else {
+        results.push_back(r);
+      }
+    }
+    results.push_back(parser_newline);
+  }
+  return results;
+}
+
+auto write_ascii(ThrowingOfstream &out, const vector<u64> &results) -> void {
+  bool first = true;
+  for (u64 r : results) {
+    if (r == parser_newline) {
+      out << '\n';
+      first = true;
+      continue;
+    }
+    if (!first) { out << ' '; }
+    first = false;
+    if (r == parser_not_found) {
+      out << "-1";
+    } else if (r == parser_invalid) {
+      out << "-2";
+    } else {
+      out << r;
+    }
+  }
+}
+
+auto write_binary(ThrowingOfstream &out, const vector<u64> &results) -> void {
+  for (u64 r : results) { out.write(r); }
+}
+
+auto write_packedint(ThrowingOfstream &out, const vector<u64> &results)
+  -> void {
+  for (u64 r : results) {
+    if (r == parser_not_found) {
+      out.put(0b01000000);
+    } else if (r == parser_invalid) {
+      out.put(0b01000001);
+    } else if (r == parser_newline) {
+      out.put(0b01000010);
+    } else {
+      for (; r >= 0b01000000; r >>= 7) {
+        out.put(static_cast<char>(0x80 | (r & 0x7F)));
+      }
+      out.put(static_cast<char>(r));
+    }
+  }
+}
+
+auto write_index_file(
+  const string &filename, IndexFileFormat format, const vector<u64> &results
+) -> void {
+  ThrowingOfstream out(filename, ios::out | ios::binary);
+  switch (format) {
+    case IndexFileFormat::ascii:
+      out.write_string_with_size("ascii");
+      out.write_string_with_size("v1.0");
+      write_ascii(out, results);
+      break;
+    case IndexFileFormat::binary:
+      out.write_string_with_size("binary");
+      out.write_string_with_size("v1.0");
+      write_binary(out, results);
+      break;
+    case IndexFileFormat::packedint:
+      out.write_string_with_size("packedint");
+      out.write_string_with_size("v1.0");
+      write_packedint(out, results);
+      break;
+  }
+}
+
+auto get_parser(IndexFileFormat format, const string &filename)
+  -> unique_ptr<IndexFileParser> {
+  auto in_stream = make_shared<ThrowingIfstream>(filename, ios::in);
+  in_stream->read_string_with_size();
+  switch (format) {
+    case IndexFileFormat::ascii:
+      return make_unique<AsciiIndexFileParser>(
+        in_stream,
+        parser_max_indexes_per_batch,
+        parser_max_seqs_per_batch,
+        gpu_warp_size
+      );
+    case IndexFileFormat::binary:
+      return make_unique<BinaryIndexFileParser>(
+        in_stream,
+        parser_max_indexes_per_batch,
+        parser_max_seqs_per_batch,
+        gpu_warp_size
+      );
+    case IndexFileFormat::packedint:
+      return make_unique<PackedIntIndexFileParser>(
+        in_stream,
+        parser_max_indexes_per_batch,
+        parser_max_seqs_per_batch,
+        gpu_warp_size
+      );
+  }
+  return nullptr;
+}
+
+// Reads the whole file in the same way as the ContinuousIndexFileParser does,
+// without the pipeline around it
+auto benchmark_index_file_parser(
+  benchmark::State &state, IndexFileFormat format
+) -> void {
+  const u64 num_results = state.range(0);
+  const string filename = (std::filesystem::temp_directory_path()
+                           / "sbwt_search_index_file_parser_benchmark")
+                            .string();
+  write_index_file(filename, format, get_random_results(num_results));
+  auto seq_statistics_batch = make_shared<SeqStatisticsBatch>();
+  auto indexes_batch = make_shared<IndexesBatch>(
+    parser_max_indexes_per_batch, parser_max_seqs_per_batch + 1
+  );
+  for (auto _ : state) {
+    auto parser = get_parser(format, filename);
+    for (bool more = true; more;) {
+      seq_statistics_batch->reset();
+      indexes_batch->reset();
+      while (
+        (more = parser->generate_batch(seq_statistics_batch, indexes_batch))
+        && indexes_batch->warped_indexes.size() < parser_max_indexes_per_batch
+        && seq_statistics_batch->found_idxs.size() < parser_max_seqs_per_batch
+      ) {}
+    }
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(
+    state.iterations() * std::filesystem::file_size(filename)
+  ));
+  std::filesystem::remove(filename);
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(benchmark_index_file_parser, ascii, IndexFileFormat::ascii)
+  ->Arg(1ULL << 22)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(benchmark_index_file_parser, binary, IndexFileFormat::binary)
+  ->Arg(1ULL << 22)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(
+  benchmark_index_file_parser, packedint, IndexFileFormat::packedint
+)
+  ->Arg(1ULL << 22)
+  ->Unit(benchmark::kMillisecond);
+
+}  // namespace sbwt_search
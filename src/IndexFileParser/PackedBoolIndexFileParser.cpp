@@ -0,0 +1,130 @@
+#include <bit>
+#include <ios>
+#include <stdexcept>
+
+#include "IndexFileParser/PackedBoolIndexFileParser.h"
+
+namespace sbwt_search {
+
+using std::bit_cast;
+using std::min;
+using std::runtime_error;
+
+PackedBoolIndexFileParser::PackedBoolIndexFileParser(
+  shared_ptr<ThrowingIfstream> in_stream_,
+  u64 max_indexes_,
+  u64 max_seqs_,
+  u64 warp_size_
+):
+    IndexFileParser(std::move(in_stream_), max_indexes_, max_seqs_, warp_size_),
+    block_header(packed_bool_header_elements) {
+  assert_version();
+}
+
+auto PackedBoolIndexFileParser::assert_version() -> void {
+  auto version = get_istream().read_string_with_size();
+  if (version != "v1.0") {
+    throw runtime_error("The file has an incompatible version number");
+  }
+}
+
+auto PackedBoolIndexFileParser::generate_batch(
+  shared_ptr<SeqStatisticsBatch> seq_statistics_batch_,
+  shared_ptr<IndexesBatch> indexes_batch_
+) -> bool {
+  IndexFileParser::generate_batch(
+    std::move(seq_statistics_batch_), std::move(indexes_batch_)
+  );
+  auto &seq_statistics_batch = *get_seq_statistics_batch();
+  const u64 initial_size = seq_statistics_batch.colored_seq_id.size();
+  while (get_num_seqs() < get_max_seqs()) {
+    if (segment_index == segments.size()) {
+      if (!load_block()) { break; }
+      continue;
+    }
+    const auto &counts = segments[segment_index];
+    seq_statistics_batch.found_idxs.back() += counts.found;
+    seq_statistics_batch.not_found_idxs.back() += counts.not_found;
+    seq_statistics_batch.invalid_idxs.back() += counts.invalid;
+    // the last segment of a block carries on in the next block
+    if (++segment_index < segments.size()) { end_seq(); }
+  }
+  add_warp_interval();
+  return seq_statistics_batch.colored_seq_id.size() > initial_size;
+}
+
+auto PackedBoolIndexFileParser::load_block() -> bool {
+  auto &in_stream = get_istream();
+  const u64 header_bytes = packed_bool_header_elements * sizeof(u64);
+  in_stream.read(
+    bit_cast<char *>(block_header.data()),
+    static_cast<std::streamsize>(header_bytes)
+  );
+  if (in_stream.gcount() == 0) { return false; }
+  const u64 block_bytes = block_header[packed_bool_status_bytes]
+    + block_header[packed_bool_table_bytes];
+  if (block.size() < block_bytes) { block.resize(block_bytes); }
+  in_stream.read(
+    bit_cast<char *>(block.data()), static_cast<std::streamsize>(block_bytes)
+  );
+  if (static_cast<u64>(in_stream.gcount()) != block_bytes) {
+    throw runtime_error("The packed bool file ended in the middle of a block");
+  }
+  decode_block();
+  return true;
+}
+
+auto PackedBoolIndexFileParser::decode_block() -> void {
+  const u64 status_bytes = block_header[packed_bool_status_bytes];
+  const u64 block_bytes = status_bytes + block_header[packed_bool_table_bytes];
+  const auto error
+    = runtime_error("The packed bool file has a block which is corrupt");
+  // every segment takes at least a byte of the length table
+  const u64 num_segments = block_header[packed_bool_seqs] + 1;
+  if (num_segments > block_header[packed_bool_table_bytes]) { throw error; }
+  segments.assign(num_segments, SegmentCounts());
+  segment_index = 0;
+  u64 table_index = status_bytes;
+  u64 byte_index = 0;
+  for (auto &counts : segments) {
+    if (table_index >= block_bytes) { throw error; }
+    u64 kmers_left = read_vlq(block.data(), table_index);
+    while (kmers_left > 0) {
+      if (byte_index >= status_bytes) { throw error; }
+      const u8 byte = block[byte_index++];
+      if ((byte & packed_bool_status_mask) == packed_bool_run) {
+        const u64 run = read_vlq(block.data(), byte_index);
+        add_status(
+          counts,
+          (byte >> packed_bool_status_bits) & packed_bool_status_mask,
+          run
+        );
+        kmers_left -= min(run, kmers_left);
+        continue;
+      }
+      const u64 statuses = min(packed_bool_statuses_per_byte, kmers_left);
+      for (u64 i = 0; i < statuses; ++i) {
+        add_status(
+          counts,
+          (byte >> (i * packed_bool_status_bits)) & packed_bool_status_mask,
+          1
+        );
+      }
+      kmers_left -= statuses;
+    }
+  }
+}
+
+auto PackedBoolIndexFileParser::add_status(
+  SegmentCounts &counts, u8 status, u64 amount
+) -> void {
+  if (status == packed_bool_found) {
+    counts.found += amount;
+  } else if (status == packed_bool_not_found) {
+    counts.not_found += amount;
+  } else {
+    counts.invalid += amount;
+  }
+}
+
+}  // namespace sbwt_search
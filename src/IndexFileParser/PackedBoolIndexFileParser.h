@@ -0,0 +1,61 @@
+#ifndef PACKED_BOOL_INDEX_FILE_PARSER_H
+#define PACKED_BOOL_INDEX_FILE_PARSER_H
+
+/**
+ * @file PackedBoolIndexFileParser.h
+ * @brief Index file parser for packed bool files. Since these files only keep
+ * whether each kmer was found, not found or invalid, no indexes are produced,
+ * and only the statistics of each seq are filled in. Each block is read with a
+ * single read call and decoded into the counts of each of its segments, which
+ * are then added to the batches one segment at a time.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "IndexFileParser/IndexFileParser.h"
+#include "IndexResultsPrinter/PackedBoolFormat.h"
+#include "Tools/IOUtils.h"
+
+namespace sbwt_search {
+
+using io_utils::ThrowingIfstream;
+using std::shared_ptr;
+using std::vector;
+
+class PackedBoolIndexFileParser: public IndexFileParser {
+private:
+  class SegmentCounts {
+  public:
+    u64 found = 0;
+    u64 not_found = 0;
+    u64 invalid = 0;
+  };
+
+  vector<u64> block_header;
+  vector<u8> block;
+  vector<SegmentCounts> segments;
+  u64 segment_index = 0;
+
+public:
+  PackedBoolIndexFileParser(
+    shared_ptr<ThrowingIfstream> in_stream_,
+    u64 max_indexes_,
+    u64 max_seqs_,
+    u64 warp_size_
+  );
+  auto generate_batch(
+    shared_ptr<SeqStatisticsBatch> seq_statistics_batch_,
+    shared_ptr<IndexesBatch> indexes_batch_
+  ) -> bool override;
+
+private:
+  auto assert_version() -> void;
+  auto load_block() -> bool;
+  auto decode_block() -> void;
+  static auto add_status(SegmentCounts &counts, u8 status, u64 amount) -> void;
+};
+
+}  // namespace sbwt_search
+
+#endif
@@ -0,0 +1,173 @@
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include "IndexFileParser/IndexFileParserTestUtils.h"
+#include "IndexFileParser/PackedBoolIndexFileParser.h"
+#include "Tools/IOUtils.h"
+
+namespace sbwt_search {
+
+using std::ios;
+using std::make_shared;
+using std::runtime_error;
+using std::filesystem::file_size;
+using std::filesystem::remove;
+
+class PackedBoolIndexFileParserTest: public ::testing::Test {
+private:
+  string temp_filename = "test_objects/tmp/PackedBoolIndexFileParserTest.pbool";
+
+protected:
+  auto get_temp_filename() -> const string & { return temp_filename; }
+  auto get_results_ints() -> vector<vector<int>> {
+    const vector<vector<int>> result = {
+      {-2, 39, 164, 216, 59, -1, -2},
+      {-2, -1, -1, -1, -1, -1, -2},
+      {1, 2, 3, 4},
+      {},
+      {0, 1, 2, 4, 5, 6},
+    };
+    return result;
+  }
+  auto run_test(
+    const vector<vector<int>> &results_ints,
+    u64 max_seqs,
+    u64 values_per_block,
+    bool run_length_encode,
+    const vector<vector<u64>> &expected_found_idxs,
+    const vector<vector<u64>> &expected_not_found_idxs,
+    const vector<vector<u64>> &expected_invalid_idxs
+  ) -> void {
+    const u64 max_indexes = 999;
+    const u64 warp_size = 4;
+    write_fake_packed_bool_results_to_file(
+      temp_filename, results_ints, values_per_block, run_length_encode
+    );
+    auto in_stream = make_shared<ThrowingIfstream>(temp_filename, ios::in);
+    auto format_name = in_stream->read_string_with_size();
+    ASSERT_EQ(format_name, "packedbool");
+    auto seq_statistics_batch = make_shared<SeqStatisticsBatch>();
+    auto indexes_batch = make_shared<IndexesBatch>(999, 999);
+    auto host
+      = PackedBoolIndexFileParser(in_stream, max_indexes, max_seqs, warp_size);
+    for (int i = 0; i < expected_found_idxs.size(); ++i) {
+      seq_statistics_batch->reset();
+      indexes_batch->reset();
+      host.generate_batch(seq_statistics_batch, indexes_batch);
+      EXPECT_EQ(seq_statistics_batch->found_idxs, expected_found_idxs[i])
+        << "with " << values_per_block << " values per block";
+      EXPECT_EQ(
+        seq_statistics_batch->not_found_idxs, expected_not_found_idxs[i]
+      );
+      EXPECT_EQ(seq_statistics_batch->invalid_idxs, expected_invalid_idxs[i]);
+      // the statuses carry no indexes, so there is nothing to color
+      EXPECT_EQ(indexes_batch->warped_indexes.size(), 0);
+      EXPECT_EQ(
+        seq_statistics_batch->colored_seq_id,
+        vector<u64>(expected_found_idxs[i].size(), 0)
+      );
+    }
+    seq_statistics_batch->reset();
+    indexes_batch->reset();
+    ASSERT_FALSE(host.generate_batch(seq_statistics_batch, indexes_batch));
+    remove(temp_filename);
+  }
+};
+
+TEST_F(PackedBoolIndexFileParserTest, OneBatch) {
+  const u64 max_seqs = 999;
+  const vector<vector<u64>> expected_found_idxs = {{4, 0, 4, 0, 6, 0}};
+  const vector<vector<u64>> expected_not_found_idxs = {{1, 5, 0, 0, 0, 0}};
+  const vector<vector<u64>> expected_invalid_idxs = {{2, 2, 0, 0, 0, 0}};
+  // 8 values make up the first seq and 29 make up the whole file
+  for (auto values_per_block : {1, 2, 3, 7, 8, 9, 29, 999}) {
+    run_test(
+      get_results_ints(),
+      max_seqs,
+      values_per_block,
+      false,
+      expected_found_idxs,
+      expected_not_found_idxs,
+      expected_invalid_idxs
+    );
+  }
+}
+
+TEST_F(PackedBoolIndexFileParserTest, MaxSeqs) {
+  const u64 max_seqs = 4;
+  const vector<vector<u64>> expected_found_idxs = {{4, 0, 4, 0}, {0, 6, 0}};
+  const vector<vector<u64>> expected_not_found_idxs = {{1, 5, 0, 0}, {0, 0, 0}};
+  const vector<vector<u64>> expected_invalid_idxs = {{2, 2, 0, 0}, {0, 0, 0}};
+  for (auto values_per_block : {1, 2, 3, 7, 8, 9, 29, 999}) {
+    run_test(
+      get_results_ints(),
+      max_seqs,
+      values_per_block,
+      false,
+      expected_found_idxs,
+      expected_not_found_idxs,
+      expected_invalid_idxs
+    );
+  }
+}
+
+TEST_F(PackedBoolIndexFileParserTest, RunLengthEncoded) {
+  const u64 max_seqs = 999;
+  const u64 long_run = 1000;
+  vector<vector<int>> results_ints = {{}, {}, {1, 2}};
+  results_ints[0].insert(results_ints[0].end(), long_run, 5);
+  results_ints[0].insert(results_ints[0].end(), long_run, -1);
+  results_ints[0].push_back(-2);
+  results_ints[1].insert(results_ints[1].end(), long_run, -2);
+  const vector<vector<u64>> expected_found_idxs = {{long_run, 0, 2, 0}};
+  const vector<vector<u64>> expected_not_found_idxs = {{long_run, 0, 0, 0}};
+  const vector<vector<u64>> expected_invalid_idxs = {{1, long_run, 0, 0}};
+  for (auto values_per_block : {1, 3, 70, 999, 5000}) {
+    for (auto run_length_encode : {false, true}) {
+      run_test(
+        results_ints,
+        max_seqs,
+        values_per_block,
+        run_length_encode,
+        expected_found_idxs,
+        expected_not_found_idxs,
+        expected_invalid_idxs
+      );
+    }
+  }
+  write_fake_packed_bool_results_to_file(
+    get_temp_filename(), results_ints, long_run * 4, false
+  );
+  const u64 packed_size = file_size(get_temp_filename());
+  write_fake_packed_bool_results_to_file(
+    get_temp_filename(), results_ints, long_run * 4, true
+  );
+  const u64 run_length_encoded_size = file_size(get_temp_filename());
+  EXPECT_LT(run_length_encoded_size * 5, packed_size);
+  remove(get_temp_filename());
+}
+
+TEST_F(PackedBoolIndexFileParserTest, Truncated) {
+  write_fake_packed_bool_results_to_file(
+    get_temp_filename(), get_results_ints(), 999, false
+  );
+  std::filesystem::resize_file(
+    get_temp_filename(), file_size(get_temp_filename()) - 1
+  );
+  auto in_stream = make_shared<ThrowingIfstream>(get_temp_filename(), ios::in);
+  in_stream->read_string_with_size();
+  auto seq_statistics_batch = make_shared<SeqStatisticsBatch>();
+  auto indexes_batch = make_shared<IndexesBatch>(999, 999);
+  seq_statistics_batch->reset();
+  indexes_batch->reset();
+  auto host = PackedBoolIndexFileParser(in_stream, 999, 999, 4);
+  ASSERT_THROW(
+    host.generate_batch(seq_statistics_batch, indexes_batch), runtime_error
+  );
+  remove(get_temp_filename());
+}
+
+}  // namespace sbwt_search
@@ -16,7 +16,9 @@ AsciiContinuousIndexResultsPrinter::AsciiContinuousIndexResultsPrinter(
   u64 threads,
   u64 max_chars_per_batch,
   u64 max_seqs_per_batch,
+  u64 write_buffer_slots,
   bool write_headers,
+  bool gzip_output,
   u64 max_index
 ):
     Base(
@@ -29,9 +31,11 @@ AsciiContinuousIndexResultsPrinter::AsciiContinuousIndexResultsPrinter(
       threads,
       max_chars_per_batch,
       max_seqs_per_batch,
+      write_buffer_slots,
       get_bits_per_element(max_index) / bits_in_byte,
       0,
-      write_headers
+      write_headers,
+      gzip_output
     ) {}
 
 auto AsciiContinuousIndexResultsPrinter::get_bits_per_element(u64 max_index)
@@ -35,7 +35,9 @@ public:
     u64 threads,
     u64 max_chars_per_batch,
     u64 max_seqs_per_batch,
+    u64 write_buffer_slots,
     bool write_headers,
+    bool gzip_output,
     u64 max_index
   );
 
@@ -0,0 +1,181 @@
+#include <bit>
+
+#include "IndexResultsPrinter/BlockedBinaryContinuousIndexResultsPrinter.h"
+
+namespace sbwt_search {
+
+using std::bit_cast;
+
+BlockedBinaryContinuousIndexResultsPrinter::
+  BlockedBinaryContinuousIndexResultsPrinter(
+    u64 stream_id,
+    shared_ptr<SharedBatchesProducer<ResultsBatch>> results_producer,
+    shared_ptr<SharedBatchesProducer<IntervalBatch>> interval_producer,
+    shared_ptr<SharedBatchesProducer<InvalidCharsBatch>> invalid_chars_producer,
+    vector<string> filenames,
+    u64 kmer_size,
+    u64 threads,
+    u64 max_chars_per_batch,
+    u64 max_seqs_per_batch,
+    u64 write_buffer_slots,
+    bool write_headers,
+    bool gzip_output
+  ):
+    Base(
+      stream_id,
+      std::move(results_producer),
+      std::move(interval_producer),
+      std::move(invalid_chars_producer),
+      std::move(filenames),
+      kmer_size,
+      threads,
+      max_chars_per_batch,
+      max_seqs_per_batch,
+      write_buffer_slots,
+      1,
+      1,
+      write_headers,
+      gzip_output
+    ) {}
+
+auto BlockedBinaryContinuousIndexResultsPrinter::get_bits_per_element() -> u64 {
+  return u64_bits;
+}
+
+auto BlockedBinaryContinuousIndexResultsPrinter::get_bits_per_seq() -> u64 {
+  return u64_bits;
+}
+
+auto BlockedBinaryContinuousIndexResultsPrinter::do_get_extension() -> string {
+  return ".bbin";
+}
+auto BlockedBinaryContinuousIndexResultsPrinter::do_get_format() -> string {
+  return "blockedbinary";
+}
+auto BlockedBinaryContinuousIndexResultsPrinter::do_get_version() -> string {
+  return "v1.0";
+}
+
+auto BlockedBinaryContinuousIndexResultsPrinter::do_allocate_buffer(
+  vector<u64> &buffer,
+  u64 max_chars_per_batch,
+  u64 max_seqs_per_batch,
+  u64 threads,
+  u64 element_size,
+  u64 newline_element_size
+) -> void {
+  Base::do_allocate_buffer(
+    buffer,
+    max_chars_per_batch,
+    max_seqs_per_batch,
+    threads,
+    element_size,
+    newline_element_size
+  );
+  buffer.resize(buffer.size() + block_header_elements);
+}
+
+auto BlockedBinaryContinuousIndexResultsPrinter::do_open_next_file(
+  const string &filename
+) -> void {
+  Base::do_open_next_file(filename);
+  block_index.clear();
+  file_offset = 0;
+  seqs_before_block = 0;
+}
+
+auto BlockedBinaryContinuousIndexResultsPrinter::do_write_file_header()
+  -> void {
+  Base::do_write_file_header();
+  file_offset = sizeof(u64) + do_get_format().size() + sizeof(u64)
+    + do_get_version().size();
+}
+
+auto BlockedBinaryContinuousIndexResultsPrinter::do_at_buffer_start(
+  // NOLINTNEXTLINE (misc-unused-parameters)
+  vector<u64> &buffer
+) const -> u64 {
+  return block_header_elements;
+}
+
+auto BlockedBinaryContinuousIndexResultsPrinter::do_at_buffer_end(
+  vector<u64> &buffer, u64 size
+) const -> u64 {
+  if (size == block_header_elements) { return 0; }
+  u64 seqs = 0, not_found = 0, invalid = 0;
+  for (u64 i = block_header_elements; i < size; ++i) {
+    seqs += static_cast<u64>(buffer[i] == minus3);
+    not_found += static_cast<u64>(buffer[i] == minus1);
+    invalid += static_cast<u64>(buffer[i] == minus2);
+  }
+  const u64 kmers = size - block_header_elements - seqs;
+  buffer[block_payload_bytes] = (size - block_header_elements) * sizeof(u64);
+  buffer[block_seqs] = seqs;
+  buffer[block_kmers] = kmers;
+  buffer[block_found] = kmers - not_found - invalid;
+  buffer[block_not_found] = not_found;
+  buffer[block_invalid] = invalid;
+  return size;
+}
+
+auto BlockedBinaryContinuousIndexResultsPrinter::do_at_slot_filled(
+  const AsyncBufferWriter<u64>::Slot &slot
+) -> void {
+  for (u64 i = 0; i < slot.buffers.size(); ++i) {
+    if (slot.sizes[i] == 0) { continue; }
+    block_index.push_back({file_offset, seqs_before_block});
+    file_offset += slot.sizes[i] * sizeof(u64);
+    seqs_before_block += slot.buffers[i][block_seqs];
+  }
+}
+
+auto BlockedBinaryContinuousIndexResultsPrinter::do_at_file_end(
+  ThrowingOfstream &out_stream
+) -> void {
+  vector<u64> footer;
+  footer.reserve(
+    1 + block_index.size() * blocked_footer_entry_elements
+    + blocked_footer_trailer_elements
+  );
+  footer.push_back(blocked_footer_marker);
+  for (const auto &entry : block_index) {
+    footer.push_back(entry.offset);
+    footer.push_back(entry.first_seq);
+  }
+  footer.push_back(block_index.size());
+  footer.push_back(file_offset);
+  out_stream.write(
+    bit_cast<char *>(footer.data()),
+    static_cast<std::streamsize>(footer.size() * sizeof(u64))
+  );
+}
+
+auto BlockedBinaryContinuousIndexResultsPrinter::do_with_result(
+  vector<u64>::iterator buffer, u64 result
+) const -> u64 {
+  *buffer = result;
+  return 1;
+}
+
+auto BlockedBinaryContinuousIndexResultsPrinter::do_with_not_found(
+  vector<u64>::iterator buffer
+) const -> u64 {
+  *buffer = minus1;
+  return 1;
+}
+
+auto BlockedBinaryContinuousIndexResultsPrinter::do_with_invalid(
+  vector<u64>::iterator buffer
+) const -> u64 {
+  *buffer = minus2;
+  return 1;
+}
+
+auto BlockedBinaryContinuousIndexResultsPrinter::do_with_newline(
+  vector<u64>::iterator buffer
+) const -> u64 {
+  *buffer = minus3;
+  return 1;
+}
+
+}  // namespace sbwt_search
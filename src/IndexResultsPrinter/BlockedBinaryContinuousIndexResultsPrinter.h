@@ -0,0 +1,88 @@
+#ifndef BLOCKED_BINARY_CONTINUOUS_INDEX_RESULTS_PRINTER_H
+#define BLOCKED_BINARY_CONTINUOUS_INDEX_RESULTS_PRINTER_H
+
+/**
+ * @file BlockedBinaryContinuousIndexResultsPrinter.h
+ * @brief Inherits ContinuousIndexResultsPrinter and prints out the same binary
+ * values as the BinaryContinuousIndexResultsPrinter, but split into blocks
+ * which each start with a header of counts, followed by a footer which indexes
+ * the blocks. Each buffer filled by a thread becomes its own block, so the
+ * counts are gathered in parallel, and the size of a block is bounded by the
+ * batch size divided by the number of threads. The layout is described in
+ * BlockedBinaryFormat.h.
+ */
+
+#include "IndexResultsPrinter/BlockedBinaryFormat.h"
+#include "IndexResultsPrinter/ContinuousIndexResultsPrinter.hpp"
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+class BlockedBinaryContinuousIndexResultsPrinter:
+    public ContinuousIndexResultsPrinter<
+      BlockedBinaryContinuousIndexResultsPrinter,
+      u64> {
+  using Base = ContinuousIndexResultsPrinter<
+    BlockedBinaryContinuousIndexResultsPrinter,
+    u64>;
+  friend Base;
+
+private:
+  u64 minus1 = static_cast<u64>(-1), minus2 = static_cast<u64>(-2),
+      minus3 = static_cast<u64>(-3);
+  vector<BlockIndexEntry> block_index;
+  // byte position in the current file at which the next block starts
+  u64 file_offset = 0;
+  u64 seqs_before_block = 0;
+
+public:
+  BlockedBinaryContinuousIndexResultsPrinter(
+    u64 stream_id,
+    shared_ptr<SharedBatchesProducer<ResultsBatch>> results_producer,
+    shared_ptr<SharedBatchesProducer<IntervalBatch>> interval_producer,
+    shared_ptr<SharedBatchesProducer<InvalidCharsBatch>> invalid_chars_producer,
+    vector<string> filenames,
+    u64 kmer_size,
+    u64 threads,
+    u64 max_chars_per_batch,
+    u64 max_seqs_per_batch,
+    u64 write_buffer_slots,
+    bool write_headers,
+    bool gzip_output
+  );
+
+  auto static get_bits_per_element() -> u64;
+  auto static get_bits_per_seq() -> u64;
+
+protected:
+  auto do_get_extension() -> string;
+  auto do_get_format() -> string;
+  auto do_get_version() -> string;
+
+  auto do_allocate_buffer(
+    vector<u64> &buffer,
+    u64 max_chars_per_batch,
+    u64 max_seqs_per_batch,
+    u64 threads,
+    u64 element_size,
+    u64 newline_element_size
+  ) -> void;
+  auto do_open_next_file(const string &filename) -> void;
+  auto do_write_file_header() -> void;
+
+  [[nodiscard]] auto do_at_buffer_start(vector<u64> &buffer) const -> u64;
+  auto do_at_buffer_end(vector<u64> &buffer, u64 size) const -> u64;
+  auto do_at_slot_filled(const AsyncBufferWriter<u64>::Slot &slot) -> void;
+  auto do_at_file_end(ThrowingOfstream &out_stream) -> void;
+
+  [[nodiscard]] auto
+  do_with_result(vector<u64>::iterator buffer, u64 result) const -> u64;
+  [[nodiscard]] auto do_with_not_found(vector<u64>::iterator buffer) const
+    -> u64;
+  [[nodiscard]] auto do_with_invalid(vector<u64>::iterator buffer) const -> u64;
+  [[nodiscard]] auto do_with_newline(vector<u64>::iterator buffer) const -> u64;
+};
+
+}  // namespace sbwt_search
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef BLOCKED_BINARY_FORMAT_H
+#define BLOCKED_BINARY_FORMAT_H
+
+/**
+ * @file BlockedBinaryFormat.h
+ * @brief Layout of the blocked binary index results format, shared by the
+ * printer which writes it and the parser which reads it. After the usual format
+ * and version headers, the file is a list of blocks followed by a footer. Every
+ * block starts with a header of block_header_elements u64s: the size of its
+ * payload in bytes, the number of seqs which end within the block, the number
+ * of kmers in it, and how many of those are found, not found and invalid. The
+ * payload uses the same values as the binary format, so indexes are plain u64s,
+ * not-found kmers are max_u64, invalid ones are max_u64-1 and the end of each
+ * seq is max_u64-2. A seq may start in one block and end in a later one. The
+ * footer starts with the blocked_footer_marker, followed by an offset and first
+ * seq pair for each block, where the offset is the byte position of the block
+ * header within the (decompressed) file and the first seq is the number of seqs
+ * which ended before the block. The last two u64s of the file are the number of
+ * blocks and the byte position of the footer, so that the index can be found by
+ * reading the end of the file.
+ */
+
+#include <limits>
+
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+// The position of each field within a block header
+enum BlockHeaderField : u64 {
+  block_payload_bytes,
+  block_seqs,
+  block_kmers,
+  block_found,
+  block_not_found,
+  block_invalid,
+  block_header_elements
+};
+
+// The payload of a block can never be this large, so the footer is never
+// mistaken for a block header
+const u64 blocked_footer_marker = std::numeric_limits<u64>::max();
+const u64 blocked_footer_entry_elements = 2;
+const u64 blocked_footer_trailer_elements = 2;
+
+class BlockIndexEntry {
+public:
+  u64 offset;
+  u64 first_seq;
+};
+
+}  // namespace sbwt_search
+
+#endif
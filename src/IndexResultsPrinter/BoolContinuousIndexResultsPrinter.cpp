@@ -15,7 +15,9 @@ BoolContinuousIndexResultsPrinter::BoolContinuousIndexResultsPrinter(
   u64 threads,
   u64 max_chars_per_batch,
   u64 max_seqs_per_batch,
-  bool write_headers
+  u64 write_buffer_slots,
+  bool write_headers,
+  bool gzip_output
 ):
     Base(
       stream_id,
@@ -27,9 +29,11 @@ BoolContinuousIndexResultsPrinter::BoolContinuousIndexResultsPrinter(
       threads,
       max_chars_per_batch,
       max_seqs_per_batch,
+      write_buffer_slots,
       1,
       1,
-      write_headers
+      write_headers,
+      gzip_output
     ) {}
 
 auto BoolContinuousIndexResultsPrinter::get_bits_per_element() -> u64 {
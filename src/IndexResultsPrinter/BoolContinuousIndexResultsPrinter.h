@@ -34,7 +34,9 @@ public:
     u64 threads,
     u64 max_chars_per_batch,
     u64 max_seqs_per_batch,
-    bool write_headers
+    u64 write_buffer_slots,
+    bool write_headers,
+    bool gzip_output
   );
 
   auto static get_bits_per_element() -> u64;
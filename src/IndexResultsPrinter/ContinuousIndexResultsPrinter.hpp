@@ -11,25 +11,34 @@
  * to be efficient and highly parallel. All the variable names are also super
  * long, and then I tried to give them some short name but it still ended up
  * seeming obscure. I tried my best to make it as easy to understand as
- * possible, but good luck!
+ * possible, but good luck! When the reads were deduplicated, the results and
+ * invalid characters of the unique seqs are first expanded in place back to
+ * the original seqs, after which printing carries on as usual. The buffers
+ * are taken from the pool of an AsyncBufferWriter, which writes them to disk
+ * on its own thread while the next batch is being formatted. With gzip
+ * output, each thread compresses its own buffer into a separate gzip member.
+ * If the invalid chars batches are empty, the searcher has already marked the
+ * invalid k-mers in the results, so the characters are not looked at at all.
  */
 
 #include <algorithm>
-#include <bit>
 #include <cmath>
-#include <functional>
 #include <iterator>
 #include <memory>
 
 #include "BatchObjects/IntervalBatch.h"
 #include "BatchObjects/InvalidCharsBatch.h"
 #include "BatchObjects/ResultsBatch.h"
+#include "Checkpointer/Checkpointer.h"
+#include "ReadDeduplicator/ReadDeduplicator.h"
+#include "Tools/AsyncBufferWriter.hpp"
 #include "Tools/IOUtils.h"
 #include "Tools/Logger.h"
 #include "Tools/MathUtils.hpp"
-#include "Tools/OmpLock.h"
+#include "Tools/PipelineProfiler.h"
 #include "Tools/SharedBatchesProducer.hpp"
 #include "Tools/StdUtils.hpp"
+#include "Tools/TaskScheduler.h"
 #include "Tools/TypeDefinitions.h"
 #include "fmt/core.h"
 
@@ -37,11 +46,13 @@ namespace sbwt_search {
 
 using design_utils::SharedBatchesProducer;
 using fmt::format;
+using io_utils::AsyncBufferWriter;
+using io_utils::is_standard_stream;
 using io_utils::ThrowingOfstream;
 using log_utils::Logger;
+using log_utils::PipelineProfiler;
 using math_utils::divide_and_ceil;
 using math_utils::round_up;
-using std::bit_cast;
 using std::ceil;
 using std::ios;
 using std::make_unique;
@@ -51,13 +62,13 @@ using std::numeric_limits;
 using std::shared_ptr;
 using std::unique_ptr;
 using std_utils::copy_advance;
-using threading_utils::OmpLock;
+using threading_utils::TaskScheduler;
 
 template <class TImplementation, class Buffer_t>
 class ContinuousIndexResultsPrinter {
 private:
   vector<u64> results_before_newline{};
-  vector<OmpLock> write_locks{};
+  vector<u64> unique_results_before_newline{};
   auto impl() -> TImplementation & {
     return static_cast<TImplementation &>(*this);
   }
@@ -70,11 +81,16 @@ private:
   shared_ptr<InvalidCharsBatch> invalid_chars_batch;
   shared_ptr<IntervalBatch> interval_batch;
   unique_ptr<ThrowingOfstream> out_stream;
-  vector<vector<Buffer_t>> buffers;
+  // The first buffer of each slot holds the newlines at the start of a file
+  // and the rest hold the output of each thread
+  unique_ptr<AsyncBufferWriter<Buffer_t>> writer;
   u64 kmer_size;
   u64 threads;
   u64 stream_id;
+  u64 batch_id = 0;
   bool write_headers;
+  bool gzip_output;
+  shared_ptr<Checkpointer> checkpointer;
 
 public:
   ContinuousIndexResultsPrinter(
@@ -88,9 +104,11 @@ public:
     u64 threads_,
     u64 max_chars_per_batch,
     u64 max_seqs_per_batch,
+    u64 write_buffer_slots,
     u64 element_size,
     u64 newline_element_size,
-    bool write_headers_
+    bool write_headers_,
+    bool gzip_output_
   ):
       results_producer(std::move(results_producer_)),
       interval_producer(std::move(interval_producer_)),
@@ -98,27 +116,44 @@ public:
       filenames(std::move(filenames_)),
       threads(threads_),
       kmer_size(kmer_size),
-      write_locks(threads_ - 1),
       stream_id(stream_id_),
-      buffers(threads_),
-      write_headers(write_headers_) {
-    for (auto &b : buffers) {
-      impl().do_allocate_buffer(
-        b,
-        max_chars_per_batch,
-        max_seqs_per_batch,
-        threads,
-        element_size,
-        newline_element_size
-      );
+      writer(make_unique<AsyncBufferWriter<Buffer_t>>(
+        format("ResultsWriter_{}", stream_id_),
+        write_buffer_slots,
+        threads_ + 1,
+        gzip_output_
+      )),
+      write_headers(write_headers_),
+      gzip_output(gzip_output_) {
+    PipelineProfiler::add_queue(
+      format("ResultsWriter_{}", stream_id),
+      format("ResultsPrinter_{}", stream_id),
+      format("ResultsWriter_{}", stream_id)
+    );
+    for (auto &slot : writer->get_slots()) {
+      for (auto &b : slot.buffers) {
+        impl().do_allocate_buffer(
+          b,
+          max_chars_per_batch,
+          max_seqs_per_batch,
+          threads,
+          element_size,
+          newline_element_size
+        );
+      }
     }
   }
 
+  // The output files are recorded in the checkpoint once they are complete
+  auto set_checkpointer(shared_ptr<Checkpointer> checkpointer_) -> void {
+    checkpointer = std::move(checkpointer_);
+  }
+
   auto read_and_generate() -> void {
     current_filename = filenames.begin();
     if (current_filename == filenames.end()) { return; }
     impl().do_start_next_file();
-    for (u64 batch_id = 0; get_batch(); ++batch_id) {
+    for (batch_id = 0; get_batch(); ++batch_id) {
       Logger::log_timed_event(
         format("ResultsPrinter_{}", stream_id),
         Logger::EVENT_STATE::START,
@@ -131,10 +166,21 @@ public:
         format("batch {}", batch_id)
       );
     }
-    impl().do_at_file_end();
+    writer->wait_until_written();
+    impl().do_at_file_end(*out_stream);
+    checkpoint_file();
+    writer->log_statistics();
   }
 
 private:
+  // The file is closed before it is recorded, so that everything in it has
+  // been written by then
+  auto checkpoint_file() -> void {
+    if (checkpointer == nullptr) { return; }
+    out_stream.reset();
+    checkpointer->mark_complete(stream_id, *std::prev(current_filename));
+  }
+
   auto get_batch() -> bool {
     return (static_cast<u64>(*interval_producer >> interval_batch)
             & static_cast<u64>(*invalid_chars_producer >> invalid_chars_batch)
@@ -144,7 +190,10 @@ private:
 
   // NOLINTNEXTLINE(readability-function-cognitive-complexity)
   auto process_batch() -> void {
-    populate_results_before_newline();
+    if (interval_batch->unique_seq_indexes != nullptr) { expand_duplicates(); }
+    populate_results_before_newline(
+      *interval_batch->chars_before_new_seq, results_before_newline
+    );
     const auto &results = results_batch->results;
     const auto &invalid_chars = invalid_chars_batch->invalid_chars;
     const auto &nlbnfs = interval_batch->seqs_before_newfile;
@@ -161,78 +210,130 @@ private:
       }
       u64 results_in_file = last_results_idx - first_results_idx;
       u64 rbnl_idx = nlbnf_idx > 0 ? nlbnfs[nlbnf_idx - 1] : 0;
-      dump_starting_newlines(first_results_idx, rbnl_idx, nlbnf_idx);
-#pragma omp parallel num_threads(threads)
-      {
-        u64 thread_idx = omp_get_thread_num();
-        if (!write_locks.empty() && thread_idx < buffers.size() - 1) {
-          write_locks[thread_idx].set_lock();
-        }
-#pragma omp barrier
-
-        auto &buffer = buffers[thread_idx];
-        buffer.resize(buffer.capacity());
-        u64 buffer_idx = 0;
-        u64 start_idx = static_cast<u64>(round(
-          (static_cast<double>(results_in_file)
-           / static_cast<double>(buffers.size()))
-          * static_cast<double>(thread_idx)
-        ));
-        u64 end_idx = min(
-          results_in_file,
-          static_cast<u64>(round(
+      auto &slot = writer->acquire(batch_id);
+      dump_starting_newlines(slot, first_results_idx, rbnl_idx, nlbnf_idx);
+      TaskScheduler::get_global().parallel_for(
+        threads,
+        [&](u64 thread_idx) {
+          auto &buffer = slot.buffers[thread_idx + 1];
+          u64 buffer_idx = impl().do_at_buffer_start(buffer);
+          u64 start_idx = static_cast<u64>(round(
             (static_cast<double>(results_in_file)
-             / static_cast<double>(buffers.size()))
-            * static_cast<double>(thread_idx + 1)
-          ))
-        );
-        u64 result_idx = first_results_idx + start_idx;
-        u64 bnl_idx = std::upper_bound(rbnls.begin(), rbnls.end(), result_idx)
-          - rbnls.begin();
-        u64 char_idx = static_cast<u64>(bnl_idx > 0)
-            * (cbnls[bnl_idx - 1] - rbnls[bnl_idx - 1])
-          + first_results_idx + start_idx;
+             / static_cast<double>(threads))
+            * static_cast<double>(thread_idx)
+          ));
+          u64 end_idx = min(
+            results_in_file,
+            static_cast<u64>(round(
+              (static_cast<double>(results_in_file)
+               / static_cast<double>(threads))
+              * static_cast<double>(thread_idx + 1)
+            ))
+          );
+          u64 result_idx = first_results_idx + start_idx;
+          u64 bnl_idx
+            = std::upper_bound(rbnls.begin(), rbnls.end(), result_idx)
+            - rbnls.begin();
+          if (invalid_chars.empty()) {
+            format_results_only(
+              buffer,
+              buffer_idx,
+              result_idx,
+              end_idx - start_idx,
+              bnl_idx,
+              nlbnf
+            );
+          } else {
+            u64 char_idx = static_cast<u64>(bnl_idx > 0)
+                * (cbnls[bnl_idx - 1] - rbnls[bnl_idx - 1])
+              + first_results_idx + start_idx;
 
-        u64 invalid_chars_left
-          = get_invalid_chars_left_first_kmer(char_idx, cbnls[bnl_idx]);
+            u64 invalid_chars_left
+              = get_invalid_chars_left_first_kmer(char_idx, cbnls[bnl_idx]);
 
-        for (u64 i = start_idx; i < end_idx; ++i, ++result_idx) {
-          if (invalid_chars[char_idx + kmer_size - 1] == 1) {
-            invalid_chars_left = kmer_size;
-          }
-          add_new_result(
-            buffer, invalid_chars_left, buffer_idx, results[result_idx]
-          );
-          bool newline = false;
-          while (result_idx + 1 == rbnls[bnl_idx] && bnl_idx < nlbnf) {
-            newline = true;
-            buffer_idx
-              += impl().do_with_newline(copy_advance(buffer.begin(), buffer_idx)
+            for (u64 i = start_idx; i < end_idx; ++i, ++result_idx) {
+              if (invalid_chars[char_idx + kmer_size - 1] == 1) {
+                invalid_chars_left = kmer_size;
+              }
+              add_new_result(
+                buffer, invalid_chars_left, buffer_idx, results[result_idx]
               );
-            ++bnl_idx;
-          }
-          if (newline) {
-            char_idx = cbnls[bnl_idx - 1];
-            invalid_chars_left
-              = get_invalid_chars_left_first_kmer(char_idx, cbnls[bnl_idx]);
-          } else {
-            ++char_idx;
-            buffer_idx
-              += impl().do_with_space(copy_advance(buffer.begin(), buffer_idx));
+              bool newline = false;
+              while (result_idx + 1 == rbnls[bnl_idx] && bnl_idx < nlbnf) {
+                newline = true;
+                buffer_idx += impl().do_with_newline(
+                  copy_advance(buffer.begin(), buffer_idx)
+                );
+                ++bnl_idx;
+              }
+              if (newline) {
+                char_idx = cbnls[bnl_idx - 1];
+                invalid_chars_left = get_invalid_chars_left_first_kmer(
+                  char_idx, cbnls[bnl_idx]
+                );
+              } else {
+                ++char_idx;
+                buffer_idx += impl().do_with_space(
+                  copy_advance(buffer.begin(), buffer_idx)
+                );
+              }
+            }
           }
+          slot.sizes[thread_idx + 1]
+            = impl().do_at_buffer_end(buffer, buffer_idx);
+          writer->finish_buffer(slot, thread_idx + 1);
         }
-        buffer.resize(static_cast<std::streamsize>(buffer_idx));
-        write_buffers_parallel();
-      }
-      impl().do_at_file_end();
+      );
+      impl().do_at_slot_filled(slot);
+      writer->submit(*out_stream);
       prev_last_results_idx = last_results_idx;
       if (nlbnf_idx + 1 < nlbnfs.size()) { do_start_next_file(); }
     }
   }
 
-  auto populate_results_before_newline() -> void {
-    const auto &cbnl = *interval_batch->chars_before_new_seq;
-    auto &rbnl = results_before_newline;
+  auto expand_duplicates() -> void {
+    const auto &cbnls = *interval_batch->chars_before_new_seq;
+    const auto &unique_cbnls = *interval_batch->unique_chars_before_new_seq;
+    const auto &unique_seq_indexes = *interval_batch->unique_seq_indexes;
+    auto &invalid_chars = invalid_chars_batch->invalid_chars;
+    // when the invalid k-mers are marked in the results, there are no invalid
+    // characters to expand
+    if (!invalid_chars.empty()) {
+      const u64 unique_chars = invalid_chars.size() - kmer_size;
+      const u64 chars = ReadDeduplicator::get_original_size(
+        cbnls, unique_cbnls, unique_chars
+      );
+      invalid_chars.resize(chars + kmer_size);
+      ReadDeduplicator::expand(
+        invalid_chars.data(),
+        cbnls,
+        unique_cbnls,
+        unique_seq_indexes,
+        unique_chars
+      );
+      std::fill(next(invalid_chars.begin(), chars), invalid_chars.end(), 0);
+    }
+    populate_results_before_newline(cbnls, results_before_newline);
+    populate_results_before_newline(
+      unique_cbnls, unique_results_before_newline
+    );
+    auto &results = results_batch->results;
+    const u64 unique_results = results.size();
+    results.resize(ReadDeduplicator::get_original_size(
+      results_before_newline, unique_results_before_newline, unique_results
+    ));
+    ReadDeduplicator::expand(
+      results.data(),
+      results_before_newline,
+      unique_results_before_newline,
+      unique_seq_indexes,
+      unique_results
+    );
+  }
+
+  auto populate_results_before_newline(
+    const vector<u64> &cbnl, vector<u64> &rbnl
+  ) -> void {
     rbnl.resize(cbnl.size());
     u64 last_rbnl = 0;
     u64 last_cbnl = 0;
@@ -248,11 +349,14 @@ private:
     rbnl.back() = cbnl.back();
   }
 
-  auto dump_starting_newlines(u64 res_idx, u64 &rbnl_idx, u64 nlbnf_idx)
-    -> void {
-    u64 buffer_idx = 0;
-    auto &buffer = buffers[0];
-    buffer.resize(buffer.capacity());
+  auto dump_starting_newlines(
+    typename AsyncBufferWriter<Buffer_t>::Slot &slot,
+    u64 res_idx,
+    u64 &rbnl_idx,
+    u64 nlbnf_idx
+  ) -> void {
+    auto &buffer = slot.buffers[0];
+    u64 buffer_idx = impl().do_at_buffer_start(buffer);
     const auto &nlbnfs = interval_batch->seqs_before_newfile;
     const auto &rbnls = results_before_newline;
     while (rbnls[rbnl_idx] == res_idx && rbnl_idx < nlbnfs[nlbnf_idx]) {
@@ -260,7 +364,8 @@ private:
         += impl().do_with_newline(copy_advance(buffer.begin(), buffer_idx));
       ++rbnl_idx;
     }
-    impl().do_write_buffer(buffer, buffer_idx);
+    slot.sizes[0] = impl().do_at_buffer_end(buffer, buffer_idx);
+    writer->finish_buffer(slot, 0);
   }
 
   auto get_invalid_chars_left_first_kmer(u64 char_idx, u64 chars_before_newline)
@@ -275,17 +380,6 @@ private:
     return 0;
   }
 
-  auto write_buffers_parallel() -> void {
-    u64 thread_idx = omp_get_thread_num();
-    auto &buffer = buffers[thread_idx];
-    if (thread_idx > 0) { write_locks[thread_idx - 1].set_lock(); }
-    impl().do_write_buffer(buffer, buffer.size());
-    if (thread_idx > 0) { write_locks[thread_idx - 1].unset_lock(); }
-    if (thread_idx < write_locks.size()) {
-      write_locks[thread_idx].unset_lock();
-    }
-  }
-
   auto add_new_result(
     vector<Buffer_t> &buffer,
     u64 &invalid_chars_left,
@@ -307,6 +401,41 @@ private:
     }
   }
 
+  // Used when the searcher has already given the invalid k-mers the
+  // invalid_kmer_result, so that only the results need to be looked at
+  auto format_results_only(
+    vector<Buffer_t> &buffer,
+    u64 &buffer_idx,
+    u64 result_idx,
+    u64 num_results,
+    u64 bnl_idx,
+    u64 nlbnf
+  ) -> void {
+    const auto &results = results_batch->results;
+    const auto &rbnls = results_before_newline;
+    for (u64 i = 0; i < num_results; ++i, ++result_idx) {
+      const u64 result = results[result_idx];
+      auto position = copy_advance(buffer.begin(), buffer_idx);
+      if (result == invalid_kmer_result) {
+        buffer_idx += impl().do_with_invalid(position);
+      } else if (result == numeric_limits<u64>::max()) {
+        buffer_idx += impl().do_with_not_found(position);
+      } else {
+        buffer_idx += impl().do_with_result(position, result);
+      }
+      if (result_idx + 1 != rbnls[bnl_idx] || bnl_idx >= nlbnf) {
+        buffer_idx
+          += impl().do_with_space(copy_advance(buffer.begin(), buffer_idx));
+        continue;
+      }
+      while (result_idx + 1 == rbnls[bnl_idx] && bnl_idx < nlbnf) {
+        buffer_idx
+          += impl().do_with_newline(copy_advance(buffer.begin(), buffer_idx));
+        ++bnl_idx;
+      }
+    }
+  }
+
 protected:
   auto do_get_extension() -> string;
   auto do_get_format() -> string;
@@ -320,35 +449,37 @@ protected:
     u64 element_size,
     u64 newline_element_size
   ) -> void {
-    buffer.reserve(
+    buffer.resize(
       divide_and_ceil<u64>(max_chars_per_batch, threads) * element_size
       + divide_and_ceil<u64>(max_seqs_per_batch, threads) * newline_element_size
     );
   }
 
-  auto do_write_buffer(const vector<Buffer_t> &buffer, u64 amount) -> void {
-    out_stream->write(
-      bit_cast<char *>(buffer.data()),
-      static_cast<std::streamsize>(amount * sizeof(Buffer_t))
-    );
-  }
-
   auto do_write_file_header() -> void {
     out_stream->write_string_with_size(impl().do_get_format());
     out_stream->write_string_with_size(impl().do_get_version());
   }
 
   auto do_start_next_file() -> void {
-    if (current_filename != filenames.begin()) { impl().do_at_file_end(); }
+    if (current_filename != filenames.begin()) {
+      writer->wait_until_written();
+      impl().do_at_file_end(*out_stream);
+      checkpoint_file();
+    }
     impl().do_open_next_file(*current_filename);
     if (this->write_headers) { impl().do_write_file_header(); }
     current_filename = next(current_filename);
   }
 
   auto do_open_next_file(const string &filename) -> void {
+    // standard output is written to as is, without adding any extension
     out_stream = make_unique<ThrowingOfstream>(
-      filename + impl().do_get_extension(), ios::binary | ios::out
+      is_standard_stream(filename) ?
+        filename :
+        filename + impl().do_get_extension() + (gzip_output ? ".gz" : ""),
+      ios::binary | ios::out
     );
+    if (gzip_output) { out_stream->enable_gzip_members(); }
   };
 
   auto do_with_result(vector<Buffer_t>::iterator buffer, u64 result) -> u64;
@@ -358,7 +489,22 @@ protected:
   // NOLINTNEXTLINE (misc-unused-parameters)
   auto do_with_space(vector<Buffer_t>::iterator buffer) -> u64 { return 0; }
 
-  auto do_at_file_end() -> void{};
+  // Returns how many elements to leave free at the start of each buffer
+  // NOLINTNEXTLINE (misc-unused-parameters)
+  auto do_at_buffer_start(vector<Buffer_t> &buffer) -> u64 { return 0; }
+  // Returns how many elements of the filled buffer are to be written
+  // NOLINTNEXTLINE (misc-unused-parameters)
+  auto do_at_buffer_end(vector<Buffer_t> &buffer, u64 size) -> u64 {
+    return size;
+  }
+  // Called once all buffers of the slot are filled, before it is written
+  // NOLINTNEXTLINE (misc-unused-parameters)
+  auto do_at_slot_filled(
+    const typename AsyncBufferWriter<Buffer_t>::Slot &slot
+  ) -> void {}
+
+  // NOLINTNEXTLINE (misc-unused-parameters)
+  auto do_at_file_end(ThrowingOfstream &out_stream) -> void {}
 };
 
 }  // namespace sbwt_search
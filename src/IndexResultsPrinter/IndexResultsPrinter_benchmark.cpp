@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BatchObjects/IntervalBatch.h"
+#include "BatchObjects/InvalidCharsBatch.h"
+#include "BatchObjects/ResultsBatch.h"
+#include "IndexResultsPrinter/AsciiContinuousIndexResultsPrinter.h"
+#include "IndexResultsPrinter/BinaryContinuousIndexResultsPrinter.h"
+#include "IndexResultsPrinter/BlockedBinaryContinuousIndexResultsPrinter.h"
+#include "IndexResultsPrinter/BoolContinuousIndexResultsPrinter.h"
+#include "IndexResultsPrinter/PackedBoolContinuousIndexResultsPrinter.h"
+#include "IndexResultsPrinter/PackedIntContinuousIndexResultsPrinter.h"
+#include "Tools/DummyBatchProducer.hpp"
+#include "Tools/RNGUtils.hpp"
+#include "Tools/TaskScheduler.h"
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+using rng_utils::get_uniform_int_generator;
+using std::make_shared;
+using std::numeric_limits;
+using std::string;
+using std::vector;
+using test_utils::DummyBatchProducer;
+using threading_utils::TaskScheduler;
+
+namespace {
+
+const u64 index_printer_kmer_size = 31;
+const u64 index_printer_max_index = 1ULL << 30;
+const u64 index_printer_max_seq_size = 300;
+const u64 index_printer_write_buffer_slots = 2;
+
+// A single batch of sequences of random length, where one in every 8 results
+// is not found and one in every 64 characters is invalid
+class IndexPrinterBenchmarkData {
+public:
+  vector<u64> chars_before_newline;
+  shared_ptr<ResultsBatch> results;
+  shared_ptr<IntervalBatch> intervals;
+  shared_ptr<InvalidCharsBatch> invalid_chars;
+
+  explicit IndexPrinterBenchmarkData(u64 num_chars) {
+    auto rng = get_uniform_int_generator<u64>(0, index_printer_max_index);
+    u64 num_results = 0;
+    for (u64 chars = 0; chars < num_chars;) {
+      u64 seq_size = std::min(
+        rng() % index_printer_max_seq_size + 1, num_chars - chars
+      );
+      chars += seq_size;
+      chars_before_newline.push_back(chars);
+      if (seq_size >= index_printer_kmer_size) {
+        num_results += seq_size - index_printer_kmer_size + 1;
+      }
+    }
+    chars_before_newline.push_back(numeric_limits<u64>::max());
+    results = make_shared<ResultsBatch>(num_results);
+    for (u64 i = 0; i < num_results; ++i) {
+      u64 r = rng();
+      results->results.push_back(r % 8 == 0 ? -1ULL : r);
+    }
+    intervals = make_shared<IntervalBatch>();
+    intervals->chars_before_new_seq = &chars_before_newline;
+    intervals->seqs_before_newfile = {numeric_limits<u64>::max()};
+    invalid_chars = make_shared<InvalidCharsBatch>();
+    invalid_chars->invalid_chars.resize(num_chars + index_printer_kmer_size);
+    for (u64 i = 0; i < num_chars; ++i) {
+      invalid_chars->invalid_chars[i] = static_cast<char>(rng() % 64 == 0);
+    }
+  }
+};
+
+// Printers which take an extra argument, such as a max_index, are given it as
+// a template argument
+template <class Printer, u64... extra_args>
+auto benchmark_index_results_printer(benchmark::State &state) -> void {
+  const u64 num_chars = state.range(0);
+  IndexPrinterBenchmarkData data(num_chars);
+  const auto directory = std::filesystem::temp_directory_path()
+    / "sbwt_search_index_results_printer_benchmark";
+  std::filesystem::create_directories(directory);
+  const string filename = (directory / "out").string();
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto printer = make_shared<Printer>(
+      0,
+      make_shared<DummyBatchProducer<ResultsBatch>>(
+        vector<shared_ptr<ResultsBatch>>{data.results}
+      ),
+      make_shared<DummyBatchProducer<IntervalBatch>>(
+        vector<shared_ptr<IntervalBatch>>{data.intervals}
+      ),
+      make_shared<DummyBatchProducer<InvalidCharsBatch>>(
+        vector<shared_ptr<InvalidCharsBatch>>{data.invalid_chars}
+      ),
+      vector<string>{filename},
+      index_printer_kmer_size,
+      TaskScheduler::get_global().get_threads(),
+      num_chars,
+      data.chars_before_newline.size(),
+      index_printer_write_buffer_slots,
+      true,
+      false,
+      extra_args...
+    );
+    state.ResumeTiming();
+    printer->read_and_generate();
+  }
+  state.SetItemsProcessed(
+    static_cast<int64_t>(state.iterations() * data.results->results.size())
+  );
+  std::filesystem::remove_all(directory);
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(
+  benchmark_index_results_printer,
+  AsciiContinuousIndexResultsPrinter,
+  index_printer_max_index
+)
+  ->Arg(1ULL << 24)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(
+  benchmark_index_results_printer, BinaryContinuousIndexResultsPrinter
+)
+  ->Arg(1ULL << 24)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(
+  benchmark_index_results_printer, BlockedBinaryContinuousIndexResultsPrinter
+)
+  ->Arg(1ULL << 24)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(
+  benchmark_index_results_printer, BoolContinuousIndexResultsPrinter
+)
+  ->Arg(1ULL << 24)
+  ->Unit(benchmark::kMillisecond);
+// with and without run length encoding
+BENCHMARK_TEMPLATE(
+  benchmark_index_results_printer, PackedBoolContinuousIndexResultsPrinter, 0
+)
+  ->Arg(1ULL << 24)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(
+  benchmark_index_results_printer, PackedBoolContinuousIndexResultsPrinter, 1
+)
+  ->Arg(1ULL << 24)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(
+  benchmark_index_results_printer,
+  PackedIntContinuousIndexResultsPrinter,
+  index_printer_max_index
+)
+  ->Arg(1ULL << 24)
+  ->Unit(benchmark::kMillisecond);
+
+}  // namespace sbwt_search
@@ -0,0 +1,208 @@
+#include <array>
+#include <bit>
+#include <cstring>
+
+#include "IndexResultsPrinter/PackedBoolContinuousIndexResultsPrinter.h"
+
+namespace sbwt_search {
+
+using std::array;
+using std::bit_cast;
+
+namespace {
+
+const u64 header_bytes = packed_bool_header_elements * sizeof(u64);
+// While formatting, the end of a seq is marked with the status which is
+// otherwise only used for runs
+const u8 newline_marker = packed_bool_run;
+
+}  // namespace
+
+PackedBoolContinuousIndexResultsPrinter::
+  PackedBoolContinuousIndexResultsPrinter(
+    u64 stream_id,
+    shared_ptr<SharedBatchesProducer<ResultsBatch>> results_producer,
+    shared_ptr<SharedBatchesProducer<IntervalBatch>> interval_producer,
+    shared_ptr<SharedBatchesProducer<InvalidCharsBatch>> invalid_chars_producer,
+    vector<string> filenames,
+    u64 kmer_size,
+    u64 threads,
+    u64 max_chars_per_batch,
+    u64 max_seqs_per_batch,
+    u64 write_buffer_slots,
+    bool write_headers,
+    bool gzip_output,
+    bool run_length_encode_
+  ):
+    Base(
+      stream_id,
+      std::move(results_producer),
+      std::move(interval_producer),
+      std::move(invalid_chars_producer),
+      std::move(filenames),
+      kmer_size,
+      threads,
+      max_chars_per_batch,
+      max_seqs_per_batch,
+      write_buffer_slots,
+      1,
+      1,
+      write_headers,
+      gzip_output
+    ),
+    run_length_encode(run_length_encode_) {}
+
+auto PackedBoolContinuousIndexResultsPrinter::get_bits_per_element() -> u64 {
+  return bits_in_byte;
+}
+
+auto PackedBoolContinuousIndexResultsPrinter::get_bits_per_seq() -> u64 {
+  return bits_in_byte;
+}
+
+auto PackedBoolContinuousIndexResultsPrinter::get_output_bits_per_element()
+  -> u64 {
+  return packed_bool_status_bits;
+}
+
+// Enough for the length of any seq of up to 2^21 kmers
+auto PackedBoolContinuousIndexResultsPrinter::get_output_bits_per_seq()
+  -> u64 {
+  return 3 * bits_in_byte;
+}
+
+auto PackedBoolContinuousIndexResultsPrinter::do_get_extension() -> string {
+  return ".pbool";
+}
+auto PackedBoolContinuousIndexResultsPrinter::do_get_format() -> string {
+  return "packedbool";
+}
+auto PackedBoolContinuousIndexResultsPrinter::do_get_version() -> string {
+  return "v1.0";
+}
+
+// Packing never takes more space than the formatted statuses, except for the
+// length of the last segment, which has no newline to take the place of
+auto PackedBoolContinuousIndexResultsPrinter::do_allocate_buffer(
+  vector<char> &buffer,
+  u64 max_chars_per_batch,
+  u64 max_seqs_per_batch,
+  u64 threads,
+  u64 element_size,
+  u64 newline_element_size
+) -> void {
+  Base::do_allocate_buffer(
+    buffer,
+    max_chars_per_batch,
+    max_seqs_per_batch,
+    threads,
+    element_size,
+    newline_element_size
+  );
+  buffer.resize(buffer.size() + header_bytes + max_vlq_bytes);
+}
+
+auto PackedBoolContinuousIndexResultsPrinter::do_at_buffer_start(
+  // NOLINTNEXTLINE (misc-unused-parameters)
+  vector<char> &buffer
+) const -> u64 {
+  return header_bytes;
+}
+
+// The packed output is written over the formatted statuses, which is safe
+// since the write position never overtakes the read position
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+auto PackedBoolContinuousIndexResultsPrinter::do_at_buffer_end(
+  vector<char> &buffer, u64 size
+) const -> u64 {
+  if (size == header_bytes) { return 0; }
+  auto *data = bit_cast<u8 *>(buffer.data());
+  vector<u64> segment_lengths;
+  u64 segment_length = 0;
+  u64 read_idx = header_bytes;
+  u64 write_idx = header_bytes;
+  // no run long enough to be encoded starts before this index
+  u64 no_run_until = 0;
+  // NOLINTBEGIN (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  while (read_idx < size) {
+    if (data[read_idx] == newline_marker) {
+      segment_lengths.push_back(segment_length);
+      segment_length = 0;
+      ++read_idx;
+      continue;
+    }
+    if (run_length_encode && read_idx >= no_run_until) {
+      const u64 run = get_run_length(data, read_idx, size);
+      if (run >= packed_bool_min_run) {
+        const u8 status = data[read_idx];
+        data[write_idx++] = static_cast<u8>(
+          packed_bool_run | (status << packed_bool_status_bits)
+        );
+        write_idx += write_vlq(data + write_idx, run);
+        read_idx += run;
+        segment_length += run;
+        continue;
+      }
+      no_run_until = read_idx + run;
+    }
+    u8 packed = 0;
+    for (u64 i = 0; i < packed_bool_statuses_per_byte && read_idx < size
+         && data[read_idx] != newline_marker;
+         ++i, ++read_idx, ++segment_length) {
+      packed |= static_cast<u8>(data[read_idx] << (i * packed_bool_status_bits)
+      );
+    }
+    data[write_idx++] = packed;
+  }
+  segment_lengths.push_back(segment_length);
+  const u64 status_bytes = write_idx - header_bytes;
+  for (const u64 length : segment_lengths) {
+    write_idx += write_vlq(data + write_idx, length);
+  }
+  // NOLINTEND (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  const array<u64, packed_bool_header_elements> header
+    = {status_bytes,
+       write_idx - header_bytes - status_bytes,
+       segment_lengths.size() - 1};
+  std::memcpy(data, header.data(), header_bytes);
+  return write_idx;
+}
+
+auto PackedBoolContinuousIndexResultsPrinter::get_run_length(
+  const u8 *statuses, u64 index, u64 size
+) const -> u64 {
+  u64 end = index + 1;
+  // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  while (end < size && statuses[end] == statuses[index]) { ++end; }
+  return end - index;
+}
+
+auto PackedBoolContinuousIndexResultsPrinter::do_with_result(
+  vector<char>::iterator buffer, u64
+) -> u64 {
+  *buffer = static_cast<char>(packed_bool_found);
+  return 1;
+}
+
+auto PackedBoolContinuousIndexResultsPrinter::do_with_not_found(
+  vector<char>::iterator buffer
+) const -> u64 {
+  *buffer = static_cast<char>(packed_bool_not_found);
+  return 1;
+}
+
+auto PackedBoolContinuousIndexResultsPrinter::do_with_invalid(
+  vector<char>::iterator buffer
+) const -> u64 {
+  *buffer = static_cast<char>(packed_bool_invalid);
+  return 1;
+}
+
+auto PackedBoolContinuousIndexResultsPrinter::do_with_newline(
+  vector<char>::iterator buffer
+) const -> u64 {
+  *buffer = static_cast<char>(newline_marker);
+  return 1;
+}
+
+}  // namespace sbwt_search
@@ -0,0 +1,90 @@
+#ifndef PACKED_BOOL_CONTINUOUS_INDEX_RESULTS_PRINTER_H
+#define PACKED_BOOL_CONTINUOUS_INDEX_RESULTS_PRINTER_H
+
+/**
+ * @file PackedBoolContinuousIndexResultsPrinter.h
+ * @brief Inherits ContinuousIndexResultsPrinter and prints out the same
+ * statuses as the BoolContinuousIndexResultsPrinter, but with 2 bits per kmer
+ * instead of a byte, and with the length of each seq stored in a table rather
+ * than ending it with a newline. Each thread first formats a byte per status
+ * into its buffer as usual, and then packs the buffer in place into a block,
+ * optionally replacing long runs of the same status by their length. The
+ * layout is described in PackedBoolFormat.h.
+ */
+
+#include "IndexResultsPrinter/ContinuousIndexResultsPrinter.hpp"
+#include "IndexResultsPrinter/PackedBoolFormat.h"
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+class PackedBoolContinuousIndexResultsPrinter:
+    public ContinuousIndexResultsPrinter<
+      PackedBoolContinuousIndexResultsPrinter,
+      char> {
+  using Base = ContinuousIndexResultsPrinter<
+    PackedBoolContinuousIndexResultsPrinter,
+    char>;
+  friend Base;
+
+private:
+  bool run_length_encode;
+
+public:
+  PackedBoolContinuousIndexResultsPrinter(
+    u64 stream_id,
+    shared_ptr<SharedBatchesProducer<ResultsBatch>> results_producer,
+    shared_ptr<SharedBatchesProducer<IntervalBatch>> interval_producer,
+    shared_ptr<SharedBatchesProducer<InvalidCharsBatch>> invalid_chars_producer,
+    vector<string> filenames_,
+    u64 kmer_size,
+    u64 threads,
+    u64 max_chars_per_batch,
+    u64 max_seqs_per_batch,
+    u64 write_buffer_slots,
+    bool write_headers,
+    bool gzip_output,
+    bool run_length_encode_
+  );
+
+  // The buffers are formatted with a byte per kmer before being packed
+  auto static get_bits_per_element() -> u64;
+  auto static get_bits_per_seq() -> u64;
+  // The size of the packed output, which is what gets compressed
+  auto static get_output_bits_per_element() -> u64;
+  auto static get_output_bits_per_seq() -> u64;
+
+protected:
+  auto do_get_extension() -> string;
+  auto do_get_format() -> string;
+  auto do_get_version() -> string;
+
+  auto do_allocate_buffer(
+    vector<char> &buffer,
+    u64 max_chars_per_batch,
+    u64 max_seqs_per_batch,
+    u64 threads,
+    u64 element_size,
+    u64 newline_element_size
+  ) -> void;
+
+  [[nodiscard]] auto do_at_buffer_start(vector<char> &buffer) const -> u64;
+  auto do_at_buffer_end(vector<char> &buffer, u64 size) const -> u64;
+
+  [[nodiscard]] auto do_with_result(vector<char>::iterator buffer, u64 result)
+    -> u64;
+  [[nodiscard]] auto do_with_not_found(vector<char>::iterator buffer) const
+    -> u64;
+  [[nodiscard]] auto do_with_invalid(vector<char>::iterator buffer) const
+    -> u64;
+  [[nodiscard]] auto do_with_newline(vector<char>::iterator buffer) const
+    -> u64;
+
+private:
+  [[nodiscard]] auto get_run_length(const u8 *statuses, u64 index, u64 size)
+    const -> u64;
+};
+
+}  // namespace sbwt_search
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef PACKED_BOOL_FORMAT_H
+#define PACKED_BOOL_FORMAT_H
+
+/**
+ * @file PackedBoolFormat.h
+ * @brief Layout of the packed bool index results format, shared by the printer
+ * which writes it and the parser which reads it. After the usual format and
+ * version headers, the file is a list of blocks. Every block starts with a
+ * header of packed_bool_header_elements u64s: the number of bytes of packed
+ * statuses, the number of bytes of the length table which follows them, and
+ * the number of seqs which end within the block. The statuses are those of the
+ * bool format, 0 for found, 1 for not found and 2 for invalid, packed 4 to a
+ * byte starting from the least significant bits, with every segment starting
+ * on a new byte. A byte whose first status is packed_bool_run instead starts a
+ * run, where the next 2 bits are the status which is repeated, and the byte is
+ * followed by the length of the run as a VLQ (7 bits per byte, least
+ * significant first, with the 8th bit set if more bytes follow). The length
+ * table holds the number of kmers in each segment as VLQs. All segments but
+ * the last end a seq, while the last one carries on in the next block, so a
+ * block which ends n seqs has n + 1 lengths in its table.
+ */
+
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+// The position of each field within a block header
+enum PackedBoolHeaderField : u64 {
+  packed_bool_status_bytes,
+  packed_bool_table_bytes,
+  packed_bool_seqs,
+  packed_bool_header_elements
+};
+
+enum PackedBoolStatus : u8 {
+  packed_bool_found,
+  packed_bool_not_found,
+  packed_bool_invalid,
+  packed_bool_run
+};
+
+const u64 packed_bool_status_bits = 2;
+const u64 packed_bool_statuses_per_byte = 4;
+const u8 packed_bool_status_mask = 0b11;
+// Runs shorter than this are packed as usual. A run takes at most
+// 1 + max_vlq_bytes bytes, which is less than the packed statuses it replaces
+const u64 packed_bool_min_run = 64;
+
+const u8 vlq_data_bits = 7;
+const u8 vlq_data_mask = 0x7F;
+const u8 vlq_continue_bit = 0x80;
+const u64 max_vlq_bytes = 10;
+
+// Writes value at buffer as a VLQ and returns the number of bytes written
+inline auto write_vlq(u8 *buffer, u64 value) -> u64 {
+  u64 bytes = 0;
+  while (value > vlq_data_mask) {
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    buffer[bytes++]
+      = static_cast<u8>((value & vlq_data_mask) | vlq_continue_bit);
+    value >>= vlq_data_bits;
+  }
+  // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  buffer[bytes++] = static_cast<u8>(value);
+  return bytes;
+}
+
+// Reads a VLQ starting at buffer[index] and moves index past it
+inline auto read_vlq(const u8 *buffer, u64 &index) -> u64 {
+  u64 result = 0;
+  for (u64 shift = 0;; shift += vlq_data_bits) {
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    const u8 byte = buffer[index++];
+    result |= static_cast<u64>(byte & vlq_data_mask) << shift;
+    if ((byte & vlq_continue_bit) == 0) { return result; }
+  }
+}
+
+}  // namespace sbwt_search
+
+#endif
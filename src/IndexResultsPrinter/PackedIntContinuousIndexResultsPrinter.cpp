@@ -14,7 +14,9 @@ PackedIntContinuousIndexResultsPrinter::PackedIntContinuousIndexResultsPrinter(
   u64 threads,
   u64 max_chars_per_batch,
   u64 max_seqs_per_batch,
+  u64 write_buffer_slots,
   bool write_headers,
+  bool gzip_output,
   u64 max_index
 ):
     Base(
@@ -27,9 +29,11 @@ PackedIntContinuousIndexResultsPrinter::PackedIntContinuousIndexResultsPrinter(
       threads,
       max_chars_per_batch,
       max_seqs_per_batch,
+      write_buffer_slots,
       get_bits_per_element(max_index) / bits_in_byte,
       1,
-      write_headers
+      write_headers,
+      gzip_output
     ) {}
 
 auto PackedIntContinuousIndexResultsPrinter::get_bits_per_element(u64 max_index)
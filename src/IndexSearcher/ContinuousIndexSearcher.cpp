@@ -9,6 +9,7 @@
 #include "SbwtContainer/GpuSbwtContainer.h"
 #include "Tools/Logger.h"
 #include "Tools/MathUtils.hpp"
+#include "Tools/Metrics.h"
 #include "Tools/SharedBatchesProducer.hpp"
 #include "Tools/TypeDefinitions.h"
 #include "fmt/core.h"
@@ -18,6 +19,7 @@ namespace sbwt_search {
 using design_utils::SharedBatchesProducer;
 using fmt::format;
 using log_utils::Logger;
+using log_utils::Metrics;
 using math_utils::round_up;
 using std::make_shared;
 using std::shared_ptr;
@@ -29,10 +31,19 @@ ContinuousIndexSearcher::ContinuousIndexSearcher(
   shared_ptr<SharedBatchesProducer<PositionsBatch>> positions_producer_,
   u64 max_batches,
   u64 max_chars_per_batch_,
-  bool move_to_key_kmer
+  bool move_to_key_kmer,
+  u64 kmer_cache_entries,
+  bool invalid_bitmap,
+  bool bucket_kmers
 ):
     searcher(
-      stream_id_, std::move(container), max_chars_per_batch_, move_to_key_kmer
+      stream_id_,
+      std::move(container),
+      max_chars_per_batch_,
+      move_to_key_kmer,
+      kmer_cache_entries,
+      invalid_bitmap,
+      bucket_kmers
     ),
     bit_seq_producer(std::move(bit_seq_producer_)),
     positions_producer(std::move(positions_producer_)),
@@ -47,10 +58,13 @@ auto ContinuousIndexSearcher::get_bits_per_element_cpu() -> u64 {
   return bits_required_per_result;
 }
 
-auto ContinuousIndexSearcher::get_bits_per_element_gpu() -> u64 {
+auto ContinuousIndexSearcher::get_bits_per_element_gpu(bool invalid_bitmap)
+  -> u64 {
   const u64 bits_required_per_position = 64;
   const u64 bits_required_per_bit_packed_entry = 2;
-  return bits_required_per_position + bits_required_per_bit_packed_entry;
+  const u64 bits_required_per_invalid_bit = 1;
+  return bits_required_per_position + bits_required_per_bit_packed_entry
+    + static_cast<u64>(invalid_bitmap) * bits_required_per_invalid_bit;
 }
 
 auto ContinuousIndexSearcher::get_default_value() -> shared_ptr<ResultsBatch> {
@@ -67,10 +81,16 @@ auto ContinuousIndexSearcher::continue_read_condition() -> bool {
 auto ContinuousIndexSearcher::generate() -> void {
   searcher.search(
     bit_seq_batch->bit_seq,
+    bit_seq_batch->invalid_bits,
     positions_batch->positions,
     current_write()->results,
     get_batch_id()
   );
+  Metrics::add(
+    format("Searcher_{}", stream_id),
+    "kmers_total",
+    static_cast<double>(positions_batch->positions.size())
+  );
 }
 
 auto ContinuousIndexSearcher::do_at_batch_start() -> void {
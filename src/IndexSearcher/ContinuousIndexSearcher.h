@@ -36,11 +36,14 @@ public:
     shared_ptr<SharedBatchesProducer<PositionsBatch>> positions_producer_,
     u64 max_batches,
     u64 max_positions_per_batch,
-    bool move_to_key_kmer
+    bool move_to_key_kmer,
+    u64 kmer_cache_entries = 0,
+    bool invalid_bitmap = false,
+    bool bucket_kmers = false
   );
 
   auto static get_bits_per_element_cpu() -> u64;
-  auto static get_bits_per_element_gpu() -> u64;
+  auto static get_bits_per_element_gpu(bool invalid_bitmap = false) -> u64;
 
   auto get_default_value() -> shared_ptr<ResultsBatch> override;
   auto continue_read_condition() -> bool override;
@@ -1,7 +1,13 @@
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "BatchObjects/ResultsBatch.h"
 #include "Global/GlobalDefinitions.h"
 #include "IndexSearcher/IndexSearcher.h"
 #include "Tools/Logger.h"
 #include "Tools/MathUtils.hpp"
+#include "Tools/TaskScheduler.h"
 #include "Tools/TypeDefinitions.h"
 #include "fmt/core.h"
 
@@ -10,21 +16,76 @@ namespace sbwt_search {
 using fmt::format;
 using log_utils::Logger;
 using math_utils::round_up;
+using std::atomic;
+using std::make_unique;
+using std::memory_order_relaxed;
+using threading_utils::TaskScheduler;
+
+namespace {
+
+// Search results are either an index below 2^62 or -1 (not found), so the
+// values with the top two bits set to 10 and 01 are free to be used as markers
+// while a batch is being resolved through the cache
+const u64 cache_miss_marker = 1ULL << 63;
+const u64 pending_marker = 1ULL << 62;
+const u64 marker_bits = 3ULL << 62;
+
+auto is_pending(u64 value) -> bool {
+  return (value & marker_bits) == pending_marker;
+}
+
+}  // namespace
 
 IndexSearcher::IndexSearcher(
   u64 stream_id_,
   shared_ptr<GpuSbwtContainer> container,
   u64 max_chars_per_batch,
-  bool move_to_key_kmer_
+  bool move_to_key_kmer_,
+  u64 kmer_cache_entries,
+  bool invalid_bitmap_,
+  bool bucket_kmers
 ):
     container(std::move(container)),
     d_bit_seqs(max_chars_per_batch / u64_bits * 2, gpu_stream),
+    d_invalid_bits(
+      invalid_bitmap_ ? max_chars_per_batch / u64_bits + 2 : 0, gpu_stream
+    ),
     d_kmer_positions(max_chars_per_batch, gpu_stream),
     stream_id(stream_id_),
-    move_to_key_kmer(move_to_key_kmer_) {}
+    move_to_key_kmer(move_to_key_kmer_),
+    invalid_bitmap(invalid_bitmap_) {
+  if (kmer_cache_entries > 0) {
+    kmer_cache = make_unique<KmerCache>(kmer_cache_entries);
+    miss_positions = make_unique<PinnedVector<u64>>(max_chars_per_batch);
+    miss_results = make_unique<PinnedVector<u64>>(max_chars_per_batch);
+    miss_keys.reserve(max_chars_per_batch);
+  }
+  if (bucket_kmers) {
+    kmer_bucketer = make_unique<KmerBucketer>(max_chars_per_batch);
+    bucketed_positions = make_unique<PinnedVector<u64>>(max_chars_per_batch);
+    bucketed_results = make_unique<PinnedVector<u64>>(max_chars_per_batch);
+  }
+}
+
+// The positions and results of the k-mers which miss the cache, as well as
+// the two word keys of those k-mers
+auto IndexSearcher::get_kmer_cache_bits_per_element() -> u64 {
+  return u64_bits * 4;
+}
+
+auto IndexSearcher::get_bucketing_bits_per_element() -> u64 {
+  return KmerBucketer::get_bits_per_element()
+    + get_bucketing_pinned_bits_per_element();
+}
+
+// The positions and results of the k-mers in bucketed order
+auto IndexSearcher::get_bucketing_pinned_bits_per_element() -> u64 {
+  return u64_bits * 2;
+}
 
 auto IndexSearcher::search(
   const PinnedVector<u64> &bit_seqs,
+  const PinnedVector<u64> &invalid_bits,
   const PinnedVector<u64> &kmer_positions,
   PinnedVector<u64> &results,
   u64 batch_id
@@ -33,7 +94,79 @@ auto IndexSearcher::search(
     Logger::LOG_LEVEL::DEBUG,
     format("Batch {} consists of {} queries", batch_id, kmer_positions.size())
   );
-  copy_to_gpu(batch_id, bit_seqs, kmer_positions, results);
+  if (kmer_cache != nullptr) {
+    search_with_cache(
+      bit_seqs, invalid_bits, kmer_positions, results, batch_id
+    );
+  } else {
+    search_on_gpu(bit_seqs, invalid_bits, kmer_positions, results, batch_id);
+  }
+}
+
+auto IndexSearcher::search_on_gpu(
+  const PinnedVector<u64> &bit_seqs,
+  const PinnedVector<u64> &invalid_bits,
+  const PinnedVector<u64> &kmer_positions,
+  PinnedVector<u64> &results,
+  u64 batch_id
+) -> void {
+  if (kmer_bucketer != nullptr) {
+    search_bucketed(bit_seqs, invalid_bits, kmer_positions, results, batch_id);
+  } else {
+    search_in_order(bit_seqs, invalid_bits, kmer_positions, results, batch_id);
+  }
+}
+
+auto IndexSearcher::search_bucketed(
+  const PinnedVector<u64> &bit_seqs,
+  const PinnedVector<u64> &invalid_bits,
+  const PinnedVector<u64> &kmer_positions,
+  PinnedVector<u64> &results,
+  u64 batch_id
+) -> void {
+  Logger::log_timed_event(
+    format("SearcherBucket_{}", stream_id),
+    Logger::EVENT_STATE::START,
+    format("batch {}", batch_id)
+  );
+  bucketed_positions->resize(kmer_positions.size());
+  kmer_bucketer->bucket(
+    bit_seqs.data(),
+    kmer_positions.data(),
+    kmer_positions.size(),
+    container->get_kmer_size(),
+    bucketed_positions->data()
+  );
+  Logger::log_timed_event(
+    format("SearcherBucket_{}", stream_id),
+    Logger::EVENT_STATE::STOP,
+    format("batch {}", batch_id)
+  );
+  search_in_order(
+    bit_seqs, invalid_bits, *bucketed_positions, *bucketed_results, batch_id
+  );
+  Logger::log_timed_event(
+    format("SearcherUnbucket_{}", stream_id),
+    Logger::EVENT_STATE::START,
+    format("batch {}", batch_id)
+  );
+  results.resize(kmer_positions.size());
+  kmer_bucketer->unbucket(bucketed_results->data(), results.data());
+  Logger::log_timed_event(
+    format("SearcherUnbucket_{}", stream_id),
+    Logger::EVENT_STATE::STOP,
+    format("batch {}", batch_id)
+  );
+}
+
+auto IndexSearcher::search_in_order(
+  const PinnedVector<u64> &bit_seqs,
+  const PinnedVector<u64> &invalid_bits,
+  const PinnedVector<u64> &kmer_positions,
+  PinnedVector<u64> &results,
+  u64 batch_id
+) -> void {
+  copy_to_gpu(batch_id, bit_seqs, invalid_bits, kmer_positions, results);
   if (!kmer_positions.empty()) {
     Logger::log_timed_event(
       format("SearcherSearch_{}", stream_id),
@@ -50,9 +183,123 @@ auto IndexSearcher::search(
   }
 }
 
+// Each distinct k-mer which is not in the cache is searched on the gpu only
+// once per batch. While the batch is being resolved, such k-mers are kept in
+// the cache with a pending marker holding their index among the misses, so
+// that later repeats of the k-mer within the same batch point to it as well.
+// Invalid k-mers are resolved from the bitmap before the cache is looked at.
+auto IndexSearcher::search_with_cache(
+  const PinnedVector<u64> &bit_seqs,
+  const PinnedVector<u64> &invalid_bits,
+  const PinnedVector<u64> &kmer_positions,
+  PinnedVector<u64> &results,
+  u64 batch_id
+) -> void {
+  Logger::log_timed_event(
+    format("SearcherCache_{}", stream_id),
+    Logger::EVENT_STATE::START,
+    format("batch {}", batch_id)
+  );
+  results.resize(kmer_positions.size());
+  const u64 hits
+    = find_in_cache(bit_seqs, invalid_bits, kmer_positions, results);
+  queue_cache_misses(bit_seqs, kmer_positions, results);
+  Logger::log_timed_event(
+    format("SearcherCache_{}", stream_id),
+    Logger::EVENT_STATE::STOP,
+    format("batch {}", batch_id)
+  );
+  search_on_gpu(
+    bit_seqs, invalid_bits, *miss_positions, *miss_results, batch_id
+  );
+  resolve_cache_misses(results);
+  log_cache_statistics(batch_id, kmer_positions.size(), hits);
+}
+
+auto IndexSearcher::find_in_cache(
+  const PinnedVector<u64> &bit_seqs,
+  const PinnedVector<u64> &invalid_bits,
+  const PinnedVector<u64> &kmer_positions,
+  PinnedVector<u64> &results
+) -> u64 {
+  const u64 kmer_size = container->get_kmer_size();
+  atomic<u64> hits = 0;
+  auto &scheduler = TaskScheduler::get_global();
+  scheduler.parallel_for_range(kmer_positions.size(), [&](u64 i) {
+    const u64 position = kmer_positions[i];
+    if (invalid_bitmap
+        && has_invalid_char(invalid_bits.data(), position, kmer_size)) {
+      results[i] = invalid_kmer_result;
+      return;
+    }
+    auto key = get_kmer_cache_key(bit_seqs.data(), position, kmer_size);
+    if (kmer_cache->find(key, results[i])) {
+      hits.fetch_add(1, memory_order_relaxed);
+    } else {
+      results[i] = cache_miss_marker;
+    }
+  });
+  return hits;
+}
+
+auto IndexSearcher::queue_cache_misses(
+  const PinnedVector<u64> &bit_seqs,
+  const PinnedVector<u64> &kmer_positions,
+  PinnedVector<u64> &results
+) -> void {
+  const u64 kmer_size = container->get_kmer_size();
+  miss_positions->resize(0);
+  miss_keys.resize(0);
+  for (u64 i = 0; i < kmer_positions.size(); ++i) {
+    if (results[i] != cache_miss_marker) { continue; }
+    auto key
+      = get_kmer_cache_key(bit_seqs.data(), kmer_positions[i], kmer_size);
+    // a repeat of a k-mer which already missed earlier in this batch
+    if (kmer_cache->find(key, results[i])) { continue; }
+    results[i] = pending_marker | miss_positions->size();
+    kmer_cache->insert(key, results[i]);
+    miss_positions->push_back(kmer_positions[i]);
+    miss_keys.push_back(key);
+  }
+}
+
+auto IndexSearcher::resolve_cache_misses(PinnedVector<u64> &results) -> void {
+  for (u64 i = 0; i < miss_keys.size(); ++i) {
+    kmer_cache->insert(miss_keys[i], (*miss_results)[i]);
+  }
+  TaskScheduler::get_global().parallel_for_range(results.size(), [&](u64 i) {
+    if (is_pending(results[i])) {
+      results[i] = (*miss_results)[results[i] & ~marker_bits];
+    }
+  });
+}
+
+auto IndexSearcher::log_cache_statistics(
+  u64 batch_id, u64 num_queries, u64 hits
+) -> void {
+  total_queries += num_queries;
+  total_cache_hits += hits;
+  const double percent = 100;
+  Logger::log(
+    Logger::LOG_LEVEL::INFO,
+    format(
+      "Batch {} on stream {}: {} of {} k-mers were found in the k-mer cache "
+      "({:.2f}% hit rate, {:.2f}% overall) and {} were searched on the gpu",
+      batch_id,
+      stream_id,
+      hits,
+      num_queries,
+      num_queries == 0 ? 0 : percent * hits / num_queries,
+      total_queries == 0 ? 0 : percent * total_cache_hits / total_queries,
+      miss_positions->size()
+    )
+  );
+}
+
 auto IndexSearcher::copy_to_gpu(
   u64 batch_id,
   const PinnedVector<u64> &bit_seqs,
+  const PinnedVector<u64> &invalid_bits,
   const PinnedVector<u64> &kmer_positions,
   PinnedVector<u64> &results
 ) -> void {
@@ -62,6 +309,11 @@ auto IndexSearcher::copy_to_gpu(
     format("batch {}", batch_id)
   );
   d_bit_seqs.set_async(bit_seqs.data(), bit_seqs.size(), gpu_stream);
+  if (invalid_bitmap) {
+    d_invalid_bits.set_async(
+      invalid_bits.data(), invalid_bits.size(), gpu_stream
+    );
+  }
   auto padded_query_size
     = round_up<u64>(kmer_positions.size(), superblock_bits);
   d_kmer_positions.set_async(
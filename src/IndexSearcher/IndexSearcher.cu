@@ -1,3 +1,6 @@
+#include <array>
+#include <utility>
+
 #include "Global/GlobalDefinitions.h"
 #include "IndexSearcher/IndexSearcher.cuh"
 #include "IndexSearcher/IndexSearcher.h"
@@ -14,51 +17,70 @@ namespace sbwt_search {
 using fmt::format;
 using log_utils::Logger;
 using math_utils::round_up;
+using std::array;
+using std::pair;
+
+namespace {
+
+using SearchKernel = decltype(&d_search<false, 0>);
+
+// The values of k which are common enough to get kernels of their own, where
+// the rank loop is unrolled. Any other k uses the generic kernel.
+template <bool move_to_key_kmer>
+const array<pair<u64, SearchKernel>, 5> specialised_search_kernels = {{
+  {15, d_search<move_to_key_kmer, 15>},
+  {21, d_search<move_to_key_kmer, 21>},
+  {25, d_search<move_to_key_kmer, 25>},
+  {31, d_search<move_to_key_kmer, 31>},
+  {63, d_search<move_to_key_kmer, 63>},
+}};
+
+template <bool move_to_key_kmer>
+auto get_search_kernel(u64 kmer_size, bool specialise) -> SearchKernel {
+  if (specialise) {
+    for (const auto &[size, kernel] :
+         specialised_search_kernels<move_to_key_kmer>) {
+      if (size == kmer_size) { return kernel; }
+    }
+  }
+  return d_search<move_to_key_kmer, 0>;
+}
+
+}  // namespace
 
 auto IndexSearcher::launch_search_kernel(u64 num_queries, u64 batch_id)
   -> void {
   u32 blocks_per_grid
     = round_up<u64>(num_queries, threads_per_block) / threads_per_block;
+  const u64 kmer_size = container->get_kmer_size();
+  const SearchKernel kernel = move_to_key_kmer ?
+    get_search_kernel<true>(kmer_size, specialise_kmer_size) :
+    get_search_kernel<false>(kmer_size, specialise_kmer_size);
+  const bool jump = move_to_key_kmer && container->has_key_kmer_jumps();
   start_timer.record(&gpu_stream);
-  if (move_to_key_kmer) {
-    hipLaunchKernelGGL(
-      d_search<true>,
-      blocks_per_grid,
-      threads_per_block,
-      0,
-      *static_cast<hipStream_t *>(gpu_stream.data()),
-      container->get_kmer_size(),
-      container->get_c_map().data(),
-      container->get_acgt_pointers().data(),
-      container->get_layer_0_pointers().data(),
-      container->get_layer_1_2_pointers().data(),
-      container->get_presearch_left().data(),
-      container->get_presearch_right().data(),
-      d_kmer_positions.data(),
-      d_bit_seqs.data(),
-      container->get_key_kmer_marks().data(),
-      d_kmer_positions.data()
-    );
-  } else {
-    hipLaunchKernelGGL(
-      d_search<false>,
-      blocks_per_grid,
-      threads_per_block,
-      0,
-      *static_cast<hipStream_t *>(gpu_stream.data()),
-      container->get_kmer_size(),
-      container->get_c_map().data(),
-      container->get_acgt_pointers().data(),
-      container->get_layer_0_pointers().data(),
-      container->get_layer_1_2_pointers().data(),
-      container->get_presearch_left().data(),
-      container->get_presearch_right().data(),
-      d_kmer_positions.data(),
-      d_bit_seqs.data(),
-      nullptr,
-      d_kmer_positions.data()
-    );
-  }
+  hipLaunchKernelGGL(
+    kernel,
+    blocks_per_grid,
+    threads_per_block,
+    0,
+    *static_cast<hipStream_t *>(gpu_stream.data()),
+    kmer_size,
+    container->get_c_map().data(),
+    container->get_acgt_pointers().data(),
+    container->get_layer_0_pointers().data(),
+    container->get_layer_1_2_pointers().data(),
+    container->get_presearch_left().data(),
+    container->get_presearch_right().data(),
+    d_kmer_positions.data(),
+    d_bit_seqs.data(),
+    invalid_bitmap ? d_invalid_bits.data() : nullptr,
+    move_to_key_kmer ? container->get_key_kmer_marks().data() : nullptr,
+    jump ? container->get_key_kmer_jump_marks().data() : nullptr,
+    jump ? container->get_key_kmer_jump_layer_0().data() : nullptr,
+    jump ? container->get_key_kmer_jump_layer_1_2().data() : nullptr,
+    jump ? container->get_key_kmer_jumps().data() : nullptr,
+    d_kmer_positions.data()
+  );
   end_timer.record(&gpu_stream);
   GPU_CHECK(hipPeekAtLastError());
   GPU_CHECK(hipStreamSynchronize(*static_cast<hipStream_t *>(gpu_stream.data()))
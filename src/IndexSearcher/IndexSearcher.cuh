@@ -6,10 +6,11 @@
  * @brief Search implementation
  */
 
+#include "BatchObjects/ResultsBatch.h"
 #include "Tools/BitDefinitions.h"
 #include "Tools/KernelUtils.cuh"
 #include "Tools/TypeDefinitions.h"
-#include "UtilityKernels/GetBoolFromBitVector.cuh"
+#include "UtilityKernels/MoveToKeyKmer.cuh"
 #include "UtilityKernels/Rank.cuh"
 #include "hip/hip_runtime.h"
 
@@ -19,7 +20,21 @@ using bit_utils::two_1s;
 using gpu_utils::get_idx;
 
 // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-template <bool move_to_key_kmer>
+// Gets the 64 bits starting at the given bit index, where the first bit is the
+// most significant
+inline __device__ auto d_get_bit_window(const u64 *bits, u64 index) -> u64 {
+  const u64 first_part = (bits[index / 64] << (index % 64));
+  const u64 second_part = (bits[index / 64 + 1] >> (64 - (index % 64)))
+    & static_cast<u64>(-static_cast<u64>((index % 64) != 0));
+  return first_part | second_part;
+}
+
+// If invalid_bits is not null, k-mers which contain an invalid character are
+// given the invalid_kmer_result without being searched. If fixed_kmer_size is
+// not 0, it is used instead of kmer_size, so that the rank loop has a trip
+// count known at compile time and can be unrolled. If jump_marks is not null,
+// the move to the key k-mer takes the jump pointers of the KeyKmerJumper.
+template <bool move_to_key_kmer, u32 fixed_kmer_size>
 __global__ void d_search(
   const u32 kmer_size,
   const u64 *const c_map,
@@ -30,24 +45,31 @@ __global__ void d_search(
   const u64 *const presearch_right,
   const u64 *const kmer_positions,
   const u64 *const bit_seqs,
+  const u64 *const invalid_bits,
   const u64 *const key_kmer_marks,
+  const u64 *const jump_marks,
+  const u64 *const jump_layer_0,
+  const u64 *const jump_layer_1_2,
+  const u64 *const key_kmer_jumps,
   u64 *out
 ) {
   const u32 idx = get_idx();
-  const u64 kmer_index = kmer_positions[idx] * 2;
-  const u64 first_part = (bit_seqs[kmer_index / 64] << (kmer_index % 64));
-  const u64 second_part
-    = (bit_seqs[kmer_index / 64 + 1] >> (64 - (kmer_index % 64)))
-    & static_cast<u64>(-static_cast<u64>((kmer_index % 64) != 0));
-  const u64 kmer = first_part | second_part;
+  const u32 k = fixed_kmer_size == 0 ? kmer_size : fixed_kmer_size;
+  const u64 position = kmer_positions[idx];
+  if (invalid_bits != nullptr
+      && d_get_bit_window(invalid_bits, position) >> (64 - k) != 0) {
+    out[idx] = invalid_kmer_result;
+    return;
+  }
+  const u64 kmer = d_get_bit_window(bit_seqs, position * 2);
   constexpr const u64 presearch_mask = (2ULL << (presearch_letters * 2)) - 1;
   const u32 presearched
     = (kmer >> (64 - presearch_letters * 2)) & presearch_mask;
   u64 node_left = presearch_left[presearched];
   u64 node_right = presearch_right[presearched];
-  for (u64 i = kmer_positions[idx] + presearch_letters;
-       i < kmer_positions[idx] + kmer_size;
-       ++i) {
+#pragma unroll
+  for (u32 offset = presearch_letters; offset < k; ++offset) {
+    const u64 i = position + offset;
     const u32 c = (bit_seqs[i / 32] >> (62 - (i % 32) * 2)) & two_1s;
     node_left = c_map[c] + d_rank(acgt[c], layer_0[c], layer_1_2[c], node_left);
     node_right = c_map[c]
@@ -58,15 +80,18 @@ __global__ void d_search(
     return;
   }
   if (move_to_key_kmer) {
-    while (!d_get_bool_from_bit_vector(key_kmer_marks, node_left)) {
-      for (u32 i = 0; i < 4; ++i) {
-        if (d_get_bool_from_bit_vector(acgt[i], node_left)) {
-          node_left
-            = c_map[i] + d_rank(acgt[i], layer_0[i], layer_1_2[i], node_left);
-          break;
-        }
-      }
-    }
+    node_left = d_move_to_key_kmer(
+      c_map,
+      acgt,
+      layer_0,
+      layer_1_2,
+      key_kmer_marks,
+      jump_marks,
+      jump_layer_0,
+      jump_layer_1_2,
+      key_kmer_jumps,
+      node_left
+    );
   }
   out[idx] = node_left;
 }
@@ -3,11 +3,22 @@
 
 /**
  * @file IndexSearcher.h
- * @brief Class for searching the SBWT index
+ * @brief Class for searching the SBWT index. Optionally, a KmerCache sits in
+ * front of the gpu search, in which case only the k-mers which are not in the
+ * cache are sent to the gpu, and each distinct k-mer is only sent once per
+ * batch. The hit rate of the cache is logged for each batch. If a bitmap of
+ * the invalid characters is given, k-mers which contain an invalid character
+ * get the invalid_kmer_result and are neither searched nor cached. The most
+ * common values of k have search kernels specialised for them. The k-mers
+ * which go to the gpu may also be bucketed by their prefix first, see
+ * KmerBucketer.h.
  */
 
 #include <memory>
+#include <vector>
 
+#include "KmerBucketer/KmerBucketer.h"
+#include "KmerCache/KmerCache.h"
 #include "SbwtContainer/GpuSbwtContainer.h"
 #include "Tools/GpuEvent.h"
 #include "Tools/GpuStream.h"
@@ -19,36 +30,102 @@ using gpu_utils::GpuEvent;
 using gpu_utils::GpuStream;
 using gpu_utils::PinnedVector;
 using std::shared_ptr;
+using std::unique_ptr;
+using std::vector;
 
 class IndexSearcher {
 private:
   GpuStream gpu_stream{};
   shared_ptr<GpuSbwtContainer> container;
   GpuPointer<u64> d_bit_seqs;
+  GpuPointer<u64> d_invalid_bits;
   GpuPointer<u64> d_kmer_positions;
   GpuEvent start_timer{}, end_timer{};
   u64 stream_id;
   bool move_to_key_kmer;
+  bool invalid_bitmap;
+  unique_ptr<KmerCache> kmer_cache;
+  unique_ptr<PinnedVector<u64>> miss_positions;
+  unique_ptr<PinnedVector<u64>> miss_results;
+  vector<KmerKey> miss_keys;
+  unique_ptr<KmerBucketer> kmer_bucketer;
+  unique_ptr<PinnedVector<u64>> bucketed_positions;
+  unique_ptr<PinnedVector<u64>> bucketed_results;
+  u64 total_queries = 0;
+  u64 total_cache_hits = 0;
 
 public:
   IndexSearcher(
     u64 stream_id_,
     shared_ptr<GpuSbwtContainer> container,
     u64 max_chars_per_batch,
-    bool move_to_key_kmer_
+    bool move_to_key_kmer_,
+    u64 kmer_cache_entries = 0,
+    bool invalid_bitmap_ = false,
+    bool bucket_kmers = false
   );
 
+  static auto get_kmer_cache_bits_per_element() -> u64;
+  static auto get_bucketing_bits_per_element() -> u64;
+  static auto get_bucketing_pinned_bits_per_element() -> u64;
+
   auto search(
     const PinnedVector<u64> &bit_seqs,
+    const PinnedVector<u64> &invalid_bits,
     const PinnedVector<u64> &kmer_positions,
     PinnedVector<u64> &results,
     u64 batch_id
   ) -> void;
 
-private:
+protected:
+  // Turning this off always uses the generic kernel, for benchmarking
+  bool specialise_kmer_size = true;
+
+  auto search_on_gpu(
+    const PinnedVector<u64> &bit_seqs,
+    const PinnedVector<u64> &invalid_bits,
+    const PinnedVector<u64> &kmer_positions,
+    PinnedVector<u64> &results,
+    u64 batch_id
+  ) -> void;
+  auto search_bucketed(
+    const PinnedVector<u64> &bit_seqs,
+    const PinnedVector<u64> &invalid_bits,
+    const PinnedVector<u64> &kmer_positions,
+    PinnedVector<u64> &results,
+    u64 batch_id
+  ) -> void;
+  auto search_in_order(
+    const PinnedVector<u64> &bit_seqs,
+    const PinnedVector<u64> &invalid_bits,
+    const PinnedVector<u64> &kmer_positions,
+    PinnedVector<u64> &results,
+    u64 batch_id
+  ) -> void;
+  auto search_with_cache(
+    const PinnedVector<u64> &bit_seqs,
+    const PinnedVector<u64> &invalid_bits,
+    const PinnedVector<u64> &kmer_positions,
+    PinnedVector<u64> &results,
+    u64 batch_id
+  ) -> void;
+  auto find_in_cache(
+    const PinnedVector<u64> &bit_seqs,
+    const PinnedVector<u64> &invalid_bits,
+    const PinnedVector<u64> &kmer_positions,
+    PinnedVector<u64> &results
+  ) -> u64;
+  auto queue_cache_misses(
+    const PinnedVector<u64> &bit_seqs,
+    const PinnedVector<u64> &kmer_positions,
+    PinnedVector<u64> &results
+  ) -> void;
+  auto resolve_cache_misses(PinnedVector<u64> &results) -> void;
+  auto log_cache_statistics(u64 batch_id, u64 num_queries, u64 hits) -> void;
   auto copy_to_gpu(
     u64 batch_id,
     const PinnedVector<u64> &bit_seqs,
+    const PinnedVector<u64> &invalid_bits,
     const PinnedVector<u64> &kmer_positions,
     PinnedVector<u64> &results
   ) -> void;
@@ -0,0 +1,151 @@
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "Global/GlobalDefinitions.h"
+#include "IndexSearcher/IndexSearcher.h"
+#include "KmerBucketer/KmerBucketer.h"
+#include "Presearcher/Presearcher.h"
+#include "SbwtContainer/SbwtContainerBenchmarkUtils.h"
+#include "Tools/MathUtils.hpp"
+#include "Tools/PinnedVector.h"
+#include "Tools/RNGUtils.hpp"
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+using gpu_utils::PinnedVector;
+using math_utils::round_up;
+using rng_utils::get_uniform_int_generator;
+
+const u64 search_num_bits = (1ULL << 24) + 3;
+const u64 search_kmer_size = 31;
+
+// Exposes the individual steps of the searcher so that the kernel can be timed
+// on its own
+class IndexSearcherBenchmark: public IndexSearcher {
+public:
+  using IndexSearcher::IndexSearcher;
+  using IndexSearcher::copy_to_gpu;
+  using IndexSearcher::launch_search_kernel;
+  using IndexSearcher::specialise_kmer_size;
+};
+
+auto run_d_search(
+  benchmark::State &state,
+  u64 num_queries,
+  u64 kmer_size,
+  bool move_to_key_kmer,
+  bool specialise_kmer_size,
+  bool bucket_kmers = false
+) -> void {
+  auto container = get_synthetic_cpu_sbwt(search_num_bits, kmer_size)->to_gpu();
+  Presearcher(container).presearch();
+  const u64 num_chars = num_queries + kmer_size - 1;
+  auto bits = get_random_bit_seqs(num_chars);
+  PinnedVector<u64> bit_seqs(bits.size());
+  for (u64 b : bits) { bit_seqs.push_back(b); }
+  auto rng = get_uniform_int_generator<u64>(0, num_chars - kmer_size);
+  PinnedVector<u64> kmer_positions(num_queries);
+  for (u64 i = 0; i < num_queries; ++i) { kmer_positions.push_back(rng()); }
+  if (bucket_kmers) {
+    KmerBucketer bucketer(num_queries);
+    PinnedVector<u64> random_positions(num_queries);
+    for (u64 i = 0; i < num_queries; ++i) {
+      random_positions.push_back(kmer_positions[i]);
+    }
+    bucketer.bucket(
+      bit_seqs.data(),
+      random_positions.data(),
+      num_queries,
+      kmer_size,
+      kmer_positions.data()
+    );
+  }
+  PinnedVector<u64> results(num_queries);
+  const PinnedVector<u64> invalid_bits(0);
+  IndexSearcherBenchmark searcher(
+    0,
+    container,
+    round_up<u64>(num_chars, threads_per_block) + threads_per_block,
+    move_to_key_kmer
+  );
+  searcher.specialise_kmer_size = specialise_kmer_size;
+  for (auto _ : state) {
+    // the results are written on top of the kmer positions on the gpu
+    state.PauseTiming();
+    searcher.copy_to_gpu(0, bit_seqs, invalid_bits, kmer_positions, results);
+    state.ResumeTiming();
+    searcher.launch_search_kernel(num_queries, 0);
+  }
+  state.SetItemsProcessed(
+    static_cast<int64_t>(state.iterations() * num_queries)
+  );
+}
+
+auto benchmark_d_search(benchmark::State &state) -> void {
+  run_d_search(
+    state, state.range(0), search_kmer_size, state.range(1) > 0, true
+  );
+}
+BENCHMARK(benchmark_d_search)
+  ->ArgNames({"queries", "move_to_key_kmer"})
+  ->ArgsProduct({{1ULL << 16, 1ULL << 20}, {0, 1}})
+  ->Unit(benchmark::kMillisecond);
+
+// Compares the kernels specialised for each k against the generic kernel
+auto benchmark_d_search_kmer_size(benchmark::State &state) -> void {
+  const u64 num_queries = 1ULL << 20;
+  run_d_search(state, num_queries, state.range(0), false, state.range(1) > 0);
+}
+BENCHMARK(benchmark_d_search_kmer_size)
+  ->ArgNames({"k", "specialised"})
+  ->ArgsProduct({{15, 21, 25, 31, 63}, {0, 1}})
+  ->Unit(benchmark::kMillisecond);
+
+// Compares the kernel on k-mers in random order against the same k-mers
+// bucketed by their prefix. Build with BENCHMARK_PERF_COUNTERS and run with
+// --benchmark_perf_counters=CACHE-MISSES,DTLB-LOAD-MISSES on the CPU platform
+// to see where the difference comes from.
+auto benchmark_d_search_bucketed(benchmark::State &state) -> void {
+  run_d_search(
+    state, state.range(0), search_kmer_size, false, true, state.range(1) > 0
+  );
+}
+BENCHMARK(benchmark_d_search_bucketed)
+  ->ArgNames({"queries", "bucketed"})
+  ->ArgsProduct({{1ULL << 16, 1ULL << 20}, {0, 1}})
+  ->Unit(benchmark::kMillisecond);
+
+// The cost of bucketing on the host, which the bucketed kernel has to beat
+auto benchmark_kmer_bucketer(benchmark::State &state) -> void {
+  const u64 num_queries = state.range(0);
+  const u64 num_chars = num_queries + search_kmer_size - 1;
+  auto bit_seqs = get_random_bit_seqs(num_chars);
+  auto rng = get_uniform_int_generator<u64>(0, num_chars - search_kmer_size);
+  vector<u64> kmer_positions(num_queries);
+  for (auto &position : kmer_positions) { position = rng(); }
+  vector<u64> bucketed_positions(num_queries);
+  KmerBucketer bucketer(num_queries);
+  for (auto _ : state) {
+    bucketer.bucket(
+      bit_seqs.data(),
+      kmer_positions.data(),
+      num_queries,
+      search_kmer_size,
+      bucketed_positions.data()
+    );
+    bucketer.unbucket(bucketed_positions.data(), kmer_positions.data());
+  }
+  state.SetItemsProcessed(
+    static_cast<int64_t>(state.iterations() * num_queries)
+  );
+}
+BENCHMARK(benchmark_kmer_bucketer)
+  ->ArgNames({"queries"})
+  ->Arg(1ULL << 16)
+  ->Arg(1ULL << 20)
+  ->Unit(benchmark::kMillisecond);
+
+}  // namespace sbwt_search
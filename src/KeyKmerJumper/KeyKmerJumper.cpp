@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <system_error>
+
+#include "KeyKmerJumper/KeyKmerJumper.h"
+#include "PoppyBuilder/PoppyBuilder.h"
+#include "Tools/IOUtils.h"
+#include "Tools/Logger.h"
+#include "fmt/core.h"
+
+namespace sbwt_search {
+
+using fmt::format;
+using io_utils::ThrowingIfstream;
+using io_utils::ThrowingOfstream;
+using log_utils::Logger;
+using std::bit_cast;
+using std::ios;
+using std::make_unique;
+using std::max;
+using std::system_error;
+
+namespace {
+
+const string cache_format = "key-kmer-jumps-v1";
+
+}  // namespace
+
+KeyKmerJumper::KeyKmerJumper(
+  shared_ptr<GpuSbwtContainer> container_, u64 jump_stride_
+):
+    container(std::move(container_)), jump_stride(jump_stride_) {}
+
+auto KeyKmerJumper::load_or_build(
+  const string &cache_filename, const vector<string> &source_filenames
+) -> void {
+  const CacheKey key{
+    jump_stride,
+    container->get_num_bits(),
+    container->get_bit_vector_size(),
+    get_fingerprint(source_filenames)};
+  vector<u64> marks;
+  vector<u64> jumps;
+  const bool cached = read_cache(cache_filename, key, marks, jumps);
+  auto d_marks
+    = make_unique<GpuPointer<u64>>(container->get_bit_vector_size());
+  if (cached) {
+    d_marks->set(marks, marks.size());
+  } else {
+    Logger::log_timed_event("KeyKmerJumpMarks", Logger::EVENT_STATE::START);
+    launch_mark_kernel(*d_marks);
+    Logger::log_timed_event("KeyKmerJumpMarks", Logger::EVENT_STATE::STOP);
+    marks.resize(container->get_bit_vector_size());
+    d_marks->copy_to(marks);
+  }
+  auto poppy = PoppyBuilder(marks, container->get_num_bits()).get_poppy();
+  auto d_layer_0 = make_unique<GpuPointer<u64>>(poppy.layer_0);
+  auto d_layer_1_2 = make_unique<GpuPointer<u64>>(poppy.layer_1_2);
+  // never empty, so that there is always something to point to on the gpu
+  auto d_jumps = make_unique<GpuPointer<u64>>(max<u64>(poppy.total_1s, 1));
+  if (cached) {
+    d_jumps->set(jumps, jumps.size());
+  } else {
+    Logger::log_timed_event("KeyKmerJumps", Logger::EVENT_STATE::START);
+    launch_jump_kernel(*d_marks, *d_layer_0, *d_layer_1_2, *d_jumps);
+    Logger::log_timed_event("KeyKmerJumps", Logger::EVENT_STATE::STOP);
+    jumps.resize(poppy.total_1s);
+    d_jumps->copy_to(jumps, poppy.total_1s);
+    write_cache(cache_filename, key, marks, jumps);
+  }
+  Logger::log(
+    Logger::LOG_LEVEL::INFO,
+    format(
+      "{} {} key k-mer jumps with a stride of {}",
+      cached ? "Loaded" : "Built",
+      poppy.total_1s,
+      jump_stride
+    )
+  );
+  container->set_key_kmer_jumps(
+    std::move(d_marks),
+    std::move(d_layer_0),
+    std::move(d_layer_1_2),
+    std::move(d_jumps)
+  );
+}
+
+auto KeyKmerJumper::get_fingerprint(const vector<string> &source_filenames)
+  -> vector<u64> {
+  vector<u64> fingerprint;
+  for (const auto &filename : source_filenames) {
+    fingerprint.push_back(std::filesystem::file_size(filename));
+    fingerprint.push_back(static_cast<u64>(
+      std::filesystem::last_write_time(filename).time_since_epoch().count()
+    ));
+  }
+  return fingerprint;
+}
+
+auto KeyKmerJumper::read_cache(
+  const string &cache_filename,
+  const CacheKey &key,
+  vector<u64> &marks,
+  vector<u64> &jumps
+) -> bool {
+  if (!std::filesystem::exists(cache_filename)) { return false; }
+  try {
+    ThrowingIfstream in_stream(cache_filename, ios::in | ios::binary);
+    if (in_stream.read_string_with_size() != cache_format
+        || in_stream.read_real<u64>() != key.jump_stride
+        || in_stream.read_real<u64>() != key.num_bits
+        || in_stream.read_real<u64>() != key.fingerprint.size()) {
+      return false;
+    }
+    for (auto value : key.fingerprint) {
+      if (in_stream.read_real<u64>() != value) { return false; }
+    }
+    marks.resize(key.bit_vector_size);
+    in_stream.read(
+      bit_cast<char *>(marks.data()),
+      static_cast<std::streamsize>(marks.size() * sizeof(u64))
+    );
+    u64 num_jumps = 0;
+    for (auto bits : marks) { num_jumps += std::popcount(bits); }
+    if (!in_stream || in_stream.read_real<u64>() != num_jumps) { return false; }
+    jumps.resize(num_jumps);
+    in_stream.read(
+      bit_cast<char *>(jumps.data()),
+      static_cast<std::streamsize>(jumps.size() * sizeof(u64))
+    );
+    // a file which was cut short or has anything extra is rebuilt
+    return static_cast<bool>(in_stream) && in_stream.peek() == EOF;
+  } catch (system_error &e) {
+    Logger::log(
+      Logger::LOG_LEVEL::WARN,
+      format("Could not read the key k-mer jumps from {}", cache_filename)
+    );
+    return false;
+  }
+}
+
+auto KeyKmerJumper::write_cache(
+  const string &cache_filename,
+  const CacheKey &key,
+  const vector<u64> &marks,
+  const vector<u64> &jumps
+) -> void {
+  // written in full before it replaces the cache, so that a run which is
+  // stopped halfway never leaves a broken cache behind
+  const string temporary_filename = cache_filename + ".tmp";
+  try {
+    ThrowingOfstream out_stream(temporary_filename, ios::out | ios::binary);
+    out_stream.write_string_with_size(cache_format);
+    out_stream.write(key.jump_stride);
+    out_stream.write(key.num_bits);
+    out_stream.write(key.fingerprint.size());
+    out_stream.write(key.fingerprint);
+    out_stream.write(marks);
+    out_stream.write(jumps.size());
+    out_stream.write(jumps);
+    out_stream.close();
+    std::filesystem::rename(temporary_filename, cache_filename);
+  } catch (system_error &e) {
+    Logger::log(
+      Logger::LOG_LEVEL::WARN,
+      format(
+        "Could not cache the key k-mer jumps to {}, so they will be built "
+        "again next time",
+        cache_filename
+      )
+    );
+  }
+}
+
+}  // namespace sbwt_search
@@ -0,0 +1,66 @@
+#include "Global/GlobalDefinitions.h"
+#include "KeyKmerJumper/KeyKmerJumper.cuh"
+#include "KeyKmerJumper/KeyKmerJumper.h"
+#include "Tools/GpuUtils.h"
+#include "Tools/MathUtils.hpp"
+#include "hip/hip_runtime.h"
+
+namespace sbwt_search {
+
+using math_utils::round_up;
+
+auto KeyKmerJumper::launch_mark_kernel(GpuPointer<u64> &marks) -> void {
+  const u64 num_nodes = container->get_num_bits();
+  const u64 blocks_per_grid
+    = round_up<u64>(num_nodes, threads_per_block) / threads_per_block;
+  marks.memset(0, 0);
+  hipLaunchKernelGGL(
+    d_mark_jump_nodes,
+    blocks_per_grid,
+    threads_per_block,
+    0,
+    nullptr,
+    container->get_c_map().data(),
+    container->get_acgt_pointers().data(),
+    container->get_layer_0_pointers().data(),
+    container->get_layer_1_2_pointers().data(),
+    container->get_key_kmer_marks().data(),
+    num_nodes,
+    jump_stride,
+    marks.data()
+  );
+  GPU_CHECK(hipPeekAtLastError());
+  GPU_CHECK(hipDeviceSynchronize());
+}
+
+auto KeyKmerJumper::launch_jump_kernel(
+  const GpuPointer<u64> &marks,
+  const GpuPointer<u64> &marks_layer_0,
+  const GpuPointer<u64> &marks_layer_1_2,
+  GpuPointer<u64> &jumps
+) -> void {
+  const u64 num_nodes = container->get_num_bits();
+  const u64 blocks_per_grid
+    = round_up<u64>(num_nodes, threads_per_block) / threads_per_block;
+  hipLaunchKernelGGL(
+    d_fill_key_kmer_jumps,
+    blocks_per_grid,
+    threads_per_block,
+    0,
+    nullptr,
+    container->get_c_map().data(),
+    container->get_acgt_pointers().data(),
+    container->get_layer_0_pointers().data(),
+    container->get_layer_1_2_pointers().data(),
+    container->get_key_kmer_marks().data(),
+    marks.data(),
+    marks_layer_0.data(),
+    marks_layer_1_2.data(),
+    num_nodes,
+    jumps.data()
+  );
+  GPU_CHECK(hipPeekAtLastError());
+  GPU_CHECK(hipDeviceSynchronize());
+}
+
+}  // namespace sbwt_search
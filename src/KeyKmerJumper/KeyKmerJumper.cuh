@@ -0,0 +1,86 @@
+#ifndef KEY_KMER_JUMPER_CUH
+#define KEY_KMER_JUMPER_CUH
+
+/**
+ * @file KeyKmerJumper.cuh
+ * @brief Device functions for building the key k-mer jumps, where each thread
+ * is given a single node of the SBWT
+ */
+
+#include "Tools/TypeDefinitions.h"
+#include "UtilityKernels/GetBoolFromBitVector.cuh"
+#include "UtilityKernels/MoveToKeyKmer.cuh"
+#include "UtilityKernels/Rank.cuh"
+#include "hip/hip_runtime.h"
+
+namespace sbwt_search {
+
+inline __device__ auto d_get_node_idx() -> u64 {
+  return static_cast<u64>(blockDim.x) * blockIdx.x + threadIdx.x;
+}
+
+// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+// Marks the node if the number of edges to its key k-mer is a non zero
+// multiple of the stride. Nodes which never reach a key k-mer are not marked.
+__global__ void d_mark_jump_nodes(
+  const u64 *const c_map,
+  const u64 *const *const acgt,
+  const u64 *const *const layer_0,
+  const u64 *const *const layer_1_2,
+  const u64 *const key_kmer_marks,
+  const u64 num_nodes,
+  const u64 jump_stride,
+  u64 *jump_marks
+) {
+  const u64 node = d_get_node_idx();
+  if (node >= num_nodes) { return; }
+  u64 current = node;
+  u64 distance = 0;
+  while (!d_get_bool_from_bit_vector(key_kmer_marks, current)) {
+    current = d_get_next_node(c_map, acgt, layer_0, layer_1_2, current);
+    if (current == no_next_node) { return; }
+    ++distance;
+  }
+  if (distance == 0 || distance % jump_stride != 0) { return; }
+  // neighbouring nodes share the same u64
+  atomicOr(
+    reinterpret_cast<unsigned long long *>(&jump_marks[node / u64_bits]),
+    1ULL << (node % u64_bits)
+  );
+}
+
+__global__ void d_fill_key_kmer_jumps(
+  const u64 *const c_map,
+  const u64 *const *const acgt,
+  const u64 *const *const layer_0,
+  const u64 *const *const layer_1_2,
+  const u64 *const key_kmer_marks,
+  const u64 *const jump_marks,
+  const u64 *const jump_layer_0,
+  const u64 *const jump_layer_1_2,
+  const u64 num_nodes,
+  u64 *key_kmer_jumps
+) {
+  const u64 node = d_get_node_idx();
+  if (node >= num_nodes || !d_get_bool_from_bit_vector(jump_marks, node)) {
+    return;
+  }
+  key_kmer_jumps[d_rank(jump_marks, jump_layer_0, jump_layer_1_2, node)]
+    = d_move_to_key_kmer(
+      c_map,
+      acgt,
+      layer_0,
+      layer_1_2,
+      key_kmer_marks,
+      nullptr,
+      nullptr,
+      nullptr,
+      nullptr,
+      node
+    );
+}
+// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+}  // namespace sbwt_search
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef KEY_KMER_JUMPER_H
+#define KEY_KMER_JUMPER_H
+
+/**
+ * @file KeyKmerJumper.h
+ * @brief When searching for colors, every k-mer found has to be moved to its
+ * key k-mer by following one edge of the SBWT at a time, which takes as many
+ * ranks as there are edges on the way. The jumper precomputes jump pointers so
+ * that this costs at most jump_stride - 1 edges and a single rank. Each node
+ * which is a multiple of jump_stride edges away from its key k-mer is marked
+ * in a bit vector with a Poppy of its own, and the key k-mer of the n-th
+ * marked node is the n-th jump. A stride of 1 marks every node which is not a
+ * key k-mer, so that the move is always a single jump. The jumps are built on
+ * the gpu once and cached in a file, which is reused for as long as the index
+ * and colors files which it was built from are not changed.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "SbwtContainer/GpuSbwtContainer.h"
+#include "Tools/GpuPointer.h"
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+using gpu_utils::GpuPointer;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+class KeyKmerJumper {
+private:
+  shared_ptr<GpuSbwtContainer> container;
+  u64 jump_stride;
+
+public:
+  KeyKmerJumper(shared_ptr<GpuSbwtContainer> container_, u64 jump_stride_);
+
+  // Gives the jumps to the container, after loading them from the cache file
+  // or building them if the cache is missing or stale. A cache file which
+  // can not be written only results in a warning.
+  auto load_or_build(
+    const string &cache_filename, const vector<string> &source_filenames
+  ) -> void;
+
+  // Changes to any of the files change the fingerprint
+  static auto get_fingerprint(const vector<string> &source_filenames)
+    -> vector<u64>;
+
+  // Everything the jumps depend on, so that a cache with a different key is
+  // stale and the jumps are built again
+  class CacheKey {
+  public:
+    u64 jump_stride = 0;
+    u64 num_bits = 0;
+    u64 bit_vector_size = 0;
+    vector<u64> fingerprint{};
+  };
+  // Returns false if the cache is missing, stale or broken
+  static auto read_cache(
+    const string &cache_filename,
+    const CacheKey &key,
+    vector<u64> &marks,
+    vector<u64> &jumps
+  ) -> bool;
+  static auto write_cache(
+    const string &cache_filename,
+    const CacheKey &key,
+    const vector<u64> &marks,
+    const vector<u64> &jumps
+  ) -> void;
+
+private:
+  auto launch_mark_kernel(GpuPointer<u64> &marks) -> void;
+  auto launch_jump_kernel(
+    const GpuPointer<u64> &marks,
+    const GpuPointer<u64> &marks_layer_0,
+    const GpuPointer<u64> &marks_layer_1_2,
+    GpuPointer<u64> &jumps
+  ) -> void;
+};
+
+}  // namespace sbwt_search
+
+#endif
@@ -0,0 +1,103 @@
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "KeyKmerJumper/KeyKmerJumper.h"
+
+namespace sbwt_search {
+
+using std::string;
+using std::vector;
+
+namespace {
+
+const string folder = "test_objects/tmp/KeyKmerJumperTest";
+const string cache_filename = folder + "/jumps.cache";
+const string source_filename = folder + "/index.sbwt";
+
+// 2 u64s of marks with 3 bits set, so 3 jumps
+const vector<u64> marks = {0b1011, 0};
+const vector<u64> jumps = {7, 11, 13};
+
+auto get_key(const vector<u64> &fingerprint) -> KeyKmerJumper::CacheKey {
+  return {2, 100, marks.size(), fingerprint};
+}
+
+auto write_source(const string &contents) -> void {
+  std::ofstream(source_filename) << contents;
+}
+
+}  // namespace
+
+TEST(KeyKmerJumperTest, WritesAndReadsCache) {
+  std::filesystem::remove_all(folder);
+  std::filesystem::create_directories(folder);
+  write_source("index");
+  const auto key = get_key(KeyKmerJumper::get_fingerprint({source_filename}));
+  vector<u64> read_marks;
+  vector<u64> read_jumps;
+  ASSERT_FALSE(
+    KeyKmerJumper::read_cache(cache_filename, key, read_marks, read_jumps)
+  );
+  KeyKmerJumper::write_cache(cache_filename, key, marks, jumps);
+  // the temporary file is renamed to the cache once it is complete
+  ASSERT_TRUE(std::filesystem::exists(cache_filename));
+  ASSERT_FALSE(std::filesystem::exists(cache_filename + ".tmp"));
+  ASSERT_TRUE(
+    KeyKmerJumper::read_cache(cache_filename, key, read_marks, read_jumps)
+  );
+  ASSERT_EQ(read_marks, marks);
+  ASSERT_EQ(read_jumps, jumps);
+}
+
+TEST(KeyKmerJumperTest, StaleCacheIsNotLoaded) {
+  std::filesystem::remove_all(folder);
+  std::filesystem::create_directories(folder);
+  write_source("index");
+  const auto key = get_key(KeyKmerJumper::get_fingerprint({source_filename}));
+  KeyKmerJumper::write_cache(cache_filename, key, marks, jumps);
+  vector<u64> read_marks;
+  vector<u64> read_jumps;
+  // the index was changed after the cache was written
+  write_source("a changed index");
+  const auto changed_key
+    = get_key(KeyKmerJumper::get_fingerprint({source_filename}));
+  ASSERT_NE(changed_key.fingerprint, key.fingerprint);
+  ASSERT_FALSE(KeyKmerJumper::read_cache(
+    cache_filename, changed_key, read_marks, read_jumps
+  ));
+  // so is a cache with a different stride
+  auto stride_key = key;
+  stride_key.jump_stride = 3;
+  ASSERT_FALSE(KeyKmerJumper::read_cache(
+    cache_filename, stride_key, read_marks, read_jumps
+  ));
+  // the rebuilt jumps replace the stale cache
+  KeyKmerJumper::write_cache(cache_filename, changed_key, marks, jumps);
+  ASSERT_TRUE(KeyKmerJumper::read_cache(
+    cache_filename, changed_key, read_marks, read_jumps
+  ));
+  ASSERT_FALSE(
+    KeyKmerJumper::read_cache(cache_filename, key, read_marks, read_jumps)
+  );
+}
+
+TEST(KeyKmerJumperTest, TruncatedCacheIsNotLoaded) {
+  std::filesystem::remove_all(folder);
+  std::filesystem::create_directories(folder);
+  const auto key = get_key({1, 2});
+  KeyKmerJumper::write_cache(cache_filename, key, marks, jumps);
+  std::filesystem::resize_file(
+    cache_filename, std::filesystem::file_size(cache_filename) - sizeof(u64)
+  );
+  vector<u64> read_marks;
+  vector<u64> read_jumps;
+  ASSERT_FALSE(
+    KeyKmerJumper::read_cache(cache_filename, key, read_marks, read_jumps)
+  );
+}
+
+}  // namespace sbwt_search
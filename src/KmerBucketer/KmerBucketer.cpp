@@ -0,0 +1,108 @@
+#include <algorithm>
+
+#include "Global/GlobalDefinitions.h"
+#include "KmerBucketer/KmerBucketer.h"
+#include "KmerCache/KmerCache.h"
+#include "Tools/MathUtils.hpp"
+#include "Tools/TaskScheduler.h"
+
+namespace sbwt_search {
+
+using math_utils::divide_and_ceil;
+using std::min;
+using threading_utils::TaskScheduler;
+
+namespace {
+
+// The key is split into two digits, one sorted by each pass
+const u64 key_bits = presearch_letters * 2;
+const u64 digit_bits = key_bits / 2;
+const u64 digits = 1ULL << digit_bits;
+const u64 digit_mask = digits - 1;
+
+}  // namespace
+
+KmerBucketer::KmerBucketer(u64 max_kmers) {
+  keys.reserve(max_kmers);
+  order.reserve(max_kmers);
+  scratch_order.reserve(max_kmers);
+}
+
+// The key, the order and the order of the first pass
+auto KmerBucketer::get_bits_per_element() -> u64 {
+  return sizeof(u32) * bits_in_byte + u64_bits * 2;
+}
+
+auto KmerBucketer::bucket(
+  const u64 *bit_seqs,
+  const u64 *kmer_positions,
+  u64 num_kmers,
+  u64 kmer_size,
+  u64 *bucketed_positions
+) -> void {
+  // k-mers shorter than the presearch are keyed on all their characters,
+  // aligned such that the order of the keys stays lexicographic
+  const u64 letters = min(presearch_letters, kmer_size);
+  const u64 key_shift = (presearch_letters - letters) * 2;
+  keys.resize(num_kmers);
+  order.resize(num_kmers);
+  scratch_order.resize(num_kmers);
+  TaskScheduler::get_global().parallel_for_range(num_kmers, [&](u64 i) {
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    const u64 key = get_kmer_key(bit_seqs, kmer_positions[i], letters);
+    keys[i] = static_cast<u32>(key << key_shift);
+    order[i] = i;
+  });
+  sort_pass(order, scratch_order, 0);
+  sort_pass(scratch_order, order, digit_bits);
+  TaskScheduler::get_global().parallel_for_range(num_kmers, [&](u64 i) {
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    bucketed_positions[i] = kmer_positions[order[i]];
+  });
+}
+
+auto KmerBucketer::unbucket(const u64 *bucketed_results, u64 *results)
+  -> void {
+  TaskScheduler::get_global().parallel_for_range(order.size(), [&](u64 i) {
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    results[order[i]] = bucketed_results[i];
+  });
+}
+
+// Each thread counts the digits of its own range, and then scatters its range
+// to the offsets it was given for each digit. Within a digit, the ranges of the
+// threads follow each other in order, which keeps the sort stable.
+auto KmerBucketer::sort_pass(
+  const vector<u64> &from, vector<u64> &to, u64 shift
+) -> void {
+  auto &scheduler = TaskScheduler::get_global();
+  const u64 threads = scheduler.get_threads();
+  const u64 size = from.size();
+  const u64 per_thread = divide_and_ceil<u64>(size, threads);
+  digit_counts.resize(threads);
+  scheduler.parallel_for(threads, [&](u64 idx) {
+    auto &counts = digit_counts[idx];
+    counts.assign(digits, 0);
+    const u64 end = min((idx + 1) * per_thread, size);
+    for (u64 i = min(idx * per_thread, size); i < end; ++i) {
+      ++counts[(keys[from[i]] >> shift) & digit_mask];
+    }
+  });
+  u64 offset = 0;
+  for (u64 digit = 0; digit < digits; ++digit) {
+    for (auto &counts : digit_counts) {
+      const u64 count = counts[digit];
+      counts[digit] = offset;
+      offset += count;
+    }
+  }
+  scheduler.parallel_for(threads, [&](u64 idx) {
+    auto &offsets = digit_counts[idx];
+    const u64 end = min((idx + 1) * per_thread, size);
+    for (u64 i = min(idx * per_thread, size); i < end; ++i) {
+      to[offsets[(keys[from[i]] >> shift) & digit_mask]++] = from[i];
+    }
+  });
+}
+
+}  // namespace sbwt_search
@@ -0,0 +1,53 @@
+#ifndef KMER_BUCKETER_H
+#define KMER_BUCKETER_H
+
+/**
+ * @file KmerBucketer.h
+ * @brief Reorders the k-mers of a batch by their first presearch_letters
+ * characters before they are searched, so that neighbouring gpu threads start
+ * from the same presearched interval and walk nearby parts of the SBWT rather
+ * than unrelated ones. The k-mers are sorted with a stable, parallel LSD radix
+ * sort of two digits, and the permutation is kept so that the results can be
+ * scattered back to the original order of the k-mers afterwards.
+ */
+
+#include <vector>
+
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+using std::vector;
+
+class KmerBucketer {
+private:
+  vector<u32> keys;
+  vector<u64> order;
+  vector<u64> scratch_order;
+  vector<vector<u64>> digit_counts;
+
+public:
+  explicit KmerBucketer(u64 max_kmers);
+
+  static auto get_bits_per_element() -> u64;
+
+  // Writes the positions in bucketed order to bucketed_positions, which must
+  // have space for num_kmers positions
+  auto bucket(
+    const u64 *bit_seqs,
+    const u64 *kmer_positions,
+    u64 num_kmers,
+    u64 kmer_size,
+    u64 *bucketed_positions
+  ) -> void;
+  // Writes the results of the bucketed k-mers back in the original order of
+  // the k-mers given to the last call of bucket
+  auto unbucket(const u64 *bucketed_results, u64 *results) -> void;
+
+private:
+  auto sort_pass(const vector<u64> &from, vector<u64> &to, u64 shift) -> void;
+};
+
+}  // namespace sbwt_search
+
+#endif
@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Global/GlobalDefinitions.h"
+#include "KmerBucketer/KmerBucketer.h"
+#include "KmerCache/KmerCache.h"
+
+namespace sbwt_search {
+
+using std::min;
+using std::string;
+using std::vector;
+
+namespace {
+
+// Packs the string with the same layout as the BitsProducer, where each u64
+// holds 32 characters and the first character is the most significant
+auto to_bit_seqs(const string &seq) -> vector<u64> {
+  const u64 chars_per_u64 = 32;
+  vector<u64> result(seq.size() / chars_per_u64 + 1, 0);
+  for (u64 i = 0; i < seq.size(); ++i) {
+    result[i / chars_per_u64] |= string("ACGT").find(seq[i])
+      << (62 - (i % chars_per_u64) * 2);
+  }
+  return result;
+}
+
+auto get_random_seq(u64 size) -> string {
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<u64> distribution(0, 3);
+  string result;
+  for (u64 i = 0; i < size; ++i) { result += "ACGT"[distribution(rng)]; }
+  return result;
+}
+
+auto run_test(u64 kmer_size) -> void {
+  const u64 num_chars = 20000;
+  const auto bit_seqs = to_bit_seqs(get_random_seq(num_chars));
+  // every other position, so that the positions are not simply the indexes
+  vector<u64> kmer_positions;
+  for (u64 i = 0; i + kmer_size <= num_chars; i += 2) {
+    kmer_positions.push_back(i);
+  }
+  KmerBucketer bucketer(kmer_positions.size());
+  vector<u64> bucketed_positions(kmer_positions.size());
+  bucketer.bucket(
+    bit_seqs.data(),
+    kmer_positions.data(),
+    kmer_positions.size(),
+    kmer_size,
+    bucketed_positions.data()
+  );
+  const u64 letters = min(presearch_letters, kmer_size);
+  auto get_key = [&](u64 position) {
+    return get_kmer_key(bit_seqs.data(), position, letters);
+  };
+  for (u64 i = 1; i < bucketed_positions.size(); ++i) {
+    const u64 previous = get_key(bucketed_positions[i - 1]);
+    const u64 current = get_key(bucketed_positions[i]);
+    ASSERT_LE(previous, current);
+    // k-mers with the same prefix keep their original order
+    if (previous == current) {
+      ASSERT_LT(bucketed_positions[i - 1], bucketed_positions[i]);
+    }
+  }
+  // use the positions as the results, which should come back in order
+  vector<u64> results(kmer_positions.size());
+  bucketer.unbucket(bucketed_positions.data(), results.data());
+  ASSERT_EQ(results, kmer_positions);
+}
+
+}  // namespace
+
+TEST(KmerBucketerTest, BucketsByPrefixAndRestoresOrder) {
+  // shorter than, equal to and longer than the presearch
+  for (auto kmer_size : {5, 12, 31}) { run_test(kmer_size); }
+}
+
+TEST(KmerBucketerTest, Empty) {
+  KmerBucketer bucketer(0);
+  const vector<u64> bit_seqs = {0};
+  bucketer.bucket(bit_seqs.data(), nullptr, 0, 31, nullptr);
+  bucketer.unbucket(nullptr, nullptr);
+}
+
+}  // namespace sbwt_search
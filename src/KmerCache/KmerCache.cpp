@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <vector>
+
+#include "Global/GlobalDefinitions.h"
+#include "KmerCache/KmerCache.h"
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+using std::atomic_ref;
+using std::memory_order_relaxed;
+
+namespace {
+
+const u64 bucket_size = 8;
+const u8 occupied_flag = 1;
+const u8 referenced_flag = 2;
+const u64 chars_per_word = u64_bits / 2;
+
+// The splitmix64 finalizer, so that k-mers which only differ in their last
+// characters still land in different buckets
+auto mix(u64 word) -> u64 {
+  word ^= word >> 30;
+  word *= 0xbf58476d1ce4e5b9ULL;
+  word ^= word >> 27;
+  word *= 0x94d049bb133111ebULL;
+  word ^= word >> 31;
+  return word;
+}
+
+// Looks for an invalid character within a single word of the bitmap, where
+// kmer_size is at most u64_bits
+auto has_invalid_char_in_word(
+  const u64 *invalid_bits, u64 position, u64 kmer_size
+) -> bool {
+  const u64 shift = position % u64_bits;
+  u64 window = invalid_bits[position / u64_bits] << shift;
+  if (shift != 0 && shift + kmer_size > u64_bits) {
+    window |= invalid_bits[position / u64_bits + 1] >> (u64_bits - shift);
+  }
+  return window >> (u64_bits - kmer_size) != 0;
+}
+
+}  // namespace
+
+KmerCache::KmerCache(u64 max_entries):
+    bucket_mask(
+      std::bit_floor(std::max<u64>(max_entries / bucket_size, 1)) - 1
+    ) {
+  keys.resize(get_capacity());
+  values.resize(get_capacity());
+  flags.resize(get_capacity(), 0);
+  hands.resize(bucket_mask + 1, 0);
+}
+
+auto KmerCache::get_bits_per_entry() -> u64 {
+  const u64 bits_per_hand = bits_in_byte / bucket_size;
+  return u64_bits * 3 + bits_in_byte + bits_per_hand;
+}
+
+auto KmerCache::get_capacity() const -> u64 {
+  return (bucket_mask + 1) * bucket_size;
+}
+
+auto KmerCache::find(const KmerKey &key, u64 &value) -> bool {
+  const u64 start = get_bucket_start(key);
+  for (u64 slot = start; slot < start + bucket_size; ++slot) {
+    atomic_ref<u8> flag(flags[slot]);
+    const u8 current_flag = flag.load(memory_order_relaxed);
+    // entries are never removed, only replaced, so no key can come after a
+    // free slot
+    if ((current_flag & occupied_flag) == 0) { return false; }
+    if (keys[slot] == key) {
+      value = values[slot];
+      if ((current_flag & referenced_flag) == 0) {
+        flag.fetch_or(referenced_flag, memory_order_relaxed);
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+auto KmerCache::insert(const KmerKey &key, u64 value) -> void {
+  const u64 start = get_bucket_start(key);
+  for (u64 slot = start; slot < start + bucket_size; ++slot) {
+    if ((flags[slot] & occupied_flag) == 0 || keys[slot] == key) {
+      keys[slot] = key;
+      values[slot] = value;
+      flags[slot] |= occupied_flag;
+      return;
+    }
+  }
+  u8 &hand = hands[start / bucket_size];
+  while ((flags[start + hand] & referenced_flag) != 0) {
+    flags[start + hand] &= ~referenced_flag;
+    hand = (hand + 1) % bucket_size;
+  }
+  keys[start + hand] = key;
+  values[start + hand] = value;
+  flags[start + hand] = occupied_flag;
+  hand = (hand + 1) % bucket_size;
+}
+
+// Both words go through the hash, so that k-mers which only differ after
+// their first 32 characters land in different buckets too. Since mix(0) is 0,
+// k-mers of up to 32 characters hash only their first word.
+auto KmerCache::get_bucket_start(const KmerKey &key) const -> u64 {
+  return (mix(key.first ^ mix(key.second)) & bucket_mask) * bucket_size;
+}
+
+auto get_kmer_key(const u64 *bit_seqs, u64 position, u64 kmer_size) -> u64 {
+  const u64 bit_index = position * 2;
+  const u64 shift = bit_index % u64_bits;
+  u64 kmer = bit_seqs[bit_index / u64_bits] << shift;
+  // only read the next word if the k-mer continues into it
+  if (shift != 0 && shift + kmer_size * 2 > u64_bits) {
+    kmer |= bit_seqs[bit_index / u64_bits + 1] >> (u64_bits - shift);
+  }
+  return kmer_size * 2 == u64_bits ? kmer : kmer >> (u64_bits - kmer_size * 2);
+}
+
+auto get_kmer_cache_key(const u64 *bit_seqs, u64 position, u64 kmer_size)
+  -> KmerKey {
+  if (kmer_size <= chars_per_word) {
+    return {get_kmer_key(bit_seqs, position, kmer_size), 0};
+  }
+  return {
+    get_kmer_key(bit_seqs, position, chars_per_word),
+    get_kmer_key(
+      bit_seqs, position + chars_per_word, kmer_size - chars_per_word
+    )};
+}
+
+auto has_invalid_char(const u64 *invalid_bits, u64 position, u64 kmer_size)
+  -> bool {
+  const u64 end = position + kmer_size;
+  for (u64 start = position; start < end; start += u64_bits) {
+    if (has_invalid_char_in_word(
+          invalid_bits, start, std::min(u64_bits, end - start)
+        )) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace sbwt_search
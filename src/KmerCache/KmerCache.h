@@ -0,0 +1,79 @@
+#ifndef KMER_CACHE_H
+#define KMER_CACHE_H
+
+/**
+ * @file KmerCache.h
+ * @brief A fixed size, host resident cache from k-mers packed into 2 bits per
+ * character to their search result. It is an open addressing table where each
+ * key may only be placed within the 8 slots of the bucket it hashes to, so
+ * that a lookup touches a single cache line of keys. When a bucket is full,
+ * the clock policy picks which entry to evict: every hit sets the reference
+ * bit of its entry, and the hand of the bucket skips over referenced entries,
+ * clearing their bit, until it finds one which has not been used since the
+ * hand last passed it. Lookups may run concurrently with each other, but not
+ * with insertions. Each key holds the whole k-mer in two words, so the cache
+ * is limited to k-mers of up to max_kmer_size characters.
+ */
+
+#include <vector>
+
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+using std::vector;
+
+// The first word holds the first 32 characters of the k-mer and the second
+// word holds the rest, each in the layout of get_kmer_key. The second word is
+// 0 when k is at most 32.
+class KmerKey {
+public:
+  u64 first = 0;
+  u64 second = 0;
+
+  auto operator==(const KmerKey &other) const -> bool = default;
+};
+
+class KmerCache {
+private:
+  vector<KmerKey> keys;
+  vector<u64> values;
+  vector<u8> flags;
+  vector<u8> hands;
+  u64 bucket_mask;
+
+public:
+  // two words of u64_bits / 2 characters each
+  static const u64 max_kmer_size = u64_bits;
+
+  explicit KmerCache(u64 max_entries);
+
+  static auto get_bits_per_entry() -> u64;
+  [[nodiscard]] auto get_capacity() const -> u64;
+  auto find(const KmerKey &key, u64 &value) -> bool;
+  auto insert(const KmerKey &key, u64 value) -> void;
+
+private:
+  [[nodiscard]] auto get_bucket_start(const KmerKey &key) const -> u64;
+};
+
+// Gets the k-mer starting at the given position of the bit sequences, in the
+// same layout as the search kernel, where the first character of the k-mer is
+// the most significant. The k-mer may be at most 32 characters long.
+auto get_kmer_key(const u64 *bit_seqs, u64 position, u64 kmer_size) -> u64;
+
+// Gets the key of the whole k-mer for the KmerCache, for k-mers of up to
+// KmerCache::max_kmer_size characters
+auto get_kmer_cache_key(const u64 *bit_seqs, u64 position, u64 kmer_size)
+  -> KmerKey;
+
+// Tells whether the k-mer starting at the given position contains a character
+// which is set in the bitmap of invalid characters, which has a bit per
+// character in the same layout as the bit sequences. The k-mer may be of any
+// size.
+auto has_invalid_char(const u64 *invalid_bits, u64 position, u64 kmer_size)
+  -> bool;
+
+}  // namespace sbwt_search
+
+#endif
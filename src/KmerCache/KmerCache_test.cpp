@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "KmerCache/KmerCache.h"
+
+namespace sbwt_search {
+
+using std::string;
+using std::vector;
+
+namespace {
+
+auto char_to_bits(char c) -> u64 { return string("ACGT").find(c); }
+
+// Packs the string with the same layout as the BitsProducer, where each u64
+// holds 32 characters and the first character is the most significant
+auto to_bit_seqs(const string &seq) -> vector<u64> {
+  const u64 chars_per_u64 = 32;
+  vector<u64> result(seq.size() / chars_per_u64 + 1, 0);
+  for (u64 i = 0; i < seq.size(); ++i) {
+    result[i / chars_per_u64]
+      |= char_to_bits(seq[i]) << (62 - (i % chars_per_u64) * 2);
+  }
+  return result;
+}
+
+auto get_expected_key(const string &seq, u64 position, u64 kmer_size) -> u64 {
+  u64 expected = 0;
+  for (u64 i = 0; i < kmer_size; ++i) {
+    expected = (expected << 2) | char_to_bits(seq[position + i]);
+  }
+  return expected;
+}
+
+}  // namespace
+
+TEST(KmerCacheTest, InsertAndFind) {
+  KmerCache cache(1024);
+  ASSERT_EQ(cache.get_capacity(), 1024);
+  u64 value = 0;
+  ASSERT_FALSE(cache.find({5, 0}, value));
+  cache.insert({5, 0}, 50);
+  cache.insert({6, 0}, static_cast<u64>(-1));
+  ASSERT_TRUE(cache.find({5, 0}, value));
+  ASSERT_EQ(value, 50);
+  ASSERT_TRUE(cache.find({6, 0}, value));
+  ASSERT_EQ(value, static_cast<u64>(-1));
+  cache.insert({5, 0}, 500);
+  ASSERT_TRUE(cache.find({5, 0}, value));
+  ASSERT_EQ(value, 500);
+  ASSERT_FALSE(cache.find({7, 0}, value));
+}
+
+TEST(KmerCacheTest, ClockEvictionKeepsReferencedEntries) {
+  // a single bucket of 8 entries
+  KmerCache cache(8);
+  ASSERT_EQ(cache.get_capacity(), 8);
+  u64 value = 0;
+  for (u64 key = 0; key < 8; ++key) { cache.insert({key, 0}, key * 10); }
+  for (u64 key = 0; key < 4; ++key) {
+    ASSERT_TRUE(cache.find({key, 0}, value));
+  }
+  cache.insert({100, 0}, 1000);
+  cache.insert({101, 0}, 1010);
+  ASSERT_TRUE(cache.find({100, 0}, value));
+  ASSERT_EQ(value, 1000);
+  ASSERT_TRUE(cache.find({101, 0}, value));
+  ASSERT_EQ(value, 1010);
+  for (u64 key = 0; key < 4; ++key) {
+    ASSERT_TRUE(cache.find({key, 0}, value));
+    ASSERT_EQ(value, key * 10);
+  }
+  ASSERT_FALSE(cache.find({4, 0}, value));
+  ASSERT_FALSE(cache.find({5, 0}, value));
+  for (u64 key = 6; key < 8; ++key) {
+    ASSERT_TRUE(cache.find({key, 0}, value));
+  }
+}
+
+TEST(KmerCacheTest, GetKmerKey) {
+  const string seq = "ACGTTGCAACGTAAACCCGGGTTTACGTACGTAGCTAGCTTTGCA";
+  auto bit_seqs = to_bit_seqs(seq);
+  for (u64 kmer_size : {1, 3, 31, 32}) {
+    for (u64 position = 0; position + kmer_size <= seq.size(); ++position) {
+      ASSERT_EQ(
+        get_kmer_key(bit_seqs.data(), position, kmer_size),
+        get_expected_key(seq, position, kmer_size)
+      ) << "at position " << position << " with k " << kmer_size;
+    }
+  }
+}
+
+TEST(KmerCacheTest, GetKmerCacheKey) {
+  const string seq
+    = "ACGTTGCAACGTAAACCCGGGTTTACGTACGTAGCTAGCTTTGCAGGCATCGATCGGATCCATG"
+      "TTGACCAGTGCATGCAAGTCGATCGTACGATTTACGACGGCTAGCATCGAT";
+  auto bit_seqs = to_bit_seqs(seq);
+  for (u64 kmer_size : {1, 31, 32, 33, 63, 64}) {
+    for (u64 position = 0; position + kmer_size <= seq.size(); ++position) {
+      const u64 first_size = std::min<u64>(kmer_size, 32);
+      const KmerKey expected{
+        get_expected_key(seq, position, first_size),
+        get_expected_key(seq, position + first_size, kmer_size - first_size)};
+      ASSERT_EQ(
+        get_kmer_cache_key(bit_seqs.data(), position, kmer_size), expected
+      ) << "at position " << position << " with k " << kmer_size;
+    }
+  }
+}
+
+TEST(KmerCacheTest, KmersWhichOnlyDifferAfterTheFirstWordDoNotCollide) {
+  const u64 kmer_size = 63;
+  const string first_seq
+    = "ACGTTGCAACGTAAACCCGGGTTTACGTACGTAGCTAGCTTTGCAGGCATCGATCGGATCCAT";
+  string second_seq = first_seq;
+  second_seq[40] = 'G';
+  auto first_bits = to_bit_seqs(first_seq);
+  auto second_bits = to_bit_seqs(second_seq);
+  auto first_key = get_kmer_cache_key(first_bits.data(), 0, kmer_size);
+  auto second_key = get_kmer_cache_key(second_bits.data(), 0, kmer_size);
+  ASSERT_EQ(first_key.first, second_key.first);
+  ASSERT_NE(first_key, second_key);
+  KmerCache cache(1024);
+  cache.insert(first_key, 1);
+  u64 value = 0;
+  ASSERT_FALSE(cache.find(second_key, value));
+  cache.insert(second_key, 2);
+  ASSERT_TRUE(cache.find(first_key, value));
+  ASSERT_EQ(value, 1);
+  ASSERT_TRUE(cache.find(second_key, value));
+  ASSERT_EQ(value, 2);
+}
+
+TEST(KmerCacheTest, HasInvalidChar) {
+  const string seq
+    = "ACGTNACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACN"
+      "ACGTACGTACGTACGTACGTACGTACGTANACGTACGTACGTACGTACGTACGTACGTACGTAC"
+      "GTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTAC"
+      "GTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTNA"
+      "CGTACGTACGT";
+  vector<u64> invalid_bits(seq.size() / u64_bits + 2, 0);
+  for (u64 i = 0; i < seq.size(); ++i) {
+    if (seq[i] == 'N') {
+      invalid_bits[i / u64_bits] |= 1ULL << (u64_bits - 1 - i % u64_bits);
+    }
+  }
+  for (u64 kmer_size : {1, 3, 31, 32, 63, 64, 65, 100, 130}) {
+    for (u64 position = 0; position + kmer_size <= seq.size(); ++position) {
+      const bool expected
+        = seq.substr(position, kmer_size).find('N') != string::npos;
+      ASSERT_EQ(
+        has_invalid_char(invalid_bits.data(), position, kmer_size), expected
+      ) << "at position " << position << " with k " << kmer_size;
+    }
+  }
+}
+
+}  // namespace sbwt_search
@@ -0,0 +1,39 @@
+#include <memory>
+#include <string>
+
+#include "ArgumentParser/BuildIndexArgumentParser.h"
+#include "Main/BuildIndexMain.h"
+#include "SbwtConstructor/SbwtConstructor.h"
+#include "Tools/Logger.h"
+
+namespace sbwt_search {
+
+using log_utils::Logger;
+using std::make_unique;
+using std::string;
+
+auto BuildIndexMain::main(int argc, char **argv) -> int {
+  const string program_name = "build";
+  const string program_description = "sbwt_search";
+  Logger::log_timed_event("main", Logger::EVENT_STATE::START);
+  auto args = make_unique<BuildIndexArgumentParser>(
+    program_name, program_description, argc, argv
+  );
+  log_resource_limits();
+  load_threads();
+  SbwtConstructor constructor(
+    args->get_kmer_size(),
+    args->get_add_reverse_complements(),
+    args->get_precalc_size()
+  );
+  for (auto &filename : args->get_input_files()) {
+    constructor.add_fasta(filename);
+  }
+  constructor.construct();
+  constructor.write(args->get_output_file());
+  Logger::log(Logger::LOG_LEVEL::INFO, "Finished");
+  Logger::log_timed_event("main", Logger::EVENT_STATE::STOP);
+  return 0;
+}
+
+}  // namespace sbwt_search
@@ -0,0 +1,21 @@
+#ifndef BUILD_INDEX_MAIN_H
+#define BUILD_INDEX_MAIN_H
+
+/**
+ * @file BuildIndexMain.h
+ * @brief The main function for constructing a plain-matrix SBWT index from
+ * FASTA files. The 'build' mode of the main executable.
+ */
+
+#include "Main/Main.h"
+
+namespace sbwt_search {
+
+class BuildIndexMain: public Main {
+public:
+  auto main(int argc, char **argv) -> int override;
+};
+
+}  // namespace sbwt_search
+
+#endif
@@ -11,40 +11,59 @@
 #include "Global/GlobalDefinitions.h"
 #include "Main/ColorSearchMain.h"
 #include "Tools/GpuUtils.h"
+#include "Tools/IOUtils.h"
 #include "Tools/Logger.h"
 #include "Tools/MathUtils.hpp"
-#include "Tools/MemoryUtils.h"
+#include "Tools/MemoryTracker.h"
+#include "Tools/Metrics.h"
+#include "Tools/PipelineProfiler.h"
+#include "Tools/ResourceLimits.h"
 #include "Tools/StdUtils.hpp"
+#include "Tools/TaskScheduler.h"
 #include "fmt/core.h"
 
 namespace sbwt_search {
 
 using fmt::format;
 using gpu_utils::get_free_gpu_memory;
+using io_utils::is_standard_stream;
 using log_utils::Logger;
+using log_utils::Metrics;
+using log_utils::PipelineProfiler;
 using math_utils::bits_to_gB;
 using math_utils::divide_and_round;
 using math_utils::round_down;
-using memory_utils::get_total_system_memory;
+using memory_utils::MemoryTracker;
 using std::cerr;
 using std::endl;
 using std::make_shared;
 using std::min;
+using std::function;
 using std::runtime_error;
+using system_utils::get_resource_limits;
+using threading_utils::TaskScheduler;
 
 const u64 interval_batch_producer_max_batches = 2;
 const u64 seq_statistics_batch_producer_max_batches = 2;
 const u64 indexes_batch_producer_max_batches = 2;
 const u64 color_searcher_max_batches = 2;
+const u64 results_printer_max_batches = 2;
 
 auto ColorSearchMain::main(int argc, char **argv) -> int {
   const string program_name = "colors";
   const string program_description = "sbwt_search";
-  Logger::log_timed_event("main", Logger::EVENT_STATE::START);
   args = make_unique<ColorSearchArgumentParser>(
     program_name, program_description, argc, argv
   );
-  load_threads();
+  if (is_standard_stream(get_args().get_output_file())) {
+    Logger::log_to_standard_error();
+  }
+  Logger::log_timed_event("main", Logger::EVENT_STATE::START);
+  start_metrics(
+    get_args().get_metrics_file(), get_args().get_metrics_interval()
+  );
+  log_resource_limits();
+  load_threads(get_args().get_pin_threads());
   Logger::log(Logger::LOG_LEVEL::INFO, "Loading components into memory");
   auto gpu_container = get_gpu_container();
   num_colors = gpu_container->num_colors;
@@ -52,16 +71,23 @@ auto ColorSearchMain::main(int argc, char **argv) -> int {
     Logger::LOG_LEVEL::INFO, format("Found {} total colors", num_colors)
   );
   auto [input_filenames, output_filenames] = get_input_output_filenames();
+  if (finish_if_complete(streams)) { return 0; }
   load_batch_info();
-  omp_set_nested(1);
+  set_memory_estimates();
   Logger::log(
     Logger::LOG_LEVEL::INFO,
-    format("Running OpenMP with {} threads", get_threads())
+    format("Running with {} worker threads", get_threads())
   );
   auto [index_file_parser, searcher, results_printer]
     = get_components(gpu_container, input_filenames, output_filenames);
   Logger::log(Logger::LOG_LEVEL::INFO, "Running queries");
+  if (get_args().get_bottleneck_report()) { PipelineProfiler::start(); }
   run_components(index_file_parser, searcher, results_printer);
+  if (get_args().get_bottleneck_report()) {
+    cerr << PipelineProfiler::get_report();
+  }
+  MemoryTracker::log_report(get_args().get_memory_estimate_margin());
+  Metrics::stop();
   Logger::log(Logger::LOG_LEVEL::INFO, "Finished");
   Logger::log_timed_event("main", Logger::EVENT_STATE::STOP);
   return 0;
@@ -113,7 +139,7 @@ auto ColorSearchMain::get_max_chars_per_batch_gpu() -> u64 {
   const double bits_required_per_character =
     // bits per element
     static_cast<double>(ContinuousColorSearcher::get_bits_per_element_gpu(
-      num_colors, get_args().get_indexes_per_seq()
+      num_colors, get_args().get_indexes_per_seq(), get_args().get_top_colors()
     ))
     // bits per warp
     + static_cast<double>(
@@ -138,13 +164,14 @@ auto ColorSearchMain::get_max_chars_per_batch_gpu() -> u64 {
 }
 
 auto ColorSearchMain::get_max_chars_per_batch_cpu() -> u64 {
-  if (get_args().get_unavailable_ram() > get_total_system_memory() * bits_in_byte) {
+  // the memory of the cgroup or Slurm allocation if it is lower than the
+  // memory of the machine
+  const u64 system_memory = get_resource_limits().get_memory() * bits_in_byte;
+  if (get_args().get_unavailable_ram() > system_memory) {
     throw runtime_error("Not enough memory. Please specify a lower number of "
                         "unavailable-main-memory.");
   }
-  u64 available_ram = min(
-    get_total_system_memory() * bits_in_byte, get_args().get_max_cpu_memory()
-  );
+  u64 available_ram = min(system_memory, get_args().get_max_cpu_memory());
   u64 unavailable_ram = get_args().get_unavailable_ram();
   u64 free_bits = (unavailable_ram > available_ram) ?
     0 :
@@ -152,7 +179,13 @@ auto ColorSearchMain::get_max_chars_per_batch_cpu() -> u64 {
       static_cast<double>(available_ram - unavailable_ram)
       * get_args().get_cpu_memory_percentage()
     );
-  const double bits_required_per_character = (
+  // memory which each stream takes once, whatever the size of its batches
+  const u64 stream_bits = get_results_printer_bits_per_stream() * streams;
+  free_bits = free_bits > stream_bits ? free_bits - stream_bits : 0;
+  // with gzip output, every buffer also has a compressed copy
+  const u64 results_printer_buffers = results_printer_max_batches
+    * (get_args().get_gzip_output() ? 2 : 1);
+  cpu_bits_per_index = (
     // bits per element
     static_cast<double>(
       IndexesBatchProducer::get_bits_per_element()
@@ -164,9 +197,11 @@ auto ColorSearchMain::get_max_chars_per_batch_cpu() -> u64 {
           * indexes_batch_producer_max_batches
         + SeqStatisticsBatchProducer::get_bits_per_seq()
           * seq_statistics_batch_producer_max_batches
-        + ContinuousColorSearcher::get_bits_per_seq_cpu(num_colors)
+        + ContinuousColorSearcher::get_bits_per_seq_cpu(
+            num_colors, get_args().get_top_colors()
+          )
           * color_searcher_max_batches
-        + get_results_printer_bits_per_seq()
+        + get_results_printer_bits_per_seq() * results_printer_buffers
       )
       / static_cast<double>(get_args().get_indexes_per_seq())
 #if defined(__HIP_CPU_RT__)  // include gpu required memory as well
@@ -185,7 +220,7 @@ auto ColorSearchMain::get_max_chars_per_batch_cpu() -> u64 {
 #endif
   );
   u64 max_chars_per_batch = static_cast<u64>(std::floor(
-    static_cast<double>(free_bits) / bits_required_per_character
+    static_cast<double>(free_bits) / cpu_bits_per_index
     / static_cast<double>(streams)
   ));
   Logger::log(
@@ -201,6 +236,54 @@ auto ColorSearchMain::get_max_chars_per_batch_cpu() -> u64 {
   return max_chars_per_batch;
 }
 
+// What the planner expects each stage to take, so that the memory tracker can
+// tell when the formulas above no longer match what is allocated
+auto ColorSearchMain::set_memory_estimates() -> void {
+  const u64 parser_bits
+    = (IndexesBatchProducer::get_bits_per_element() * max_indexes_per_batch
+       + IndexesBatchProducer::get_bits_per_seq() * max_seqs_per_batch)
+    * indexes_batch_producer_max_batches;
+  const u64 searcher_bits = ContinuousColorSearcher::get_bits_per_seq_cpu(
+                              num_colors, get_args().get_top_colors()
+                            )
+    * max_seqs_per_batch * color_searcher_max_batches;
+  const double searcher_gpu_bits
+    = (ContinuousColorSearcher::get_bits_per_element_gpu(
+         num_colors,
+         get_args().get_indexes_per_seq(),
+         get_args().get_top_colors()
+       )
+       + static_cast<double>(
+           ContinuousColorSearcher::get_bits_per_warp_gpu(num_colors)
+         )
+         / static_cast<double>(gpu_warp_size))
+    * static_cast<double>(max_indexes_per_batch);
+  for (u64 i = 0; i < streams; ++i) {
+    MemoryTracker::set_estimate(
+      format("ContinuousIndexFileParser_{}", i),
+      MemoryTracker::MEMORY_KIND::PINNED,
+      parser_bits / bits_in_byte
+    );
+    MemoryTracker::set_estimate(
+      format("Searcher_{}", i),
+      MemoryTracker::MEMORY_KIND::PINNED,
+      searcher_bits / bits_in_byte
+    );
+    MemoryTracker::set_estimate(
+      format("Searcher_{}", i),
+      MemoryTracker::MEMORY_KIND::GPU,
+      static_cast<u64>(searcher_gpu_bits / bits_in_byte)
+    );
+  }
+  MemoryTracker::start_host_measurement(
+    static_cast<u64>(
+      cpu_bits_per_index
+      * static_cast<double>(max_indexes_per_batch * streams) / bits_in_byte
+    )
+    + get_results_printer_bits_per_stream() * streams / bits_in_byte
+  );
+}
+
 auto ColorSearchMain::get_results_printer_bits_per_seq() -> u64 {
   if (get_args().get_print_mode() == "ascii") {
     return AsciiContinuousColorResultsPrinter::get_bits_per_seq(num_colors);
@@ -214,9 +297,21 @@ auto ColorSearchMain::get_results_printer_bits_per_seq() -> u64 {
   if (get_args().get_print_mode() == "packedint") {
     return PackedIntContinuousColorResultsPrinter::get_bits_per_seq(num_colors);
   }
+  if (get_args().get_print_mode() == "abundance") {
+    return AbundanceContinuousColorResultsPrinter::get_bits_per_seq(num_colors);
+  }
   throw runtime_error("Invalid value passed by user for argument print_mode");
 }
 
+auto ColorSearchMain::get_results_printer_bits_per_stream() -> u64 {
+  if (get_args().get_print_mode() == "abundance") {
+    return AbundanceContinuousColorResultsPrinter::get_bits_per_stream(
+      num_colors, get_threads()
+    );
+  }
+  return 0;
+}
+
 auto ColorSearchMain::get_input_output_filenames()
   -> std::tuple<vector<vector<string>>, vector<vector<string>>> {
   FilenamesParser filenames_parser(
@@ -227,6 +322,12 @@ auto ColorSearchMain::get_input_output_filenames()
   if (input_filenames.size() != output_filenames.size()) {
     throw runtime_error("Input and output file sizes differ");
   }
+  apply_checkpoint(
+    input_filenames,
+    output_filenames,
+    get_args().get_checkpoint_file(),
+    get_args().get_resume()
+  );
   streams = min(input_filenames.size(), args->get_streams());
   Logger::log(Logger::LOG_LEVEL::DEBUG, format("Using {} streams", streams));
   return FilesizeLoadBalancer(input_filenames, output_filenames)
@@ -254,6 +355,9 @@ auto ColorSearchMain::get_components(
     Logger::log_timed_event(
       format("IndexFileParserAllocator_{}", i), Logger::EVENT_STATE::START
     );
+    MemoryTracker::set_thread_component(
+      format("ContinuousIndexFileParser_{}", i)
+    );
     index_file_parsers[i] = make_shared<ContinuousIndexFileParser>(
       i,
       max_indexes_per_batch,
@@ -261,7 +365,8 @@ auto ColorSearchMain::get_components(
       gpu_warp_size,
       split_input_filenames[i],
       seq_statistics_batch_producer_max_batches,
-      indexes_batch_producer_max_batches
+      indexes_batch_producer_max_batches,
+      get_args().get_paired_end()
     );
     Logger::log_timed_event(
       format("IndexFileParserAllocator_{}", i), Logger::EVENT_STATE::STOP
@@ -269,6 +374,7 @@ auto ColorSearchMain::get_components(
     Logger::log_timed_event(
       format("SearcherAllocator_{}", i), Logger::EVENT_STATE::START
     );
+    MemoryTracker::set_thread_component(format("Searcher_{}", i));
     searchers[i] = make_shared<ContinuousColorSearcher>(
       i,
       gpu_container,
@@ -276,7 +382,10 @@ auto ColorSearchMain::get_components(
       max_indexes_per_batch,
       max_seqs_per_batch,
       color_searcher_max_batches,
-      gpu_container->num_colors
+      gpu_container->num_colors,
+      // the top colors are picked from the counts
+      get_args().get_threshold() == 1 && get_args().get_top_colors() == 0,
+      get_args().get_top_colors()
     );
     Logger::log_timed_event(
       format("SearcherAllocator_{}", i), Logger::EVENT_STATE::STOP
@@ -284,6 +393,7 @@ auto ColorSearchMain::get_components(
     Logger::log_timed_event(
       format("ResultsPrinterAllocator_{}", i), Logger::EVENT_STATE::START
     );
+    MemoryTracker::set_thread_component(format("ResultsPrinter_{}", i));
     results_printers[i] = get_results_printer(
       i,
       index_file_parsers[i],
@@ -291,9 +401,28 @@ auto ColorSearchMain::get_components(
       split_output_filenames[i],
       num_colors
     );
+    std::visit(
+      [&](auto &arg) -> void { arg.set_checkpointer(get_checkpointer()); },
+      *results_printers[i]
+    );
     Logger::log_timed_event(
       format("ResultsPrinterAllocator_{}", i), Logger::EVENT_STATE::STOP
     );
+    MemoryTracker::set_thread_component("");
+
+    if (Metrics::is_enabled() || get_args().get_bottleneck_report()) {
+      const string parser = format("ContinuousIndexFileParser_{}", i);
+      const string searcher = format("Searcher_{}", i);
+      const string printer = format("ResultsPrinter_{}", i);
+      index_file_parsers[i]->get_indexes_batch_producer()->enable_measurements(
+        format("IndexesBatchProducer_{}", i), parser, searcher
+      );
+      index_file_parsers[i]->get_seq_statistics_batch_producer()
+        ->enable_measurements(
+          format("SeqStatisticsBatchProducer_{}", i), parser, printer
+        );
+      searchers[i]->enable_measurements(searcher, searcher, printer);
+    }
   }
   Logger::log_timed_event("MemoryAllocator", Logger::EVENT_STATE::STOP);
   return {index_file_parsers, searchers, results_printers};
@@ -318,7 +447,9 @@ auto ColorSearchMain::get_results_printer(
       get_args().get_include_invalid(),
       get_threads(),
       max_seqs_per_batch,
-      get_args().get_write_headers()
+      results_printer_max_batches,
+      get_args().get_write_headers(),
+      get_args().get_gzip_output()
     ));
   }
   if (get_args().get_print_mode() == "binary") {
@@ -333,7 +464,9 @@ auto ColorSearchMain::get_results_printer(
       get_args().get_include_invalid(),
       get_threads(),
       max_seqs_per_batch,
-      get_args().get_write_headers()
+      results_printer_max_batches,
+      get_args().get_write_headers(),
+      get_args().get_gzip_output()
     ));
   }
   if (get_args().get_print_mode() == "csv") {
@@ -348,7 +481,9 @@ auto ColorSearchMain::get_results_printer(
       get_args().get_include_invalid(),
       get_threads(),
       max_seqs_per_batch,
-      get_args().get_write_headers()
+      results_printer_max_batches,
+      get_args().get_write_headers(),
+      get_args().get_gzip_output()
     ));
   }
   if (get_args().get_print_mode() == "packedint") {
@@ -363,7 +498,26 @@ auto ColorSearchMain::get_results_printer(
       get_args().get_include_invalid(),
       get_threads(),
       max_seqs_per_batch,
-      get_args().get_write_headers()
+      results_printer_max_batches,
+      get_args().get_write_headers(),
+      get_args().get_gzip_output()
+    ));
+  }
+  if (get_args().get_print_mode() == "abundance") {
+    return make_shared<ColorResultsPrinter>(AbundanceContinuousColorResultsPrinter(
+      stream_id,
+      index_file_parser->get_seq_statistics_batch_producer(),
+      std::move(colors_batch_producer),
+      filenames,
+      num_colors,
+      get_args().get_threshold(),
+      get_args().get_include_not_found(),
+      get_args().get_include_invalid(),
+      get_threads(),
+      max_seqs_per_batch,
+      results_printer_max_batches,
+      get_args().get_write_headers(),
+      get_args().get_gzip_output()
     ));
   }
   throw runtime_error("Invalid value passed by user for argument print_mode");
@@ -375,21 +529,17 @@ auto ColorSearchMain::run_components(
   vector<shared_ptr<ColorResultsPrinter>> &results_printers
 ) -> void {
   Logger::log_timed_event("Querier", Logger::EVENT_STATE::START);
-  const u64 num_components = 3;
-#pragma omp parallel sections num_threads(num_components)
-  {
-#pragma omp section
-#pragma omp parallel for num_threads(streams)
-    for (auto &element : index_file_parsers) { element->read_and_generate(); }
-#pragma omp section
-#pragma omp parallel for num_threads(streams)
-    for (auto &element : color_searchers) { element->read_and_generate(); }
-#pragma omp section
-#pragma omp parallel for num_threads(streams)
-    for (auto &element : results_printers) {
-      std::visit([](auto &arg) -> void { arg.read_and_generate(); }, *element);
-    }
+  vector<function<void()>> stages;
+  for (u64 i = 0; i < streams; ++i) {
+    stages.emplace_back([&, i] { index_file_parsers[i]->read_and_generate(); });
+    stages.emplace_back([&, i] { color_searchers[i]->read_and_generate(); });
+    stages.emplace_back([&, i] {
+      std::visit(
+        [](auto &arg) -> void { arg.read_and_generate(); }, *results_printers[i]
+      );
+    });
   }
+  TaskScheduler::get_global().run_blocking(stages);
   Logger::log_timed_event("Querier", Logger::EVENT_STATE::STOP);
 }
 
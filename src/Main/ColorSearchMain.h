@@ -13,6 +13,7 @@
 
 #include "ArgumentParser/ColorSearchArgumentParser.h"
 #include "ColorIndexContainer/GpuColorIndexContainer.h"
+#include "ColorResultsPrinter/AbundanceContinuousColorResultsPrinter.h"
 #include "ColorResultsPrinter/AsciiContinuousColorResultsPrinter.h"
 #include "ColorResultsPrinter/BinaryContinuousColorResultsPrinter.h"
 #include "ColorResultsPrinter/CsvContinuousColorResultsPrinter.h"
@@ -31,7 +32,8 @@ using ColorResultsPrinter = variant<
   AsciiContinuousColorResultsPrinter,
   BinaryContinuousColorResultsPrinter,
   CsvContinuousColorResultsPrinter,
-  PackedIntContinuousColorResultsPrinter>;
+  PackedIntContinuousColorResultsPrinter,
+  AbundanceContinuousColorResultsPrinter>;
 
 class ColorSearchMain: public Main {
 private:
@@ -39,6 +41,8 @@ private:
   u64 streams = 0;
   u64 max_indexes_per_batch = 0;
   u64 max_seqs_per_batch = 0;
+  // the host memory which the planner expects for each index of a batch
+  double cpu_bits_per_index = 0;
   unique_ptr<ColorSearchArgumentParser> args;
 
 public:
@@ -51,7 +55,9 @@ private:
   auto get_max_chars_per_batch_cpu() -> u64;
   auto get_max_chars_per_batch_gpu() -> u64;
   auto get_results_printer_bits_per_seq() -> u64;
+  auto get_results_printer_bits_per_stream() -> u64;
   auto get_max_chars_per_batch() -> u64;
+  auto set_memory_estimates() -> void;
   auto get_input_output_filenames()
     -> std::tuple<vector<vector<string>>, vector<vector<string>>>;
   auto get_components(
@@ -0,0 +1,45 @@
+#include <memory>
+#include <string>
+
+#include "ArgumentParser/GenerateDataArgumentParser.h"
+#include "Main/GenerateDataMain.h"
+#include "SyntheticDataGenerator/SyntheticDataGenerator.h"
+#include "Tools/Logger.h"
+
+namespace sbwt_search {
+
+using log_utils::Logger;
+using std::make_unique;
+using std::string;
+
+auto GenerateDataMain::main(int argc, char **argv) -> int {
+  const string program_name = "generate";
+  const string program_description = "sbwt_search";
+  Logger::log_timed_event("main", Logger::EVENT_STATE::START);
+  auto args = make_unique<GenerateDataArgumentParser>(
+    program_name, program_description, argc, argv
+  );
+  SyntheticDataGenerator generator(args->get_seed());
+  auto references = generator.generate_references(
+    args->get_references(), args->get_reference_length()
+  );
+  SyntheticDataGenerator::write_fasta(
+    args->get_output_prefix() + "_references.fna", references, "reference"
+  );
+  auto reads = generator.generate_reads(
+    references,
+    args->get_reads(),
+    args->get_read_length(),
+    args->get_error_rate(),
+    args->get_unmapped_fraction(),
+    args->get_reverse_complements()
+  );
+  SyntheticDataGenerator::write_fasta(
+    args->get_output_prefix() + "_reads.fna", reads, "read"
+  );
+  Logger::log(Logger::LOG_LEVEL::INFO, "Finished");
+  Logger::log_timed_event("main", Logger::EVENT_STATE::STOP);
+  return 0;
+}
+
+}  // namespace sbwt_search
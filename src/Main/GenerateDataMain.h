@@ -0,0 +1,22 @@
+#ifndef GENERATE_DATA_MAIN_H
+#define GENERATE_DATA_MAIN_H
+
+/**
+ * @file GenerateDataMain.h
+ * @brief The main function for generating synthetic references and reads,
+ * which can be used for building indexes and querying them. The 'generate'
+ * mode of the main executable.
+ */
+
+#include "Main/Main.h"
+
+namespace sbwt_search {
+
+class GenerateDataMain: public Main {
+public:
+  auto main(int argc, char **argv) -> int override;
+};
+
+}  // namespace sbwt_search
+
+#endif
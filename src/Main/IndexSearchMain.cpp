@@ -1,33 +1,51 @@
+#include <chrono>
 #include <omp.h>
 
 #include "ArgumentParser/IndexSearchArgumentParser.h"
 #include "FilenamesParser/FilenamesParser.h"
 #include "FilesizeLoadBalancer/FilesizeLoadBalancer.h"
 #include "Global/GlobalDefinitions.h"
+#include "IndexSearcher/IndexSearcher.h"
+#include "KeyKmerJumper/KeyKmerJumper.h"
+#include "KmerCache/KmerCache.h"
 #include "Main/IndexSearchMain.h"
 #include "Presearcher/Presearcher.h"
+#include "ReadDeduplicator/ReadDeduplicator.h"
 #include "SbwtBuilder/SbwtBuilder.h"
 #include "SbwtContainer/CpuSbwtContainer.h"
 #include "SbwtContainer/GpuSbwtContainer.h"
 #include "Tools/GpuUtils.h"
+#include "Tools/IOUtils.h"
 #include "Tools/Logger.h"
 #include "Tools/MathUtils.hpp"
-#include "Tools/MemoryUtils.h"
+#include "Tools/MemoryTracker.h"
+#include "Tools/Metrics.h"
+#include "Tools/PipelineProfiler.h"
+#include "Tools/PinnedArena.h"
+#include "Tools/ResourceLimits.h"
 #include "Tools/StdUtils.hpp"
+#include "Tools/TaskScheduler.h"
 #include "fmt/core.h"
 
 namespace sbwt_search {
 
 using fmt::format;
 using gpu_utils::get_free_gpu_memory;
+using io_utils::is_standard_stream;
+using gpu_utils::PinnedArena;
 using log_utils::Logger;
+using log_utils::Metrics;
+using log_utils::PipelineProfiler;
 using math_utils::bits_to_gB;
 using math_utils::round_down;
-using memory_utils::get_total_system_memory;
+using memory_utils::MemoryTracker;
 using std::cerr;
 using std::endl;
 using std::min;
+using std::function;
 using std::runtime_error;
+using system_utils::get_resource_limits;
+using threading_utils::TaskScheduler;
 
 const u64 string_sequence_batch_producer_max_batches = 2;
 const u64 string_break_batch_producer_max_batches = 2;
@@ -37,27 +55,46 @@ const u64 invalid_chars_producer_max_batches = 2;
 const u64 bits_producer_max_batches = 2;
 const u64 positions_builder_max_batches = 2;
 const u64 searcher_max_batches = 2;
+const u64 results_printer_max_batches = 2;
 
 auto IndexSearchMain::main(int argc, char **argv) -> int {
   const string program_name = "index";
   const string program_description = "sbwt_search";
-  Logger::log_timed_event("main", Logger::EVENT_STATE::START);
   args = make_unique<IndexSearchArgumentParser>(
     program_name, program_description, argc, argv
   );
+  if (is_standard_stream(get_args().get_output_file())) {
+    Logger::log_to_standard_error();
+  }
+  Logger::log_timed_event("main", Logger::EVENT_STATE::START);
+  start_metrics(
+    get_args().get_metrics_file(), get_args().get_metrics_interval()
+  );
+  log_resource_limits();
   Logger::log(Logger::LOG_LEVEL::INFO, "Loading components into memory");
   auto gpu_container = get_gpu_container();
   kmer_size = gpu_container->get_kmer_size();
   max_index = gpu_container->get_max_index();
+  if (get_args().get_kmer_cache_size() > 0
+      && kmer_size > KmerCache::max_kmer_size) {
+    throw runtime_error(format(
+      "The k-mer cache only supports k-mers of up to {} characters, while the "
+      "k-mers of this index have {}. Please set kmer-cache-size to 0.",
+      KmerCache::max_kmer_size,
+      kmer_size
+    ));
+  }
   auto [split_input_filenames, split_output_filenames]
     = get_input_output_filenames();
+  if (finish_if_complete(streams)) { return 0; }
   load_batch_info();
-  omp_set_nested(1);
-  load_threads();
+  set_memory_estimates();
+  load_threads(get_args().get_pin_threads());
   Logger::log(
     Logger::LOG_LEVEL::INFO,
-    format("Running OpenMP with {} threads", get_threads())
+    format("Running with {} worker threads", get_threads())
   );
+  if (get_args().get_pinned_arena()) { reserve_pinned_arena(); }
   auto
     [sequence_file_parsers,
      seq_to_bits_converters,
@@ -68,6 +105,7 @@ auto IndexSearchMain::main(int argc, char **argv) -> int {
       gpu_container, split_input_filenames, split_output_filenames
     );
   Logger::log(Logger::LOG_LEVEL::INFO, "Running queries");
+  if (get_args().get_bottleneck_report()) { PipelineProfiler::start(); }
   run_components(
     sequence_file_parsers,
     seq_to_bits_converters,
@@ -75,6 +113,12 @@ auto IndexSearchMain::main(int argc, char **argv) -> int {
     searchers,
     results_printers
   );
+  if (get_args().get_pinned_arena()) { log_pinned_arena_statistics(); }
+  if (get_args().get_bottleneck_report()) {
+    cerr << PipelineProfiler::get_report();
+  }
+  MemoryTracker::log_report(get_args().get_memory_estimate_margin());
+  Metrics::stop();
   Logger::log(Logger::LOG_LEVEL::INFO, "Finished");
   Logger::log_timed_event("main", Logger::EVENT_STATE::STOP);
   return 0;
@@ -98,6 +142,16 @@ auto IndexSearchMain::get_gpu_container() -> shared_ptr<GpuSbwtContainer> {
   Logger::log_timed_event("Presearcher", Logger::EVENT_STATE::START);
   presearcher.presearch();
   Logger::log_timed_event("Presearcher", Logger::EVENT_STATE::STOP);
+  const u64 jump_stride = get_args().get_key_kmer_jump_stride();
+  if (jump_stride > 0 && !get_args().get_colors_file().empty()) {
+    Logger::log_timed_event("KeyKmerJumper", Logger::EVENT_STATE::START);
+    KeyKmerJumper(gpu_container, jump_stride)
+      .load_or_build(
+        format("{}.{}.keyjumps", get_args().get_colors_file(), jump_stride),
+        {get_args().get_index_file(), get_args().get_colors_file()}
+      );
+    Logger::log_timed_event("KeyKmerJumper", Logger::EVENT_STATE::STOP);
+  }
   Logger::log_timed_event("SBWTLoader", Logger::EVENT_STATE::STOP);
   return gpu_container;
 }
@@ -137,7 +191,9 @@ auto IndexSearchMain::get_max_chars_per_batch_gpu() -> u64 {
     * get_args().get_gpu_memory_percentage()
   );
   const u64 bits_required_per_character
-    = ContinuousIndexSearcher::get_bits_per_element_gpu();
+    = ContinuousIndexSearcher::get_bits_per_element_gpu(
+      get_args().get_invalid_kmers_on_gpu()
+    );
   auto max_chars_per_batch = free / bits_required_per_character / streams;
   Logger::log(
     Logger::LOG_LEVEL::DEBUG,
@@ -153,13 +209,14 @@ auto IndexSearchMain::get_max_chars_per_batch_gpu() -> u64 {
 }
 
 auto IndexSearchMain::get_max_chars_per_batch_cpu() -> u64 {
-  if (get_args().get_unavailable_ram() > get_total_system_memory() * bits_in_byte) {
+  // the memory of the cgroup or Slurm allocation if it is lower than the
+  // memory of the machine
+  const u64 system_memory = get_resource_limits().get_memory() * bits_in_byte;
+  if (get_args().get_unavailable_ram() > system_memory) {
     throw runtime_error("Not enough memory. Please specify a lower number of "
                         "unavailable-main-memory.");
   }
-  u64 available_ram = min(
-    get_total_system_memory() * bits_in_byte, get_args().get_max_cpu_memory()
-  );
+  u64 available_ram = min(system_memory, get_args().get_max_cpu_memory());
   u64 unavailable_ram = get_args().get_unavailable_ram();
   u64 free_bits = (unavailable_ram > available_ram) ?
     0 :
@@ -167,33 +224,56 @@ auto IndexSearchMain::get_max_chars_per_batch_cpu() -> u64 {
       static_cast<double>(available_ram - unavailable_ram)
       * get_args().get_cpu_memory_percentage()
     );
-  const double bits_required_per_character
+  free_bits -= min(free_bits, get_args().get_kmer_cache_size());
+  const u64 deduplicator_bits_per_seq = get_args().get_deduplicate_reads() ?
+    ReadDeduplicator::get_bits_per_seq(sequence_file_parser_max_batches) :
+    0;
+  // with gzip output, every buffer also has a compressed copy, which is about
+  // as large as the output of the printer at most
+  const u64 results_printer_compressed_buffers
+    = get_args().get_gzip_output() ? results_printer_max_batches : 0;
+  const bool invalid_bitmap = get_args().get_invalid_kmers_on_gpu();
+  cpu_bits_per_character
     = static_cast<double>(
         // bits per element
         StringSequenceBatchProducer::get_bits_per_element()
           * string_sequence_batch_producer_max_batches
-        + InvalidCharsProducer::get_bits_per_element()
+        + InvalidCharsProducer::get_bits_per_element(invalid_bitmap)
           * invalid_chars_producer_max_batches
-        + BitsProducer::get_bits_per_element() * bits_producer_max_batches
+        + BitsProducer::get_bits_per_element(invalid_bitmap)
+          * bits_producer_max_batches
         + ContinuousPositionsBuilder::get_bits_per_element()
           * positions_builder_max_batches
         + ContinuousIndexSearcher::get_bits_per_element_cpu()
           * searcher_max_batches
-        + get_results_printer_bits_per_element()
+        + (get_kmer_cache_entries() > 0 ?
+             IndexSearcher::get_kmer_cache_bits_per_element() :
+             0)
+        + (get_args().get_bucket_kmers() ?
+             IndexSearcher::get_bucketing_bits_per_element() :
+             0)
+        + get_results_printer_bits_per_element() * results_printer_max_batches
+        + get_results_printer_output_bits_per_element()
+          * results_printer_compressed_buffers
       )
     // bits per seq
     + static_cast<double>(
         IntervalBatchProducer::get_bits_per_seq()
           * string_break_batch_producer_max_batches
-        + get_results_printer_bits_per_seq()
+        + get_results_printer_bits_per_seq() * results_printer_max_batches
+        + get_results_printer_output_bits_per_seq()
+          * results_printer_compressed_buffers
+        + deduplicator_bits_per_seq
       )
       / static_cast<double>(get_args().get_base_pairs_per_seq())
 #if defined(__HIP_CPU_RT__)  // include gpu required memory as well
-    + static_cast<double>(ContinuousIndexSearcher::get_bits_per_element_gpu())
+    + static_cast<double>(
+      ContinuousIndexSearcher::get_bits_per_element_gpu(invalid_bitmap)
+    )
 #endif
     ;
   u64 max_chars_per_batch = static_cast<u64>(std::floor(
-    static_cast<double>(free_bits) / bits_required_per_character
+    static_cast<double>(free_bits) / cpu_bits_per_character
     / static_cast<double>(streams)
   ));
   Logger::log(
@@ -209,6 +289,118 @@ auto IndexSearchMain::get_max_chars_per_batch_cpu() -> u64 {
   return max_chars_per_batch;
 }
 
+auto IndexSearchMain::get_kmer_cache_entries() -> u64 {
+  return get_args().get_kmer_cache_size() / KmerCache::get_bits_per_entry()
+    / streams;
+}
+
+// The batches which live in pinned memory, so that they can be copied to and
+// from the gpu quickly
+auto IndexSearchMain::get_pinned_bits_per_element() -> u64 {
+  return BitsProducer::get_bits_per_element(
+           get_args().get_invalid_kmers_on_gpu()
+         )
+    * bits_producer_max_batches
+    + ContinuousPositionsBuilder::get_bits_per_element()
+    * positions_builder_max_batches
+    + ContinuousIndexSearcher::get_bits_per_element_cpu() * searcher_max_batches
+    + (get_kmer_cache_entries() > 0 ?
+         IndexSearcher::get_kmer_cache_bits_per_element() :
+         0)
+    + (get_args().get_bucket_kmers() ?
+         IndexSearcher::get_bucketing_pinned_bits_per_element() :
+         0);
+}
+
+// Every pinned vector of every stream is carved out of a single arena, with
+// a huge page per stream to spare for the rounding of each batch
+auto IndexSearchMain::reserve_pinned_arena() -> void {
+  const u64 huge_page_bytes = 2ULL * 1024 * 1024;
+  const u64 bytes = (get_pinned_bits_per_element() * max_chars_per_batch
+                     / bits_in_byte
+                     + huge_page_bytes)
+    * streams;
+  Logger::log_timed_event("PinnedArenaAllocator", Logger::EVENT_STATE::START);
+  auto start_time = std::chrono::steady_clock::now();
+  auto &arena = PinnedArena::get_global();
+  arena.reserve(bytes);
+  const double millis = std::chrono::duration<double, std::milli>(
+                          std::chrono::steady_clock::now() - start_time
+  )
+                          .count();
+  Logger::log_timed_event("PinnedArenaAllocator", Logger::EVENT_STATE::STOP);
+  Logger::log(
+    Logger::LOG_LEVEL::INFO,
+    format(
+      "Reserved a pinned memory arena of {} bytes ({:.2f}GB) backed by {} "
+      "huge pages in {:.2f}ms",
+      arena.get_capacity(),
+      bits_to_gB(arena.get_capacity() * bits_in_byte),
+      arena.uses_huge_pages() ? "explicit" : "transparent",
+      millis
+    )
+  );
+}
+
+auto IndexSearchMain::log_pinned_arena_statistics() -> void {
+  auto &arena = PinnedArena::get_global();
+  Logger::log(
+    Logger::LOG_LEVEL::INFO,
+    format(
+      "The pinned memory arena reached a high water mark of {} of its {} "
+      "bytes, and {} allocations did not fit and were pinned on their own",
+      arena.get_high_water_mark(),
+      arena.get_capacity(),
+      arena.get_fallback_allocations()
+    )
+  );
+}
+
+// What the planner expects each stage to take, so that the memory tracker can
+// tell when the formulas above no longer match what is allocated
+auto IndexSearchMain::set_memory_estimates() -> void {
+  const bool invalid_bitmap = get_args().get_invalid_kmers_on_gpu();
+  const u64 converter_bits = BitsProducer::get_bits_per_element(invalid_bitmap)
+    * bits_producer_max_batches;
+  const u64 positions_builder_bits
+    = ContinuousPositionsBuilder::get_bits_per_element()
+    * positions_builder_max_batches;
+  const u64 searcher_bits
+    = get_pinned_bits_per_element() - converter_bits - positions_builder_bits;
+  const u64 searcher_gpu_bits
+    = ContinuousIndexSearcher::get_bits_per_element_gpu(invalid_bitmap);
+  const auto to_bytes = [&](u64 bits_per_element) {
+    return bits_per_element * max_chars_per_batch / bits_in_byte;
+  };
+  for (u64 i = 0; i < streams; ++i) {
+    MemoryTracker::set_estimate(
+      format("SeqToBitsConverter_{}", i),
+      MemoryTracker::MEMORY_KIND::PINNED,
+      to_bytes(converter_bits)
+    );
+    MemoryTracker::set_estimate(
+      format("PositionsBuilder_{}", i),
+      MemoryTracker::MEMORY_KIND::PINNED,
+      to_bytes(positions_builder_bits)
+    );
+    MemoryTracker::set_estimate(
+      format("Searcher_{}", i),
+      MemoryTracker::MEMORY_KIND::PINNED,
+      to_bytes(searcher_bits)
+    );
+    MemoryTracker::set_estimate(
+      format("Searcher_{}", i),
+      MemoryTracker::MEMORY_KIND::GPU,
+      to_bytes(searcher_gpu_bits)
+    );
+  }
+  MemoryTracker::start_host_measurement(static_cast<u64>(
+    (cpu_bits_per_character * static_cast<double>(max_chars_per_batch * streams)
+     + static_cast<double>(get_args().get_kmer_cache_size()))
+    / bits_in_byte
+  ));
+}
+
 auto IndexSearchMain::get_results_printer_bits_per_element() -> u64 {
   if (get_args().get_print_mode() == "ascii") {
     return AsciiContinuousIndexResultsPrinter::get_bits_per_element(max_index);
@@ -216,8 +408,14 @@ auto IndexSearchMain::get_results_printer_bits_per_element() -> u64 {
   if (get_args().get_print_mode() == "binary") {
     return BinaryContinuousIndexResultsPrinter::get_bits_per_element();
   }
+  if (get_args().get_print_mode() == "blockedbinary") {
+    return BlockedBinaryContinuousIndexResultsPrinter::get_bits_per_element();
+  }
   if (get_args().get_print_mode() == "bool") {
     return BoolContinuousIndexResultsPrinter::get_bits_per_element();
+  }
+  if (get_args().get_print_mode() == "packedbool") {
+    return PackedBoolContinuousIndexResultsPrinter::get_bits_per_element();
   }
     if (get_args().get_print_mode() == "packedint") {
     return PackedIntContinuousIndexResultsPrinter::get_bits_per_element(max_index);
@@ -230,15 +428,39 @@ auto IndexSearchMain::get_results_printer_bits_per_seq() -> u64 {
   if (get_args().get_print_mode() == "binary") {
     return BinaryContinuousIndexResultsPrinter::get_bits_per_seq();
   }
+  if (get_args().get_print_mode() == "blockedbinary") {
+    return BlockedBinaryContinuousIndexResultsPrinter::get_bits_per_seq();
+  }
   if (get_args().get_print_mode() == "bool") {
     return BoolContinuousIndexResultsPrinter::get_bits_per_seq();
   }
+  if (get_args().get_print_mode() == "packedbool") {
+    return PackedBoolContinuousIndexResultsPrinter::get_bits_per_seq();
+  }
   if (get_args().get_print_mode() == "packedint") {
     return PackedIntContinuousIndexResultsPrinter::get_bits_per_seq();
   }
   throw runtime_error("Invalid value passed by user for argument print_mode");
 }
 
+// The packed bool printer packs its buffers before they are written, so its
+// output is smaller than the buffers it formats into, while every other
+// printer writes out its buffers as they are
+auto IndexSearchMain::get_results_printer_output_bits_per_element() -> u64 {
+  if (get_args().get_print_mode() == "packedbool") {
+    return PackedBoolContinuousIndexResultsPrinter::
+      get_output_bits_per_element();
+  }
+  return get_results_printer_bits_per_element();
+}
+
+auto IndexSearchMain::get_results_printer_output_bits_per_seq() -> u64 {
+  if (get_args().get_print_mode() == "packedbool") {
+    return PackedBoolContinuousIndexResultsPrinter::get_output_bits_per_seq();
+  }
+  return get_results_printer_bits_per_seq();
+}
+
 auto IndexSearchMain::get_components(
   const shared_ptr<GpuSbwtContainer> &gpu_container,
   const vector<vector<string>> &input_filenames,
@@ -264,6 +486,7 @@ auto IndexSearchMain::get_components(
     Logger::log_timed_event(
       format("SequenceFileParserAllocator_{}", i), Logger::EVENT_STATE::START
     );
+    MemoryTracker::set_thread_component(format("SequenceFileParser_{}", i));
     sequence_file_parsers[i] = make_shared<ContinuousSequenceFileParser>(
       i,
       input_filenames[i],
@@ -272,7 +495,8 @@ auto IndexSearchMain::get_components(
       max_seqs_per_batch,
       string_sequence_batch_producer_max_batches,
       string_break_batch_producer_max_batches,
-      interval_batch_producer_max_batches
+      interval_batch_producer_max_batches,
+      args->get_deduplicate_reads()
     );
     Logger::log_timed_event(
       format("SequenceFileParserAllocator_{}", i), Logger::EVENT_STATE::STOP
@@ -281,6 +505,7 @@ auto IndexSearchMain::get_components(
     Logger::log_timed_event(
       format("SeqToBitsConverterAllocator_{}", i), Logger::EVENT_STATE::START
     );
+    MemoryTracker::set_thread_component(format("SeqToBitsConverter_{}", i));
     seq_to_bits_converters[i] = make_shared<ContinuousSeqToBitsConverter>(
       i,
       sequence_file_parsers[i]->get_string_sequence_batch_producer(),
@@ -288,7 +513,8 @@ auto IndexSearchMain::get_components(
       kmer_size,
       max_chars_per_batch,
       invalid_chars_producer_max_batches,
-      bits_producer_max_batches
+      bits_producer_max_batches,
+      args->get_invalid_kmers_on_gpu()
     );
     Logger::log_timed_event(
       format("SeqToBitsConverterAllocator_{}", i), Logger::EVENT_STATE::STOP
@@ -297,6 +523,7 @@ auto IndexSearchMain::get_components(
     Logger::log_timed_event(
       format("PositionsBuilderAllocator_{}", i), Logger::EVENT_STATE::START
     );
+    MemoryTracker::set_thread_component(format("PositionsBuilder_{}", i));
     positions_builders[i] = make_shared<ContinuousPositionsBuilder>(
       i,
       sequence_file_parsers[i]->get_string_break_batch_producer(),
@@ -311,6 +538,7 @@ auto IndexSearchMain::get_components(
     Logger::log_timed_event(
       format("SearcherAllocator_{}", i), Logger::EVENT_STATE::START
     );
+    MemoryTracker::set_thread_component(format("Searcher_{}", i));
     searchers[i] = make_shared<ContinuousIndexSearcher>(
       i,
       gpu_container,
@@ -318,7 +546,10 @@ auto IndexSearchMain::get_components(
       positions_builders[i],
       searcher_max_batches,
       max_chars_per_batch,
-      !args->get_colors_file().empty()
+      !args->get_colors_file().empty(),
+      get_kmer_cache_entries(),
+      args->get_invalid_kmers_on_gpu(),
+      args->get_bucket_kmers()
     );
     Logger::log_timed_event(
       format("SearcherAllocator_{}", i), Logger::EVENT_STATE::STOP
@@ -327,6 +558,7 @@ auto IndexSearchMain::get_components(
     Logger::log_timed_event(
       format("ResultsPrinterAllocator_{}", i), Logger::EVENT_STATE::START
     );
+    MemoryTracker::set_thread_component(format("ResultsPrinter_{}", i));
     results_printers[i] = get_results_printer(
       i,
       searchers[i],
@@ -334,9 +566,45 @@ auto IndexSearchMain::get_components(
       seq_to_bits_converters[i]->get_invalid_chars_producer(),
       output_filenames[i]
     );
+    std::visit(
+      [&](auto &arg) -> void { arg.set_checkpointer(get_checkpointer()); },
+      *results_printers[i]
+    );
     Logger::log_timed_event(
       format("ResultsPrinterAllocator_{}", i), Logger::EVENT_STATE::STOP
     );
+    MemoryTracker::set_thread_component("");
+
+    if (Metrics::is_enabled() || get_args().get_bottleneck_report()) {
+      const string parser = format("SequenceFileParser_{}", i);
+      const string converter = format("SeqToBitsConverter_{}", i);
+      const string positions_builder = format("PositionsBuilder_{}", i);
+      const string searcher = format("Searcher_{}", i);
+      const string printer = format("ResultsPrinter_{}", i);
+      sequence_file_parsers[i]->get_string_sequence_batch_producer()
+        ->enable_measurements(
+          format("StringSequenceBatchProducer_{}", i), parser, converter
+        );
+      sequence_file_parsers[i]->get_string_break_batch_producer()
+        ->enable_measurements(
+          format("StringBreakBatchProducer_{}", i), parser, positions_builder
+        );
+      sequence_file_parsers[i]->get_interval_batch_producer()
+        ->enable_measurements(
+          format("IntervalBatchProducer_{}", i), parser, printer
+        );
+      seq_to_bits_converters[i]->get_bits_producer()->enable_measurements(
+        format("BitsProducer_{}", i), converter, searcher
+      );
+      seq_to_bits_converters[i]->get_invalid_chars_producer()
+        ->enable_measurements(
+          format("InvalidCharsProducer_{}", i), converter, printer
+        );
+      positions_builders[i]->enable_measurements(
+        positions_builder, positions_builder, searcher
+      );
+      searchers[i]->enable_measurements(searcher, searcher, printer);
+    }
   }
   Logger::log_timed_event("MemoryAllocator", Logger::EVENT_STATE::STOP);
 
@@ -366,7 +634,9 @@ auto IndexSearchMain::get_results_printer(
       get_threads(),
       max_chars_per_batch,
       max_seqs_per_batch,
+      results_printer_max_batches,
       get_args().get_write_headers(),
+      get_args().get_gzip_output(),
       max_index
     ));
   }
@@ -381,9 +651,29 @@ auto IndexSearchMain::get_results_printer(
       get_threads(),
       max_chars_per_batch,
       max_seqs_per_batch,
-      get_args().get_write_headers()
+      results_printer_max_batches,
+      get_args().get_write_headers(),
+      get_args().get_gzip_output()
     ));
   }
+  if (get_args().get_print_mode() == "blockedbinary") {
+    return make_shared<IndexResultsPrinter>(
+      BlockedBinaryContinuousIndexResultsPrinter(
+        stream_id,
+        searcher,
+        interval_batch_producer,
+        invalid_chars_producer,
+        output_filenames,
+        kmer_size,
+        get_threads(),
+        max_chars_per_batch,
+        max_seqs_per_batch,
+        results_printer_max_batches,
+        get_args().get_write_headers(),
+        get_args().get_gzip_output()
+      )
+    );
+  }
   if (get_args().get_print_mode() == "bool") {
     return make_shared<IndexResultsPrinter>(BoolContinuousIndexResultsPrinter(
       stream_id,
@@ -395,9 +685,30 @@ auto IndexSearchMain::get_results_printer(
       get_threads(),
       max_chars_per_batch,
       max_seqs_per_batch,
-      get_args().get_write_headers()
+      results_printer_max_batches,
+      get_args().get_write_headers(),
+      get_args().get_gzip_output()
     ));
   }
+  if (get_args().get_print_mode() == "packedbool") {
+    return make_shared<IndexResultsPrinter>(
+      PackedBoolContinuousIndexResultsPrinter(
+        stream_id,
+        searcher,
+        interval_batch_producer,
+        invalid_chars_producer,
+        output_filenames,
+        kmer_size,
+        get_threads(),
+        max_chars_per_batch,
+        max_seqs_per_batch,
+        results_printer_max_batches,
+        get_args().get_write_headers(),
+        get_args().get_gzip_output(),
+        get_args().get_run_length_encode()
+      )
+    );
+  }
   if (get_args().get_print_mode() == "packedint") {
     return make_shared<IndexResultsPrinter>(PackedIntContinuousIndexResultsPrinter(
       stream_id,
@@ -409,7 +720,9 @@ auto IndexSearchMain::get_results_printer(
       get_threads(),
       max_chars_per_batch,
       max_seqs_per_batch,
+      results_printer_max_batches,
       get_args().get_write_headers(),
+      get_args().get_gzip_output(),
       max_index
     ));
   }
@@ -426,6 +739,12 @@ auto IndexSearchMain::get_input_output_filenames()
   if (input_filenames.size() != output_filenames.size()) {
     throw runtime_error("Input and output file sizes differ");
   }
+  apply_checkpoint(
+    input_filenames,
+    output_filenames,
+    get_args().get_checkpoint_file(),
+    get_args().get_resume()
+  );
   streams = min(input_filenames.size(), args->get_streams());
   Logger::log(Logger::LOG_LEVEL::DEBUG, format("Using {} streams", streams));
   return FilesizeLoadBalancer(input_filenames, output_filenames)
@@ -440,31 +759,26 @@ auto IndexSearchMain::run_components(
   vector<shared_ptr<IndexResultsPrinter>> &results_printers
 ) -> void {
   Logger::log_timed_event("Querier", Logger::EVENT_STATE::START);
-  const u64 num_components = 5;
-#pragma omp parallel sections num_threads(num_components)
-  {
-#pragma omp section
-#pragma omp parallel for num_threads(streams)
-    for (auto &element : sequence_file_parsers) {
-      element->read_and_generate();
-    }
-#pragma omp section
-#pragma omp parallel for num_threads(streams)
-    for (auto &element : seq_to_bits_converters) {
-      element->read_and_generate();
-    }
-#pragma omp section
-#pragma omp parallel for num_threads(streams)
-    for (auto &element : positions_builders) { element->read_and_generate(); }
-#pragma omp section
-#pragma omp parallel for num_threads(streams)
-    for (auto &element : searchers) { element->read_and_generate(); }
-#pragma omp section
-#pragma omp parallel for num_threads(streams)
-    for (auto &element : results_printers) {
-      std::visit([](auto &arg) -> void { arg.read_and_generate(); }, *element);
-    }
+  // Each stage loop spends most of its time waiting on its neighbours, so it
+  // gets a thread of its own, while the heavy work within the stages is
+  // submitted to the shared task scheduler.
+  vector<function<void()>> stages;
+  for (u64 i = 0; i < streams; ++i) {
+    stages.emplace_back([&, i] {
+      sequence_file_parsers[i]->read_and_generate();
+    });
+    stages.emplace_back([&, i] {
+      seq_to_bits_converters[i]->read_and_generate();
+    });
+    stages.emplace_back([&, i] { positions_builders[i]->read_and_generate(); });
+    stages.emplace_back([&, i] { searchers[i]->read_and_generate(); });
+    stages.emplace_back([&, i] {
+      std::visit(
+        [](auto &arg) -> void { arg.read_and_generate(); }, *results_printers[i]
+      );
+    });
   }
+  TaskScheduler::get_global().run_blocking(stages);
   Logger::log_timed_event("Querier", Logger::EVENT_STATE::STOP);
 }
 
@@ -16,7 +16,9 @@
 #include "ArgumentParser/IndexSearchArgumentParser.h"
 #include "IndexResultsPrinter/AsciiContinuousIndexResultsPrinter.h"
 #include "IndexResultsPrinter/BinaryContinuousIndexResultsPrinter.h"
+#include "IndexResultsPrinter/BlockedBinaryContinuousIndexResultsPrinter.h"
 #include "IndexResultsPrinter/BoolContinuousIndexResultsPrinter.h"
+#include "IndexResultsPrinter/PackedBoolContinuousIndexResultsPrinter.h"
 #include "IndexResultsPrinter/PackedIntContinuousIndexResultsPrinter.h"
 #include "IndexSearcher/ContinuousIndexSearcher.h"
 #include "Main/Main.h"
@@ -36,7 +38,9 @@ using std::vector;
 using IndexResultsPrinter = variant<
   AsciiContinuousIndexResultsPrinter,
   BinaryContinuousIndexResultsPrinter,
+  BlockedBinaryContinuousIndexResultsPrinter,
   BoolContinuousIndexResultsPrinter,
+  PackedBoolContinuousIndexResultsPrinter,
   PackedIntContinuousIndexResultsPrinter>;
 
 class IndexSearchMain: public Main {
@@ -49,14 +53,23 @@ private:
   u64 max_chars_per_batch = 0;
   u64 max_seqs_per_batch = 0;
   u64 max_index;
+  // the host memory which the planner expects for each character of a batch
+  double cpu_bits_per_character = 0;
   unique_ptr<IndexSearchArgumentParser> args;
 
   [[nodiscard]] auto get_args() const -> const IndexSearchArgumentParser &;
   auto get_gpu_container() -> shared_ptr<GpuSbwtContainer>;
   auto load_batch_info() -> void;
   auto get_max_chars_per_batch_cpu() -> u64;
+  auto get_kmer_cache_entries() -> u64;
+  auto get_pinned_bits_per_element() -> u64;
+  auto reserve_pinned_arena() -> void;
+  auto log_pinned_arena_statistics() -> void;
+  auto set_memory_estimates() -> void;
   auto get_results_printer_bits_per_element() -> u64;
   auto get_results_printer_bits_per_seq() -> u64;
+  auto get_results_printer_output_bits_per_element() -> u64;
+  auto get_results_printer_output_bits_per_seq() -> u64;
   auto get_max_chars_per_batch_gpu() -> u64;
   auto get_max_chars_per_batch() -> u64;
   auto get_components(
@@ -1,24 +1,102 @@
+#include <cstdlib>
+#include <memory>
 #include <omp.h>
 #include <stdexcept>
 
 #include "FilenamesParser/FilenamesParser.h"
 #include "Main/Main.h"
+#include "Tools/GpuUtils.h"
 #include "Tools/Logger.h"
+#include "Tools/MemoryTracker.h"
+#include "Tools/Metrics.h"
+#include "Tools/ResourceLimits.h"
+#include "Tools/TaskScheduler.h"
+#include "fmt/core.h"
 
 namespace sbwt_search {
 
+using fmt::format;
+using gpu_utils::get_free_gpu_memory;
+using gpu_utils::get_total_gpu_memory;
 using log_utils::Logger;
+using log_utils::Metrics;
+using memory_utils::MemoryTracker;
+using std::make_shared;
 using std::runtime_error;
+using system_utils::get_resource_limits;
+using threading_utils::TaskScheduler;
 
 Main::Main() { Logger::initialise_global_logging(Logger::LOG_LEVEL::WARN); }
 
 auto Main::get_threads() const -> u64 { return threads; }
 
-auto Main::load_threads() -> void {
-  omp_set_nested(1);
+auto Main::load_threads(bool pin_threads) -> void {
+  // By default OpenMP uses every core of the machine, even within a cgroup
+  // quota or a Slurm allocation, so unless the user chose a number of threads
+  // we only use the cpus we are allowed
+  if (std::getenv("OMP_NUM_THREADS") == nullptr) {
+    omp_set_num_threads(static_cast<int>(get_resource_limits().get_cpus()));
+  }
 #pragma omp parallel
 #pragma omp single
   threads = omp_get_num_threads();
+  TaskScheduler::initialise_global(threads, pin_threads);
+}
+
+auto Main::log_resource_limits() -> void {
+  for (const auto &line : get_resource_limits().get_description()) {
+    Logger::log(Logger::LOG_LEVEL::INFO, line);
+  }
+}
+
+auto Main::start_metrics(const string &filename, u64 interval_seconds)
+  -> void {
+  if (filename.empty()) { return; }
+  Metrics::add_gauge_reader("pinned_memory_bytes", [] {
+    return static_cast<double>(
+      MemoryTracker::get_in_use(MemoryTracker::MEMORY_KIND::PINNED)
+    );
+  });
+  Metrics::add_gauge_reader("gpu_memory_bytes", [] {
+    return static_cast<double>(get_total_gpu_memory() - get_free_gpu_memory());
+  });
+  Metrics::start(filename, interval_seconds);
+  Logger::log(
+    Logger::LOG_LEVEL::INFO,
+    format(
+      "Writing metrics to {} every {} seconds", filename, interval_seconds
+    )
+  );
+}
+
+auto Main::apply_checkpoint(
+  vector<string> &input_filenames,
+  vector<string> &output_filenames,
+  const string &checkpoint_file,
+  bool resume
+) -> void {
+  if (checkpoint_file.empty()) { return; }
+  checkpointer = make_shared<Checkpointer>(checkpoint_file, resume);
+  const u64 skipped
+    = checkpointer->remove_complete(input_filenames, output_filenames);
+  if (skipped > 0) {
+    Logger::log(
+      Logger::LOG_LEVEL::INFO,
+      format("Skipping {} queries which are already complete", skipped)
+    );
+  }
+}
+
+auto Main::get_checkpointer() const -> const shared_ptr<Checkpointer> & {
+  return checkpointer;
+}
+
+auto Main::finish_if_complete(u64 streams) -> bool {
+  if (streams > 0) { return false; }
+  Logger::log(Logger::LOG_LEVEL::INFO, "All queries are already complete");
+  Metrics::stop();
+  Logger::log_timed_event("main", Logger::EVENT_STATE::STOP);
+  return true;
 }
 
 }  // namespace sbwt_search
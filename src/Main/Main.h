@@ -6,19 +6,23 @@
  * @brief Interface class for main classes
  */
 
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "Checkpointer/Checkpointer.h"
 #include "Tools/TypeDefinitions.h"
 
 namespace sbwt_search {
 
+using std::shared_ptr;
 using std::string;
 using std::vector;
 
 class Main {
 private:
   u64 threads = 0;
+  shared_ptr<Checkpointer> checkpointer;
 
 protected:
   [[nodiscard]] auto get_threads() const -> u64;
@@ -33,7 +37,27 @@ public:
 
 protected:
   Main();
-  auto load_threads() -> void;
+  // Uses as many threads as there are cpus which this process may use
+  auto load_threads(bool pin_threads = false) -> void;
+  // Logs the memory and cpus which were found, and what limits them
+  auto log_resource_limits() -> void;
+  // Does nothing if the filename is empty
+  auto start_metrics(const string &filename, u64 interval_seconds) -> void;
+  // Removes the queries which the checkpoint file has as complete, and keeps
+  // the checkpointer for the printers to record those which complete in this
+  // run. Does nothing if the checkpoint file is empty.
+  auto apply_checkpoint(
+    vector<string> &input_filenames,
+    vector<string> &output_filenames,
+    const string &checkpoint_file,
+    bool resume
+  ) -> void;
+  // Empty if there is no checkpoint file
+  [[nodiscard]] auto get_checkpointer() const
+    -> const shared_ptr<Checkpointer> &;
+  // With no streams every query was already complete, so the run ends here,
+  // and true is returned
+  auto finish_if_complete(u64 streams) -> bool;
 };
 
 }  // namespace sbwt_search
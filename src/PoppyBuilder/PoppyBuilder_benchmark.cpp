@@ -0,0 +1,24 @@
+#include <benchmark/benchmark.h>
+
+#include "PoppyBuilder/PoppyBuilder.h"
+#include "SbwtContainer/SbwtContainerBenchmarkUtils.h"
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+auto benchmark_poppy_builder(benchmark::State &state) -> void {
+  const u64 num_bits = state.range(0);
+  auto bits = get_random_bit_vector(num_bits, u64_bits / 2);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(PoppyBuilder(bits, num_bits).get_poppy());
+  }
+  state.SetBytesProcessed(
+    static_cast<int64_t>(state.iterations() * num_bits / 8)
+  );
+}
+BENCHMARK(benchmark_poppy_builder)
+  ->RangeMultiplier(16)
+  ->Range(1ULL << 20, 1ULL << 28)
+  ->Unit(benchmark::kMillisecond);
+
+}  // namespace sbwt_search
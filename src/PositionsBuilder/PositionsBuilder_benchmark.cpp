@@ -0,0 +1,46 @@
+#include <limits>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "PositionsBuilder/PositionsBuilder.h"
+#include "Tools/PinnedVector.h"
+#include "Tools/RNGUtils.hpp"
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+using gpu_utils::PinnedVector;
+using rng_utils::get_uniform_int_generator;
+using std::numeric_limits;
+using std::vector;
+
+const u64 positions_kmer_size = 31;
+const u64 positions_min_seq_size = 1;
+const u64 positions_max_seq_size = 300;
+
+auto benchmark_positions_builder(benchmark::State &state) -> void {
+  const u64 num_chars = state.range(0);
+  auto rng = get_uniform_int_generator<u64>(
+    positions_min_seq_size, positions_max_seq_size
+  );
+  vector<u64> chars_before_newline;
+  for (u64 chars = rng(); chars < num_chars; chars += rng()) {
+    chars_before_newline.push_back(chars);
+  }
+  chars_before_newline.push_back(numeric_limits<u64>::max());
+  PositionsBuilder builder(positions_kmer_size);
+  PinnedVector<u64> positions(num_chars);
+  for (auto _ : state) {
+    builder.build_positions(chars_before_newline, num_chars, positions);
+  }
+  state.SetItemsProcessed(
+    static_cast<int64_t>(state.iterations() * num_chars)
+  );
+}
+BENCHMARK(benchmark_positions_builder)
+  ->RangeMultiplier(16)
+  ->Range(1ULL << 16, 1ULL << 24)
+  ->Unit(benchmark::kMillisecond);
+
+}  // namespace sbwt_search
@@ -0,0 +1,40 @@
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include "Global/GlobalDefinitions.h"
+#include "Presearcher/Presearcher.h"
+#include "SbwtContainer/SbwtContainerBenchmarkUtils.h"
+#include "Tools/GpuPointer.h"
+#include "Tools/MathUtils.hpp"
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+using gpu_utils::GpuPointer;
+using math_utils::round_up;
+using std::make_unique;
+
+const u64 presearch_num_bits = (1ULL << 24) + 3;
+const u64 presearch_kmer_size = 31;
+
+auto benchmark_d_presearch(benchmark::State &state) -> void {
+  auto container
+    = get_synthetic_cpu_sbwt(presearch_num_bits, presearch_kmer_size)->to_gpu();
+  Presearcher presearcher(container);
+  constexpr const auto presearch_times
+    = round_up<u64>(1ULL << (presearch_letters * 2), threads_per_block);
+  auto presearch_left = make_unique<GpuPointer<u64>>(presearch_times);
+  auto presearch_right = make_unique<GpuPointer<u64>>(presearch_times);
+  for (auto _ : state) {
+    presearcher.launch_presearch_kernel(
+      presearch_left, presearch_right, presearch_times / threads_per_block
+    );
+  }
+  state.SetItemsProcessed(
+    static_cast<int64_t>(state.iterations() * presearch_times)
+  );
+}
+BENCHMARK(benchmark_d_presearch)->Unit(benchmark::kMillisecond);
+
+}  // namespace sbwt_search
@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+#include "ReadDeduplicator/ReadDeduplicator.h"
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+using std::bit_ceil;
+using std::hash;
+using std::max;
+using std::numeric_limits;
+
+namespace {
+
+const u64 empty_slot = numeric_limits<u64>::max();
+
+// Moves the characters to an earlier or the same position
+auto move_chars(vector<char> &seqs, u64 start, u64 end, u64 destination)
+  -> void {
+  if (destination == start) { return; }
+  std::copy(
+    seqs.begin() + static_cast<std::ptrdiff_t>(start),
+    seqs.begin() + static_cast<std::ptrdiff_t>(end),
+    seqs.begin() + static_cast<std::ptrdiff_t>(destination)
+  );
+}
+
+}  // namespace
+
+ReadDeduplicator::ReadDeduplicator(u64 max_batches):
+    original_chars_before_new_seq(max_batches),
+    unique_seq_indexes(max_batches) {}
+
+// The original breaks and the unique seq indexes of each batch which is alive,
+// and the hash of each unique seq plus the hash table at half load
+auto ReadDeduplicator::get_bits_per_seq(u64 max_batches) -> u64 {
+  const u64 bits_required_per_break = 64;
+  const u64 bits_required_per_index = 64;
+  const u64 bits_required_per_hash = 64;
+  const u64 bits_required_per_table_entry = 64 * 2;
+  return (bits_required_per_break + bits_required_per_index) * max_batches
+    + bits_required_per_hash + bits_required_per_table_entry;
+}
+
+auto ReadDeduplicator::deduplicate(
+  vector<char> &seqs, vector<u64> &chars_before_new_seq
+) -> u64 {
+  slot = (slot + 1) % original_chars_before_new_seq.size();
+  auto &original = original_chars_before_new_seq[slot];
+  auto &indexes = unique_seq_indexes[slot];
+  original.assign(chars_before_new_seq.begin(), chars_before_new_seq.end());
+  chars_before_new_seq.resize(0);
+  indexes.resize(original.size());
+  unique_hashes.resize(0);
+  table.assign(bit_ceil(max<u64>(original.size() * 2, 1)), empty_slot);
+  u64 duplicates = 0;
+  u64 write_idx = 0;
+  for (u64 i = 0; i < original.size(); ++i) {
+    const u64 start = i == 0 ? 0 : original[i - 1];
+    // Everything before write_idx has already been compacted, and write_idx
+    // never overtakes the start of the current seq, so the current seq is
+    // still intact
+    indexes[i] = find_or_insert(
+      string_view(seqs.data() + start, original[i] - start),
+      seqs,
+      chars_before_new_seq
+    );
+    if (indexes[i] < chars_before_new_seq.size()) {
+      ++duplicates;
+      continue;
+    }
+    move_chars(seqs, start, original[i], write_idx);
+    write_idx += original[i] - start;
+    chars_before_new_seq.push_back(write_idx);
+  }
+  const u64 trailing_start = original.empty() ? 0 : original.back();
+  move_chars(seqs, trailing_start, seqs.size(), write_idx);
+  seqs.resize(write_idx + seqs.size() - trailing_start);
+  total_seqs += original.size();
+  total_duplicates += duplicates;
+  return duplicates;
+}
+
+// Returns the index of the unique seq which is equal to the given seq, or the
+// index which the seq will have if it is new
+auto ReadDeduplicator::find_or_insert(
+  string_view seq,
+  const vector<char> &seqs,
+  const vector<u64> &unique_chars_before_new_seq
+) -> u64 {
+  const u64 seq_hash = hash<string_view>{}(seq);
+  const u64 mask = table.size() - 1;
+  u64 table_idx = seq_hash & mask;
+  for (; table[table_idx] != empty_slot; table_idx = (table_idx + 1) & mask) {
+    const u64 unique_idx = table[table_idx];
+    if (unique_hashes[unique_idx] != seq_hash) { continue; }
+    const u64 start
+      = unique_idx == 0 ? 0 : unique_chars_before_new_seq[unique_idx - 1];
+    const string_view unique_seq(
+      seqs.data() + start, unique_chars_before_new_seq[unique_idx] - start
+    );
+    if (unique_seq == seq) { return unique_idx; }
+  }
+  table[table_idx] = unique_hashes.size();
+  unique_hashes.push_back(seq_hash);
+  return table[table_idx];
+}
+
+auto ReadDeduplicator::get_original_chars_before_new_seq() -> vector<u64> & {
+  return original_chars_before_new_seq[slot];
+}
+
+auto ReadDeduplicator::get_unique_seq_indexes() -> vector<u64> & {
+  return unique_seq_indexes[slot];
+}
+
+auto ReadDeduplicator::get_total_seqs() const -> u64 { return total_seqs; }
+
+auto ReadDeduplicator::get_total_duplicates() const -> u64 {
+  return total_duplicates;
+}
+
+auto ReadDeduplicator::get_original_size(
+  const vector<u64> &original_breaks,
+  const vector<u64> &unique_breaks,
+  u64 unique_size
+) -> u64 {
+  return get_trailing_start(original_breaks) + unique_size
+    - get_trailing_start(unique_breaks);
+}
+
+auto ReadDeduplicator::get_trailing_start(const vector<u64> &breaks) -> u64 {
+  return breaks.size() < 2 ? 0 : breaks[breaks.size() - 2];
+}
+
+}  // namespace sbwt_search
@@ -0,0 +1,104 @@
+#ifndef READ_DEDUPLICATOR_H
+#define READ_DEDUPLICATOR_H
+
+/**
+ * @file ReadDeduplicator.h
+ * @brief Collapses seqs which are exact duplicates of an earlier seq in the
+ * same batch, so that only the unique seqs are converted to bits, searched
+ * and color searched. The batch is compacted in place and the mapping from
+ * each original seq to its unique seq is kept, such that the results printers
+ * can expand their results back to the original order. Since the output of a
+ * seq only depends on its characters, the expanded output is identical to
+ * that of a run without deduplication. The seq which is still being read at
+ * the end of a batch is never collapsed, so that the characters carried over
+ * to the next batch stay the same.
+ */
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+using std::string_view;
+using std::vector;
+
+class ReadDeduplicator {
+private:
+  vector<vector<u64>> original_chars_before_new_seq;
+  vector<vector<u64>> unique_seq_indexes;
+  vector<u64> unique_hashes;
+  vector<u64> table;
+  u64 slot = 0;
+  u64 total_seqs = 0;
+  u64 total_duplicates = 0;
+
+public:
+  // max_batches is the number of batches which may be alive at the same time,
+  // since the mapping of each of them needs to stay valid until it is printed
+  explicit ReadDeduplicator(u64 max_batches);
+
+  static auto get_bits_per_seq(u64 max_batches) -> u64;
+
+  // Compacts seqs and chars_before_new_seq in place and returns the number of
+  // seqs which were collapsed
+  auto deduplicate(vector<char> &seqs, vector<u64> &chars_before_new_seq)
+    -> u64;
+  auto get_original_chars_before_new_seq() -> vector<u64> &;
+  auto get_unique_seq_indexes() -> vector<u64> &;
+  [[nodiscard]] auto get_total_seqs() const -> u64;
+  [[nodiscard]] auto get_total_duplicates() const -> u64;
+
+  // Gets the size of the original batch from the size of the unique batch,
+  // where the breaks are cumulative and end with the ULLONG_MAX sentinel
+  static auto get_original_size(
+    const vector<u64> &original_breaks,
+    const vector<u64> &unique_breaks,
+    u64 unique_size
+  ) -> u64;
+
+  // Expands per seq data, such as results or invalid characters, from the
+  // unique layout to the original layout in place. The data must have space
+  // for the original size.
+  template <class T>
+  static auto expand(
+    T *data,
+    const vector<u64> &original_breaks,
+    const vector<u64> &unique_breaks,
+    const vector<u64> &unique_seq_indexes,
+    u64 unique_size
+  ) -> void {
+    const u64 trailing_start = get_trailing_start(unique_breaks);
+    const u64 original_trailing_start = get_trailing_start(original_breaks);
+    // Going backwards, every seq is copied to a position which is at least as
+    // far as its source, and sources of earlier seqs are never overwritten
+    std::copy_backward(
+      data + trailing_start,
+      data + unique_size,
+      data + original_trailing_start + unique_size - trailing_start
+    );
+    for (u64 i = unique_seq_indexes.size(); i > 0; --i) {
+      const u64 unique_idx = unique_seq_indexes[i - 1];
+      const u64 start = unique_idx == 0 ? 0 : unique_breaks[unique_idx - 1];
+      std::copy_backward(
+        data + start,
+        data + unique_breaks[unique_idx],
+        data + original_breaks[i - 1]
+      );
+    }
+  }
+
+private:
+  static auto get_trailing_start(const vector<u64> &breaks) -> u64;
+  auto find_or_insert(
+    string_view seq,
+    const vector<char> &seqs,
+    const vector<u64> &unique_chars_before_new_seq
+  ) -> u64;
+};
+
+}  // namespace sbwt_search
+
+#endif
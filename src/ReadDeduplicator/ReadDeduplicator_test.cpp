@@ -0,0 +1,73 @@
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ReadDeduplicator/ReadDeduplicator.h"
+
+namespace sbwt_search {
+
+using std::numeric_limits;
+using std::string;
+using std::vector;
+
+namespace {
+
+const u64 max = numeric_limits<u64>::max();
+
+// The last seq has no break since it is still being read
+const string original_seqs = "ACGTAAAACGTAAACCGTAC";
+const vector<u64> original_breaks = {4, 7, 11, 14, 14, 16, 16};
+
+}  // namespace
+
+TEST(ReadDeduplicatorTest, Deduplicate) {
+  ReadDeduplicator deduplicator(2);
+  vector<char> seqs(original_seqs.begin(), original_seqs.end());
+  vector<u64> breaks = original_breaks;
+  ASSERT_EQ(deduplicator.deduplicate(seqs, breaks), 3);
+  ASSERT_EQ(string(seqs.begin(), seqs.end()), "ACGTAAACCGTAC");
+  ASSERT_EQ(breaks, vector<u64>({4, 7, 7, 9}));
+  ASSERT_EQ(
+    deduplicator.get_unique_seq_indexes(), vector<u64>({0, 1, 0, 1, 2, 3, 2})
+  );
+  ASSERT_EQ(deduplicator.get_original_chars_before_new_seq(), original_breaks);
+  ASSERT_EQ(deduplicator.get_total_seqs(), original_breaks.size());
+  ASSERT_EQ(deduplicator.get_total_duplicates(), 3);
+}
+
+TEST(ReadDeduplicatorTest, ExpandRestoresOriginal) {
+  ReadDeduplicator deduplicator(2);
+  vector<char> seqs(original_seqs.begin(), original_seqs.end());
+  vector<u64> breaks = original_breaks;
+  deduplicator.deduplicate(seqs, breaks);
+  auto &original = deduplicator.get_original_chars_before_new_seq();
+  original.push_back(max);
+  breaks.push_back(max);
+  const u64 unique_size = seqs.size();
+  ASSERT_EQ(
+    ReadDeduplicator::get_original_size(original, breaks, unique_size),
+    original_seqs.size()
+  );
+  seqs.resize(original_seqs.size());
+  ReadDeduplicator::expand(
+    seqs.data(),
+    original,
+    breaks,
+    deduplicator.get_unique_seq_indexes(),
+    unique_size
+  );
+  ASSERT_EQ(string(seqs.begin(), seqs.end()), original_seqs);
+}
+
+TEST(ReadDeduplicatorTest, NoSeqs) {
+  ReadDeduplicator deduplicator(1);
+  vector<char> seqs = {'A', 'C'};
+  vector<u64> breaks = {};
+  ASSERT_EQ(deduplicator.deduplicate(seqs, breaks), 0);
+  ASSERT_EQ(seqs, vector<char>({'A', 'C'}));
+  ASSERT_TRUE(breaks.empty());
+}
+
+}  // namespace sbwt_search
@@ -0,0 +1,328 @@
+#include <algorithm>
+#include <bit>
+#include <ios>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <omp.h>
+
+#include "Global/GlobalDefinitions.h"
+#include "SbwtConstructor/SbwtConstructor.h"
+#include "Tools/IOUtils.h"
+#include "Tools/Logger.h"
+#include "Tools/MathUtils.hpp"
+#include "Tools/StdUtils.hpp"
+#include "Tools/TypeDefinitions.h"
+#include "fmt/core.h"
+
+namespace sbwt_search {
+
+using fmt::format;
+using io_utils::ThrowingIfstream;
+using log_utils::Logger;
+using math_utils::divide_and_ceil;
+using math_utils::round_up;
+using std::ios;
+using std::runtime_error;
+using std_utils::parallel_sort;
+
+namespace {
+
+const u64 invalid_char = 4;
+const u64 max_kmer_size = u64_bits / 2;
+
+auto char_to_bits(char c) -> u64 {
+  switch (c) {
+    case 'A':
+    case 'a':
+      return 0;
+    case 'C':
+    case 'c':
+      return 1;
+    case 'G':
+    case 'g':
+      return 2;
+    case 'T':
+    case 't':
+      return 3;
+    default:
+      return invalid_char;
+  }
+}
+
+// Colexicographic order, where $ comes before A. Since $ and A share the same
+// bits, the node with more $ characters comes first when the values are equal
+auto node_order(const SbwtConstructor::Node &a, const SbwtConstructor::Node &b)
+  -> bool {
+  return a.value < b.value || (a.value == b.value && a.dollars > b.dollars);
+}
+
+auto node_equal(const SbwtConstructor::Node &a, const SbwtConstructor::Node &b)
+  -> bool {
+  return a.value == b.value && a.dollars == b.dollars;
+}
+
+// The last k-1 characters of the node, which are shared by all nodes in the
+// same suffix group
+auto get_suffix(const SbwtConstructor::Node &node) -> SbwtConstructor::Node {
+  return {node.value >> 2, node.dollars == 0 ? 0 : node.dollars - 1};
+}
+
+}  // namespace
+
+SbwtConstructor::SbwtConstructor(
+  u64 kmer_size_, bool add_reverse_complements_, u64 precalc_size_
+):
+    kmer_size(kmer_size_),
+    add_reverse_complements(add_reverse_complements_),
+    precalc_size(std::min(precalc_size_, kmer_size_)) {
+  if (kmer_size == 0 || kmer_size > max_kmer_size) {
+    throw runtime_error(
+      format("The k-mer size must be between 1 and {}", max_kmer_size)
+    );
+  }
+  if (precalc_size == 0) {
+    throw runtime_error("The k-mer prefix precalc size must be at least 1");
+  }
+}
+
+auto SbwtConstructor::add_fasta(const string &filename) -> void {
+  Logger::log(
+    Logger::LOG_LEVEL::INFO, format("Reading references from {}", filename)
+  );
+  ThrowingIfstream in_stream(filename, ios::in);
+  string seq;
+  string line;
+  while (std::getline(in_stream, line)) {
+    if (!line.empty() && line[0] == '>') {
+      add_sequence(seq);
+      seq.clear();
+    } else {
+      seq += line;
+    }
+  }
+  add_sequence(seq);
+}
+
+auto SbwtConstructor::add_sequence(const string &seq) -> void {
+  const u64 last_char_shift = 2 * (kmer_size - 1);
+  const u64 kmer_mask = get_value_mask(kmer_size);
+  u64 value = 0;
+  u64 reverse_complement = 0;
+  u64 valid_chars = 0;
+  for (char c : seq) {
+    u64 bits = char_to_bits(c);
+    if (bits == invalid_char) {
+      valid_chars = 0;
+      continue;
+    }
+    value = (value >> 2) | (bits << last_char_shift);
+    reverse_complement = ((reverse_complement << 2) | (3 - bits)) & kmer_mask;
+    if (++valid_chars < kmer_size) { continue; }
+    kmers.push_back(value);
+    if (add_reverse_complements) { kmers.push_back(reverse_complement); }
+  }
+}
+
+auto SbwtConstructor::construct() -> void {
+  Logger::log_timed_event("SbwtConstruction", Logger::EVENT_STATE::START);
+  sort_kmers();
+  build_nodes(get_dummies());
+  build_suffix_group_starts();
+  build_edges();
+  Logger::log_timed_event("SbwtConstruction", Logger::EVENT_STATE::STOP);
+  Logger::log(
+    Logger::LOG_LEVEL::INFO,
+    format(
+      "Constructed SBWT with {} k-mers and {} nodes", num_kmers, nodes.size()
+    )
+  );
+}
+
+auto SbwtConstructor::sort_kmers() -> void {
+  Logger::log_timed_event("KmerSort", Logger::EVENT_STATE::START);
+  parallel_sort(kmers);
+  kmers.erase(std::unique(kmers.begin(), kmers.end()), kmers.end());
+  num_kmers = kmers.size();
+  Logger::log_timed_event("KmerSort", Logger::EVENT_STATE::STOP);
+}
+
+// Each k-mer whose (k-1)-prefix is not the (k-1)-suffix of any other k-mer has
+// no incoming edge, so we add the dummy nodes $x[0..k-1), $$x[0..k-2), ...
+// until $^k, which lead to it
+auto SbwtConstructor::get_dummies() -> vector<Node> {
+  const u64 prefix_mask = get_value_mask(kmer_size - 1);
+  vector<vector<Node>> thread_dummies(omp_get_max_threads());
+#pragma omp parallel for
+  for (u64 i = 0; i < kmers.size(); ++i) {
+    const u64 prefix = kmers[i] & prefix_mask;
+    auto suffix_iter = std::lower_bound(
+      kmers.begin(),
+      kmers.end(),
+      prefix,
+      [](u64 kmer, u64 p) { return (kmer >> 2) < p; }
+    );
+    if (suffix_iter != kmers.end() && (*suffix_iter >> 2) == prefix) {
+      continue;
+    }
+    auto &dummies = thread_dummies[omp_get_thread_num()];
+    for (u64 dollars = 1; dollars < kmer_size; ++dollars) {
+      dummies.push_back(
+        {(kmers[i] & get_value_mask(kmer_size - dollars)) << (2 * dollars),
+         dollars}
+      );
+    }
+  }
+  vector<Node> dummies = {{0, kmer_size}};
+  for (auto &d : thread_dummies) {
+    dummies.insert(dummies.end(), d.begin(), d.end());
+  }
+  parallel_sort(dummies, node_order);
+  dummies.erase(
+    std::unique(dummies.begin(), dummies.end(), node_equal), dummies.end()
+  );
+  return dummies;
+}
+
+auto SbwtConstructor::build_nodes(const vector<Node> &dummies) -> void {
+  nodes.reserve(kmers.size() + dummies.size());
+  auto kmer_iter = kmers.begin();
+  auto dummy_iter = dummies.begin();
+  while (kmer_iter != kmers.end() || dummy_iter != dummies.end()) {
+    if (dummy_iter == dummies.end()
+        || (kmer_iter != kmers.end()
+            && node_order({*kmer_iter, 0}, *dummy_iter))) {
+      nodes.push_back({*kmer_iter++, 0});
+    } else {
+      nodes.push_back(*dummy_iter++);
+    }
+  }
+  kmers = {};
+}
+
+auto SbwtConstructor::build_suffix_group_starts() -> void {
+  suffix_group_starts.resize(divide_and_ceil<u64>(nodes.size(), u64_bits));
+#pragma omp parallel for
+  for (u64 word = 0; word < suffix_group_starts.size(); ++word) {
+    const u64 end = std::min((word + 1) * u64_bits, nodes.size());
+    for (u64 i = word * u64_bits; i < end; ++i) {
+      if (i == 0
+          || !node_equal(get_suffix(nodes[i - 1]), get_suffix(nodes[i]))) {
+        suffix_group_starts[word] |= 1ULL << (i % u64_bits);
+      }
+    }
+  }
+}
+
+// Each node other than $^k has a single incoming edge, labelled with its last
+// character, which goes out of the first node of the suffix group whose suffix
+// is the node's (k-1)-prefix
+auto SbwtConstructor::build_edges() -> void {
+  const u64 prefix_mask = get_value_mask(kmer_size - 1);
+  const u64 last_char_shift = 2 * (kmer_size - 1);
+  acgt = vector<vector<u64>>(
+    4, vector<u64>(divide_and_ceil<u64>(nodes.size(), u64_bits), 0)
+  );
+  bool missing_source = false;
+#pragma omp parallel for
+  for (u64 i = 0; i < nodes.size(); ++i) {
+    if (nodes[i].dollars == kmer_size) { continue; }
+    const Node prefix = {nodes[i].value & prefix_mask, nodes[i].dollars};
+    auto source_iter = std::lower_bound(
+      nodes.begin(),
+      nodes.end(),
+      prefix,
+      [](const Node &node, const Node &p) {
+        return node_order(get_suffix(node), p);
+      }
+    );
+    if (source_iter == nodes.end()
+        || !node_equal(get_suffix(*source_iter), prefix)) {
+#pragma omp atomic write
+      missing_source = true;
+      continue;
+    }
+    const u64 source = std::distance(nodes.begin(), source_iter);
+    const u64 c = nodes[i].value >> last_char_shift;
+#pragma omp atomic
+    acgt[c][source / u64_bits] |= 1ULL << (source % u64_bits);
+  }
+  if (missing_source) {
+    throw runtime_error("Error: SBWT node found without an incoming edge");
+  }
+}
+
+auto SbwtConstructor::get_c_map() -> vector<u64> {
+  vector<u64> c_map(4, 1);
+  for (u64 i = 1; i < 4; ++i) {
+    c_map[i] = c_map[i - 1];
+    for (u64 word : acgt[i - 1]) { c_map[i] += std::popcount(word); }
+  }
+  return c_map;
+}
+
+// The first and last node ending with each string of precalc_size characters,
+// or -1 for both if there is none. The first character of the string is the
+// least significant, which is the same layout as the last characters of the
+// node values.
+auto SbwtConstructor::get_prefix_intervals() -> vector<u64> {
+  const u64 shift = 2 * (kmer_size - precalc_size);
+  vector<u64> intervals(2ULL << (2 * precalc_size), -1ULL);
+  for (u64 i = 0; i < nodes.size(); ++i) {
+    if (nodes[i].dollars > kmer_size - precalc_size) { continue; }
+    const u64 key = nodes[i].value >> shift;
+    if (intervals[2 * key] == -1ULL) { intervals[2 * key] = i; }
+    intervals[2 * key + 1] = i;
+  }
+  return intervals;
+}
+
+auto SbwtConstructor::write(const string &filename) -> void {
+  Logger::log_timed_event("SbwtWrite", Logger::EVENT_STATE::START);
+  ThrowingOfstream out(filename, ios::out | ios::binary);
+  out.write_string_with_size("plain-matrix");
+  out.write_string_with_size("v0.1");
+  for (auto &bits : acgt) { write_bit_vector(out, bits); }
+  for (u64 i = 0; i < 4; ++i) { write_empty_rank_structure(out); }
+  write_bit_vector(out, suffix_group_starts);
+  auto c_map = get_c_map();
+  out.write<u64>(c_map.size() * sizeof(u64));
+  out.write(c_map);
+  auto prefix_intervals = get_prefix_intervals();
+  out.write<u64>(prefix_intervals.size() * sizeof(u64));
+  out.write(prefix_intervals);
+  out.write<u64>(precalc_size);
+  out.write<u64>(nodes.size());
+  out.write<u64>(num_kmers);
+  out.write<u64>(kmer_size);
+  Logger::log_timed_event("SbwtWrite", Logger::EVENT_STATE::STOP);
+}
+
+auto SbwtConstructor::write_bit_vector(
+  ThrowingOfstream &out, const vector<u64> &bits
+) -> void {
+  out.write<u64>(nodes.size());
+  out.write(bits);
+}
+
+// The rank structures are not used by this program, which builds its own Poppy
+// instead. As in the files written by the SBWT tool, they are written with the
+// size of sdsl's rank_support_v but their contents are left empty.
+auto SbwtConstructor::write_empty_rank_structure(ThrowingOfstream &out)
+  -> void {
+  const u64 capacity = round_up<u64>(nodes.size(), u64_bits);
+  const u64 words = ((capacity >> 9) + 1) << 1;
+  out.write<u64>(words * u64_bits);
+  out.write(vector<u64>(words, 0));
+}
+
+auto SbwtConstructor::get_num_kmers() const -> u64 { return num_kmers; }
+auto SbwtConstructor::get_num_nodes() const -> u64 { return nodes.size(); }
+
+auto SbwtConstructor::get_value_mask(u64 chars) const -> u64 {
+  return chars >= max_kmer_size ? -1ULL : (1ULL << (2 * chars)) - 1;
+}
+
+}  // namespace sbwt_search
@@ -0,0 +1,73 @@
+#ifndef SBWT_CONSTRUCTOR_H
+#define SBWT_CONSTRUCTOR_H
+
+/**
+ * @file SbwtConstructor.h
+ * @brief Constructs a plain-matrix SBWT from a set of reference sequences and
+ * writes it to disk in the same format as the SBWT tool, which is the format
+ * that the SbwtBuilder reads. The k-mers are packed into 2 bits per character
+ * such that the last character of the k-mer is the most significant, which
+ * makes their numeric order the same as their colexicographic order. Dummy
+ * nodes, which are prefixed with $ characters, are kept alongside the number
+ * of $ characters they have, since $ shares its bits with A. The resulting
+ * file contains the acgt bit vectors, the suffix group starts, the c-map and
+ * the k-mer prefix intervals used by the SBWT tool for its searches.
+ */
+
+#include <string>
+#include <vector>
+
+#include "Tools/IOUtils.h"
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+using io_utils::ThrowingOfstream;
+using std::string;
+using std::vector;
+
+class SbwtConstructor {
+public:
+  struct Node {
+    u64 value;
+    u64 dollars;
+  };
+
+private:
+  u64 kmer_size;
+  bool add_reverse_complements;
+  u64 precalc_size;
+  u64 num_kmers = 0;
+  vector<u64> kmers;
+  vector<Node> nodes;
+  vector<vector<u64>> acgt;
+  vector<u64> suffix_group_starts;
+
+public:
+  SbwtConstructor(
+    u64 kmer_size_, bool add_reverse_complements_, u64 precalc_size_ = 8
+  );
+  auto add_fasta(const string &filename) -> void;
+  auto add_sequence(const string &seq) -> void;
+  auto construct() -> void;
+  auto write(const string &filename) -> void;
+  [[nodiscard]] auto get_num_kmers() const -> u64;
+  [[nodiscard]] auto get_num_nodes() const -> u64;
+
+private:
+  auto sort_kmers() -> void;
+  auto get_dummies() -> vector<Node>;
+  auto build_nodes(const vector<Node> &dummies) -> void;
+  auto build_suffix_group_starts() -> void;
+  auto build_edges() -> void;
+  auto get_c_map() -> vector<u64>;
+  auto get_prefix_intervals() -> vector<u64>;
+  auto write_bit_vector(ThrowingOfstream &out, const vector<u64> &bits)
+    -> void;
+  auto write_empty_rank_structure(ThrowingOfstream &out) -> void;
+  [[nodiscard]] auto get_value_mask(u64 chars) const -> u64;
+};
+
+}  // namespace sbwt_search
+
+#endif
@@ -0,0 +1,56 @@
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "SbwtConstructor/SbwtConstructor.h"
+
+namespace sbwt_search {
+
+using std::ifstream;
+using std::istreambuf_iterator;
+using std::string;
+using std::vector;
+
+auto read_file_bytes(const string &filename) -> vector<char> {
+  ifstream stream(filename, std::ios::binary);
+  return {istreambuf_iterator<char>(stream), istreambuf_iterator<char>()};
+}
+
+TEST(SbwtConstructorTest, SameAsSbwtTool) {
+  const u64 kmer_size = 30;
+  const string out_filename = "test_objects/tmp/SbwtConstructorTest.sbwt";
+  SbwtConstructor constructor(kmer_size, false);
+  constructor.add_fasta("test_objects/search_test_indexed.fna");
+  constructor.construct();
+  constructor.write(out_filename);
+  EXPECT_EQ(constructor.get_num_kmers(), 177);
+  EXPECT_EQ(constructor.get_num_nodes(), 236);
+  ASSERT_EQ(
+    read_file_bytes(out_filename),
+    read_file_bytes("test_objects/search_test_index.sbwt")
+  );
+}
+
+TEST(SbwtConstructorTest, ReverseComplements) {
+  const u64 kmer_size = 3;
+  // k-mers: ACG, CGT and GTT, while TT is broken by the N. ACG needs the
+  // dummies $AC, $$A and $$$ while the others have an incoming edge.
+  const string seq = "ACGTTNTT";
+  SbwtConstructor forward_constructor(kmer_size, false);
+  forward_constructor.add_sequence(seq);
+  forward_constructor.construct();
+  EXPECT_EQ(forward_constructor.get_num_kmers(), 3);
+  EXPECT_EQ(forward_constructor.get_num_nodes(), 6);
+  // the reverse complements add AAC, whose dummies $AA, $$A and $$$ replace
+  // those of ACG
+  SbwtConstructor both_constructor(kmer_size, true);
+  both_constructor.add_sequence(seq);
+  both_constructor.construct();
+  EXPECT_EQ(both_constructor.get_num_kmers(), 4);
+  EXPECT_EQ(both_constructor.get_num_nodes(), 7);
+}
+
+}  // namespace sbwt_search
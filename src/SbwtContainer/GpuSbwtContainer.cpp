@@ -88,4 +88,38 @@ auto GpuSbwtContainer::get_key_kmer_marks() const -> GpuPointer<u64> & {
   return *key_kmer_marks;
 }
 
+auto GpuSbwtContainer::set_key_kmer_jumps(
+  unique_ptr<GpuPointer<u64>> marks,
+  unique_ptr<GpuPointer<u64>> marks_layer_0,
+  unique_ptr<GpuPointer<u64>> marks_layer_1_2,
+  unique_ptr<GpuPointer<u64>> jumps
+) -> void {
+  key_kmer_jump_marks = std::move(marks);
+  key_kmer_jump_layer_0 = std::move(marks_layer_0);
+  key_kmer_jump_layer_1_2 = std::move(marks_layer_1_2);
+  key_kmer_jumps = std::move(jumps);
+}
+
+auto GpuSbwtContainer::has_key_kmer_jumps() const -> bool {
+  return key_kmer_jumps != nullptr;
+}
+
+auto GpuSbwtContainer::get_key_kmer_jump_marks() const -> GpuPointer<u64> & {
+  return *key_kmer_jump_marks;
+}
+
+auto GpuSbwtContainer::get_key_kmer_jump_layer_0() const
+  -> GpuPointer<u64> & {
+  return *key_kmer_jump_layer_0;
+}
+
+auto GpuSbwtContainer::get_key_kmer_jump_layer_1_2() const
+  -> GpuPointer<u64> & {
+  return *key_kmer_jump_layer_1_2;
+}
+
+auto GpuSbwtContainer::get_key_kmer_jumps() const -> GpuPointer<u64> & {
+  return *key_kmer_jumps;
+}
+
 }  // namespace sbwt_search
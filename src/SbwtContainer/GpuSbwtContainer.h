@@ -27,6 +27,8 @@ private:
   unique_ptr<GpuPointer<u64 *>> acgt_pointers, layer_0_pointers,
     layer_1_2_pointers;
   unique_ptr<GpuPointer<u64>> key_kmer_marks;
+  unique_ptr<GpuPointer<u64>> key_kmer_jump_marks, key_kmer_jump_layer_0,
+    key_kmer_jump_layer_1_2, key_kmer_jumps;
   u64 max_index;
 
 public:
@@ -52,6 +54,18 @@ public:
   [[nodiscard]] auto get_presearch_left() const -> GpuPointer<u64> &;
   [[nodiscard]] auto get_presearch_right() const -> GpuPointer<u64> &;
   [[nodiscard]] auto get_key_kmer_marks() const -> GpuPointer<u64> &;
+  auto set_key_kmer_jumps(
+    unique_ptr<GpuPointer<u64>> marks,
+    unique_ptr<GpuPointer<u64>> marks_layer_0,
+    unique_ptr<GpuPointer<u64>> marks_layer_1_2,
+    unique_ptr<GpuPointer<u64>> jumps
+  ) -> void;
+  [[nodiscard]] auto has_key_kmer_jumps() const -> bool;
+  [[nodiscard]] auto get_key_kmer_jump_marks() const -> GpuPointer<u64> &;
+  [[nodiscard]] auto get_key_kmer_jump_layer_0() const -> GpuPointer<u64> &;
+  [[nodiscard]] auto get_key_kmer_jump_layer_1_2() const
+    -> GpuPointer<u64> &;
+  [[nodiscard]] auto get_key_kmer_jumps() const -> GpuPointer<u64> &;
 };
 
 }  // namespace sbwt_search
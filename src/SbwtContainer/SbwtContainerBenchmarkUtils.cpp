@@ -0,0 +1,102 @@
+#include <memory>
+
+#include "Global/GlobalDefinitions.h"
+#include "PoppyBuilder/PoppyBuilder.h"
+#include "SbwtContainer/SbwtContainerBenchmarkUtils.h"
+#include "Tools/MathUtils.hpp"
+#include "Tools/RNGUtils.hpp"
+
+namespace sbwt_search {
+
+using math_utils::divide_and_ceil;
+using math_utils::round_up;
+using rng_utils::get_uniform_int_generator;
+using std::make_unique;
+
+namespace {
+
+auto get_bit(const vector<u64> &v, u64 idx) -> bool {
+  return ((v[idx / u64_bits] >> (idx % u64_bits)) & 1ULL) > 0;
+}
+
+auto set_bit(vector<u64> &v, u64 idx) -> void {
+  v[idx / u64_bits] |= 1ULL << (idx % u64_bits);
+}
+
+// A node is a key kmer if it has no outgoing edge or if its first outgoing
+// edge does not lead to a larger node. Otherwise it is a key kmer with a
+// probability of 1/8. Hence, following the first edge of non key kmers
+// strictly increases the node and always terminates.
+auto get_key_kmer_marks(
+  const vector<vector<u64>> &acgt,
+  const vector<u64> &c_map,
+  u64 num_bits,
+  int seed
+) -> vector<u64> {
+  auto rng = get_uniform_int_generator<u64>(0, 7, seed);
+  vector<u64> key_kmer_marks(acgt[0].size(), 0);
+  vector<u64> ranks(4, 0);
+  for (u64 node = 0; node < num_bits; ++node) {
+    bool is_key = true;
+    for (u64 c = 0; c < 4; ++c) {
+      if (get_bit(acgt[c], node)) {
+        is_key = c_map[c] + ranks[c] <= node || rng() == 0;
+        break;
+      }
+    }
+    if (is_key) { set_bit(key_kmer_marks, node); }
+    for (u64 c = 0; c < 4; ++c) {
+      ranks[c] += static_cast<u64>(get_bit(acgt[c], node));
+    }
+  }
+  return key_kmer_marks;
+}
+
+}  // namespace
+
+auto get_random_bit_vector(u64 num_bits, u64 ones_per_64, int seed)
+  -> vector<u64> {
+  auto rng = get_uniform_int_generator<u64>(0, u64_bits - 1, seed);
+  vector<u64> result(round_up<u64>(num_bits, superblock_bits) / u64_bits, 0);
+  for (u64 i = 0; i < num_bits; ++i) {
+    if (rng() < ones_per_64) { set_bit(result, i); }
+  }
+  return result;
+}
+
+auto get_synthetic_cpu_sbwt(u64 num_bits, u64 kmer_size, int seed)
+  -> unique_ptr<CpuSbwtContainer> {
+  const u64 ones_per_64 = u64_bits / 5;
+  vector<vector<u64>> acgt(4);
+  vector<Poppy> poppys(4);
+  vector<u64> c_map(cmap_size, 1);
+  for (u64 i = 0; i < 4; ++i) {
+    acgt[i] = get_random_bit_vector(
+      num_bits, ones_per_64, seed + static_cast<int>(i)
+    );
+    poppys[i] = PoppyBuilder(acgt[i], num_bits).get_poppy();
+    c_map[i + 1] = poppys[i].total_1s;
+  }
+  for (u64 i = 0; i < 4; ++i) { c_map[i + 1] += c_map[i]; }
+  auto key_kmer_marks = get_key_kmer_marks(acgt, c_map, num_bits, seed);
+  const u64 bit_vector_size = acgt[0].size();
+  return make_unique<CpuSbwtContainer>(
+    std::move(acgt),
+    std::move(poppys),
+    std::move(c_map),
+    num_bits,
+    bit_vector_size,
+    kmer_size,
+    std::move(key_kmer_marks)
+  );
+}
+
+auto get_random_bit_seqs(u64 num_chars, int seed) -> vector<u64> {
+  auto rng = get_uniform_int_generator<u64>(0, -1ULL, seed);
+  // the extra element is read by the search when a kmer straddles the end
+  vector<u64> result(divide_and_ceil<u64>(num_chars, u64_bits / 2) + 1);
+  for (auto &bits : result) { bits = rng(); }
+  return result;
+}
+
+}  // namespace sbwt_search
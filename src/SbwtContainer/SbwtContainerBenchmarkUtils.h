@@ -0,0 +1,35 @@
+#ifndef SBWT_CONTAINER_BENCHMARK_UTILS_H
+#define SBWT_CONTAINER_BENCHMARK_UTILS_H
+
+/**
+ * @file SbwtContainerBenchmarkUtils.h
+ * @brief Methods used by the benchmarking modules to generate synthetic SBWTs
+ * and queries, so that they do not depend on any index files being present
+ */
+
+#include <memory>
+#include <vector>
+
+#include "SbwtContainer/CpuSbwtContainer.h"
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+using std::unique_ptr;
+using std::vector;
+
+// Each of the acgt vectors has roughly a fifth of its bits set, such that all
+// nodes reached by the search stay within num_bits. Key kmers are marked such
+// that moving to a key kmer always terminates.
+auto get_synthetic_cpu_sbwt(u64 num_bits, u64 kmer_size, int seed = 0)
+  -> unique_ptr<CpuSbwtContainer>;
+
+auto get_random_bit_vector(u64 num_bits, u64 ones_per_64, int seed = 0)
+  -> vector<u64>;
+
+// 2 bits per character, packed in the same way as the SeqToBitsConverter
+auto get_random_bit_seqs(u64 num_chars, int seed = 0) -> vector<u64>;
+
+}  // namespace sbwt_search
+
+#endif
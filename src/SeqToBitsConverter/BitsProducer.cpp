@@ -9,20 +9,28 @@ using math_utils::divide_and_ceil;
 
 const u64 chars_per_u64 = 32;
 
-BitsProducer::BitsProducer(u64 max_chars_per_batch_, u64 max_batches):
+BitsProducer::BitsProducer(
+  u64 max_chars_per_batch_, u64 max_batches, bool invalid_bitmap_
+):
     max_chars_per_batch(max_chars_per_batch_),
+    invalid_bitmap(invalid_bitmap_),
     SharedBatchesProducer<BitSeqBatch>(max_batches) {
   initialise_batches();
 }
 
-auto BitsProducer::get_bits_per_element() -> u64 {
+auto BitsProducer::get_bits_per_element(bool invalid_bitmap) -> u64 {
   const u64 bits_required_per_bit_packed_entry = 2;
-  return bits_required_per_bit_packed_entry;
+  const u64 bits_required_per_invalid_bit = 1;
+  return bits_required_per_bit_packed_entry
+    + static_cast<u64>(invalid_bitmap) * bits_required_per_invalid_bit;
 }
 
+// The bitmap has an extra word at the end so that a k-mer in its last word can
+// be read in the same way as every other k-mer
 auto BitsProducer::get_default_value() -> shared_ptr<BitSeqBatch> {
   return make_shared<BitSeqBatch>(
-    round_up<u64>(max_chars_per_batch, chars_per_u64) / chars_per_u64
+    round_up<u64>(max_chars_per_batch, chars_per_u64) / chars_per_u64,
+    invalid_bitmap ? max_chars_per_batch / u64_bits + 2 : 0
   );
 }
 
@@ -30,10 +38,19 @@ auto BitsProducer::start_new_batch(u64 num_chars) -> void {
   SharedBatchesProducer<BitSeqBatch>::do_at_batch_start();
   current_write()->bit_seq.resize(divide_and_ceil<u64>(num_chars, chars_per_u64)
   );
+  if (invalid_bitmap) {
+    auto &invalid_bits = current_write()->invalid_bits;
+    invalid_bits.resize(divide_and_ceil<u64>(num_chars, u64_bits) + 1);
+    invalid_bits.back() = 0;
+  }
 }
 
 auto BitsProducer::set(u64 index, u64 value) -> void {
   current_write()->bit_seq[index] = value;
 }
 
+auto BitsProducer::set_invalid_bits(u64 index, u64 value) -> void {
+  current_write()->invalid_bits[index] = value;
+}
+
 }  // namespace sbwt_search
@@ -4,7 +4,9 @@
 /**
  * @file BitsProducer.h
  * @brief Transforms a list of ACTG characters into their 2-bit equivalent and
- * packs them into a u64 bitvector
+ * packs them into a u64 bitvector. If asked to, it also packs a bitmap of
+ * which characters are invalid, so that the invalid k-mers can be found on the
+ * gpu
  */
 
 #include <algorithm>
@@ -28,16 +30,20 @@ using std::shared_ptr;
 class BitsProducer: public SharedBatchesProducer<BitSeqBatch> {
   friend ContinuousSeqToBitsConverter;
   u64 max_chars_per_batch;
+  bool invalid_bitmap;
 
 public:
-  BitsProducer(u64 max_chars_per_batch_, u64 max_batches);
+  BitsProducer(
+    u64 max_chars_per_batch_, u64 max_batches, bool invalid_bitmap_ = false
+  );
 
-  auto static get_bits_per_element() -> u64;
+  auto static get_bits_per_element(bool invalid_bitmap = false) -> u64;
 
 private:
   auto get_default_value() -> shared_ptr<BitSeqBatch> override;
   auto start_new_batch(u64 num_chars) -> void;
   auto set(u64 index, u64 value) -> void;
+  auto set_invalid_bits(u64 index, u64 value) -> void;
 };
 
 }  // namespace sbwt_search
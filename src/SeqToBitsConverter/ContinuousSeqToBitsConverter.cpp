@@ -3,6 +3,7 @@
 
 #include "SeqToBitsConverter/ContinuousSeqToBitsConverter.h"
 #include "Tools/Logger.h"
+#include "Tools/TaskScheduler.h"
 #include "fmt/core.h"
 
 namespace sbwt_search {
@@ -10,6 +11,7 @@ namespace sbwt_search {
 using fmt::format;
 using log_utils::Logger;
 using std::min;
+using threading_utils::TaskScheduler;
 
 ContinuousSeqToBitsConverter::ContinuousSeqToBitsConverter(
   u64 stream_id_,
@@ -18,17 +20,22 @@ ContinuousSeqToBitsConverter::ContinuousSeqToBitsConverter(
   u64 kmer_size,
   u64 max_chars_per_batch,
   u64 invalid_chars_producer_max_batches,
-  u64 bits_producer_max_batches
+  u64 bits_producer_max_batches,
+  bool invalid_bitmap_
 ):
     producer(std::move(producer)),
     threads(threads),
     invalid_chars_producer(make_shared<InvalidCharsProducer>(
-      kmer_size, max_chars_per_batch, invalid_chars_producer_max_batches
+      kmer_size,
+      max_chars_per_batch,
+      invalid_chars_producer_max_batches,
+      invalid_bitmap_
     )),
-    bits_producer(
-      make_shared<BitsProducer>(max_chars_per_batch, bits_producer_max_batches)
-    ),
-    stream_id(stream_id_) {}
+    bits_producer(make_shared<BitsProducer>(
+      max_chars_per_batch, bits_producer_max_batches, invalid_bitmap_
+    )),
+    stream_id(stream_id_),
+    invalid_bitmap(invalid_bitmap_) {}
 
 auto ContinuousSeqToBitsConverter::get_invalid_chars_producer() const
   -> const shared_ptr<InvalidCharsProducer> & {
@@ -62,34 +69,44 @@ auto ContinuousSeqToBitsConverter::read_and_generate() -> void {
   bits_producer->do_at_generate_finish();
 }
 
+// Each thread gets a multiple of 64 characters, so that every word of the
+// invalid characters bitmap is written by a single thread
 auto ContinuousSeqToBitsConverter::parallel_generate(
   StringSequenceBatch &read_batch
 ) -> void {
   const u64 chars_per_u64 = 32;
   auto seq_size = read_batch.seq->size();
   u64 chars_per_thread = static_cast<u64>(ceil(
-                           (ceil(static_cast<double>(seq_size) / chars_per_u64))
+                           (ceil(static_cast<double>(seq_size) / u64_bits))
                            / static_cast<double>(threads)
                          ))
-    * chars_per_u64;
-#pragma omp parallel num_threads(threads) shared(read_batch)
-  {
-    u64 idx = omp_get_thread_num();
+    * u64_bits;
+  TaskScheduler::get_global().parallel_for(threads, [&](u64 idx) {
     u64 start_index = min(idx * chars_per_thread, seq_size);
     u64 end_index = min((idx + 1) * chars_per_thread, seq_size);
+    u64 invalid_bits = 0;
     for (u64 index = start_index; index < end_index; index += chars_per_u64) {
       bits_producer->set(
         index / chars_per_u64,
         convert_int(
-          *read_batch.seq, index, min(index + chars_per_u64, end_index)
+          *read_batch.seq,
+          index,
+          min(index + chars_per_u64, end_index),
+          invalid_bits
         )
       );
+      // flush the bitmap word once both of its halves are done
+      if (invalid_bitmap
+          && (index % u64_bits != 0 || index + chars_per_u64 >= end_index)) {
+        bits_producer->set_invalid_bits(index / u64_bits, invalid_bits);
+        invalid_bits = 0;
+      }
     }
-  }
+  });
 }
 
 auto ContinuousSeqToBitsConverter::convert_int(
-  const vector<char> &str, u64 start_index, u64 end_index
+  const vector<char> &str, u64 start_index, u64 end_index, u64 &invalid_bits
 ) -> u64 {
   const u64 bits_per_character = 2;
   u64 result = 0;
@@ -98,7 +115,12 @@ auto ContinuousSeqToBitsConverter::convert_int(
        internal_shift -= bits_per_character, ++index) {
     u64 c = char_to_bits(str[index + start_index]);
     if (c == invalid_char_to_bits_value) {
-      invalid_chars_producer->set(index + start_index);
+      if (invalid_bitmap) {
+        invalid_bits
+          |= 1ULL << (u64_bits - 1 - (index + start_index) % u64_bits);
+      } else {
+        invalid_chars_producer->set(index + start_index);
+      }
       continue;
     }
     result |= c << internal_shift;
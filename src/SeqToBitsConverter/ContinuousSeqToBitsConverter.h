@@ -4,7 +4,9 @@
 /**
  * @file ContinuousSeqToBitsConverter.h
  * @brief Class for converting char sequences continuously, with parallel
- * capabilities. Also builds the invalid characters list in the same pass
+ * capabilities. Also builds the invalid characters list in the same pass, or
+ * alternatively a bitmap of the invalid characters which goes along with the
+ * bits
  */
 
 #include <string>
@@ -29,6 +31,7 @@ private:
   u64 threads;
   CharToBits char_to_bits;
   u64 stream_id;
+  bool invalid_bitmap;
 
 public:
   ContinuousSeqToBitsConverter(
@@ -38,7 +41,8 @@ public:
     u64 kmer_size,
     u64 max_chars_per_batch,
     u64 invalid_chars_producer_max_batches,
-    u64 bits_producer_max_batches
+    u64 bits_producer_max_batches,
+    bool invalid_bitmap_ = false
   );
 
   [[nodiscard]] auto get_invalid_chars_producer() const
@@ -49,8 +53,9 @@ public:
 
 private:
   auto parallel_generate(StringSequenceBatch &seq_batch) -> void;
-  auto convert_int(const vector<char> &str, u64 start_index, u64 end_index)
-    -> u64;
+  auto convert_int(
+    const vector<char> &str, u64 start_index, u64 end_index, u64 &invalid_bits
+  ) -> u64;
 };
 
 }  // namespace sbwt_search
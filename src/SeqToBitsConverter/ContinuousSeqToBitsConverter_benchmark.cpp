@@ -0,0 +1,61 @@
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BatchObjects/StringSequenceBatch.h"
+#include "SeqToBitsConverter/ContinuousSeqToBitsConverter.h"
+#include "Tools/DummyBatchProducer.hpp"
+#include "Tools/RNGUtils.hpp"
+#include "Tools/TaskScheduler.h"
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+using rng_utils::get_uniform_int_generator;
+using std::make_shared;
+using std::vector;
+using test_utils::DummyBatchProducer;
+using threading_utils::TaskScheduler;
+
+const u64 seq_to_bits_kmer_size = 31;
+
+// The conversion of a batch is dominated by convert_int, which is applied on
+// each group of 32 characters. With a single thread this measures convert_int
+// on its own, while with more threads we also see how well it scales. A thread
+// count of 0 means that all the threads of the scheduler are used. One in every
+// 100 characters is invalid.
+auto benchmark_convert_int(benchmark::State &state) -> void {
+  const u64 num_chars = state.range(0);
+  const u64 threads = state.range(1) == 0 ?
+    TaskScheduler::get_global().get_threads() :
+    static_cast<u64>(state.range(1));
+  const vector<char> alphabet = {'A', 'C', 'G', 'T', 'a', 'c', 'g', 't'};
+  auto rng = get_uniform_int_generator<u64>(0, 99);
+  vector<char> seq(num_chars);
+  for (auto &c : seq) {
+    u64 r = rng();
+    c = r == 0 ? 'N' : alphabet[r % alphabet.size()];
+  }
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto producer = make_shared<DummyBatchProducer<StringSequenceBatch>>(
+      vector<shared_ptr<StringSequenceBatch>>{
+        make_shared<StringSequenceBatch>(StringSequenceBatch{&seq})}
+    );
+    ContinuousSeqToBitsConverter converter(
+      0, producer, threads, seq_to_bits_kmer_size, num_chars, 2, 2
+    );
+    state.ResumeTiming();
+    converter.read_and_generate();
+  }
+  state.SetBytesProcessed(
+    static_cast<int64_t>(state.iterations() * num_chars)
+  );
+}
+BENCHMARK(benchmark_convert_int)
+  ->ArgNames({"chars", "threads"})
+  ->ArgsProduct({{1ULL << 20, 1ULL << 26}, {1, 0}})
+  ->Unit(benchmark::kMillisecond);
+
+}  // namespace sbwt_search
@@ -39,8 +39,10 @@ protected:
     const vector<vector<char>> &seqs,
     const vector<vector<u64>> &bits,
     const vector<vector<char>> &invalid_chars,
+    const vector<vector<u64>> &invalid_bits,
     u64 max_chars_per_batch,
-    u64 max_batches
+    u64 max_batches,
+    bool invalid_bitmap
   ) {
     omp_set_nested(1);
     u64 threads = 0;
@@ -60,7 +62,8 @@ protected:
       kmer_size,
       max_chars_per_batch,
       max_batches,
-      max_batches
+      max_batches,
+      invalid_bitmap
     );
     auto bits_producer = host->get_bits_producer();
     auto invalid_chars_producer = host->get_invalid_chars_producer();
@@ -82,6 +85,9 @@ protected:
         for (batches = 0; (*bits_producer) >> bit_seq_batch; ++batches) {
           sleep_for(milliseconds(rng()));
           EXPECT_EQ(bits[batches], bit_seq_batch->bit_seq.to_vector());
+          EXPECT_EQ(
+            invalid_bits[batches], bit_seq_batch->invalid_bits.to_vector()
+          );
         }
         EXPECT_EQ(batches, expected_batches);
       }
@@ -109,15 +115,17 @@ auto convert_binary(string bin) -> u64 {
   return total;
 }
 
-TEST_F(ContinuousSeqToBitsConverterTest, TestAll) {
-  vector<string> str_seqs = {
+auto get_str_seqs() -> vector<string> {
+  return {
     "ACgTgnGAtGtCa"  // A00 C01 g10 T11 g10 n00 G10 A00 t11 G10 t11 C01 a00
     "AAAAaAAaAAAAAAAaAAAAAAAAAAAAAAAA"  // 32 As = 64 0s
     "GC",                               // 1001
     "nTAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAATn"
     "nAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAnG"};
+}
 
-  vector<vector<u64>> expected_bits = {
+auto get_expected_bits() -> vector<vector<u64>> {
+  return {
     {
       convert_binary(
         "0001101110001000111011010000000000000000000000000000000000000000"
@@ -140,7 +148,9 @@ TEST_F(ContinuousSeqToBitsConverterTest, TestAll) {
         "0000000000000000000000000000000000000000000000000000000000000010"
       )  // We apply 0 padding on the right to get decimal equivalent };
     }};
+}
 
+TEST_F(ContinuousSeqToBitsConverterTest, TestAll) {
   const u64 max_chars_per_batch = 200;
   for (auto kmer_size : {3}) {
     const vector<vector<char>> expected_invalid_chars = [&] {
@@ -154,18 +164,47 @@ TEST_F(ContinuousSeqToBitsConverterTest, TestAll) {
       for (auto i : {0, 63, 64, 126}) { ret_val[1][i] = 1; }
       return ret_val;
     }();
-    auto seqs = to_char_vec(str_seqs);
+    auto seqs = to_char_vec(get_str_seqs());
     for (auto max_batches : {1, 2, 3, 4, 5, 6, 7}) {
       run_test(
         kmer_size,
         seqs,
-        expected_bits,
+        get_expected_bits(),
         expected_invalid_chars,
+        vector<vector<u64>>(seqs.size()),
         max_chars_per_batch,
-        max_batches
+        max_batches,
+        false
       );
     }
   }
 }
 
+// The invalid characters are only in the bitmap, which has a trailing word of
+// padding, and the invalid chars batches are left empty
+TEST_F(ContinuousSeqToBitsConverterTest, InvalidBitmap) {
+  const u64 max_chars_per_batch = 200;
+  const u64 kmer_size = 3;
+  const u64 first_bit = 1ULL << (u64_bits - 1);
+  // NOLINTBEGIN
+  // (cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+  const vector<vector<u64>> expected_invalid_bits
+    = {{first_bit >> 5, 0}, {first_bit | 1, first_bit | (1 << 1), 0}};
+  // NOLINTEND
+  // (cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+  auto seqs = to_char_vec(get_str_seqs());
+  for (auto max_batches : {1, 2, 3, 7}) {
+    run_test(
+      kmer_size,
+      seqs,
+      get_expected_bits(),
+      vector<vector<char>>(seqs.size()),
+      expected_invalid_bits,
+      max_chars_per_batch,
+      max_batches,
+      true
+    );
+  }
+}
+
 }  // namespace sbwt_search
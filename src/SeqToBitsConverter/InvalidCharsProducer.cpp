@@ -10,15 +10,20 @@ using std::fill;
 using std::make_shared;
 
 InvalidCharsProducer::InvalidCharsProducer(
-  u64 kmer_size_, u64 max_chars_per_batch_, u64 max_batches
+  u64 kmer_size_,
+  u64 max_chars_per_batch_,
+  u64 max_batches,
+  bool invalid_bitmap_
 ):
     kmer_size(kmer_size_),
     max_chars_per_batch(max_chars_per_batch_),
+    invalid_bitmap(invalid_bitmap_),
     SharedBatchesProducer<InvalidCharsBatch>(max_batches) {
   initialise_batches();
 }
 
-auto InvalidCharsProducer::get_bits_per_element() -> u64 {
+auto InvalidCharsProducer::get_bits_per_element(bool invalid_bitmap) -> u64 {
+  if (invalid_bitmap) { return 0; }
   u64 bits_required_per_entry = 8;
   return 8;
 }
@@ -26,12 +31,15 @@ auto InvalidCharsProducer::get_bits_per_element() -> u64 {
 auto InvalidCharsProducer::get_default_value()
   -> shared_ptr<InvalidCharsBatch> {
   auto batch = make_shared<InvalidCharsBatch>();
-  batch->invalid_chars.reserve(max_chars_per_batch + kmer_size);
+  if (!invalid_bitmap) {
+    batch->invalid_chars.reserve(max_chars_per_batch + kmer_size);
+  }
   return batch;
 }
 
 auto InvalidCharsProducer::start_new_batch(u64 num_chars) -> void {
   SharedBatchesProducer<InvalidCharsBatch>::do_at_batch_start();
+  if (invalid_bitmap) { return; }
   current_write()->invalid_chars.resize(num_chars + kmer_size);
   fill(
     current_write()->invalid_chars.begin(),
@@ -5,7 +5,10 @@
  * @file InvalidCharsProducer.h
  * @brief Produces a list of booleans which tell wether a character is valid or
  * not. Instead of bool we use a 1 or 0 character since it is faster to process,
- * even though the memory footprint is higher
+ * even though the memory footprint is higher. When the invalid characters are
+ * instead sent to the gpu as a bitmap along with the bits, the batches are
+ * left empty, which tells the printers that the results already mark the
+ * invalid k-mers.
  */
 
 #include <memory>
@@ -25,13 +28,17 @@ class InvalidCharsProducer: public SharedBatchesProducer<InvalidCharsBatch> {
   friend ContinuousSeqToBitsConverter;
   u64 kmer_size;
   u64 max_chars_per_batch;
+  bool invalid_bitmap;
 
 public:
   InvalidCharsProducer(
-    u64 kmer_size_, u64 max_chars_per_batch_, u64 max_batches
+    u64 kmer_size_,
+    u64 max_chars_per_batch_,
+    u64 max_batches,
+    bool invalid_bitmap_ = false
   );
 
-  auto static get_bits_per_element() -> u64;
+  auto static get_bits_per_element(bool invalid_bitmap = false) -> u64;
 
 private:
   auto get_default_value() -> shared_ptr<InvalidCharsBatch> override;
@@ -14,6 +14,7 @@
 #include "SequenceFileParser/StringSequenceBatchProducer.h"
 #include "Tools/IOUtils.h"
 #include "Tools/Logger.h"
+#include "Tools/Metrics.h"
 #include "Tools/SharedBatchesProducer.hpp"
 #include "Tools/TypeDefinitions.h"
 #include "fmt/core.h"
@@ -22,8 +23,11 @@
 namespace sbwt_search {
 
 using fmt::format;
+using io_utils::is_standard_stream;
+using io_utils::standard_input_path;
 using io_utils::ThrowingIfstream;
 using log_utils::Logger;
+using log_utils::Metrics;
 using reklibpp::Seq;
 using reklibpp::SeqStreamIn;
 using std::ios;
@@ -42,7 +46,8 @@ ContinuousSequenceFileParser::ContinuousSequenceFileParser(
   u64 max_seqs_per_batch_,
   u64 string_sequence_batch_producer_max_batches,
   u64 string_break_batch_producer_max_batches,
-  u64 interval_batch_producer_max_batches
+  u64 interval_batch_producer_max_batches,
+  bool deduplicate_reads
 ):
     filenames(filenames_),
     kmer_size(kmer_size_),
@@ -67,6 +72,9 @@ ContinuousSequenceFileParser::ContinuousSequenceFileParser(
   for (unsigned int i = 0; i < batches.capacity(); ++i) {
     batches.set(i, make_shared<Seq>(max_chars_per_batch, max_seqs_per_batch));
   }
+  if (deduplicate_reads) {
+    deduplicator = make_unique<ReadDeduplicator>(batches.capacity());
+  }
 }
 
 auto ContinuousSequenceFileParser::read_and_generate() -> void {
@@ -122,7 +130,10 @@ auto ContinuousSequenceFileParser::start_next_file() -> bool {
       Logger::log(
         Logger::LOG_LEVEL::INFO, format("Now reading file {}", filename)
       );
-      stream = make_unique<SeqStreamIn>(filename.c_str());
+      stream = make_unique<SeqStreamIn>(
+        is_standard_stream(filename) ? standard_input_path.c_str() :
+                                       filename.c_str()
+      );
       return true;
     } catch (ios::failure &e) {
       Logger::log(Logger::LOG_LEVEL::ERROR, e.what());
@@ -150,16 +161,51 @@ auto ContinuousSequenceFileParser::read_next() -> void {
   while ((rec->seqs.size() < max_chars_per_batch)
          && (rec->chars_before_new_seq.size() < max_seqs_per_batch)
          && ((*stream) >> (*rec) || start_next_file())) {}
+  if (deduplicator != nullptr) {
+    deduplicate();
+    return;
+  }
   string_sequence_batch_producer->set_string(rec->seqs);
   string_break_batch_producer->set(rec->chars_before_new_seq, rec->seqs.size());
   interval_batch_producer->set_chars_before_newline(rec->chars_before_new_seq);
 }
 
+auto ContinuousSequenceFileParser::deduplicate() -> void {
+  auto rec = batches.current_write();
+  const u64 seqs_in_batch = rec->chars_before_new_seq.size();
+  const u64 duplicates
+    = deduplicator->deduplicate(rec->seqs, rec->chars_before_new_seq);
+  Logger::log(
+    Logger::LOG_LEVEL::DEBUG,
+    format(
+      "Batch {} in stream {} has {} duplicate seqs out of {} ({:.2f}%)",
+      batch_id,
+      stream_id,
+      duplicates,
+      seqs_in_batch,
+      seqs_in_batch == 0 ? 0 : 100.0 * duplicates / seqs_in_batch
+    )
+  );
+  string_sequence_batch_producer->set_string(rec->seqs);
+  string_break_batch_producer->set(rec->chars_before_new_seq, rec->seqs.size());
+  interval_batch_producer->set_chars_before_newline(
+    deduplicator->get_original_chars_before_new_seq()
+  );
+  interval_batch_producer->set_unique_seqs(
+    rec->chars_before_new_seq, deduplicator->get_unique_seq_indexes()
+  );
+}
+
 auto ContinuousSequenceFileParser::do_at_batch_finish() -> void {
   batches.step_read();
   auto seq_size = batches.current_write()->seqs.size();
   auto &str_breaks = batches.current_write()->chars_before_new_seq;
   str_breaks.push_back(std::numeric_limits<u64>::max());
+  if (deduplicator != nullptr) {
+    deduplicator->get_original_chars_before_new_seq().push_back(
+      std::numeric_limits<u64>::max()
+    );
+  }
   auto strings_in_batch = str_breaks.size()
     + static_cast<u64>(!str_breaks.empty()
                        && str_breaks.back() != (seq_size - 1));
@@ -173,6 +219,11 @@ auto ContinuousSequenceFileParser::do_at_batch_finish() -> void {
       strings_in_batch
     )
   );
+  Metrics::add(
+    format("SequenceFileParser_{}", stream_id),
+    "bytes_total",
+    static_cast<double>(seq_size)
+  );
   Logger::log_timed_event(
     format("SequenceFileParser_{}", stream_id),
     Logger::EVENT_STATE::STOP,
@@ -185,6 +236,21 @@ auto ContinuousSequenceFileParser::do_at_batch_finish() -> void {
 }
 
 auto ContinuousSequenceFileParser::do_at_generate_finish() -> void {
+  if (deduplicator != nullptr) {
+    const u64 total_seqs = deduplicator->get_total_seqs();
+    Logger::log(
+      Logger::LOG_LEVEL::INFO,
+      format(
+        "Stream {} collapsed {} duplicate seqs out of {} ({:.2f}%)",
+        stream_id,
+        deduplicator->get_total_duplicates(),
+        total_seqs,
+        total_seqs == 0 ?
+          0 :
+          100.0 * deduplicator->get_total_duplicates() / total_seqs
+      )
+    );
+  }
   string_sequence_batch_producer->do_at_generate_finish();
   string_break_batch_producer->do_at_generate_finish();
   interval_batch_producer->do_at_generate_finish();
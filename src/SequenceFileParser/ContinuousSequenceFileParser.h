@@ -7,7 +7,9 @@
  * buffer. Then it can serve these sequences to its consumers. The reading is
  * done in such a way that a single batch can contain characters from multiple
  * lines. kseqpp_REad is used for parsing the files and getting the list of
- * where each line break is.
+ * where each line break is. Optionally, the seqs which are exact duplicates
+ * of an earlier seq in the same batch are collapsed before being served, in
+ * which case the IntervalBatch still describes the original seqs.
  */
 
 #include <algorithm>
@@ -15,6 +17,7 @@
 #include <string>
 #include <vector>
 
+#include "ReadDeduplicator/ReadDeduplicator.h"
 #include "SequenceFileParser/IntervalBatchProducer.h"
 #include "SequenceFileParser/StringBreakBatchProducer.h"
 #include "SequenceFileParser/StringSequenceBatchProducer.h"
@@ -47,6 +50,7 @@ private:
   shared_ptr<IntervalBatchProducer> interval_batch_producer;
   CircularBuffer<shared_ptr<Seq>> batches;
   u64 stream_id;
+  unique_ptr<ReadDeduplicator> deduplicator;
 
 public:
   ContinuousSequenceFileParser(
@@ -57,7 +61,8 @@ public:
     u64 max_seqs_per_batch_,
     u64 string_sequence_batch_producer_max_batches,
     u64 string_break_batch_producer_max_batches,
-    u64 interval_batch_producer_max_batches
+    u64 interval_batch_producer_max_batches,
+    bool deduplicate_reads = false
   );
   auto read_and_generate() -> void;
   [[nodiscard]] auto get_string_sequence_batch_producer() const
@@ -70,6 +75,7 @@ public:
 private:
   auto start_next_file() -> bool;
   auto read_next() -> void;
+  auto deduplicate() -> void;
   auto reset_rec() -> void;
   auto do_at_batch_start() -> void;
   auto do_at_batch_finish() -> void;
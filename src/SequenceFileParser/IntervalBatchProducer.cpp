@@ -40,6 +40,14 @@ auto IntervalBatchProducer::set_chars_before_newline(
   current_write()->chars_before_new_seq = &chars_before_newline;
 }
 
+auto IntervalBatchProducer::set_unique_seqs(
+  const vector<u64> &unique_chars_before_new_seq,
+  const vector<u64> &unique_seq_indexes
+) -> void {
+  current_write()->unique_chars_before_new_seq = &unique_chars_before_new_seq;
+  current_write()->unique_seq_indexes = &unique_seq_indexes;
+}
+
 auto IntervalBatchProducer::do_at_batch_start() -> void {
   SharedBatchesProducer<IntervalBatch>::do_at_batch_start();
   current_write()->seqs_before_newfile.resize(0);
@@ -36,6 +36,10 @@ private:
   auto get_default_value() -> shared_ptr<IntervalBatch> override;
   auto set_chars_before_newline(const vector<size_t> &chars_before_newline)
     -> void;
+  auto set_unique_seqs(
+    const vector<u64> &unique_chars_before_new_seq,
+    const vector<u64> &unique_seq_indexes
+  ) -> void;
 };
 
 }  // namespace sbwt_search
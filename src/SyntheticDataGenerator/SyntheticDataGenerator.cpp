@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <ios>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "SyntheticDataGenerator/SyntheticDataGenerator.h"
+#include "Tools/IOUtils.h"
+#include "Tools/TypeDefinitions.h"
+#include "fmt/core.h"
+
+namespace sbwt_search {
+
+using fmt::format;
+using io_utils::ThrowingOfstream;
+using std::ios;
+using std::runtime_error;
+using std::uniform_int_distribution;
+using std::uniform_real_distribution;
+
+namespace {
+
+const string alphabet = "ACGT";
+const u64 fasta_line_width = 80;
+
+auto get_complement(char c) -> char {
+  return alphabet[alphabet.size() - 1 - alphabet.find(c)];
+}
+
+}  // namespace
+
+SyntheticDataGenerator::SyntheticDataGenerator(u64 seed): rng(seed) {}
+
+auto SyntheticDataGenerator::generate_references(
+  u64 num_references, u64 reference_length
+) -> vector<string> {
+  vector<string> references;
+  references.reserve(num_references);
+  for (u64 i = 0; i < num_references; ++i) {
+    references.push_back(get_random_seq(reference_length));
+  }
+  return references;
+}
+
+auto SyntheticDataGenerator::generate_reads(
+  const vector<string> &references,
+  u64 num_reads,
+  u64 read_length,
+  double error_rate,
+  double unmapped_fraction,
+  bool reverse_complements
+) -> vector<string> {
+  if (references.empty()) {
+    throw runtime_error("Reads can not be generated without any references");
+  }
+  uniform_int_distribution<u64> reference_distribution(
+    0, references.size() - 1
+  );
+  vector<string> reads;
+  reads.reserve(num_reads);
+  for (u64 i = 0; i < num_reads; ++i) {
+    if (get_random_double() < unmapped_fraction) {
+      reads.push_back(get_random_seq(read_length));
+      continue;
+    }
+    const string &reference = references[reference_distribution(rng)];
+    const u64 length = std::min(read_length, reference.size());
+    uniform_int_distribution<u64> start_distribution(
+      0, reference.size() - length
+    );
+    string read = reference.substr(start_distribution(rng), length);
+    if (reverse_complements && get_random_double() < 0.5) {
+      std::reverse(read.begin(), read.end());
+      std::transform(read.begin(), read.end(), read.begin(), get_complement);
+    }
+    add_errors(read, error_rate);
+    reads.push_back(std::move(read));
+  }
+  return reads;
+}
+
+auto SyntheticDataGenerator::write_fasta(
+  const string &filename, const vector<string> &seqs, const string &name
+) -> void {
+  ThrowingOfstream out(filename, ios::out);
+  for (u64 i = 0; i < seqs.size(); ++i) {
+    out << format(">{}_{}\n", name, i);
+    for (u64 start = 0; start < seqs[i].size(); start += fasta_line_width) {
+      out << seqs[i].substr(start, fasta_line_width) << '\n';
+    }
+  }
+}
+
+auto SyntheticDataGenerator::get_random_seq(u64 length) -> string {
+  uniform_int_distribution<u64> char_distribution(0, alphabet.size() - 1);
+  string seq(length, ' ');
+  for (auto &c : seq) { c = alphabet[char_distribution(rng)]; }
+  return seq;
+}
+
+// Substitutions always change the character to one of the other 3
+auto SyntheticDataGenerator::add_errors(string &read, double error_rate)
+  -> void {
+  uniform_int_distribution<u64> offset_distribution(1, alphabet.size() - 1);
+  for (auto &c : read) {
+    if (get_random_double() < error_rate) {
+      c = alphabet
+        [(alphabet.find(c) + offset_distribution(rng)) % alphabet.size()];
+    }
+  }
+}
+
+auto SyntheticDataGenerator::get_random_double() -> double {
+  return uniform_real_distribution<double>(0, 1)(rng);
+}
+
+}  // namespace sbwt_search
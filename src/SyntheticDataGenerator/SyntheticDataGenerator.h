@@ -0,0 +1,55 @@
+#ifndef SYNTHETIC_DATA_GENERATOR_H
+#define SYNTHETIC_DATA_GENERATOR_H
+
+/**
+ * @file SyntheticDataGenerator.h
+ * @brief Generates random reference genomes and reads sampled from them, so
+ * that indexes and queries of any size can be created for benchmarking without
+ * downloading any data. Reads are substrings of the references at uniformly
+ * random positions, which may be reverse complemented and which get
+ * substitution errors at the given rate. A fraction of the reads can instead
+ * be fully random, such that most of their k-mers are not found in the index.
+ * The same seed always generates the same data.
+ */
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+using std::mt19937_64;
+using std::string;
+using std::vector;
+
+class SyntheticDataGenerator {
+private:
+  mt19937_64 rng;
+
+public:
+  explicit SyntheticDataGenerator(u64 seed);
+  auto generate_references(u64 num_references, u64 reference_length)
+    -> vector<string>;
+  auto generate_reads(
+    const vector<string> &references,
+    u64 num_reads,
+    u64 read_length,
+    double error_rate,
+    double unmapped_fraction,
+    bool reverse_complements
+  ) -> vector<string>;
+  static auto write_fasta(
+    const string &filename, const vector<string> &seqs, const string &name
+  ) -> void;
+
+private:
+  auto get_random_seq(u64 length) -> string;
+  auto add_errors(string &read, double error_rate) -> void;
+  auto get_random_double() -> double;
+};
+
+}  // namespace sbwt_search
+
+#endif
@@ -0,0 +1,61 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "SyntheticDataGenerator/SyntheticDataGenerator.h"
+
+namespace sbwt_search {
+
+using std::string;
+using std::vector;
+
+const u64 num_references = 3;
+const u64 reference_length = 1000;
+const u64 num_reads = 100;
+const u64 read_length = 150;
+
+TEST(SyntheticDataGeneratorTest, SameSeedSameData) {
+  SyntheticDataGenerator generator_1(1);
+  SyntheticDataGenerator generator_2(1);
+  auto references
+    = generator_1.generate_references(num_references, reference_length);
+  ASSERT_EQ(
+    references,
+    generator_2.generate_references(num_references, reference_length)
+  );
+  ASSERT_EQ(references.size(), num_references);
+  for (auto &reference : references) {
+    ASSERT_EQ(reference.size(), reference_length);
+    ASSERT_EQ(reference.find_first_not_of("ACGT"), string::npos);
+  }
+  const double error_rate = 0.1;
+  const double unmapped_fraction = 0.1;
+  ASSERT_EQ(
+    generator_1.generate_reads(
+      references, num_reads, read_length, error_rate, unmapped_fraction, true
+    ),
+    generator_2.generate_reads(
+      references, num_reads, read_length, error_rate, unmapped_fraction, true
+    )
+  );
+}
+
+TEST(SyntheticDataGeneratorTest, ErrorFreeReadsAreSubstrings) {
+  SyntheticDataGenerator generator(0);
+  auto references
+    = generator.generate_references(num_references, reference_length);
+  auto reads
+    = generator.generate_reads(references, num_reads, read_length, 0, 0, false);
+  ASSERT_EQ(reads.size(), num_reads);
+  for (auto &read : reads) {
+    ASSERT_EQ(read.size(), read_length);
+    bool found = false;
+    for (auto &reference : references) {
+      found = found || reference.find(read) != string::npos;
+    }
+    ASSERT_TRUE(found);
+  }
+}
+
+}  // namespace sbwt_search
@@ -0,0 +1,294 @@
+#ifndef ASYNC_BUFFER_WRITER_HPP
+#define ASYNC_BUFFER_WRITER_HPP
+
+/**
+ * @file AsyncBufferWriter.hpp
+ * @brief Writes filled buffers to their output stream on a dedicated thread,
+ * so that a results printer can format its next batch while the previous one
+ * is still being written. The buffers come from a fixed pool of slots which
+ * are allocated once and then recycled. The printer acquires a free slot,
+ * fills its buffers and submits it, and only blocks if every slot is still
+ * waiting to be written, which is logged as a write stall. Slots are written
+ * in the order in which they were submitted. The buffers within a slot are
+ * written at the same time at prefix sum offsets if the stream is a regular
+ * file, otherwise they are written one after the other. If compression is
+ * enabled, each buffer is compressed into a gzip member of its own by the
+ * thread which filled it, so compression scales with the formatting threads
+ * and the concatenated members still form a single gzip stream.
+ */
+
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <ios>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Tools/CircularQueue.hpp"
+#include "Tools/GzipUtils.h"
+#include "Tools/IOUtils.h"
+#include "Tools/Logger.h"
+#include "Tools/Metrics.h"
+#include "Tools/PipelineProfiler.h"
+#include "Tools/TaskScheduler.h"
+#include "Tools/TypeDefinitions.h"
+#include "fmt/core.h"
+
+namespace io_utils {
+
+using fmt::format;
+using log_utils::Logger;
+using log_utils::Metrics;
+using log_utils::PipelineProfiler;
+using std::bit_cast;
+using std::condition_variable;
+using std::exception_ptr;
+using std::mutex;
+using std::string;
+using std::thread;
+using std::unique_lock;
+using std::vector;
+using std::chrono::duration;
+using std::chrono::steady_clock;
+using structure_utils::CircularQueue;
+using threading_utils::TaskScheduler;
+
+template <class Buffer_t>
+class AsyncBufferWriter {
+public:
+  class Slot {
+  public:
+    vector<vector<Buffer_t>> buffers;
+    // the number of elements of each buffer which are to be written
+    vector<u64> sizes;
+    vector<vector<char>> compressed;
+    ThrowingOfstream *stream = nullptr;
+    u64 batch_id = 0;
+  };
+
+private:
+  string name;
+  bool compress;
+  vector<Slot> slots;
+  CircularQueue<u64> free_slots;
+  CircularQueue<u64> filled_slots;
+  u64 acquired_slot = 0;
+  u64 pending_slots = 0;
+  mutex slots_mutex;
+  condition_variable slot_freed;
+  condition_variable slot_filled;
+  bool stopping = false;
+  exception_ptr error = nullptr;
+  vector<u64> offsets;
+  u64 bytes_written = 0;
+  duration<double, std::milli> write_time{0};
+  duration<double, std::milli> stall_time{0};
+  thread writer;
+
+public:
+  AsyncBufferWriter(
+    string name_, u64 num_slots, u64 buffers_per_slot, bool compress_ = false
+  ):
+      name(std::move(name_)),
+      compress(compress_),
+      slots(num_slots),
+      free_slots(num_slots),
+      filled_slots(num_slots),
+      offsets(buffers_per_slot + 1) {
+    for (u64 i = 0; i < num_slots; ++i) {
+      slots[i].buffers.resize(buffers_per_slot);
+      slots[i].sizes.resize(buffers_per_slot, 0);
+      slots[i].compressed.resize(compress ? buffers_per_slot : 0);
+      free_slots.push(i);
+    }
+    writer = thread([this] { write_loop(); });
+  }
+  AsyncBufferWriter(AsyncBufferWriter &) = delete;
+  AsyncBufferWriter(AsyncBufferWriter &&) = delete;
+  auto operator=(AsyncBufferWriter &) = delete;
+  auto operator=(AsyncBufferWriter &&) = delete;
+
+  // Slots which were submitted are still written before the thread exits
+  ~AsyncBufferWriter() {
+    {
+      unique_lock lock(slots_mutex);
+      stopping = true;
+    }
+    slot_filled.notify_all();
+    writer.join();
+  }
+
+  // Only to be used for allocating the buffers up front
+  auto get_slots() -> vector<Slot> & { return slots; }
+
+  // Blocks until a slot is free. Only one slot may be acquired at a time, and
+  // it must be submitted before the next one is acquired.
+  auto acquire(u64 batch_id) -> Slot & {
+    unique_lock lock(slots_mutex);
+    if (free_slots.empty() && error == nullptr) {
+      Logger::log_timed_event(
+        format("{}Stall", name),
+        Logger::EVENT_STATE::START,
+        format("batch {}", batch_id)
+      );
+      auto start_time = steady_clock::now();
+      slot_freed.wait(lock, [this] {
+        return !free_slots.empty() || error != nullptr;
+      });
+      const duration<double> stall = steady_clock::now() - start_time;
+      stall_time += stall;
+      Metrics::add(name, "full_queue_wait_seconds_total", stall.count());
+      PipelineProfiler::add_wait(name, true, stall.count());
+      Logger::log_timed_event(
+        format("{}Stall", name),
+        Logger::EVENT_STATE::STOP,
+        format("batch {}", batch_id)
+      );
+    }
+    if (error != nullptr) { std::rethrow_exception(error); }
+    acquired_slot = free_slots.front();
+    free_slots.pop();
+    auto &slot = slots[acquired_slot];
+    slot.batch_id = batch_id;
+    return slot;
+  }
+
+  // To be called by the thread which filled the buffer, once it is done
+  auto finish_buffer(Slot &slot, u64 buffer_idx) -> void {
+    if (!compress) { return; }
+    auto &compressed = slot.compressed[buffer_idx];
+    if (slot.sizes[buffer_idx] == 0) {
+      compressed.resize(0);
+      return;
+    }
+    gzip_compress(
+      bit_cast<char *>(slot.buffers[buffer_idx].data()),
+      slot.sizes[buffer_idx] * sizeof(Buffer_t),
+      compressed
+    );
+  }
+
+  // Queues the acquired slot to be written to the given stream
+  auto submit(ThrowingOfstream &stream) -> void {
+    {
+      unique_lock lock(slots_mutex);
+      slots[acquired_slot].stream = &stream;
+      filled_slots.push(acquired_slot);
+      ++pending_slots;
+    }
+    slot_filled.notify_one();
+  }
+
+  // Blocks until every submitted slot has been written, after which the
+  // stream may be written to directly or closed
+  auto wait_until_written() -> void {
+    unique_lock lock(slots_mutex);
+    slot_freed.wait(lock, [this] {
+      return pending_slots == 0 || error != nullptr;
+    });
+    if (error != nullptr) { std::rethrow_exception(error); }
+  }
+
+  auto log_statistics() -> void {
+    unique_lock lock(slots_mutex);
+    Logger::log(
+      Logger::LOG_LEVEL::INFO,
+      format(
+        "{} wrote {} bytes in {:.2f}ms, and formatting stalled for {:.2f}ms "
+        "while waiting for free buffers",
+        name,
+        bytes_written,
+        write_time.count(),
+        stall_time.count()
+      )
+    );
+  }
+
+private:
+  auto write_loop() -> void {
+    while (true) {
+      u64 slot_idx = 0;
+      {
+        unique_lock lock(slots_mutex);
+        const auto wait_start_time = steady_clock::now();
+        slot_filled.wait(lock, [this] {
+          return stopping || !filled_slots.empty();
+        });
+        PipelineProfiler::add_wait(
+          name,
+          false,
+          duration<double>(steady_clock::now() - wait_start_time).count()
+        );
+        if (filled_slots.empty()) { return; }
+        slot_idx = filled_slots.front();
+        filled_slots.pop();
+      }
+      auto &slot = slots[slot_idx];
+      Logger::log_timed_event(
+        name, Logger::EVENT_STATE::START, format("batch {}", slot.batch_id)
+      );
+      auto start_time = steady_clock::now();
+      u64 bytes = 0;
+      exception_ptr slot_error = nullptr;
+      try {
+        bytes = write_slot(slot);
+      } catch (...) { slot_error = std::current_exception(); }
+      auto end_time = steady_clock::now();
+      Logger::log_timed_event(
+        name, Logger::EVENT_STATE::STOP, format("batch {}", slot.batch_id)
+      );
+      Metrics::add(name, "bytes_total", static_cast<double>(bytes));
+      Metrics::add(name, "batches_total", 1);
+      {
+        unique_lock lock(slots_mutex);
+        if (slot_error != nullptr && error == nullptr) { error = slot_error; }
+        bytes_written += bytes;
+        write_time += end_time - start_time;
+        free_slots.push(slot_idx);
+        --pending_slots;
+      }
+      slot_freed.notify_all();
+    }
+  }
+
+  auto get_output(Slot &slot, u64 buffer_idx) -> const char * {
+    if (compress) { return slot.compressed[buffer_idx].data(); }
+    return bit_cast<char *>(slot.buffers[buffer_idx].data());
+  }
+
+  auto get_output_size(Slot &slot, u64 buffer_idx) -> u64 {
+    if (compress) { return slot.compressed[buffer_idx].size(); }
+    return slot.sizes[buffer_idx] * sizeof(Buffer_t);
+  }
+
+  auto write_slot(Slot &slot) -> u64 {
+    auto &stream = *slot.stream;
+    const u64 buffers = slot.buffers.size();
+    if (!stream.supports_positional_writes()) {
+      u64 bytes = 0;
+      for (u64 i = 0; i < buffers; ++i) {
+        stream.write_raw(get_output(slot, i), get_output_size(slot, i));
+        bytes += get_output_size(slot, i);
+      }
+      return bytes;
+    }
+    offsets[0] = stream.get_write_position();
+    for (u64 i = 0; i < buffers; ++i) {
+      offsets[i + 1] = offsets[i] + get_output_size(slot, i);
+    }
+    TaskScheduler::get_global().parallel_for(buffers, [&](u64 idx) {
+      stream.write_at(
+        get_output(slot, idx), offsets[idx + 1] - offsets[idx], offsets[idx]
+      );
+    });
+    stream.set_write_position(offsets.back());
+    return offsets.back() - offsets.front();
+  }
+};
+
+}  // namespace io_utils
+
+#endif
@@ -0,0 +1,67 @@
+#include <filesystem>
+#include <ios>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "Tools/AsyncBufferWriter.hpp"
+#include "Tools/IOUtils.h"
+
+namespace io_utils {
+
+using std::ios;
+using std::string;
+
+namespace {
+
+auto fill_slot(AsyncBufferWriter<char>::Slot &slot, const string &content)
+  -> void {
+  // spread the content over all buffers, leaving some of them empty
+  const u64 per_buffer = content.size() / slot.buffers.size() + 1;
+  for (u64 i = 0, idx = 0; i < slot.buffers.size(); ++i) {
+    slot.sizes[i] = 0;
+    for (; idx < content.size() && slot.sizes[i] < per_buffer; ++idx) {
+      slot.buffers[i][slot.sizes[i]++] = content[idx];
+    }
+  }
+}
+
+auto read_file(const string &filename) -> string {
+  ThrowingIfstream in(filename, ios::in);
+  string content;
+  std::getline(in, content);
+  return content;
+}
+
+}  // namespace
+
+TEST(AsyncBufferWriterTest, WritesSlotsInOrder) {
+  const string filename = "test_objects/tmp/async_buffer_writer.txt";
+  std::filesystem::create_directories("test_objects/tmp");
+  const u64 slots = 2;
+  const u64 buffers_per_slot = 3;
+  const u64 buffer_size = 10;
+  string expected;
+  {
+    AsyncBufferWriter<char> writer("TestWriter", slots, buffers_per_slot);
+    for (auto &slot : writer.get_slots()) {
+      for (auto &buffer : slot.buffers) { buffer.resize(buffer_size); }
+    }
+    ThrowingOfstream out(filename, ios::out | ios::binary);
+    out << "header ";
+    expected += "header ";
+    for (u64 batch = 0; batch < 20; ++batch) {
+      const string content = std::to_string(batch * batch) + "abcdefghij";
+      fill_slot(writer.acquire(batch), content);
+      writer.submit(out);
+      expected += content;
+    }
+    writer.wait_until_written();
+    out << " footer";
+    expected += " footer";
+  }
+  ASSERT_EQ(read_file(filename), expected);
+  std::filesystem::remove(filename);
+}
+
+}  // namespace io_utils
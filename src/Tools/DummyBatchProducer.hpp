@@ -8,6 +8,7 @@
  */
 
 #include <memory>
+#include <type_traits>
 #include <vector>
 
 #include "Tools/SharedBatchesProducer.hpp"
@@ -38,8 +39,13 @@ public:
     this->read_and_generate();
   }
 
+  // the default values are only placeholders, since generate() replaces them
   auto get_default_value() -> shared_ptr<T> override {
-    return make_shared<T>();
+    if constexpr (std::is_default_constructible_v<T>) {
+      return make_shared<T>();
+    } else {
+      return nullptr;
+    }
   }
 
   auto continue_read_condition() -> bool override {
@@ -3,6 +3,7 @@
 
 #include "Tools/GpuPointer.h"
 #include "Tools/GpuUtils.h"
+#include "Tools/MemoryTracker.h"
 #include "Tools/TypeDefinitions.h"
 #include "hip/hip_runtime.h"
 
@@ -10,10 +11,13 @@ using std::vector;
 
 namespace gpu_utils {
 
+using memory_utils::MemoryTracker;
+
 template <class T>
 GpuPointer<T>::GpuPointer(u64 size):
     bytes(size * sizeof(T)), owning_pointer(true) {
   GPU_CHECK(hipMalloc((void **)(&ptr), bytes));
+  tracker_id = MemoryTracker::add(MemoryTracker::MEMORY_KIND::GPU, bytes);
 }
 template <class T>
 GpuPointer<T>::GpuPointer(const T *cpu_ptr, u64 size): GpuPointer(size) {
@@ -33,6 +37,7 @@ GpuPointer<T>::GpuPointer(u64 size, GpuStream &gpu_stream):
   GPU_CHECK(hipMallocAsync(
     (void **)(&ptr), bytes, *reinterpret_cast<hipStream_t *>(gpu_stream.data())
   ));
+  tracker_id = MemoryTracker::add(MemoryTracker::MEMORY_KIND::GPU, bytes);
 }
 template <class T>
 GpuPointer<T>::GpuPointer(const T *cpu_ptr, u64 size, GpuStream &gpu_stream):
@@ -187,6 +192,7 @@ auto GpuPointer<T>::copy_to_async(vector<T> &destination, GpuStream &gpu_stream)
 template <class T>
 GpuPointer<T>::~GpuPointer() {
   if (owning_pointer) {
+    MemoryTracker::remove(tracker_id, MemoryTracker::MEMORY_KIND::GPU, bytes);
     try {
       GPU_CHECK(hipFree(ptr));
     } catch (std::runtime_error &e) { std::cerr << e.what() << std::endl; }
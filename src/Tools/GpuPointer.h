@@ -23,6 +23,8 @@ private:
   T *ptr;
   u64 bytes = 0;
   bool owning_pointer;
+  // only owning pointers are counted by the MemoryTracker
+  u64 tracker_id = 0;
 
 public:
   explicit GpuPointer(u64 size);
@@ -11,4 +11,11 @@ auto get_free_gpu_memory() -> u64 {
   return free;
 }
 
+auto get_total_gpu_memory() -> u64 {
+  u64 free = 0;
+  u64 total = 0;
+  GPU_CHECK(hipMemGetInfo(&free, &total));
+  return total;
+}
+
 }  // namespace gpu_utils
@@ -29,6 +29,7 @@ namespace gpu_utils {
   }
 
 auto get_free_gpu_memory() -> u64;
+auto get_total_gpu_memory() -> u64;
 
 }  // namespace gpu_utils
 
@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <bit>
+#include <ios>
+#include <limits>
+#include <vector>
+
+#include <zlib.h>
+
+#include "Tools/GzipUtils.h"
+#include "Tools/TypeDefinitions.h"
+#include "fmt/core.h"
+
+namespace io_utils {
+
+using fmt::format;
+using std::bit_cast;
+using std::ios;
+using std::min;
+using std::numeric_limits;
+
+namespace {
+
+// 15 bits for the window plus 16 so that zlib writes and reads gzip headers
+const int gzip_window_bits = 15 + 16;
+const int gzip_memory_level = 8;
+const u64 max_zlib_chunk = numeric_limits<uInt>::max();
+const u64 input_buffer_size = 1ULL << 16ULL;
+const u64 output_buffer_size = 1ULL << 18ULL;
+
+}  // namespace
+
+auto gzip_compress(const char *data, u64 size, vector<char> &out, int level)
+  -> void {
+  z_stream stream{};
+  if (deflateInit2(
+        &stream,
+        level,
+        Z_DEFLATED,
+        gzip_window_bits,
+        gzip_memory_level,
+        Z_DEFAULT_STRATEGY
+      )
+      != Z_OK) {
+    throw ios::failure("Could not initialise the gzip compression");
+  }
+  out.resize(deflateBound(&stream, size));
+  u64 in_left = size;
+  int result = Z_OK;
+  while (result != Z_STREAM_END) {
+    if (stream.avail_in == 0 && in_left > 0) {
+      const u64 chunk = min(in_left, max_zlib_chunk);
+      // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      stream.next_in = bit_cast<Bytef *>(data + (size - in_left));
+      stream.avail_in = static_cast<uInt>(chunk);
+      in_left -= chunk;
+    }
+    if (stream.total_out == out.size()) { out.resize(out.size() * 2); }
+    stream.next_out = bit_cast<Bytef *>(out.data() + stream.total_out);
+    stream.avail_out
+      = static_cast<uInt>(min(out.size() - stream.total_out, max_zlib_chunk));
+    result = deflate(&stream, in_left == 0 ? Z_FINISH : Z_NO_FLUSH);
+    if (result == Z_STREAM_ERROR) {
+      deflateEnd(&stream);
+      throw ios::failure("Could not gzip compress the output");
+    }
+  }
+  out.resize(stream.total_out);
+  deflateEnd(&stream);
+}
+
+GzipMemberOutputBuffer::GzipMemberOutputBuffer(streambuf *destination_):
+    destination(destination_) {}
+
+auto GzipMemberOutputBuffer::overflow(int_type c) -> int_type {
+  if (!traits_type::eq_int_type(c, traits_type::eof())) {
+    pending.push_back(traits_type::to_char_type(c));
+  }
+  return traits_type::not_eof(c);
+}
+
+auto GzipMemberOutputBuffer::xsputn(const char_type *s, std::streamsize count)
+  -> std::streamsize {
+  // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  pending.insert(pending.end(), s, s + count);
+  return count;
+}
+
+auto GzipMemberOutputBuffer::sync() -> int {
+  if (!pending.empty()) {
+    gzip_compress(pending.data(), pending.size(), compressed);
+    const auto size = static_cast<std::streamsize>(compressed.size());
+    if (destination->sputn(compressed.data(), size) != size) { return -1; }
+    pending.clear();
+  }
+  return destination->pubsync();
+}
+
+auto GzipMemberOutputBuffer::seekoff(
+  off_type off, std::ios::seekdir dir, std::ios::openmode which
+) -> pos_type {
+  if (sync() != 0) { return {off_type(-1)}; }
+  return destination->pubseekoff(off, dir, which);
+}
+
+auto GzipMemberOutputBuffer::seekpos(pos_type pos, std::ios::openmode which)
+  -> pos_type {
+  if (sync() != 0) { return {off_type(-1)}; }
+  return destination->pubseekpos(pos, which);
+}
+
+GzipInputBuffer::GzipInputBuffer(streambuf *source_):
+    source(source_),
+    in_buffer(input_buffer_size),
+    out_buffer(output_buffer_size) {
+  if (inflateInit2(&inflate_stream, gzip_window_bits) != Z_OK) {
+    throw ios::failure("Could not initialise the gzip decompression");
+  }
+  setg(out_buffer.data(), out_buffer.data(), out_buffer.data());
+}
+
+GzipInputBuffer::~GzipInputBuffer() { inflateEnd(&inflate_stream); }
+
+auto GzipInputBuffer::underflow() -> int_type {
+  if (gptr() < egptr()) { return traits_type::to_int_type(*gptr()); }
+  while (true) {
+    if (inflate_stream.avail_in == 0) { fill_input(); }
+    if (inflate_stream.avail_in == 0) {
+      if (!in_member) { return traits_type::eof(); }
+      throw ios::failure("The gzip stream ended in the middle of a member");
+    }
+    // every member is a complete gzip stream of its own
+    if (!in_member) {
+      inflateReset(&inflate_stream);
+      in_member = true;
+    }
+    inflate_stream.next_out = bit_cast<Bytef *>(out_buffer.data());
+    inflate_stream.avail_out = static_cast<uInt>(out_buffer.size());
+    const int result = inflate(&inflate_stream, Z_NO_FLUSH);
+    if (result == Z_STREAM_END) {
+      in_member = false;
+    } else if (result != Z_OK && result != Z_BUF_ERROR) {
+      throw ios::failure(format(
+        "Could not decompress the gzip stream: {}",
+        inflate_stream.msg == nullptr ? "unknown error" : inflate_stream.msg
+      ));
+    }
+    const u64 produced = out_buffer.size() - inflate_stream.avail_out;
+    if (produced > 0) {
+      setg(
+        out_buffer.data(),
+        out_buffer.data(),
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        out_buffer.data() + produced
+      );
+      return traits_type::to_int_type(*gptr());
+    }
+  }
+}
+
+auto GzipInputBuffer::fill_input() -> void {
+  const auto read = source->sgetn(
+    in_buffer.data(), static_cast<std::streamsize>(in_buffer.size())
+  );
+  inflate_stream.next_in = bit_cast<Bytef *>(in_buffer.data());
+  inflate_stream.avail_in = static_cast<uInt>(read);
+}
+
+}  // namespace io_utils
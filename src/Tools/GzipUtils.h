@@ -0,0 +1,81 @@
+#ifndef GZIP_UTILS_H
+#define GZIP_UTILS_H
+
+/**
+ * @file GzipUtils.h
+ * @brief Utilities for reading and writing gzip streams made up of many
+ * independently compressed members. Since a gzip file may be any number of
+ * members one after the other, threads can each compress their own part of
+ * the output and the concatenation is still a single valid gzip file, which
+ * the standard tools and the input buffer here read back as a whole.
+ */
+
+#include <streambuf>
+#include <vector>
+
+#include <zlib.h>
+
+#include "Tools/TypeDefinitions.h"
+
+namespace io_utils {
+
+using std::streambuf;
+using std::vector;
+
+// Replaces the contents of out with a complete gzip member holding the data
+auto gzip_compress(
+  const char *data,
+  u64 size,
+  vector<char> &out,
+  int level = Z_DEFAULT_COMPRESSION
+) -> void;
+
+// Stream buffer which collects whatever is written through it and writes it
+// to the destination as a separate gzip member every time it is synced
+class GzipMemberOutputBuffer: public streambuf {
+private:
+  streambuf *destination;
+  vector<char> pending;
+  vector<char> compressed;
+
+public:
+  explicit GzipMemberOutputBuffer(streambuf *destination_);
+
+protected:
+  auto overflow(int_type c) -> int_type override;
+  auto xsputn(const char_type *s, std::streamsize count)
+    -> std::streamsize override;
+  auto sync() -> int override;
+  auto seekoff(off_type off, std::ios::seekdir dir, std::ios::openmode which)
+    -> pos_type override;
+  auto seekpos(pos_type pos, std::ios::openmode which) -> pos_type override;
+};
+
+// Stream buffer which decompresses a gzip stream read from the source, where
+// the stream may consist of any number of concatenated members
+class GzipInputBuffer: public streambuf {
+private:
+  streambuf *source;
+  z_stream inflate_stream{};
+  vector<char> in_buffer;
+  vector<char> out_buffer;
+  bool in_member = false;
+
+public:
+  explicit GzipInputBuffer(streambuf *source_);
+  GzipInputBuffer(GzipInputBuffer &) = delete;
+  GzipInputBuffer(GzipInputBuffer &&) = delete;
+  auto operator=(GzipInputBuffer &) = delete;
+  auto operator=(GzipInputBuffer &&) = delete;
+  ~GzipInputBuffer() override;
+
+protected:
+  auto underflow() -> int_type override;
+
+private:
+  auto fill_input() -> void;
+};
+
+}  // namespace io_utils
+
+#endif
@@ -0,0 +1,93 @@
+#include <filesystem>
+#include <ios>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "Tools/GzipUtils.h"
+#include "Tools/IOUtils.h"
+
+namespace io_utils {
+
+using std::ios;
+using std::string;
+using std::vector;
+
+namespace {
+
+auto read_gzip_file(const string &filename) -> string {
+  ThrowingIfstream in(filename, ios::in | ios::binary);
+  in.enable_gzip_decompression();
+  string content;
+  vector<char> buffer(7);
+  // read in odd sized pieces so that reads cross member boundaries
+  while (!in.eof()) {
+    in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    content.append(buffer.data(), in.gcount());
+  }
+  return content;
+}
+
+}  // namespace
+
+TEST(GzipUtilsTest, ConcatenatedMembersReadAsOneStream) {
+  const string filename = "test_objects/tmp/gzip_members.gz";
+  std::filesystem::create_directories("test_objects/tmp");
+  string expected;
+  {
+    ThrowingOfstream out(filename, ios::out | ios::binary);
+    out.enable_gzip_members();
+    ASSERT_TRUE(out.writes_gzip_members());
+    out.write_string_with_size("header");
+    expected += string("\x06\0\0\0\0\0\0\0", sizeof(u64)) + "header";
+    vector<char> compressed;
+    for (u64 i = 0; i < 50; ++i) {
+      const string part = std::to_string(i * i) + " 1 2 3 -1 -2\n";
+      gzip_compress(part.data(), part.size(), compressed);
+      out.write_raw(compressed.data(), compressed.size());
+      expected += part;
+    }
+    // an empty member is still valid
+    gzip_compress(nullptr, 0, compressed);
+    out.write_raw(compressed.data(), compressed.size());
+    out << "footer";
+    expected += "footer";
+  }
+  ASSERT_EQ(read_gzip_file(filename), expected);
+  std::filesystem::remove(filename);
+}
+
+TEST(GzipUtilsTest, LargeMember) {
+  const string filename = "test_objects/tmp/gzip_large.gz";
+  std::filesystem::create_directories("test_objects/tmp");
+  string expected;
+  for (u64 i = 0; expected.size() < 1000000; ++i) {
+    expected += std::to_string(i * 7919 % 100003) + " ";
+  }
+  {
+    ThrowingOfstream out(filename, ios::out | ios::binary);
+    vector<char> compressed;
+    gzip_compress(expected.data(), expected.size(), compressed);
+    ASSERT_LT(compressed.size(), expected.size());
+    out.write_raw(compressed.data(), compressed.size());
+  }
+  ASSERT_EQ(read_gzip_file(filename), expected);
+  std::filesystem::remove(filename);
+}
+
+TEST(GzipUtilsTest, TruncatedStreamThrows) {
+  const string filename = "test_objects/tmp/gzip_truncated.gz";
+  std::filesystem::create_directories("test_objects/tmp");
+  const string content(100000, 'a');
+  {
+    ThrowingOfstream out(filename, ios::out | ios::binary);
+    vector<char> compressed;
+    gzip_compress(content.data(), content.size(), compressed);
+    out.write_raw(compressed.data(), compressed.size() / 2);
+  }
+  ASSERT_THROW(read_gzip_file(filename), ios::failure);
+  std::filesystem::remove(filename);
+}
+
+}  // namespace io_utils
@@ -1,6 +1,14 @@
 #include <bit>
+#include <cerrno>
+#include <cstring>
 #include <ios>
+#include <memory>
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Tools/GzipUtils.h"
 #include "Tools/IOUtils.h"
 #include "Tools/TypeDefinitions.h"
 #include "fmt/core.h"
@@ -11,21 +19,42 @@ using fmt::format;
 using std::bit_cast;
 using std::ifstream;
 using std::ios;
+using std::make_unique;
 using std::string;
 
 ThrowingIfstream::ThrowingIfstream(const string &filename, ios::openmode mode):
-    ifstream(filename, mode) {
+    ifstream(
+      is_standard_stream(filename) ? standard_input_path : filename, mode
+    ) {
   if (this->fail()) {
     throw ios::failure(format("The input file {} cannot be opened", filename));
   }
 }
 
+ThrowingIfstream::~ThrowingIfstream() = default;
+
+auto ThrowingIfstream::enable_gzip_decompression() -> void {
+  gzip_buffer = make_unique<GzipInputBuffer>(ifstream::rdbuf());
+  std::istream::rdbuf(gzip_buffer.get());
+  // a corrupt stream would otherwise only set the badbit, which the readers
+  // do not check
+  exceptions(ios::badbit);
+}
+
 auto ThrowingIfstream::check_file_exists(const string &filename) -> void {
   ThrowingIfstream(filename, ios::in);
 }
 
-ThrowingOfstream::ThrowingOfstream(const string &filepath, ios::openmode mode):
-    ofstream(filepath, mode) {
+// Standard output is opened for appending, so that a file which it was
+// redirected to with '>>' is not truncated
+ThrowingOfstream::ThrowingOfstream(
+  const string &filepath_, ios::openmode mode
+):
+    ofstream(
+      is_standard_stream(filepath_) ? standard_output_path : filepath_,
+      is_standard_stream(filepath_) ? mode | ios::app : mode
+    ),
+    filepath(filepath_) {
   if (this->fail()) {
     throw ios::failure(fmt::format(
       "The path {}"
@@ -37,6 +66,81 @@ ThrowingOfstream::ThrowingOfstream(const string &filepath, ios::openmode mode):
   }
 }
 
+ThrowingOfstream::~ThrowingOfstream() {
+  if (gzip_buffer != nullptr) {
+    flush();
+    std::ostream::rdbuf(ofstream::rdbuf());
+  }
+  if (positional_fd >= 0) { ::close(positional_fd); }
+}
+
+auto ThrowingOfstream::supports_positional_writes() -> bool {
+  // standard output may be appending to a file which already has contents, so
+  // the offsets of the stream would not match those of the file
+  if (!positional_checked && !is_standard_stream(filepath)) {
+    positional_checked = true;
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+    positional_fd = ::open(filepath.c_str(), O_WRONLY);
+    struct stat file_stat {};
+    if (positional_fd >= 0
+        && (fstat(positional_fd, &file_stat) != 0
+            || !S_ISREG(file_stat.st_mode))) {
+      ::close(positional_fd);
+      positional_fd = -1;
+    }
+  }
+  return positional_fd >= 0;
+}
+
+auto ThrowingOfstream::get_write_position() -> u64 {
+  flush();
+  return static_cast<u64>(tellp());
+}
+
+auto ThrowingOfstream::write_at(const char *data, u64 size, u64 offset)
+  -> void {
+  while (size > 0) {
+    auto result
+      = pwrite(positional_fd, data, size, static_cast<off_t>(offset));
+    if (result < 0) {
+      if (errno == EINTR) { continue; }
+      throw ios::failure(format(
+        "Could not write to the file {}: {}", filepath, std::strerror(errno)
+      ));
+    }
+    auto written = static_cast<u64>(result);
+    data += written;  // NOLINT (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    size -= written;
+    offset += written;
+  }
+}
+
+auto ThrowingOfstream::set_write_position(u64 offset) -> void {
+  seekp(static_cast<std::streamoff>(offset));
+}
+
+auto ThrowingOfstream::enable_gzip_members() -> void {
+  gzip_buffer = make_unique<GzipMemberOutputBuffer>(ofstream::rdbuf());
+  std::ostream::rdbuf(gzip_buffer.get());
+}
+
+auto ThrowingOfstream::writes_gzip_members() const -> bool {
+  return gzip_buffer != nullptr;
+}
+
+auto ThrowingOfstream::write_raw(const char *data, u64 size) -> void {
+  if (gzip_buffer == nullptr) {
+    write(data, static_cast<std::streamsize>(size));
+    return;
+  }
+  // anything still pending in the gzip buffer must come first
+  flush();
+  const auto amount = static_cast<std::streamsize>(size);
+  if (ofstream::rdbuf()->sputn(data, amount) != amount) {
+    throw ios::failure(format("Could not write to the file {}", filepath));
+  }
+}
+
 auto ThrowingOfstream::check_path_valid(const string &filepath) -> void {
   ThrowingOfstream(filepath, ios::out);
 }
@@ -4,14 +4,21 @@
 /**
  * @file IOUtils.h
  * @brief Contains utilities to ease interacting with IO streams
- *        such as check if a file exists
+ *        such as check if a file exists. The output stream can additionally
+ *        write at given offsets of the file, which lets multiple threads write
+ *        their own part of the output at the same time. Either stream can
+ *        also be switched to read or write gzip, see GzipUtils.h. A
+ *        filename of '-' stands for standard input or standard output.
  */
 
 #include <bit>
 #include <fstream>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "Tools/TypeDefinitions.h"
+
 namespace io_utils {
 
 using std::bit_cast;
@@ -19,13 +26,40 @@ using std::ifstream;
 using std::ios;
 using std::ofstream;
 using std::string;
+using std::unique_ptr;
 using std::vector;
 
+const string standard_stream_filename = "-";
+const string standard_input_path = "/dev/stdin";
+const string standard_output_path = "/dev/stdout";
+
+inline auto is_standard_stream(const string &filename) -> bool {
+  return filename == standard_stream_filename;
+}
+
+class GzipInputBuffer;
+class GzipMemberOutputBuffer;
+
 class ThrowingIfstream: public ifstream {
+private:
+  unique_ptr<GzipInputBuffer> gzip_buffer;
+
 public:
   ThrowingIfstream(const string &filename, ios::openmode mode);
+  ThrowingIfstream(ThrowingIfstream &) = delete;
+  ThrowingIfstream(ThrowingIfstream &&) = delete;
+  auto operator=(ThrowingIfstream &) = delete;
+  auto operator=(ThrowingIfstream &&) = delete;
+  ~ThrowingIfstream() override;
   static void check_file_exists(const string &filename);
 
+  // Everything read from now on is decompressed from the gzip file
+  auto enable_gzip_decompression() -> void;
+  // Hides ifstream::rdbuf, which would always give the raw file buffer
+  [[nodiscard]] auto rdbuf() const -> std::streambuf * {
+    return std::istream::rdbuf();
+  }
+
   auto read_string_with_size() -> string;
   template <class Real>
   auto read_real() -> Real {
@@ -36,10 +70,38 @@ public:
 };
 
 class ThrowingOfstream: public ofstream {
+private:
+  string filepath;
+  int positional_fd = -1;
+  bool positional_checked = false;
+  unique_ptr<GzipMemberOutputBuffer> gzip_buffer;
+
 public:
-  ThrowingOfstream(const string &filepath, ios::openmode mode);
+  ThrowingOfstream(const string &filepath_, ios::openmode mode);
+  ThrowingOfstream(ThrowingOfstream &) = delete;
+  ThrowingOfstream(ThrowingOfstream &&) = delete;
+  auto operator=(ThrowingOfstream &) = delete;
+  auto operator=(ThrowingOfstream &&) = delete;
+  ~ThrowingOfstream() override;
   static void check_path_valid(const string &filepath);
 
+  // Positional writes need a regular file, so they are not possible when
+  // writing to something like a pipe
+  auto supports_positional_writes() -> bool;
+  // Flushes what was written through the stream so far and returns the offset
+  // at which the next byte would go
+  auto get_write_position() -> u64;
+  // Thread safe, as long as the written ranges do not overlap
+  auto write_at(const char *data, u64 size, u64 offset) -> void;
+  auto set_write_position(u64 offset) -> void;
+
+  // Everything written through the stream from now on is compressed, where
+  // each flush ends a gzip member. Data which is already compressed as gzip
+  // members is instead given to write_raw, which writes it unchanged.
+  auto enable_gzip_members() -> void;
+  [[nodiscard]] auto writes_gzip_members() const -> bool;
+  auto write_raw(const char *data, u64 size) -> void;
+
   using ofstream::write;
 
   template <class Real>
@@ -48,4 +48,35 @@ TEST(IOUtilsTest, TestPathValid) {
   }
 }
 
+TEST(IOUtilsTest, PositionalWrites) {
+  const string filename = "test_objects/tmp/positional_writes.txt";
+  std::filesystem::create_directories("test_objects/tmp");
+  {
+    ThrowingOfstream out(filename, ios::out | ios::binary);
+    ASSERT_TRUE(out.supports_positional_writes());
+    out << "ab";
+    const u64 position = out.get_write_position();
+    ASSERT_EQ(position, 2);
+    out.write_at("ef", 2, position + 2);
+    out.write_at("cd", 2, position);
+    out.set_write_position(position + 4);
+    out << "g";
+  }
+  ThrowingIfstream in(filename, ios::in);
+  string content;
+  std::getline(in, content);
+  ASSERT_EQ(content, "abcdefg");
+  std::filesystem::remove(filename);
+}
+
+TEST(IOUtilsTest, StandardOutput) {
+  testing::internal::CaptureStdout();
+  {
+    ThrowingOfstream out(standard_stream_filename, ios::out | ios::binary);
+    ASSERT_FALSE(out.supports_positional_writes());
+    out << "abc";
+  }
+  ASSERT_EQ(testing::internal::GetCapturedStdout(), "abc");
+}
+
 }  // namespace io_utils
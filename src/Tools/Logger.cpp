@@ -7,7 +7,9 @@
 #include <unordered_map>
 
 #include "Tools/Logger.h"
+#include "Tools/PipelineProfiler.h"
 #include "spdlog/cfg/env.h"
+#include "spdlog/sinks/stdout_color_sinks.h"
 #include "spdlog/spdlog.h"
 
 using fmt::format;
@@ -38,6 +40,12 @@ auto Logger::initialise_global_logging(Logger::LOG_LEVEL default_log_level)
   );
 }
 
+auto Logger::log_to_standard_error() -> void {
+  // the new logger takes the pattern and levels which were set globally
+  spdlog::drop("");
+  spdlog::set_default_logger(spdlog::stderr_color_mt(""));
+}
+
 auto Logger::log(LOG_LEVEL level, const string &message) -> void {
   string message_formatted
     = format(R"({{"type": "message", "message": "{}"}})", message);
@@ -50,6 +58,9 @@ auto Logger::log_timed_event(
   const string &message,
   LOG_LEVEL level
 ) -> void {
+  PipelineProfiler::add_timed_event(
+    component, start_stop == EVENT_STATE::START, message
+  );
   string state = start_stop == EVENT_STATE::START ? "start" : "stop";
   string json_message = format(
     R"({{"type": "timed_event", "state": "{}", "component": "{}", "message": "{}"}})",
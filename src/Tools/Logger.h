@@ -23,6 +23,9 @@ public:
   static auto
   initialise_global_logging(LOG_LEVEL default_log_level = LOG_LEVEL::WARN)
     -> void;
+  // Sends the logs to standard error rather than standard output, so that
+  // they do not get mixed with results which are written to standard output
+  static auto log_to_standard_error() -> void;
   static auto log(LOG_LEVEL level, const string &message) -> void;
   static auto log_timed_event(
     const string &component,
@@ -0,0 +1,264 @@
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include "Tools/Logger.h"
+#include "Tools/MathUtils.hpp"
+#include "Tools/MemoryTracker.h"
+#include "Tools/MemoryUtils.h"
+#include "Tools/Metrics.h"
+#include "fmt/core.h"
+
+namespace memory_utils {
+
+using fmt::format;
+using log_utils::Logger;
+using log_utils::Metrics;
+using math_utils::bits_to_gB;
+using std::map;
+using std::mutex;
+using std::unique_lock;
+
+namespace {
+
+const string other_component = "Other";
+const string host_component = "Total";
+const string host_kind_name = "host";
+
+class ComponentMemory {
+public:
+  string name;
+  map<MemoryTracker::MEMORY_KIND, u64> in_use;
+  map<MemoryTracker::MEMORY_KIND, u64> peak;
+  map<MemoryTracker::MEMORY_KIND, u64> estimate;
+
+  explicit ComponentMemory(string name_): name(std::move(name_)) {}
+};
+
+class TrackerState {
+public:
+  mutex state_mutex;
+  // the first component is Other
+  vector<ComponentMemory> components{ComponentMemory(other_component)};
+  map<string, u64> component_ids{{other_component, 0}};
+  map<MemoryTracker::MEMORY_KIND, u64> total_in_use;
+  bool measuring_host = false;
+  u64 host_baseline = 0;
+  u64 host_estimate = 0;
+};
+
+auto get_state() -> TrackerState & {
+  static TrackerState state;
+  return state;
+}
+
+thread_local string thread_component;
+
+auto get_kind_name(MemoryTracker::MEMORY_KIND kind) -> string {
+  return kind == MemoryTracker::MEMORY_KIND::PINNED ? "pinned" : "gpu";
+}
+
+// Must be called with the state locked
+auto get_component_id(TrackerState &state, const string &component) -> u64 {
+  const string &name = component.empty() ? other_component : component;
+  auto [iterator, inserted]
+    = state.component_ids.try_emplace(name, state.components.size());
+  if (inserted) { state.components.emplace_back(name); }
+  return iterator->second;
+}
+
+auto set_metrics(
+  const string &component, MemoryTracker::MEMORY_KIND kind, u64 in_use, u64 peak
+) -> void {
+  Metrics::set(
+    component,
+    format("{}_memory_bytes", get_kind_name(kind)),
+    static_cast<double>(in_use)
+  );
+  Metrics::set(
+    component,
+    format("{}_memory_peak_bytes", get_kind_name(kind)),
+    static_cast<double>(peak)
+  );
+}
+
+auto to_gB(u64 bytes) -> double { return bits_to_gB(bytes * bits_in_byte); }
+
+auto get_host_peak(const TrackerState &state) -> u64 {
+  const u64 peak = get_peak_resident_memory();
+  return peak > state.host_baseline ? peak - state.host_baseline : 0;
+}
+
+auto is_mismatch(u64 peak, u64 estimate, double margin) -> bool {
+  const auto difference = std::abs(
+    static_cast<double>(peak) - static_cast<double>(estimate)
+  );
+  return difference > margin * static_cast<double>(estimate);
+}
+
+auto get_line(
+  const string &component, const string &kind, u64 peak, u64 estimate
+) -> string {
+  return format(
+    "{} used at most {:.3f}GB of {} memory, against an estimate of {:.3f}GB",
+    component,
+    to_gB(peak),
+    kind,
+    to_gB(estimate)
+  );
+}
+
+}  // namespace
+
+auto MemoryTracker::set_thread_component(const string &component) -> void {
+  thread_component = component;
+}
+
+auto MemoryTracker::add(MEMORY_KIND kind, u64 bytes) -> u64 {
+  auto &state = get_state();
+  u64 id = 0;
+  string name;
+  u64 in_use = 0;
+  u64 peak = 0;
+  {
+    const unique_lock lock(state.state_mutex);
+    id = get_component_id(state, thread_component);
+    auto &component = state.components[id];
+    component.in_use[kind] += bytes;
+    component.peak[kind]
+      = std::max(component.peak[kind], component.in_use[kind]);
+    state.total_in_use[kind] += bytes;
+    name = component.name;
+    in_use = component.in_use[kind];
+    peak = component.peak[kind];
+  }
+  // the metrics are set outside the lock, since writing the metrics reads
+  // from this class too
+  set_metrics(name, kind, in_use, peak);
+  return id;
+}
+
+auto MemoryTracker::remove(u64 component_id, MEMORY_KIND kind, u64 bytes)
+  -> void {
+  auto &state = get_state();
+  string name;
+  u64 in_use = 0;
+  u64 peak = 0;
+  {
+    const unique_lock lock(state.state_mutex);
+    auto &component = state.components[component_id];
+    component.in_use[kind] -= std::min(component.in_use[kind], bytes);
+    state.total_in_use[kind] -= std::min(state.total_in_use[kind], bytes);
+    name = component.name;
+    in_use = component.in_use[kind];
+    peak = component.peak[kind];
+  }
+  set_metrics(name, kind, in_use, peak);
+}
+
+auto MemoryTracker::get_in_use(MEMORY_KIND kind) -> u64 {
+  auto &state = get_state();
+  const unique_lock lock(state.state_mutex);
+  return state.total_in_use[kind];
+}
+
+auto MemoryTracker::get_peak(const string &component, MEMORY_KIND kind)
+  -> u64 {
+  auto &state = get_state();
+  const unique_lock lock(state.state_mutex);
+  return state.components[get_component_id(state, component)].peak[kind];
+}
+
+auto MemoryTracker::set_estimate(
+  const string &component, MEMORY_KIND kind, u64 bytes
+) -> void {
+  auto &state = get_state();
+  const unique_lock lock(state.state_mutex);
+  state.components[get_component_id(state, component)].estimate[kind] = bytes;
+}
+
+auto MemoryTracker::start_host_measurement(u64 estimated_bytes) -> void {
+  auto &state = get_state();
+  const unique_lock lock(state.state_mutex);
+  state.measuring_host = reset_peak_resident_memory();
+  if (!state.measuring_host) {
+    Logger::log(
+      Logger::LOG_LEVEL::DEBUG,
+      "The peak resident memory can not be measured on this system"
+    );
+  }
+  state.host_baseline = get_resident_memory();
+  state.host_estimate = estimated_bytes;
+}
+
+auto MemoryTracker::get_report() -> vector<string> {
+  auto &state = get_state();
+  const unique_lock lock(state.state_mutex);
+  vector<string> lines;
+  if (state.measuring_host) {
+    lines.push_back(get_line(
+      host_component, host_kind_name, get_host_peak(state), state.host_estimate
+    ));
+  }
+  for (const auto &component : state.components) {
+    for (const auto kind : {MEMORY_KIND::PINNED, MEMORY_KIND::GPU}) {
+      const bool has_peak = component.peak.contains(kind);
+      const bool has_estimate = component.estimate.contains(kind);
+      if (!has_peak && !has_estimate) { continue; }
+      lines.push_back(get_line(
+        component.name,
+        get_kind_name(kind),
+        has_peak ? component.peak.at(kind) : 0,
+        has_estimate ? component.estimate.at(kind) : 0
+      ));
+    }
+  }
+  return lines;
+}
+
+auto MemoryTracker::get_mismatches(double margin) -> vector<string> {
+  auto &state = get_state();
+  const unique_lock lock(state.state_mutex);
+  vector<string> mismatches;
+  if (state.measuring_host) {
+    const u64 peak = get_host_peak(state);
+    if (is_mismatch(peak, state.host_estimate, margin)) {
+      mismatches.push_back(
+        get_line(host_component, host_kind_name, peak, state.host_estimate)
+      );
+    }
+  }
+  // components without an estimate, such as Other, are not checked
+  for (auto &component : state.components) {
+    for (const auto &[kind, estimate] : component.estimate) {
+      const u64 peak = component.peak[kind];
+      if (is_mismatch(peak, estimate, margin)) {
+        mismatches.push_back(
+          get_line(component.name, get_kind_name(kind), peak, estimate)
+        );
+      }
+    }
+  }
+  return mismatches;
+}
+
+auto MemoryTracker::log_report(double margin) -> void {
+  for (const auto &line : get_report()) {
+    Logger::log(Logger::LOG_LEVEL::INFO, line);
+  }
+  for (const auto &mismatch : get_mismatches(margin)) {
+    Logger::log(
+      Logger::LOG_LEVEL::WARN,
+      format(
+        "{}, which is off by more than {:.0f}%, so the memory formulas of "
+        "this component may need updating",
+        mismatch,
+        margin * 100
+      )
+    );
+  }
+}
+
+}  // namespace memory_utils
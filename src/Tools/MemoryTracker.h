@@ -0,0 +1,58 @@
+#ifndef MEMORY_TRACKER_H
+#define MEMORY_TRACKER_H
+
+/**
+ * @file MemoryTracker.h
+ * @brief Keeps count of the pinned and gpu memory taken by each component, so
+ * that the peaks can be checked against what the planner expected when it
+ * worked out the size of the batches. PinnedVector and GpuPointer add
+ * themselves to the component which the thread creating them was set to, such
+ * as Searcher_0, and take themselves out when they are freed. Host memory in
+ * plain vectors is not counted per component, so instead the peak resident
+ * memory of the process from the time the batches are about to be allocated
+ * is compared against the total which the planner expected. The current and
+ * peak memory of each component also go to the metrics file if it is enabled.
+ */
+
+#include <string>
+#include <vector>
+
+#include "Tools/TypeDefinitions.h"
+
+namespace memory_utils {
+
+using std::string;
+using std::vector;
+
+class MemoryTracker {
+private:
+  MemoryTracker() = default;
+
+public:
+  enum class MEMORY_KIND { PINNED, GPU };
+
+  // Memory which is allocated by this thread from now on is counted towards
+  // this component. An empty component is counted as Other.
+  static auto set_thread_component(const string &component) -> void;
+  // Returns the id which is to be given back when the memory is freed
+  static auto add(MEMORY_KIND kind, u64 bytes) -> u64;
+  static auto remove(u64 component_id, MEMORY_KIND kind, u64 bytes) -> void;
+  [[nodiscard]] static auto get_in_use(MEMORY_KIND kind) -> u64;
+  [[nodiscard]] static auto
+  get_peak(const string &component, MEMORY_KIND kind) -> u64;
+  static auto
+  set_estimate(const string &component, MEMORY_KIND kind, u64 bytes) -> void;
+  // The host memory is measured from here on, against this estimate
+  static auto start_host_measurement(u64 estimated_bytes) -> void;
+  // One line for each component with an estimate or a peak
+  [[nodiscard]] static auto get_report() -> vector<string>;
+  // The peaks which are further than the margin from their estimate, where
+  // 0.2 means 20% more or less than the estimate
+  [[nodiscard]] static auto get_mismatches(double margin) -> vector<string>;
+  // Logs the report, and warns about each mismatch
+  static auto log_report(double margin) -> void;
+};
+
+}  // namespace memory_utils
+
+#endif
@@ -0,0 +1,73 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Tools/MemoryTracker.h"
+
+namespace memory_utils {
+
+using std::string;
+using std::vector;
+
+namespace {
+
+const auto pinned = MemoryTracker::MEMORY_KIND::PINNED;
+const auto gpu = MemoryTracker::MEMORY_KIND::GPU;
+
+auto count_containing(const vector<string> &lines, const string &text) -> u64 {
+  u64 count = 0;
+  for (const auto &line : lines) {
+    if (line.find(text) != string::npos) { ++count; }
+  }
+  return count;
+}
+
+}  // namespace
+
+TEST(MemoryTrackerTest, KeepsPeaksOfEachComponent) {
+  const u64 pinned_before = MemoryTracker::get_in_use(pinned);
+  MemoryTracker::set_thread_component("TrackedParser_0");
+  const u64 first = MemoryTracker::add(pinned, 100);
+  const u64 second = MemoryTracker::add(pinned, 50);
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(MemoryTracker::get_in_use(pinned), pinned_before + 150);
+  MemoryTracker::remove(second, pinned, 50);
+  MemoryTracker::add(pinned, 20);
+  MemoryTracker::set_thread_component("TrackedSearcher_0");
+  const u64 searcher = MemoryTracker::add(gpu, 30);
+  EXPECT_NE(first, searcher);
+  MemoryTracker::set_thread_component("");
+  EXPECT_EQ(MemoryTracker::get_peak("TrackedParser_0", pinned), 150);
+  EXPECT_EQ(MemoryTracker::get_peak("TrackedParser_0", gpu), 0);
+  EXPECT_EQ(MemoryTracker::get_peak("TrackedSearcher_0", gpu), 30);
+  MemoryTracker::remove(first, pinned, 120);
+  MemoryTracker::remove(searcher, gpu, 30);
+  EXPECT_EQ(MemoryTracker::get_in_use(pinned), pinned_before);
+  // the peak stays after the memory is freed
+  EXPECT_EQ(MemoryTracker::get_peak("TrackedParser_0", pinned), 150);
+}
+
+TEST(MemoryTrackerTest, FindsMismatches) {
+  MemoryTracker::set_thread_component("EstimatedPrinter_0");
+  const u64 id = MemoryTracker::add(pinned, 1000);
+  MemoryTracker::add(gpu, 1000);
+  MemoryTracker::set_thread_component("");
+  MemoryTracker::set_estimate("EstimatedPrinter_0", pinned, 1100);
+  MemoryTracker::set_estimate("EstimatedPrinter_0", gpu, 2000);
+  MemoryTracker::remove(id, pinned, 1000);
+  MemoryTracker::remove(id, gpu, 1000);
+  const auto mismatches = MemoryTracker::get_mismatches(0.2);
+  EXPECT_EQ(count_containing(mismatches, "EstimatedPrinter_0"), 1);
+  EXPECT_EQ(count_containing(mismatches, "EstimatedPrinter_0 used at most"), 1);
+  EXPECT_EQ(count_containing(mismatches, "of gpu memory"), 1);
+  // with a wide enough margin both estimates are close enough
+  EXPECT_EQ(
+    count_containing(MemoryTracker::get_mismatches(1), "EstimatedPrinter_0"), 0
+  );
+  EXPECT_EQ(
+    count_containing(MemoryTracker::get_report(), "EstimatedPrinter_0"), 2
+  );
+}
+
+}  // namespace memory_utils
@@ -1,10 +1,16 @@
 // Function credits:
 // https://stackoverflow.com/questions/2513505/how-to-get-available-memory-c-g
 
+#include <fstream>
+#include <string>
+
+#include "Tools/MemoryUtils.h"
 #include "Tools/TypeDefinitions.h"
 
 namespace memory_utils {
 
+using std::string;
+
 #ifdef __linux__
 
 #include <unistd.h>
@@ -14,6 +20,36 @@ auto get_total_system_memory() -> u64 {
   return pages * page_size;
 }
 
+namespace {
+
+const u64 bytes_in_kB = 1024;
+
+// Reads a line such as 'VmRSS:     1234 kB' from /proc/self/status
+auto get_status_kB(const string &field) -> u64 {
+  std::ifstream status("/proc/self/status");
+  string line;
+  while (std::getline(status, line)) {
+    if (line.starts_with(field + ":")) {
+      return std::stoull(line.substr(field.size() + 1)) * bytes_in_kB;
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+
+auto get_resident_memory() -> u64 { return get_status_kB("VmRSS"); }
+
+auto get_peak_resident_memory() -> u64 { return get_status_kB("VmHWM"); }
+
+auto reset_peak_resident_memory() -> bool {
+  // writing 5 to clear_refs resets the peak, see 'man 5 proc'
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  clear_refs << "5";
+  clear_refs.close();
+  return !clear_refs.fail();
+}
+
 #elif _WIN32
 
 #include <windows.h>
@@ -24,6 +60,10 @@ unsigned long long get_total_system_memory() {
   return status.ullTotalPhys;
 }
 
+auto get_resident_memory() -> u64 { return 0; }
+auto get_peak_resident_memory() -> u64 { return 0; }
+auto reset_peak_resident_memory() -> bool { return false; }
+
 #endif
 
 }  // namespace memory_utils
@@ -14,6 +14,13 @@
 namespace memory_utils {
 
 auto get_total_system_memory() -> u64;
+// The resident memory of this process and the most it has reached, in bytes.
+// These are 0 where they can not be read.
+auto get_resident_memory() -> u64;
+auto get_peak_resident_memory() -> u64;
+// Starts the peak resident memory over from the current resident memory, and
+// returns false if this is not supported
+auto reset_peak_resident_memory() -> bool;
 
 }  // namespace memory_utils
 
@@ -0,0 +1,219 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <ios>
+#include <map>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Tools/IOUtils.h"
+#include "Tools/Logger.h"
+#include "Tools/Metrics.h"
+#include "fmt/core.h"
+
+namespace log_utils {
+
+using fmt::format;
+using io_utils::ThrowingOfstream;
+using std::atomic;
+using std::condition_variable;
+using std::ios;
+using std::map;
+using std::mutex;
+using std::pair;
+using std::thread;
+using std::unique_lock;
+using std::vector;
+using std::chrono::duration;
+using std::chrono::steady_clock;
+
+namespace {
+
+const string metric_prefix = "sbwt_search_";
+const string counter_suffix = "_total";
+
+class MetricsState {
+public:
+  atomic<bool> enabled = false;
+  mutex values_mutex;
+  // keyed by name and then component, so that each name is written together
+  map<pair<string, string>, double> counters;
+  map<pair<string, string>, double> gauges;
+  map<pair<string, string>, double> previous_counters;
+  vector<pair<string, function<double()>>> gauge_readers;
+  steady_clock::time_point start_time;
+  steady_clock::time_point previous_time;
+  string filename;
+  u64 interval_seconds = 0;
+  mutex writer_mutex;
+  condition_variable writer_wakeup;
+  bool stopping = false;
+  thread writer;
+};
+
+auto get_state() -> MetricsState & {
+  static MetricsState state;
+  return state;
+}
+
+// Components such as Searcher_0 are split into the stage and the stream
+auto get_labels(const string &component) -> string {
+  const auto underscore = component.rfind('_');
+  if (underscore != string::npos && underscore + 1 < component.size()
+      && component.find_first_not_of("0123456789", underscore + 1)
+        == string::npos) {
+    return format(
+      R"({{stage="{}",stream="{}"}})",
+      component.substr(0, underscore),
+      component.substr(underscore + 1)
+    );
+  }
+  if (component.empty()) { return ""; }
+  return format(R"({{stage="{}"}})", component);
+}
+
+auto write_values(
+  string &text,
+  const map<pair<string, string>, double> &values,
+  const string &type
+) -> void {
+  string previous_name;
+  for (const auto &[key, value] : values) {
+    const auto &[name, component] = key;
+    if (name != previous_name) {
+      text += format("# TYPE {}{} {}\n", metric_prefix, name, type);
+      previous_name = name;
+    }
+    text += format(
+      "{}{}{} {}\n", metric_prefix, name, get_labels(component), value
+    );
+  }
+}
+
+// The per second gauges are over the time since the file was last written,
+// so they show what the job is doing now rather than on average
+auto get_rates(MetricsState &state, double seconds)
+  -> map<pair<string, string>, double> {
+  map<pair<string, string>, double> rates;
+  for (const auto &[key, value] : state.counters) {
+    const auto &[name, component] = key;
+    string rate_name = name;
+    if (rate_name.ends_with(counter_suffix)) {
+      rate_name.resize(rate_name.size() - counter_suffix.size());
+    }
+    const double previous = state.previous_counters[key];
+    rates[{rate_name + "_per_second", component}]
+      = seconds > 0 ? (value - previous) / seconds : 0;
+  }
+  return rates;
+}
+
+auto write_file(const string &text) -> void {
+  auto &state = get_state();
+  const string temporary_filename = state.filename + ".tmp";
+  try {
+    {
+      ThrowingOfstream out_stream(temporary_filename, ios::out);
+      out_stream << text;
+    }
+    std::filesystem::rename(temporary_filename, state.filename);
+  } catch (std::exception &e) {
+    Logger::log(
+      Logger::LOG_LEVEL::WARN,
+      format("Could not write the metrics to {}", state.filename)
+    );
+  }
+}
+
+auto writer_loop() -> void {
+  auto &state = get_state();
+  unique_lock lock(state.writer_mutex);
+  while (!state.stopping) {
+    state.writer_wakeup.wait_for(
+      lock,
+      std::chrono::seconds(state.interval_seconds),
+      [&] { return state.stopping; }
+    );
+    if (!state.stopping) { write_file(Metrics::get_text()); }
+  }
+  // the last write happens here, even if stop was called before the loop
+  // started, so that the file always holds the final values
+  write_file(Metrics::get_text());
+}
+
+}  // namespace
+
+auto Metrics::start(const string &filename, u64 interval_seconds) -> void {
+  auto &state = get_state();
+  state.filename = filename;
+  state.interval_seconds = interval_seconds;
+  state.start_time = steady_clock::now();
+  state.previous_time = state.start_time;
+  state.stopping = false;
+  state.enabled = true;
+  state.writer = thread(writer_loop);
+}
+
+auto Metrics::stop() -> void {
+  auto &state = get_state();
+  if (!state.writer.joinable()) { return; }
+  {
+    const unique_lock lock(state.writer_mutex);
+    state.stopping = true;
+  }
+  state.writer_wakeup.notify_all();
+  state.writer.join();
+  state.enabled = false;
+}
+
+auto Metrics::is_enabled() -> bool { return get_state().enabled; }
+
+auto Metrics::add(const string &component, const string &name, double amount)
+  -> void {
+  auto &state = get_state();
+  if (!state.enabled) { return; }
+  const unique_lock lock(state.values_mutex);
+  state.counters[{name, component}] += amount;
+}
+
+auto Metrics::set(const string &component, const string &name, double value)
+  -> void {
+  auto &state = get_state();
+  if (!state.enabled) { return; }
+  const unique_lock lock(state.values_mutex);
+  state.gauges[{name, component}] = value;
+}
+
+auto Metrics::add_gauge_reader(const string &name, function<double()> reader)
+  -> void {
+  auto &state = get_state();
+  const unique_lock lock(state.values_mutex);
+  state.gauge_readers.emplace_back(name, std::move(reader));
+}
+
+auto Metrics::get_text() -> string {
+  auto &state = get_state();
+  const unique_lock lock(state.values_mutex);
+  const auto now = steady_clock::now();
+  auto gauges = state.gauges;
+  for (const auto &[name, reader] : state.gauge_readers) {
+    gauges[{name, ""}] = reader();
+  }
+  gauges[{"uptime_seconds", ""}]
+    = duration<double>(now - state.start_time).count();
+  const auto rates
+    = get_rates(state, duration<double>(now - state.previous_time).count());
+  gauges.insert(rates.begin(), rates.end());
+  state.previous_counters = state.counters;
+  state.previous_time = now;
+  string text;
+  write_values(text, state.counters, "counter");
+  write_values(text, gauges, "gauge");
+  return text;
+}
+
+}  // namespace log_utils
@@ -0,0 +1,54 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+/**
+ * @file Metrics.h
+ * @brief A cheap, always available view into a running job. Components add to
+ * counters and set gauges under their name, which is the same one they use for
+ * their timed events, such as Searcher_0. While metrics are enabled, a
+ * background thread rewrites a file in the Prometheus text format every
+ * interval, so that it can be picked up by the textfile collector of the node
+ * exporter or simply looked at. The component names are split into a stage
+ * and a stream label, and every counter also gets a per second gauge over the
+ * last interval. The file is written to a temporary file first and then
+ * renamed, so that it is never read halfway through being written. When
+ * metrics are not enabled, adding to them returns straight away.
+ */
+
+#include <functional>
+#include <string>
+
+#include "Tools/TypeDefinitions.h"
+
+namespace log_utils {
+
+using std::function;
+using std::string;
+
+class Metrics {
+private:
+  Metrics() = default;
+
+public:
+  // Starts rewriting the file every interval until stop is called
+  static auto start(const string &filename, u64 interval_seconds) -> void;
+  // Writes the file one last time and stops the background thread
+  static auto stop() -> void;
+  [[nodiscard]] static auto is_enabled() -> bool;
+  // Counters are expected to be named with a _total suffix
+  static auto add(const string &component, const string &name, double amount)
+    -> void;
+  static auto set(const string &component, const string &name, double value)
+    -> void;
+  // Gauges which do not belong to any component, such as the memory in use,
+  // and are read each time the file is written
+  static auto add_gauge_reader(const string &name, function<double()> reader)
+    -> void;
+  // Gets the contents of the file as it would be written now, after which the
+  // per second gauges start over
+  static auto get_text() -> string;
+};
+
+}  // namespace log_utils
+
+#endif
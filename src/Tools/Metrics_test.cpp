@@ -0,0 +1,78 @@
+#include <filesystem>
+#include <ios>
+#include <iterator>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Tools/IOUtils.h"
+#include "Tools/Metrics.h"
+
+namespace log_utils {
+
+using io_utils::ThrowingIfstream;
+using std::ios;
+using std::string;
+
+namespace {
+
+const string metrics_filename = "test_objects/tmp/MetricsTest.prom";
+
+auto contains(const string &text, const string &line) -> bool {
+  return text.find(line + "\n") != string::npos;
+}
+
+}  // namespace
+
+TEST(MetricsTest, NothingIsRecordedWhenDisabled) {
+  Metrics::add("Disabled_0", "disabled_total", 1);
+  Metrics::set("Disabled_0", "disabled_gauge", 1);
+  EXPECT_FALSE(Metrics::is_enabled());
+  EXPECT_EQ(Metrics::get_text().find("disabled"), string::npos);
+}
+
+TEST(MetricsTest, WritesCountersGaugesAndRates) {
+  std::filesystem::create_directories("test_objects/tmp");
+  Metrics::add_gauge_reader("test_reader_bytes", [] { return 42.0; });
+  Metrics::start(metrics_filename, 60);
+  EXPECT_TRUE(Metrics::is_enabled());
+  Metrics::add("Stage_3", "test_items_total", 5);
+  Metrics::add("Stage_3", "test_items_total", 2);
+  Metrics::add("Stage_12", "test_items_total", 1);
+  Metrics::set("Other", "test_depth", 4);
+  auto text = Metrics::get_text();
+  EXPECT_TRUE(contains(text, "# TYPE sbwt_search_test_items_total counter"));
+  EXPECT_TRUE(contains(
+    text, R"(sbwt_search_test_items_total{stage="Stage",stream="3"} 7)"
+  ));
+  EXPECT_TRUE(contains(
+    text, R"(sbwt_search_test_items_total{stage="Stage",stream="12"} 1)"
+  ));
+  EXPECT_TRUE(contains(text, "# TYPE sbwt_search_test_depth gauge"));
+  EXPECT_TRUE(contains(text, R"(sbwt_search_test_depth{stage="Other"} 4)"));
+  EXPECT_TRUE(contains(text, "sbwt_search_test_reader_bytes 42"));
+  EXPECT_NE(
+    text.find(R"(sbwt_search_test_items_per_second{stage="Stage",stream="3"})"),
+    string::npos
+  );
+  EXPECT_NE(text.find("sbwt_search_uptime_seconds "), string::npos);
+  // the per second gauges only count what was added since the last time
+  text = Metrics::get_text();
+  EXPECT_TRUE(contains(
+    text, R"(sbwt_search_test_items_per_second{stage="Stage",stream="3"} 0)"
+  ));
+  Metrics::stop();
+  EXPECT_FALSE(Metrics::is_enabled());
+  ThrowingIfstream in_stream(metrics_filename, ios::in);
+  const string contents(
+    (std::istreambuf_iterator<char>(in_stream)),
+    std::istreambuf_iterator<char>()
+  );
+  EXPECT_TRUE(contains(
+    contents, R"(sbwt_search_test_items_total{stage="Stage",stream="3"} 7)"
+  ));
+  EXPECT_FALSE(std::filesystem::exists(metrics_filename + ".tmp"));
+  std::filesystem::remove(metrics_filename);
+}
+
+}  // namespace log_utils
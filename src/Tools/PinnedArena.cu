@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <sys/mman.h>
+
+#include "Tools/GpuUtils.h"
+#include "Tools/MathUtils.hpp"
+#include "Tools/PinnedArena.h"
+#include "hip/hip_runtime.h"
+
+namespace gpu_utils {
+
+using math_utils::round_up;
+using std::lock_guard;
+using std::runtime_error;
+
+namespace {
+
+const u64 huge_page_bytes = 2ULL * 1024 * 1024;
+// Keeps every sub-allocation aligned well beyond what the gpu needs for copies
+const u64 allocation_alignment = 256;
+
+}  // namespace
+
+PinnedArena::~PinnedArena() {
+  // if something still points into the arena, it is safer to leak it
+  if (live_allocations > 0) { return; }
+  try {
+    unmap();
+  } catch (runtime_error &e) { std::cerr << e.what() << std::endl; }
+}
+
+auto PinnedArena::get_global() -> PinnedArena & {
+  static PinnedArena arena;
+  return arena;
+}
+
+auto PinnedArena::reserve(u64 bytes) -> void {
+  lock_guard<mutex> lock(arena_mutex);
+  if (live_allocations > 0) {
+    throw runtime_error(
+      "The pinned memory arena can not be reserved while it is in use"
+    );
+  }
+  used = 0;
+  high_water_mark = 0;
+  fallback_allocations = 0;
+  if (capacity >= bytes) { return; }
+  unmap();
+  const u64 rounded_bytes = round_up<u64>(bytes, huge_page_bytes);
+  void *result = mmap(
+    nullptr,
+    rounded_bytes,
+    PROT_READ | PROT_WRITE,
+    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+    -1,
+    0
+  );
+  huge_pages = result != MAP_FAILED;
+  if (!huge_pages) {
+    // no explicit huge pages are set aside, so ask for transparent ones
+    result = mmap(
+      nullptr,
+      rounded_bytes,
+      PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS,
+      -1,
+      0
+    );
+    if (result == MAP_FAILED) {
+      throw runtime_error("Could not map the pinned memory arena");
+    }
+    madvise(result, rounded_bytes, MADV_HUGEPAGE);
+  }
+  memory = static_cast<char *>(result);
+  capacity = rounded_bytes;
+  GPU_CHECK(hipHostRegister(memory, capacity, hipHostRegisterDefault));
+}
+
+auto PinnedArena::release() -> void {
+  lock_guard<mutex> lock(arena_mutex);
+  if (live_allocations > 0) {
+    throw runtime_error(
+      "The pinned memory arena can not be released while it is in use"
+    );
+  }
+  unmap();
+}
+
+auto PinnedArena::unmap() -> void {
+  if (memory == nullptr) { return; }
+  GPU_CHECK(hipHostUnregister(memory));
+  munmap(memory, capacity);
+  memory = nullptr;
+  capacity = 0;
+  used = 0;
+}
+
+auto PinnedArena::allocate(u64 bytes) -> void * {
+  lock_guard<mutex> lock(arena_mutex);
+  if (memory == nullptr || bytes == 0) { return nullptr; }
+  const u64 start = round_up<u64>(used, allocation_alignment);
+  if (start + bytes > capacity) {
+    ++fallback_allocations;
+    return nullptr;
+  }
+  used = start + bytes;
+  high_water_mark = std::max(high_water_mark, used);
+  ++live_allocations;
+  // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  return memory + start;
+}
+
+auto PinnedArena::deallocate(void *ptr) -> bool {
+  lock_guard<mutex> lock(arena_mutex);
+  auto *bytes = static_cast<char *>(ptr);
+  // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  if (memory == nullptr || bytes < memory || bytes >= memory + capacity) {
+    return false;
+  }
+  // the memory is only handed back in bulk, once the arena is empty
+  if (--live_allocations == 0) { used = 0; }
+  return true;
+}
+
+auto PinnedArena::get_capacity() -> u64 {
+  lock_guard<mutex> lock(arena_mutex);
+  return capacity;
+}
+
+auto PinnedArena::get_high_water_mark() -> u64 {
+  lock_guard<mutex> lock(arena_mutex);
+  return high_water_mark;
+}
+
+auto PinnedArena::get_fallback_allocations() -> u64 {
+  lock_guard<mutex> lock(arena_mutex);
+  return fallback_allocations;
+}
+
+auto PinnedArena::uses_huge_pages() -> bool {
+  lock_guard<mutex> lock(arena_mutex);
+  return huge_pages;
+}
+
+}  // namespace gpu_utils
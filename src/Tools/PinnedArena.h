@@ -0,0 +1,69 @@
+#ifndef PINNED_ARENA_H
+#define PINNED_ARENA_H
+
+/**
+ * @file PinnedArena.h
+ * @brief A single large block of pinned host memory which is carved into
+ * sub-allocations, so that the many large PinnedVectors of a run cost a single
+ * mapping and registration rather than one hipHostMalloc each. The block is
+ * backed by huge pages where the system allows it, which saves TLB misses
+ * when going through the batches. Sub-allocations are never freed on their
+ * own, instead the whole arena is rewound once nothing lives in it any more,
+ * so that a later run in the same process can reuse the registration. Until
+ * the arena is reserved, or once it is full, allocations return null and the
+ * caller falls back to allocating its own pinned memory.
+ */
+
+#include <mutex>
+
+#include "Tools/TypeDefinitions.h"
+
+namespace gpu_utils {
+
+using std::mutex;
+
+class PinnedArena {
+private:
+  char *memory = nullptr;
+  u64 capacity = 0;
+  u64 used = 0;
+  u64 high_water_mark = 0;
+  u64 live_allocations = 0;
+  u64 fallback_allocations = 0;
+  bool huge_pages = false;
+  mutex arena_mutex;
+
+public:
+  PinnedArena() = default;
+  PinnedArena(PinnedArena &) = delete;
+  PinnedArena(PinnedArena &&) = delete;
+  auto operator=(PinnedArena &) = delete;
+  auto operator=(PinnedArena &&) = delete;
+  ~PinnedArena();
+
+  static auto get_global() -> PinnedArena &;
+
+  // Makes sure that at least the given number of bytes are reserved. If the
+  // current reservation is large enough it is rewound and reused, otherwise
+  // it is replaced by a new one. Nothing may live in the arena at this point.
+  auto reserve(u64 bytes) -> void;
+  // Frees the reservation. Nothing may live in the arena at this point.
+  auto release() -> void;
+  auto allocate(u64 bytes) -> void *;
+  // Returns false if the memory does not belong to the arena
+  auto deallocate(void *ptr) -> bool;
+
+  [[nodiscard]] auto get_capacity() -> u64;
+  [[nodiscard]] auto get_high_water_mark() -> u64;
+  [[nodiscard]] auto get_fallback_allocations() -> u64;
+  // Whether the memory is backed by explicit huge pages, as opposed to
+  // transparent huge pages which the kernel may or may not have given us
+  [[nodiscard]] auto uses_huge_pages() -> bool;
+
+private:
+  auto unmap() -> void;
+};
+
+}  // namespace gpu_utils
+
+#endif
@@ -0,0 +1,71 @@
+#include <memory>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+
+#include "Tools/PinnedArena.h"
+#include "Tools/PinnedVector.h"
+
+namespace gpu_utils {
+
+using std::make_unique;
+using std::runtime_error;
+
+const u64 arena_bytes = 1024;
+
+TEST(PinnedArenaTest, AllocatesUntilFull) {
+  PinnedArena arena;
+  ASSERT_EQ(arena.allocate(arena_bytes), nullptr);
+  arena.reserve(arena_bytes);
+  ASSERT_GE(arena.get_capacity(), arena_bytes);
+  auto *first = static_cast<char *>(arena.allocate(arena_bytes / 2));
+  auto *second = static_cast<char *>(arena.allocate(arena_bytes / 2));
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+  ASSERT_GE(second - first, arena_bytes / 2);
+  ASSERT_EQ(arena.get_high_water_mark(), second - first + arena_bytes / 2);
+  ASSERT_EQ(arena.allocate(arena.get_capacity()), nullptr);
+  ASSERT_EQ(arena.get_fallback_allocations(), 1);
+  int outside = 0;
+  ASSERT_FALSE(arena.deallocate(&outside));
+  ASSERT_TRUE(arena.deallocate(first));
+  ASSERT_THROW(arena.reserve(arena_bytes), runtime_error);
+  ASSERT_TRUE(arena.deallocate(second));
+  // once empty, the arena starts again from the beginning
+  ASSERT_EQ(arena.allocate(arena_bytes), first);
+  ASSERT_TRUE(arena.deallocate(first));
+  arena.release();
+  ASSERT_EQ(arena.get_capacity(), 0);
+}
+
+TEST(PinnedArenaTest, ReserveReusesLargeEnoughArena) {
+  PinnedArena arena;
+  arena.reserve(arena_bytes);
+  const u64 capacity = arena.get_capacity();
+  auto *memory = arena.allocate(1);
+  ASSERT_TRUE(arena.deallocate(memory));
+  arena.reserve(arena_bytes / 2);
+  ASSERT_EQ(arena.get_capacity(), capacity);
+  ASSERT_EQ(arena.get_high_water_mark(), 0);
+  ASSERT_EQ(arena.allocate(1), memory);
+  ASSERT_TRUE(arena.deallocate(memory));
+}
+
+TEST(PinnedArenaTest, PinnedVectorsUseGlobalArena) {
+  auto &arena = PinnedArena::get_global();
+  arena.reserve(arena_bytes);
+  auto small = make_unique<PinnedVector<u64>>(arena_bytes / sizeof(u64) / 2);
+  // too large for what is left, so this is allocated on its own
+  auto large = make_unique<PinnedVector<u64>>(arena.get_capacity());
+  ASSERT_EQ(arena.get_fallback_allocations(), 1);
+  for (u64 i = 0; i < arena_bytes / sizeof(u64) / 2; ++i) {
+    small->push_back(i);
+  }
+  ASSERT_EQ(small->back(), arena_bytes / sizeof(u64) / 2 - 1);
+  ASSERT_THROW(arena.release(), runtime_error);
+  small.reset();
+  large.reset();
+  arena.release();
+}
+
+}  // namespace gpu_utils
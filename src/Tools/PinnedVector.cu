@@ -1,13 +1,21 @@
 #include <iostream>
 
 #include "Tools/GpuUtils.h"
+#include "Tools/MemoryTracker.h"
+#include "Tools/PinnedArena.h"
 #include "Tools/PinnedVector.h"
 #include "hip/hip_runtime.h"
 
 namespace gpu_utils {
 
+using memory_utils::MemoryTracker;
+
 template <class T>
-PinnedVector<T>::PinnedVector(u64 size): bytes(size * sizeof(T)) {
+PinnedVector<T>::PinnedVector(u64 size):
+    bytes(size * sizeof(T)),
+    tracker_id(MemoryTracker::add(MemoryTracker::MEMORY_KIND::PINNED, bytes)) {
+  ptr = static_cast<T *>(PinnedArena::get_global().allocate(bytes));
+  if (ptr != nullptr) { return; }
   // NOLINTNEXTLIE (google-readability-casting)
   GPU_CHECK(hipHostMalloc((void **)(&ptr), size * sizeof(T)));
 }
@@ -57,6 +65,8 @@ auto PinnedVector<T>::back() -> T & {
 
 template <class T>
 PinnedVector<T>::~PinnedVector() {
+  MemoryTracker::remove(tracker_id, MemoryTracker::MEMORY_KIND::PINNED, bytes);
+  if (PinnedArena::get_global().deallocate(ptr)) { return; }
   // NOLINTNEXTLIE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
   try {
     GPU_CHECK(hipHostFree(ptr));
@@ -6,7 +6,9 @@
  * @brief This class is part of the gpu utilities and represents an array of
  * fixed size but with some nice utilities to interact with other gpu utilities.
  * It uses pinned memory so that memory transfers between cpu and gpu are much
- * faster.
+ * faster. The memory is taken from the global PinnedArena if it has been
+ * reserved and has room, and is otherwise allocated on its own. Either way it
+ * is counted by the MemoryTracker under the component of the creating thread.
  */
 
 #include <vector>
@@ -22,6 +24,7 @@ class PinnedVector {
   T *ptr;
   u64 bytes;
   u64 num_elems = 0;
+  u64 tracker_id;
 
 public:
   explicit PinnedVector(u64 size);
@@ -0,0 +1,243 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "Tools/PipelineProfiler.h"
+#include "Tools/TypeDefinitions.h"
+#include "fmt/core.h"
+
+namespace log_utils {
+
+using fmt::format;
+using std::atomic;
+using std::map;
+using std::mutex;
+using std::optional;
+using std::pair;
+using std::set;
+using std::tuple;
+using std::unique_lock;
+using std::vector;
+using std::chrono::duration;
+using std::chrono::steady_clock;
+
+namespace {
+
+const string batch_event_prefix = "batch ";
+// waits shorter than this share of the wall time are left out of the summary
+const double notable_wait_fraction = 0.1;
+
+class StageTimes {
+public:
+  double busy_seconds = 0;
+  // the waits which happen during a batch event are not busy time
+  double waits_during_events = 0;
+  optional<steady_clock::time_point> event_start;
+  map<string, double> input_waits;
+  map<string, double> output_waits;
+};
+
+class ProfilerState {
+public:
+  atomic<bool> enabled = false;
+  mutex state_mutex;
+  steady_clock::time_point start_time;
+  // from each queue to the stages which produce into it and consume from it
+  map<string, pair<string, string>> queues;
+  map<string, StageTimes> stages;
+};
+
+auto get_state() -> ProfilerState & {
+  static ProfilerState state;
+  return state;
+}
+
+auto get_busy_seconds(const StageTimes &times) -> double {
+  return std::max(0.0, times.busy_seconds - times.waits_during_events);
+}
+
+auto get_total(const map<string, double> &waits) -> double {
+  double total = 0;
+  for (const auto &[queue, seconds] : waits) { total += seconds; }
+  return total;
+}
+
+auto get_longest(const map<string, double> &waits) -> pair<string, double> {
+  pair<string, double> longest{"", 0};
+  for (const auto &[queue, seconds] : waits) {
+    if (seconds > longest.second) { longest = {queue, seconds}; }
+  }
+  return longest;
+}
+
+auto get_percentage(double seconds, double wall_seconds) -> double {
+  return wall_seconds > 0 ? seconds / wall_seconds * 100 : 0;
+}
+
+auto write_table(string &report, ProfilerState &state, double wall_seconds)
+  -> void {
+  u64 width = 0;
+  for (const auto &[stage, times] : state.stages) {
+    width = std::max<u64>(width, stage.size());
+  }
+  width += 2;
+  report += format(
+    "{:<{}}{:>8}{:>8}{:>8}\n", "stage", width, "busy", "input", "output"
+  );
+  for (const auto &[stage, times] : state.stages) {
+    report += format(
+      "{:<{}}{:>7.1f}%{:>7.1f}%{:>7.1f}%\n",
+      stage,
+      width,
+      get_percentage(get_busy_seconds(times), wall_seconds),
+      get_percentage(get_total(times.input_waits), wall_seconds),
+      get_percentage(get_total(times.output_waits), wall_seconds)
+    );
+  }
+}
+
+auto write_notable_waits(
+  string &report, ProfilerState &state, double wall_seconds
+) -> void {
+  // the seconds, the stage which waited and what it waited for
+  vector<tuple<double, string, string>> waits;
+  for (const auto &[stage, times] : state.stages) {
+    for (const auto &[queue, seconds] : times.input_waits) {
+      waits.emplace_back(seconds, stage, queue);
+    }
+    for (const auto &[queue, seconds] : times.output_waits) {
+      waits.emplace_back(
+        seconds,
+        stage,
+        format("{} to free room in {}", state.queues[queue].second, queue)
+      );
+    }
+  }
+  std::sort(waits.rbegin(), waits.rend());
+  for (const auto &[seconds, stage, waited_for] : waits) {
+    if (seconds < notable_wait_fraction * wall_seconds) { break; }
+    report += format(
+      "{} waited {:.0f}% of wall time for {}\n",
+      stage,
+      get_percentage(seconds, wall_seconds),
+      waited_for
+    );
+  }
+}
+
+// Starts from each stage which only consumes, and keeps going to the producer
+// of the queue it waited on the longest, for as long as the stage waited for
+// that queue for longer than it was busy
+auto write_critical_paths(
+  string &report, ProfilerState &state, double wall_seconds
+) -> void {
+  set<string> producers;
+  for (const auto &[queue, queue_stages] : state.queues) {
+    producers.insert(queue_stages.first);
+  }
+  for (const auto &[sink, sink_times] : state.stages) {
+    if (producers.contains(sink)) { continue; }
+    string path = sink;
+    string stage = sink;
+    set<string> visited{sink};
+    while (true) {
+      const auto &times = state.stages[stage];
+      const auto [queue, seconds] = get_longest(times.input_waits);
+      if (seconds <= get_busy_seconds(times)) { break; }
+      const string producer = state.queues[queue].first;
+      if (visited.contains(producer)) { break; }
+      visited.insert(producer);
+      path += format(" <- {}", producer);
+      stage = producer;
+    }
+    report += format(
+      "Critical path: {}, where {} is the bottleneck and was busy {:.0f}% of "
+      "wall time\n",
+      path,
+      stage,
+      get_percentage(get_busy_seconds(state.stages[stage]), wall_seconds)
+    );
+  }
+}
+
+}  // namespace
+
+auto PipelineProfiler::start() -> void {
+  auto &state = get_state();
+  const unique_lock lock(state.state_mutex);
+  state.start_time = steady_clock::now();
+  state.enabled = true;
+}
+
+auto PipelineProfiler::is_enabled() -> bool { return get_state().enabled; }
+
+auto PipelineProfiler::add_queue(
+  const string &queue,
+  const string &producer_stage,
+  const string &consumer_stage
+) -> void {
+  auto &state = get_state();
+  const unique_lock lock(state.state_mutex);
+  state.queues[queue] = {producer_stage, consumer_stage};
+  state.stages[producer_stage];
+  state.stages[consumer_stage];
+}
+
+auto PipelineProfiler::add_wait(
+  const string &queue, bool waiting_for_room, double seconds
+) -> void {
+  auto &state = get_state();
+  if (!state.enabled) { return; }
+  const unique_lock lock(state.state_mutex);
+  const auto queue_stages = state.queues.find(queue);
+  if (queue_stages == state.queues.end()) { return; }
+  const auto &[producer_stage, consumer_stage] = queue_stages->second;
+  auto &times
+    = state.stages[waiting_for_room ? producer_stage : consumer_stage];
+  (waiting_for_room ? times.output_waits : times.input_waits)[queue]
+    += seconds;
+  if (times.event_start.has_value()) { times.waits_during_events += seconds; }
+}
+
+auto PipelineProfiler::add_timed_event(
+  const string &component, bool is_start, const string &message
+) -> void {
+  auto &state = get_state();
+  if (!state.enabled || !message.starts_with(batch_event_prefix)) { return; }
+  const auto now = steady_clock::now();
+  const unique_lock lock(state.state_mutex);
+  const auto stage = state.stages.find(component);
+  // events of components which are not stages of the pipeline are skipped
+  if (stage == state.stages.end()) { return; }
+  auto &times = stage->second;
+  if (is_start) {
+    times.event_start = now;
+  } else if (times.event_start.has_value()) {
+    times.busy_seconds
+      += duration<double>(now - times.event_start.value()).count();
+    times.event_start.reset();
+  }
+}
+
+auto PipelineProfiler::get_report() -> string {
+  auto &state = get_state();
+  const unique_lock lock(state.state_mutex);
+  const double wall_seconds
+    = duration<double>(steady_clock::now() - state.start_time).count();
+  string report = format(
+    "Bottleneck report over {:.2f} seconds of wall time\n", wall_seconds
+  );
+  write_table(report, state, wall_seconds);
+  write_notable_waits(report, state, wall_seconds);
+  write_critical_paths(report, state, wall_seconds);
+  return report;
+}
+
+}  // namespace log_utils
@@ -0,0 +1,57 @@
+#ifndef PIPELINE_PROFILER_H
+#define PIPELINE_PROFILER_H
+
+/**
+ * @file PipelineProfiler.h
+ * @brief Works out where the time of a run went, so that it can be reported at
+ * the end of the run without going through the logs. Every queue between two
+ * stages is added with the stage which produces into it and the stage which
+ * consumes from it, and the queues report each time a stage had to wait on
+ * them, either for a batch to read or for room to write one. The time each
+ * stage is busy comes from its timed events for each batch. The report then
+ * gives, for each stage, the share of the wall time spent busy, waiting for
+ * input and waiting for room for its output, along with the critical path of
+ * each stream, which is found by starting from the last stage and following
+ * the queue it waited on the longest until reaching a stage which was busy
+ * for longer than it waited.
+ */
+
+#include <string>
+
+namespace log_utils {
+
+using std::string;
+
+class PipelineProfiler {
+private:
+  PipelineProfiler() = default;
+
+public:
+  // Nothing is measured before this, and the wall time of the report starts
+  // here
+  static auto start() -> void;
+  [[nodiscard]] static auto is_enabled() -> bool;
+  // The components are named the same as in the timed events, such as
+  // Searcher_0. Queues can be added before starting, since they are only
+  // added once
+  static auto add_queue(
+    const string &queue,
+    const string &producer_stage,
+    const string &consumer_stage
+  ) -> void;
+  // If waiting_for_room is true, the producer waited for the consumer to free
+  // a batch, otherwise the consumer waited for the producer to fill one
+  static auto
+  add_wait(const string &queue, bool waiting_for_room, double seconds)
+    -> void;
+  // Only the events of each batch, whose message starts with 'batch', are
+  // counted towards the busy time of a stage
+  static auto add_timed_event(
+    const string &component, bool is_start, const string &message
+  ) -> void;
+  [[nodiscard]] static auto get_report() -> string;
+};
+
+}  // namespace log_utils
+
+#endif
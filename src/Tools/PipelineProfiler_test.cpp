@@ -0,0 +1,55 @@
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "Tools/PipelineProfiler.h"
+
+namespace log_utils {
+
+using std::string;
+
+TEST(PipelineProfilerTest, FindsBottleneck) {
+  PipelineProfiler::add_queue("ProfiledQueue_0", "Parser_0", "Searcher_0");
+  PipelineProfiler::add_queue("ProfiledSearcher_0", "Searcher_0", "Printer_0");
+  // nothing is measured before starting
+  PipelineProfiler::add_wait("ProfiledQueue_0", false, 1000);
+  PipelineProfiler::start();
+  EXPECT_TRUE(PipelineProfiler::is_enabled());
+  PipelineProfiler::add_timed_event("Parser_0", true, "batch 0");
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  PipelineProfiler::add_timed_event("Parser_0", false, "batch 0");
+  PipelineProfiler::add_wait("ProfiledQueue_0", true, 0.001);
+  // the searcher waits for its input during its own batch event, which does
+  // not count as being busy
+  PipelineProfiler::add_timed_event("Searcher_0", true, "batch 0");
+  PipelineProfiler::add_wait("ProfiledQueue_0", false, 20);
+  PipelineProfiler::add_timed_event("Searcher_0", false, "batch 0");
+  PipelineProfiler::add_wait("ProfiledSearcher_0", false, 10);
+  // components which are not stages and events which are not batches are
+  // left out
+  PipelineProfiler::add_timed_event("NotAStage_0", true, "batch 0");
+  PipelineProfiler::add_timed_event("NotAStage_0", false, "batch 0");
+  PipelineProfiler::add_timed_event("Parser_0", true, "");
+  const auto report = PipelineProfiler::get_report();
+  EXPECT_EQ(report.find("NotAStage_0"), string::npos);
+  EXPECT_NE(report.find("Bottleneck report over "), string::npos);
+  // the longer wait comes first
+  EXPECT_LT(
+    report.find("Searcher_0 waited "), report.find("Printer_0 waited ")
+  );
+  EXPECT_NE(report.find("Printer_0 waited "), string::npos);
+  EXPECT_NE(report.find("% of wall time for ProfiledQueue_0\n"), string::npos);
+  // the output wait was too short to be in the summary
+  EXPECT_EQ(report.find("to free room in ProfiledQueue_0"), string::npos);
+  EXPECT_NE(
+    report.find(
+      "Critical path: Printer_0 <- Searcher_0 <- Parser_0, where Parser_0 is "
+      "the bottleneck"
+    ),
+    string::npos
+  );
+}
+
+}  // namespace log_utils
@@ -0,0 +1,284 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sched.h>
+#include <sstream>
+#include <thread>
+
+#include "Tools/MathUtils.hpp"
+#include "Tools/MemoryUtils.h"
+#include "Tools/ResourceLimits.h"
+#include "fmt/core.h"
+
+namespace system_utils {
+
+using fmt::format;
+using math_utils::bits_to_gB;
+using memory_utils::get_total_system_memory;
+using std::function;
+using std::map;
+using std::pair;
+
+namespace {
+
+const u64 bytes_in_mB = 1024ULL * 1024;
+// cgroup v1 has no word for no limit, so it uses a number close to the
+// largest 64 bit number instead
+const u64 no_memory_limit = 1ULL << 60;
+
+auto read_first_line(const string &filename) -> optional<string> {
+  std::ifstream stream(filename);
+  string line;
+  if (!stream || !std::getline(stream, line)) { return {}; }
+  return line;
+}
+
+auto parse_u64(const string &text) -> optional<u64> {
+  if (text.empty() || text.find('-') != string::npos) { return {}; }
+  try {
+    return std::stoull(text);
+  } catch (std::exception &) { return {}; }
+}
+
+auto read_u64(const string &filename) -> optional<u64> {
+  const auto line = read_first_line(filename);
+  if (!line.has_value()) { return {}; }
+  return parse_u64(line.value());
+}
+
+auto get_environment_u64(const char *name) -> optional<u64> {
+  const char *value = std::getenv(name);
+  if (value == nullptr) { return {}; }
+  return parse_u64(value);
+}
+
+template <class T>
+auto keep_lowest(optional<T> &lowest, const optional<T> &value) -> void {
+  if (value.has_value() && (!lowest.has_value() || value < lowest)) {
+    lowest = value;
+  }
+}
+
+// From each controller, such as memory, to the folder it is mounted in under
+// the cgroup root and the path of the cgroup of this process. Each line of
+// the file is 'hierarchy:controllers:path', where cgroup v2 has no
+// controllers and is kept under the empty controller.
+auto read_process_cgroups(const string &process_cgroup_file)
+  -> map<string, pair<string, string>> {
+  map<string, pair<string, string>> cgroups;
+  std::ifstream stream(process_cgroup_file);
+  string line;
+  while (std::getline(stream, line)) {
+    const auto first_colon = line.find(':');
+    const auto second_colon = line.find(':', first_colon + 1);
+    if (first_colon == string::npos || second_colon == string::npos) {
+      continue;
+    }
+    const string controllers
+      = line.substr(first_colon + 1, second_colon - first_colon - 1);
+    const string path = line.substr(second_colon + 1);
+    if (controllers.empty()) {
+      cgroups[""] = {"", path};
+      continue;
+    }
+    std::stringstream controller_stream(controllers);
+    string controller;
+    while (std::getline(controller_stream, controller, ',')) {
+      cgroups[controller] = {"/" + controllers, path};
+    }
+  }
+  return cgroups;
+}
+
+// Reads the limit of the cgroup and of each of its parents, and keeps the
+// lowest. Within a container the cgroup is often mounted as the root, so
+// that its path does not exist, in which case only the root is read.
+template <class T>
+auto get_lowest_limit(
+  const string &folder,
+  string path,
+  const function<optional<T>(const string &)> &read_limit
+) -> optional<T> {
+  optional<T> lowest;
+  while (true) {
+    keep_lowest(lowest, read_limit(folder + path));
+    if (path.empty() || path == "/") { break; }
+    path = path.substr(0, path.find_last_of('/'));
+  }
+  return lowest;
+}
+
+auto read_cgroup_v2_memory(const string &folder) -> optional<u64> {
+  // this is 'max' when there is no limit
+  return read_u64(folder + "/memory.max");
+}
+
+auto read_cgroup_v1_memory(const string &folder) -> optional<u64> {
+  const auto limit = read_u64(folder + "/memory.limit_in_bytes");
+  if (limit.has_value() && limit.value() >= no_memory_limit) { return {}; }
+  return limit;
+}
+
+auto read_cgroup_v2_cpu_quota(const string &folder) -> optional<double> {
+  // such as '150000 100000', or 'max 100000' when there is no limit
+  const auto line = read_first_line(folder + "/cpu.max");
+  if (!line.has_value()) { return {}; }
+  const auto space = line->find(' ');
+  if (space == string::npos) { return {}; }
+  const auto quota = parse_u64(line->substr(0, space));
+  const auto period = parse_u64(line->substr(space + 1));
+  if (!quota.has_value() || !period.has_value() || period == 0) { return {}; }
+  return static_cast<double>(quota.value())
+    / static_cast<double>(period.value());
+}
+
+auto read_cgroup_v1_cpu_quota(const string &folder) -> optional<double> {
+  // the quota is -1 when there is no limit
+  const auto quota = read_u64(folder + "/cpu.cfs_quota_us");
+  const auto period = read_u64(folder + "/cpu.cfs_period_us");
+  if (!quota.has_value() || !period.has_value() || period == 0) { return {}; }
+  return static_cast<double>(quota.value())
+    / static_cast<double>(period.value());
+}
+
+auto read_cgroup_limits(
+  ResourceLimits &limits,
+  const string &process_cgroup_file,
+  const string &cgroup_root
+) -> void {
+  const auto cgroups = read_process_cgroups(process_cgroup_file);
+  if (cgroups.contains("")) {
+    const auto &path = cgroups.at("").second;
+    keep_lowest(
+      limits.cgroup_memory,
+      get_lowest_limit<u64>(cgroup_root, path, read_cgroup_v2_memory)
+    );
+    keep_lowest(
+      limits.cgroup_cpu_quota,
+      get_lowest_limit<double>(cgroup_root, path, read_cgroup_v2_cpu_quota)
+    );
+  }
+  if (cgroups.contains("memory")) {
+    const auto &[folder, path] = cgroups.at("memory");
+    keep_lowest(
+      limits.cgroup_memory,
+      get_lowest_limit<u64>(cgroup_root + folder, path, read_cgroup_v1_memory)
+    );
+  }
+  if (cgroups.contains("cpu")) {
+    const auto &[folder, path] = cgroups.at("cpu");
+    keep_lowest(
+      limits.cgroup_cpu_quota,
+      get_lowest_limit<double>(
+        cgroup_root + folder, path, read_cgroup_v1_cpu_quota
+      )
+    );
+  }
+}
+
+auto read_slurm_limits(ResourceLimits &limits) -> void {
+  limits.slurm_cpus = get_environment_u64("SLURM_CPUS_PER_TASK");
+  if (!limits.slurm_cpus.has_value()) {
+    limits.slurm_cpus = get_environment_u64("SLURM_CPUS_ON_NODE");
+  }
+  // Slurm gives its memory in megabytes, either for the whole node or for
+  // each cpu of the job on this node
+  const auto memory_per_node = get_environment_u64("SLURM_MEM_PER_NODE");
+  const auto memory_per_cpu = get_environment_u64("SLURM_MEM_PER_CPU");
+  const auto cpus_on_node = get_environment_u64("SLURM_CPUS_ON_NODE");
+  if (memory_per_node.has_value()) {
+    limits.slurm_memory = memory_per_node.value() * bytes_in_mB;
+  } else if (memory_per_cpu.has_value()) {
+    limits.slurm_memory = memory_per_cpu.value() * bytes_in_mB
+      * cpus_on_node.value_or(limits.slurm_cpus.value_or(1));
+  }
+}
+
+auto read_affinity_cpus() -> optional<u64> {
+#ifdef __linux__
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(cpu_set_t), &allowed) != 0) { return {}; }
+  return CPU_COUNT(&allowed);
+#else
+  return {};
+#endif
+}
+
+auto to_gB(u64 bytes) -> double { return bits_to_gB(bytes * bits_in_byte); }
+
+}  // namespace
+
+auto ResourceLimits::get_memory() const -> u64 {
+  u64 memory = physical_memory;
+  for (const auto &limit : {cgroup_memory, slurm_memory}) {
+    if (limit.has_value()) { memory = std::min(memory, limit.value()); }
+  }
+  return memory;
+}
+
+auto ResourceLimits::get_cpus() const -> u64 {
+  optional<u64> cpus;
+  if (hardware_threads > 0) { cpus = hardware_threads; }
+  keep_lowest(cpus, affinity_cpus);
+  keep_lowest(cpus, slurm_cpus);
+  if (cgroup_cpu_quota.has_value()) {
+    keep_lowest(
+      cpus, optional<u64>(static_cast<u64>(std::ceil(cgroup_cpu_quota.value())))
+    );
+  }
+  return std::max<u64>(cpus.value_or(1), 1);
+}
+
+auto ResourceLimits::get_description() const -> vector<string> {
+  string memory = format(
+    "Main memory: {:.2f}GB on the machine", to_gB(physical_memory)
+  );
+  if (cgroup_memory.has_value()) {
+    memory += format(
+      ", {:.2f}GB allowed by the cgroup", to_gB(cgroup_memory.value())
+    );
+  }
+  if (slurm_memory.has_value()) {
+    memory
+      += format(", {:.2f}GB allowed by Slurm", to_gB(slurm_memory.value()));
+  }
+  memory += format(", so up to {:.2f}GB is used", to_gB(get_memory()));
+  string cpus = format("Cpus: {} hardware threads", hardware_threads);
+  if (affinity_cpus.has_value()) {
+    cpus += format(", {} in the affinity mask", affinity_cpus.value());
+  }
+  if (cgroup_cpu_quota.has_value()) {
+    cpus += format(
+      ", {:.2f} allowed by the cgroup quota", cgroup_cpu_quota.value()
+    );
+  }
+  if (slurm_cpus.has_value()) {
+    cpus += format(", {} allowed by Slurm", slurm_cpus.value());
+  }
+  cpus += format(", so {} are used", get_cpus());
+  return {memory, cpus};
+}
+
+auto get_resource_limits() -> const ResourceLimits & {
+  static const ResourceLimits limits
+    = read_resource_limits("/proc/self/cgroup", "/sys/fs/cgroup");
+  return limits;
+}
+
+auto read_resource_limits(
+  const string &process_cgroup_file, const string &cgroup_root
+) -> ResourceLimits {
+  ResourceLimits limits;
+  limits.physical_memory = get_total_system_memory();
+  limits.hardware_threads = std::thread::hardware_concurrency();
+  limits.affinity_cpus = read_affinity_cpus();
+  read_cgroup_limits(limits, process_cgroup_file, cgroup_root);
+  read_slurm_limits(limits);
+  return limits;
+}
+
+}  // namespace system_utils
@@ -0,0 +1,59 @@
+#ifndef RESOURCE_LIMITS_H
+#define RESOURCE_LIMITS_H
+
+/**
+ * @file ResourceLimits.h
+ * @brief Finds out how much memory and how many cpus this process may really
+ * use, as opposed to what the whole machine has. Within a container or a
+ * Slurm allocation, the memory is limited by the cgroup and by the memory
+ * which Slurm gave the job, and the cpus are limited by the affinity mask,
+ * the cpu quota of the cgroup and the cpus which Slurm gave each task. Both
+ * cgroup v1 and v2 are understood, and nested cgroups are limited by the
+ * lowest limit along the way. Each limit which is not set is left empty.
+ */
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Tools/TypeDefinitions.h"
+
+namespace system_utils {
+
+using std::optional;
+using std::string;
+using std::vector;
+
+class ResourceLimits {
+public:
+  // in bytes
+  u64 physical_memory = 0;
+  optional<u64> cgroup_memory;
+  optional<u64> slurm_memory;
+  u64 hardware_threads = 0;
+  optional<u64> affinity_cpus;
+  // the number of cpus worth of time, which may not be whole
+  optional<double> cgroup_cpu_quota;
+  optional<u64> slurm_cpus;
+
+  // The lowest of the limits, in bytes
+  [[nodiscard]] auto get_memory() const -> u64;
+  // The lowest of the limits, where a quota is rounded up, and at least 1
+  [[nodiscard]] auto get_cpus() const -> u64;
+  // A line for the memory and a line for the cpus, which say where each
+  // limit came from
+  [[nodiscard]] auto get_description() const -> vector<string>;
+};
+
+// The limits of this process, which are only read the first time
+auto get_resource_limits() -> const ResourceLimits &;
+// Reads the limits using the given cgroup file of the process, which is
+// usually /proc/self/cgroup, and the root where the cgroups are mounted,
+// which is usually /sys/fs/cgroup. The Slurm limits come from the environment.
+auto read_resource_limits(
+  const string &process_cgroup_file, const string &cgroup_root
+) -> ResourceLimits;
+
+}  // namespace system_utils
+
+#endif
@@ -0,0 +1,113 @@
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Tools/ResourceLimits.h"
+
+namespace system_utils {
+
+using std::string;
+
+namespace {
+
+const string cgroup_root = "test_objects/tmp/ResourceLimitsTest";
+const string process_cgroup_file = cgroup_root + "/process_cgroup";
+const u64 gB = 1024ULL * 1024 * 1024;
+
+auto write_file(const string &filename, const string &contents) -> void {
+  std::filesystem::create_directories(
+    std::filesystem::path(filename).parent_path()
+  );
+  std::ofstream(filename) << contents << "\n";
+}
+
+auto unset_slurm() -> void {
+  for (const auto *name :
+       {"SLURM_CPUS_PER_TASK",
+        "SLURM_CPUS_ON_NODE",
+        "SLURM_MEM_PER_NODE",
+        "SLURM_MEM_PER_CPU"}) {
+    unsetenv(name);
+  }
+}
+
+}  // namespace
+
+TEST(ResourceLimitsTest, CgroupV2) {
+  unset_slurm();
+  std::filesystem::remove_all(cgroup_root);
+  write_file(process_cgroup_file, "0::/job/step");
+  // the parent has the lower memory limit and the child the cpu quota
+  write_file(cgroup_root + "/job/memory.max", std::to_string(gB));
+  write_file(cgroup_root + "/job/cpu.max", "max 100000");
+  write_file(cgroup_root + "/job/step/memory.max", "max");
+  write_file(cgroup_root + "/job/step/cpu.max", "150000 100000");
+  const auto limits = read_resource_limits(process_cgroup_file, cgroup_root);
+  ASSERT_TRUE(limits.cgroup_memory.has_value());
+  EXPECT_EQ(limits.cgroup_memory.value(), gB);
+  ASSERT_TRUE(limits.cgroup_cpu_quota.has_value());
+  EXPECT_DOUBLE_EQ(limits.cgroup_cpu_quota.value(), 1.5);
+  EXPECT_FALSE(limits.slurm_memory.has_value());
+  EXPECT_FALSE(limits.slurm_cpus.has_value());
+  EXPECT_EQ(limits.get_memory(), std::min(gB, limits.physical_memory));
+  EXPECT_LE(limits.get_cpus(), 2);
+  EXPECT_EQ(limits.get_description().size(), 2);
+}
+
+TEST(ResourceLimitsTest, CgroupV1) {
+  unset_slurm();
+  std::filesystem::remove_all(cgroup_root);
+  // within a container the cgroup of the process is mounted as the root
+  write_file(
+    process_cgroup_file,
+    "5:memory:/docker/abc\n4:cpu,cpuacct:/docker/abc\n1:name=systemd:/"
+  );
+  write_file(cgroup_root + "/memory/memory.limit_in_bytes", "1073741824");
+  write_file(cgroup_root + "/cpu,cpuacct/cpu.cfs_quota_us", "200000");
+  write_file(cgroup_root + "/cpu,cpuacct/cpu.cfs_period_us", "100000");
+  const auto limits = read_resource_limits(process_cgroup_file, cgroup_root);
+  EXPECT_EQ(limits.cgroup_memory, gB);
+  EXPECT_EQ(limits.cgroup_cpu_quota, 2.0);
+}
+
+TEST(ResourceLimitsTest, NoLimits) {
+  unset_slurm();
+  std::filesystem::remove_all(cgroup_root);
+  write_file(process_cgroup_file, "4:memory:/\n3:cpu:/");
+  write_file(
+    cgroup_root + "/memory/memory.limit_in_bytes", "9223372036854771712"
+  );
+  write_file(cgroup_root + "/cpu/cpu.cfs_quota_us", "-1");
+  write_file(cgroup_root + "/cpu/cpu.cfs_period_us", "100000");
+  const auto limits = read_resource_limits(process_cgroup_file, cgroup_root);
+  EXPECT_FALSE(limits.cgroup_memory.has_value());
+  EXPECT_FALSE(limits.cgroup_cpu_quota.has_value());
+  EXPECT_EQ(limits.get_memory(), limits.physical_memory);
+  EXPECT_GE(limits.get_cpus(), 1);
+  // a missing file means there are no limits either
+  const auto missing
+    = read_resource_limits(cgroup_root + "/missing", cgroup_root);
+  EXPECT_FALSE(missing.cgroup_memory.has_value());
+}
+
+TEST(ResourceLimitsTest, Slurm) {
+  unset_slurm();
+  std::filesystem::remove_all(cgroup_root);
+  setenv("SLURM_CPUS_PER_TASK", "1", 1);
+  setenv("SLURM_CPUS_ON_NODE", "4", 1);
+  setenv("SLURM_MEM_PER_CPU", "256", 1);
+  auto limits = read_resource_limits(process_cgroup_file, cgroup_root);
+  EXPECT_EQ(limits.slurm_cpus, 1);
+  EXPECT_EQ(limits.get_cpus(), 1);
+  EXPECT_EQ(limits.slurm_memory, gB);
+  // the memory for the whole node comes before the memory per cpu
+  setenv("SLURM_MEM_PER_NODE", "2048", 1);
+  limits = read_resource_limits(process_cgroup_file, cgroup_root);
+  EXPECT_EQ(limits.slurm_memory, 2 * gB);
+  unset_slurm();
+}
+
+}  // namespace system_utils
@@ -4,23 +4,36 @@
 /**
  * @file SharedBatchesProducer.hpp
  * @brief Template class for any class which is a continuous batch producer that
- * shares its batch
+ * shares its batch. Once measurements are enabled for it, it reports the
+ * batches it produced, how many batches are waiting to be read, and the time
+ * spent waiting for a free batch, which means its consumer is slower, or by its
+ * consumer waiting for a batch, which means this producer is slower. These go
+ * to the metrics and to the bottleneck report.
  */
 
+#include <chrono>
 #include <memory>
 #include <stdexcept>
+#include <string>
 
 #include "Tools/CircularBuffer.hpp"
 #include "Tools/ErrorUtils.h"
+#include "Tools/Metrics.h"
 #include "Tools/OmpLock.h"
+#include "Tools/PipelineProfiler.h"
 #include "Tools/Semaphore.h"
 #include "Tools/TypeDefinitions.h"
 
 namespace design_utils {
 
+using log_utils::Metrics;
+using log_utils::PipelineProfiler;
 using std::make_shared;
 using std::runtime_error;
 using std::shared_ptr;
+using std::string;
+using std::chrono::duration;
+using std::chrono::steady_clock;
 using structure_utils::CircularBuffer;
 using threading_utils::OmpLock;
 using threading_utils::Semaphore;
@@ -33,6 +46,7 @@ private:
   OmpLock step_lock;
   u64 batch_id = 0;
   CircularBuffer<shared_ptr<BatchType>> batches;
+  string queue_name;
 
 public:
   SharedBatchesProducer(SharedBatchesProducer &) = delete;
@@ -58,7 +72,9 @@ public:
 
   auto operator>>(shared_ptr<BatchType> &out) -> bool {
     start_semaphore.release();
-    finish_semaphore.acquire();
+    acquire_measured(
+      finish_semaphore, "empty_queue_wait_seconds_total", false
+    );
     step_lock.set_lock();
     if (batches.empty()) {
       step_lock.unset_lock();
@@ -66,10 +82,25 @@ public:
     }
     out = current_read();
     batches.step_read();
+    const u64 queued = batches.size();
     step_lock.unset_lock();
+    set_queue_metric(queued);
     return true;
   }
 
+  // The components are named the same as in the timed events. The queue is
+  // named after this producer, such as BitsProducer_0, while the stages are
+  // the ones which write into it and read from it, such as
+  // SeqToBitsConverter_0 and Searcher_0
+  auto enable_measurements(
+    string queue_name_,
+    const string &producer_stage,
+    const string &consumer_stage
+  ) -> void {
+    queue_name = std::move(queue_name_);
+    PipelineProfiler::add_queue(queue_name, producer_stage, consumer_stage);
+  }
+
 protected:
   [[nodiscard]] auto get_batch_id() const -> u64 { return batch_id; }
   [[nodiscard]] auto get_batches() -> CircularBuffer<shared_ptr<BatchType>> & {
@@ -96,18 +127,47 @@ protected:
     throw_uninitialised();
     return false;
   };
-  auto virtual do_at_batch_start() -> void { start_semaphore.acquire(); }
+  auto virtual do_at_batch_start() -> void {
+    acquire_measured(start_semaphore, "full_queue_wait_seconds_total", true);
+  }
   auto virtual generate() -> void { throw_uninitialised(); };
   auto virtual do_at_batch_finish() -> void {
     step_lock.set_lock();
     batches.step_write();
+    const u64 queued = batches.size();
     step_lock.unset_lock();
     finish_semaphore.release();
+    if (!queue_name.empty()) {
+      Metrics::add(queue_name, "batches_total", 1);
+      set_queue_metric(queued);
+    }
   }
   auto virtual do_at_generate_finish() -> void { finish_semaphore.release(); }
   virtual ~SharedBatchesProducer() = default;
 
 private:
+  auto acquire_measured(
+    Semaphore &semaphore, const string &metric, bool waiting_for_room
+  ) -> void {
+    if (queue_name.empty()) {
+      semaphore.acquire();
+      return;
+    }
+    const auto start_time = steady_clock::now();
+    semaphore.acquire();
+    const double seconds
+      = duration<double>(steady_clock::now() - start_time).count();
+    Metrics::add(queue_name, metric, seconds);
+    PipelineProfiler::add_wait(queue_name, waiting_for_room, seconds);
+  }
+
+  auto set_queue_metric(u64 queued) -> void {
+    if (queue_name.empty()) { return; }
+    Metrics::set(
+      queue_name, "queued_batches", static_cast<double>(queued)
+    );
+  }
+
   auto throw_if_uninitialised() {
     if (!batches_initialised) {
       throw runtime_error(
@@ -6,9 +6,13 @@
  * @brief Functions to help out with standard library items
  */
 
+#include <algorithm>
+#include <functional>
 #include <iterator>
 #include <vector>
 
+#include <omp.h>
+
 #include "Tools/MathUtils.hpp"
 #include "Tools/TypeDefinitions.h"
 
@@ -37,6 +41,37 @@ auto split_vector(const vector<T> &v, u64 parts) -> vector<vector<T>> {
   return result;
 }
 
+// Sorts the vector by first sorting contiguous chunks of it in parallel and
+// then merging neighbouring chunks in parallel, doubling the chunk size each
+// round until a single chunk is left
+template <class T, class Compare = std::less<T>>
+auto parallel_sort(vector<T> &v, Compare compare = Compare()) -> void {
+  const u64 chunks = std::min<u64>(omp_get_max_threads(), v.size() + 1);
+  vector<u64> starts(chunks + 1);
+  for (u64 i = 0; i <= chunks; ++i) {
+    starts[i] = divide_and_round<u64>(i * v.size(), chunks);
+  }
+#pragma omp parallel for
+  for (u64 i = 0; i < chunks; ++i) {
+    std::sort(
+      copy_advance(v.begin(), starts[i]),
+      copy_advance(v.begin(), starts[i + 1]),
+      compare
+    );
+  }
+  for (u64 width = 1; width < chunks; width *= 2) {
+#pragma omp parallel for
+    for (u64 i = 0; i < chunks - width; i += 2 * width) {
+      std::inplace_merge(
+        copy_advance(v.begin(), starts[i]),
+        copy_advance(v.begin(), starts[i + width]),
+        copy_advance(v.begin(), starts[std::min(i + 2 * width, chunks)]),
+        compare
+      );
+    }
+  }
+}
+
 }  // namespace std_utils
 
 #endif
@@ -1,12 +1,16 @@
+#include <algorithm>
+#include <functional>
 #include <numeric>
 #include <vector>
 
 #include <gtest/gtest.h>
 
+#include "Tools/RNGUtils.hpp"
 #include "Tools/StdUtils.hpp"
 
 namespace std_utils {
 
+using rng_utils::get_uniform_int_generator;
 using std::vector;
 
 TEST(StdUtils, SplitVector) {
@@ -20,4 +24,18 @@ TEST(StdUtils, SplitVector) {
   ASSERT_EQ(count, vector_size);
 }
 
+TEST(StdUtils, ParallelSort) {
+  const u64 vector_size = 10000;
+  auto rng = get_uniform_int_generator<u64>(0, vector_size);
+  vector<u64> v(vector_size);
+  for (auto &x : v) { x = rng(); }
+  auto expected = v;
+  std::sort(expected.begin(), expected.end(), std::greater<>());
+  parallel_sort(v, std::greater<>());
+  ASSERT_EQ(v, expected);
+  vector<u64> empty;
+  parallel_sort(empty);
+  ASSERT_TRUE(empty.empty());
+}
+
 }  // namespace std_utils
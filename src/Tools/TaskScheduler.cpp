@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <memory>
+#include <pthread.h>
+#include <sched.h>
+
+#include "Tools/TaskScheduler.h"
+
+namespace threading_utils {
+
+using std::lock_guard;
+using std::make_shared;
+using std::make_unique;
+using std::min;
+using std::unique_lock;
+
+namespace {
+
+unique_ptr<TaskScheduler> global_scheduler;  // NOLINT (cert-err58-cpp)
+mutex global_scheduler_mutex;                // NOLINT (cert-err58-cpp)
+
+thread_local TaskScheduler *current_scheduler = nullptr;
+thread_local u64 current_worker = 0;
+
+class ParallelForState {
+public:
+  atomic<u64> next_idx = 0;
+  atomic<u64> finished = 0;
+  atomic<u64> written = 0;
+};
+
+}  // namespace
+
+TaskScheduler::TaskScheduler(u64 threads, bool pin_threads_):
+    pin_threads(pin_threads_) {
+  threads = std::max<u64>(threads, 1);
+  for (u64 i = 0; i < threads; ++i) {
+    queues.push_back(make_unique<WorkerQueue>());
+  }
+  for (u64 i = 0; i < threads; ++i) {
+    workers.emplace_back([this, i] { worker_loop(i); });
+  }
+}
+
+TaskScheduler::~TaskScheduler() {
+  {
+    lock_guard<mutex> lock(sleep_mutex);
+    stopping = true;
+  }
+  sleep_condition.notify_all();
+  for (auto &worker : workers) { worker.join(); }
+}
+
+auto TaskScheduler::initialise_global(u64 threads, bool pin_threads) -> void {
+  lock_guard<mutex> lock(global_scheduler_mutex);
+  global_scheduler.reset();
+  global_scheduler = make_unique<TaskScheduler>(threads, pin_threads);
+}
+
+auto TaskScheduler::get_global() -> TaskScheduler & {
+  lock_guard<mutex> lock(global_scheduler_mutex);
+  if (global_scheduler == nullptr) {
+    global_scheduler
+      = make_unique<TaskScheduler>(std::thread::hardware_concurrency());
+  }
+  return *global_scheduler;
+}
+
+auto TaskScheduler::get_threads() const -> u64 { return workers.size(); }
+
+auto TaskScheduler::submit(function<void()> task) -> void {
+  u64 queue_idx = (current_scheduler == this) ?
+    current_worker :
+    next_queue.fetch_add(1) % queues.size();
+  {
+    lock_guard<mutex> lock(queues[queue_idx]->queue_mutex);
+    queues[queue_idx]->tasks.push_back(std::move(task));
+  }
+  ++queued_tasks;
+  { lock_guard<mutex> lock(sleep_mutex); }
+  sleep_condition.notify_one();
+}
+
+auto TaskScheduler::parallel_for(
+  u64 tasks,
+  const function<void(u64)> &body,
+  const function<void(u64)> &in_order
+) -> void {
+  if (tasks == 0) { return; }
+  auto state = make_shared<ParallelForState>();
+  // helpers which run after all indexes were claimed exit without touching
+  // body or in_order, so capturing these by reference is safe
+  auto run_indexes = [state, tasks, &body, &in_order] {
+    for (u64 idx = state->next_idx++; idx < tasks; idx = state->next_idx++) {
+      body(idx);
+      if (in_order) {
+        for (u64 written = state->written; written != idx;
+             written = state->written) {
+          state->written.wait(written);
+        }
+        in_order(idx);
+        state->written = idx + 1;
+        state->written.notify_all();
+      }
+      ++state->finished;
+      state->finished.notify_all();
+    }
+  };
+  u64 helpers = min<u64>(tasks - 1, workers.size());
+  for (u64 i = 0; i < helpers; ++i) { submit(run_indexes); }
+  run_indexes();
+  for (u64 finished = state->finished; finished < tasks;
+       finished = state->finished) {
+    if (!try_run_task()) { state->finished.wait(finished); }
+  }
+}
+
+auto TaskScheduler::run_blocking(const vector<function<void()>> &tasks)
+  -> void {
+  vector<thread> threads;
+  threads.reserve(tasks.size());
+  for (const auto &task : tasks) { threads.emplace_back(task); }
+  for (auto &t : threads) { t.join(); }
+}
+
+auto TaskScheduler::worker_loop(u64 worker_idx) -> void {
+  current_scheduler = this;
+  current_worker = worker_idx;
+  if (pin_threads) { pin_current_thread(worker_idx); }
+  while (true) {
+    if (try_run_task()) { continue; }
+    unique_lock<mutex> lock(sleep_mutex);
+    sleep_condition.wait(lock, [this] {
+      return stopping || queued_tasks > 0;
+    });
+    if (stopping && queued_tasks == 0) { return; }
+  }
+}
+
+auto TaskScheduler::try_run_task() -> bool {
+  bool is_worker = current_scheduler == this;
+  u64 own_idx = is_worker ? current_worker : next_queue % queues.size();
+  auto task = pop_task(own_idx, is_worker);
+  for (u64 i = 1; !task && i < queues.size(); ++i) {
+    task = pop_task((own_idx + i) % queues.size(), false);
+  }
+  if (!task) { return false; }
+  --queued_tasks;
+  (*task)();
+  return true;
+}
+
+auto TaskScheduler::pop_task(u64 queue_idx, bool from_back)
+  -> optional<function<void()>> {
+  auto &queue = *queues[queue_idx];
+  lock_guard<mutex> lock(queue.queue_mutex);
+  if (queue.tasks.empty()) { return std::nullopt; }
+  function<void()> task;
+  if (from_back) {
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+  } else {
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+  }
+  return task;
+}
+
+auto TaskScheduler::pin_current_thread(u64 worker_idx) -> void {
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(cpu_set_t), &allowed) != 0) { return; }
+  vector<u64> cores;
+  for (u64 core = 0; core < CPU_SETSIZE; ++core) {
+    if (CPU_ISSET(core, &allowed)) { cores.push_back(core); }
+  }
+  if (cores.empty()) { return; }
+  cpu_set_t target;
+  CPU_ZERO(&target);
+  CPU_SET(cores[worker_idx % cores.size()], &target);
+  pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &target);
+}
+
+}  // namespace threading_utils
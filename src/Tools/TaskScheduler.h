@@ -0,0 +1,110 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+/**
+ * @file TaskScheduler.h
+ * @brief A work stealing task scheduler with a fixed pool of worker threads.
+ * Each worker owns a deque of tasks, pops its own tasks from the back and
+ * steals from the front of the other workers' deques when it runs dry.
+ * Threads which wait on a parallel_for also help execute tasks, so nested
+ * submissions from pipeline stages never oversubscribe the machine. Workers
+ * can optionally be pinned to the cores this process is allowed to run on.
+ * Long running, mostly blocked work such as the pipeline stage loops is given
+ * to run_blocking instead, which gives each one a light thread of its own so
+ * that it can not starve the pool.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "Tools/MathUtils.hpp"
+#include "Tools/TypeDefinitions.h"
+
+namespace threading_utils {
+
+using std::atomic;
+using std::condition_variable;
+using std::deque;
+using std::function;
+using std::mutex;
+using std::optional;
+using std::thread;
+using std::unique_ptr;
+using std::vector;
+
+class TaskScheduler {
+private:
+  class WorkerQueue {
+  public:
+    mutex queue_mutex;
+    deque<function<void()>> tasks;
+  };
+
+  vector<unique_ptr<WorkerQueue>> queues;
+  vector<thread> workers;
+  bool pin_threads;
+  atomic<bool> stopping = false;
+  atomic<u64> queued_tasks = 0;
+  atomic<u64> next_queue = 0;
+  mutex sleep_mutex;
+  condition_variable sleep_condition;
+
+public:
+  explicit TaskScheduler(u64 threads, bool pin_threads_ = false);
+  TaskScheduler(TaskScheduler &) = delete;
+  TaskScheduler(TaskScheduler &&) = delete;
+  auto operator=(TaskScheduler &) = delete;
+  auto operator=(TaskScheduler &&) = delete;
+  ~TaskScheduler();
+
+  // The process wide scheduler. If it was never initialised, it is created
+  // with as many workers as there are hardware threads.
+  static auto initialise_global(u64 threads, bool pin_threads = false) -> void;
+  static auto get_global() -> TaskScheduler &;
+
+  [[nodiscard]] auto get_threads() const -> u64;
+  auto submit(function<void()> task) -> void;
+  // Runs body(i) for i in [0, tasks) and returns once all are done. Indexes
+  // are claimed in increasing order. If in_order is given, in_order(i) is
+  // called after body(i), and only after in_order(i - 1) has returned, which
+  // allows tasks to format in parallel but write to a stream sequentially.
+  auto parallel_for(
+    u64 tasks,
+    const function<void(u64)> &body,
+    const function<void(u64)> &in_order = nullptr
+  ) -> void;
+  // Runs function(i) for i in [0, size), split into one range of consecutive
+  // indexes for each worker, which suits many small and even iterations
+  template <class Function>
+  auto parallel_for_range(u64 size, Function function) -> void {
+    const u64 threads = get_threads();
+    const u64 per_thread = math_utils::divide_and_ceil<u64>(size, threads);
+    parallel_for(threads, [&](u64 idx) {
+      const u64 end = std::min((idx + 1) * per_thread, size);
+      for (u64 i = std::min(idx * per_thread, size); i < end; ++i) {
+        function(i);
+      }
+    });
+  }
+  // Runs each task on its own thread and joins them all. Use this for tasks
+  // which spend most of their time blocked, such as pipeline stages.
+  auto run_blocking(const vector<function<void()>> &tasks) -> void;
+
+private:
+  auto worker_loop(u64 worker_idx) -> void;
+  auto try_run_task() -> bool;
+  auto pop_task(u64 queue_idx, bool from_back) -> optional<function<void()>>;
+  static auto pin_current_thread(u64 worker_idx) -> void;
+};
+
+}  // namespace threading_utils
+
+#endif
@@ -0,0 +1,74 @@
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "Tools/Semaphore.h"
+#include "Tools/TaskScheduler.h"
+
+namespace threading_utils {
+
+using std::atomic;
+using std::function;
+using std::vector;
+
+const u64 scheduler_threads = 4;
+const u64 tasks = 1000;
+
+TEST(TaskSchedulerTest, ParallelForVisitsAllIndexes) {
+  TaskScheduler scheduler(scheduler_threads);
+  vector<u64> visited(tasks, 0);
+  scheduler.parallel_for(tasks, [&](u64 idx) { ++visited[idx]; });
+  ASSERT_EQ(vector<u64>(tasks, 1), visited);
+}
+
+TEST(TaskSchedulerTest, ParallelForRangeVisitsAllIndexes) {
+  TaskScheduler scheduler(scheduler_threads);
+  // a size which does not split evenly, and one smaller than the workers
+  for (const u64 size : {tasks + 3, scheduler_threads - 1}) {
+    vector<u64> visited(size, 0);
+    scheduler.parallel_for_range(size, [&](u64 idx) { ++visited[idx]; });
+    ASSERT_EQ(vector<u64>(size, 1), visited);
+  }
+}
+
+TEST(TaskSchedulerTest, InOrderIsSequential) {
+  TaskScheduler scheduler(scheduler_threads);
+  vector<u64> order;
+  scheduler.parallel_for(
+    tasks, [](u64 /*idx*/) {}, [&](u64 idx) { order.push_back(idx); }
+  );
+  ASSERT_EQ(tasks, order.size());
+  for (u64 i = 0; i < tasks; ++i) { ASSERT_EQ(i, order[i]); }
+}
+
+TEST(TaskSchedulerTest, NestedParallelFor) {
+  TaskScheduler scheduler(2);
+  atomic<u64> counter = 0;
+  scheduler.parallel_for(scheduler_threads, [&](u64 /*idx*/) {
+    scheduler.parallel_for(tasks, [&](u64 /*idx*/) { ++counter; });
+  });
+  ASSERT_EQ(scheduler_threads * tasks, counter);
+}
+
+TEST(TaskSchedulerTest, RunBlockingRunsConcurrently) {
+  TaskScheduler scheduler(1);
+  Semaphore first_done(0);
+  Semaphore second_done(0);
+  u64 result = 0;
+  scheduler.run_blocking(vector<function<void()>>{
+    [&] {
+      second_done.acquire();
+      result = result * 2;
+      first_done.release();
+    },
+    [&] {
+      result = 3;
+      second_done.release();
+      first_done.acquire();
+    }});
+  ASSERT_EQ(6, result);
+}
+
+}  // namespace threading_utils
@@ -0,0 +1,70 @@
+#ifndef MOVE_TO_KEY_KMER_CUH
+#define MOVE_TO_KEY_KMER_CUH
+
+/**
+ * @file MoveToKeyKmer.cuh
+ * @brief Only the key k-mers of the SBWT have colors, so the colors of any
+ * other k-mer are those of the key k-mer reached by following the outgoing
+ * edges of its node. These functions follow those edges, one at a time, or
+ * take a jump pointer as soon as they reach a node which has one (see
+ * KeyKmerJumper.h).
+ */
+
+#include "Tools/TypeDefinitions.h"
+#include "UtilityKernels/GetBoolFromBitVector.cuh"
+#include "UtilityKernels/Rank.cuh"
+#include "hip/hip_runtime.h"
+
+namespace sbwt_search {
+
+const u64 no_next_node = static_cast<u64>(-1);
+
+// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+// Follows the first outgoing edge of the node, or gives no_next_node if it has
+// none
+inline __device__ auto d_get_next_node(
+  const u64 *const c_map,
+  const u64 *const *const acgt,
+  const u64 *const *const layer_0,
+  const u64 *const *const layer_1_2,
+  u64 node
+) -> u64 {
+  for (u32 i = 0; i < 4; ++i) {
+    if (d_get_bool_from_bit_vector(acgt[i], node)) {
+      return c_map[i] + d_rank(acgt[i], layer_0[i], layer_1_2[i], node);
+    }
+  }
+  return no_next_node;
+}
+
+// If jump_marks is null, the whole way to the key k-mer is walked
+inline __device__ auto d_move_to_key_kmer(
+  const u64 *const c_map,
+  const u64 *const *const acgt,
+  const u64 *const *const layer_0,
+  const u64 *const *const layer_1_2,
+  const u64 *const key_kmer_marks,
+  const u64 *const jump_marks,
+  const u64 *const jump_layer_0,
+  const u64 *const jump_layer_1_2,
+  const u64 *const key_kmer_jumps,
+  u64 node
+) -> u64 {
+  while (!d_get_bool_from_bit_vector(key_kmer_marks, node)) {
+    if (jump_marks != nullptr
+        && d_get_bool_from_bit_vector(jump_marks, node)) {
+      return key_kmer_jumps[d_rank(
+        jump_marks, jump_layer_0, jump_layer_1_2, node
+      )];
+    }
+    const u64 next = d_get_next_node(c_map, acgt, layer_0, layer_1_2, node);
+    if (next == no_next_node) { break; }
+    node = next;
+  }
+  return node;
+}
+// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+}  // namespace sbwt_search
+
+#endif
@@ -0,0 +1,46 @@
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "PoppyBuilder/PoppyBuilder.h"
+#include "SbwtContainer/SbwtContainerBenchmarkUtils.h"
+#include "Tools/GpuPointer.h"
+#include "Tools/RNGUtils.hpp"
+#include "Tools/TypeDefinitions.h"
+#include "UtilityKernels/Rank_benchmark.h"
+
+namespace sbwt_search {
+
+using gpu_utils::GpuPointer;
+using rng_utils::get_uniform_int_generator;
+using std::vector;
+
+const u64 rank_num_bits = 1ULL << 26;
+
+auto benchmark_d_rank(benchmark::State &state) -> void {
+  const u64 num_indexes = state.range(0);
+  auto bits = get_random_bit_vector(rank_num_bits, u64_bits / 2);
+  auto poppy = PoppyBuilder(bits, rank_num_bits).get_poppy();
+  auto rng = get_uniform_int_generator<u64>(0, rank_num_bits - 1);
+  vector<u64> indexes(num_indexes);
+  for (auto &index : indexes) { index = rng(); }
+  GpuPointer<u64> d_bits(bits);
+  GpuPointer<u64> d_layer_0(poppy.layer_0);
+  GpuPointer<u64> d_layer_1_2(poppy.layer_1_2);
+  GpuPointer<u64> d_indexes(indexes);
+  GpuPointer<u64> d_results(num_indexes);
+  for (auto _ : state) {
+    get_ranks(
+      d_bits, d_layer_0, d_layer_1_2, d_indexes, num_indexes, d_results
+    );
+  }
+  state.SetItemsProcessed(
+    static_cast<int64_t>(state.iterations() * num_indexes)
+  );
+}
+BENCHMARK(benchmark_d_rank)
+  ->RangeMultiplier(8)
+  ->Range(1ULL << 14, 1ULL << 20)
+  ->Unit(benchmark::kMillisecond);
+
+}  // namespace sbwt_search
@@ -0,0 +1,39 @@
+#include "Global/GlobalDefinitions.h"
+#include "Tools/GpuPointer.h"
+#include "Tools/GpuUtils.h"
+#include "Tools/MathUtils.hpp"
+#include "UtilityKernels/Rank_benchmark.cuh"
+#include "UtilityKernels/Rank_benchmark.h"
+#include "hip/hip_runtime.h"
+
+using gpu_utils::GpuPointer;
+using math_utils::divide_and_ceil;
+
+namespace sbwt_search {
+
+auto get_ranks(
+  const GpuPointer<u64> &bit_vector,
+  const GpuPointer<u64> &poppy_layer_0,
+  const GpuPointer<u64> &poppy_layer_1_2,
+  const GpuPointer<u64> &indexes,
+  u64 num_indexes,
+  GpuPointer<u64> &results
+) -> void {
+  hipLaunchKernelGGL(
+    d_global_ranks,
+    divide_and_ceil<u64>(num_indexes, threads_per_block),
+    threads_per_block,
+    0,
+    nullptr,
+    bit_vector.data(),
+    poppy_layer_0.data(),
+    poppy_layer_1_2.data(),
+    indexes.data(),
+    num_indexes,
+    results.data()
+  );
+  GPU_CHECK(hipPeekAtLastError());
+  GPU_CHECK(hipDeviceSynchronize());
+}
+
+}  // namespace sbwt_search
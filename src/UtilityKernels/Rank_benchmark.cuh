@@ -0,0 +1,34 @@
+#ifndef RANK_BENCHMARK_CUH
+#define RANK_BENCHMARK_CUH
+
+/**
+ * @file Rank_benchmark.cuh
+ * @brief Kernel which computes one rank per thread, used for benchmarking
+ */
+
+#include "Tools/KernelUtils.cuh"
+#include "UtilityKernels/Rank.cuh"
+#include "hip/hip_runtime.h"
+
+namespace sbwt_search {
+
+using gpu_utils::get_idx;
+
+// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+__global__ auto d_global_ranks(
+  const u64 *bit_vector,
+  const u64 *layer_0,
+  const u64 *layer_1_2,
+  const u64 *indexes,
+  const u64 num_indexes,
+  u64 *results
+) -> void {
+  const u64 idx = get_idx();
+  if (idx >= num_indexes) { return; }
+  results[idx] = d_rank(bit_vector, layer_0, layer_1_2, indexes[idx]);
+}
+// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+}  // namespace sbwt_search
+
+#endif
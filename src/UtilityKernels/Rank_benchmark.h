@@ -0,0 +1,27 @@
+#ifndef RANK_BENCHMARK_H
+#define RANK_BENCHMARK_H
+
+/**
+ * @file Rank_benchmark.h
+ * @brief Header for the host side launcher of the rank benchmarking kernel
+ */
+
+#include "Tools/GpuPointer.h"
+#include "Tools/TypeDefinitions.h"
+
+namespace sbwt_search {
+
+using gpu_utils::GpuPointer;
+
+auto get_ranks(
+  const GpuPointer<u64> &bit_vector,
+  const GpuPointer<u64> &poppy_layer_0,
+  const GpuPointer<u64> &poppy_layer_1_2,
+  const GpuPointer<u64> &indexes,
+  u64 num_indexes,
+  GpuPointer<u64> &results
+) -> void;
+
+}  // namespace sbwt_search
+
+#endif
@@ -0,0 +1,33 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "Tools/Logger.h"
+
+using log_utils::Logger;
+using std::string;
+using std::string_view;
+using std::vector;
+
+// Results are printed as json unless the user asks for another format, so that
+// runs can be compared with tools such as google benchmark's compare.py
+auto main(int argc, char **argv) -> int {
+  Logger::initialise_global_logging(Logger::LOG_LEVEL::OFF);
+  vector<char *> args(argv, argv + argc);
+  string json_format = "--benchmark_format=json";
+  bool has_format = false;
+  for (const string_view arg : args) {
+    has_format = has_format || arg.starts_with("--benchmark_format");
+  }
+  if (!has_format) { args.push_back(json_format.data()); }
+  int args_size = static_cast<int>(args.size());
+  ::benchmark::Initialize(&args_size, args.data());
+  if (::benchmark::ReportUnrecognizedArguments(args_size, args.data())) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+  ::benchmark::Shutdown();
+  return 0;
+}
@@ -6,11 +6,15 @@
 
 #include <unordered_map>
 
+#include "Main/BuildIndexMain.h"
 #include "Main/ColorSearchMain.h"
+#include "Main/GenerateDataMain.h"
 #include "Main/IndexSearchMain.h"
 #include "Main/Main.h"
 
+using sbwt_search::BuildIndexMain;
 using sbwt_search::ColorSearchMain;
+using sbwt_search::GenerateDataMain;
 using sbwt_search::IndexSearchMain;
 using sbwt_search::Main;
 using std::cout;
@@ -25,9 +29,11 @@ auto main(int argc, char **argv) -> int {
   auto args = span{argv, static_cast<u64>(argc)};
   const unordered_map<string, shared_ptr<Main>> str_to_item{
     {"index", make_shared<IndexSearchMain>()},
-    {"colors", make_shared<ColorSearchMain>()}};
+    {"colors", make_shared<ColorSearchMain>()},
+    {"build", make_shared<BuildIndexMain>()},
+    {"generate", make_shared<GenerateDataMain>()}};
   if (argc == 1 || !str_to_item.contains(args[1])) {
-    cout << "Usage: sbwt_search [index|colors]" << endl;
+    cout << "Usage: sbwt_search [index|colors|build|generate]" << endl;
     return 1;
   }
   str_to_item.at(args[1])->main(argc, argv);